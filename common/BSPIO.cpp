@@ -1,6 +1,7 @@
 #include "extdll.h"
 #include "util.h"
 
+#include "CFile.h"
 #include "MiniBSPFile.h"
 
 #include "BSPIO.h"
@@ -65,95 +66,105 @@ char* LoadEntityLump( const char* const pszFileName )
 	return pszBuffer;
 }
 
-void ProcessEnts( const char* pszBuffer, ParseEntCallback pCallback )
+bool LoadLumps( const char* const pszFileName, std::initializer_list<LumpRequest> lumps )
 {
-	ASSERT( pszBuffer );
-	ASSERT( pCallback );
+	CFile file( pszFileName, "rb" );
 
-	char token[ 1024 ];
-	bool bError = false;
+	if( !file.IsOpen() )
+		return false;
 
-	// parse entities from entity lump of .bsp file
-	while( 1 )
+	dheader_t header;
+
+	if( file.Read( &header, sizeof( dheader_t ) ) != sizeof( dheader_t ) )
+	{
+		Con_Printf( "bsp::LoadLumps: Could not read BSP header for map [%s].\n", pszFileName );
+		return false;
+	}
+
+	if( header.version != BSPVERSION_QUAKE && header.version != BSPVERSION )
 	{
-		// parse the opening brace	
-		pszBuffer = COM_Parse( pszBuffer, token, sizeof( token ) );
-		if( !pszBuffer )
-			break;
+		Con_Printf( "bsp::LoadLumps: Map [%s] has incorrect BSP version (%i should be %i).\n", pszFileName, header.version, BSPVERSION );
+		return false;
+	}
 
-		// Didn't find opening brace?
-		if( token[ 0 ] != '{' )
+	const unsigned int uiFileSize = file.Size();
+
+	for( const auto& request : lumps )
+	{
+		ASSERT( request.iLump >= 0 && request.iLump < HEADER_LUMPS );
+		ASSERT( request.pData );
+
+		const lump_t& lump = header.lumps[ request.iLump ];
+
+		if( lump.fileofs < 0 || lump.filelen < 0 || static_cast<unsigned int>( lump.fileofs ) + static_cast<unsigned int>( lump.filelen ) > uiFileSize )
 		{
-			Con_Printf( "bsp::ProcessEnts: found %s when expecting {\n", token );
-			return;
+			Con_Printf( "bsp::LoadLumps: Map [%s] has an invalid lump %d.\n", pszFileName, request.iLump );
+			return false;
 		}
 
-		// Fill in data
-		pszBuffer = pCallback( pszBuffer, bError );
+		request.pData->resize( lump.filelen );
+
+		if( lump.filelen == 0 )
+			continue;
+
+		file.Seek( lump.fileofs, FILESYSTEM_SEEK_HEAD );
 
-		// Check for errors and abort if any
-		if( bError )
+		if( file.Read( request.pData->data(), lump.filelen ) != lump.filelen )
 		{
-			Con_Printf( "bsp::ProcessEnts: error parsing entities\n" );
-			return;
+			Con_Printf( "bsp::LoadLumps: Could not read lump %d for map [%s].\n", request.iLump, pszFileName );
+			return false;
 		}
 	}
+
+	return true;
 }
 
-const char* ParseKeyValue( const char* pszBuffer, char* pszKey, const size_t uiKeySize, char* pszValue, const size_t uiValueSize, bool& bError, bool& bEnd )
+bool LoadTextureNames( const char* const pszFileName, std::vector<std::string>& names )
 {
-	char token[ 1024 ];
+	names.clear();
 
-	// Parse key
-	pszBuffer = COM_Parse( pszBuffer, token, sizeof( token ) );
-	if( token[ 0 ] == '}' )
-	{
-		bEnd = true;
-		return pszBuffer;
-	}
+	std::vector<uint8_t> data;
 
-	bEnd = false;
+	if( !LoadLumps( pszFileName, { { LUMP_TEXTURES, &data } } ) )
+		return false;
 
-	// Ran out of input buffer?
-	if( !pszBuffer )
-	{
-		bError = true;
-		return pszBuffer;
-	}
+	//Empty lump means no textures.
+	if( data.size() < sizeof( int ) )
+		return true;
+
+	int iNumMiptex;
 
-	// Store off the key
-	strncpy( pszKey, token, uiKeySize );
-	pszKey[ uiKeySize - 1 ] = '\0';
+	memcpy( &iNumMiptex, data.data(), sizeof( iNumMiptex ) );
 
-	// Fix keynames with trailing spaces
-	size_t n = strlen( pszKey );
-	while( n && pszKey[ n - 1 ] == ' ' )
+	if( iNumMiptex < 0 || static_cast<size_t>( iNumMiptex ) > ( data.size() / sizeof( int ) ) - 1 )
 	{
-		pszKey[ n - 1 ] = 0;
-		--n;
+		Con_Printf( "bsp::LoadTextureNames: Map [%s] has an invalid texture lump.\n", pszFileName );
+		return false;
 	}
 
-	// Parse value	
-	pszBuffer = COM_Parse( pszBuffer, token, sizeof( token ) );
+	names.reserve( iNumMiptex );
 
-	// Ran out of buffer?
-	if( !pszBuffer )
-	{
-		bError = true;
-		return pszBuffer;
-	}
+	char szName[ sizeof( miptex_t::name ) + 1 ];
 
-	// Hit the end instead of a value?
-	if( token[ 0 ] == '}' )
+	for( int iMiptex = 0; iMiptex < iNumMiptex; ++iMiptex )
 	{
-		bError = true;
-		return pszBuffer;
-	}
+		int iOffset;
 
-	strncpy( pszValue, token, uiValueSize );
-	pszValue[ uiValueSize - 1 ] = '\0';
+		memcpy( &iOffset, data.data() + sizeof( int ) * ( iMiptex + 1 ), sizeof( iOffset ) );
 
-	// Return what's left in the stream
-	return pszBuffer;
+		//-1 marks textures that the compiler couldn't find.
+		if( iOffset < 0 || static_cast<size_t>( iOffset ) + sizeof( miptex_t::name ) > data.size() )
+		{
+			names.emplace_back();
+			continue;
+		}
+
+		memcpy( szName, data.data() + iOffset, sizeof( miptex_t::name ) );
+		szName[ sizeof( szName ) - 1 ] = '\0';
+
+		names.emplace_back( szName );
+	}
+
+	return true;
 }
 }
@@ -1,10 +1,13 @@
 #ifndef COMMON_BSPIO_H
 #define COMMON_BSPIO_H
 
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
 namespace bsp
 {
-using ParseEntCallback = const char* ( *)( const char* pszBuffer, bool& bError );
-
 /**
 *	Open the .bsp and read in the entity lump
 */
@@ -19,14 +22,29 @@ inline void FreeEntityLump( char* pszBuffer )
 }
 
 /**
-*	Parse through entity lump looking for requested info.
+*	A lump to load, and the buffer to load it into.
+*/
+struct LumpRequest final
+{
+	int iLump;
+	std::vector<uint8_t>* pData;
+};
+
+/**
+*	Open the .bsp and read in the given lumps.
+*	@param pszFileName Name of the BSP file.
+*	@param lumps Lumps to load. Each buffer is resized to fit its lump.
+*	@return Whether all lumps could be loaded.
 */
-void ProcessEnts( const char* pszBuffer, ParseEntCallback pCallback );
+bool LoadLumps( const char* const pszFileName, std::initializer_list<LumpRequest> lumps );
 
 /**
-*	Evaluate Key/Value pairs for the entity
+*	Open the .bsp and read the names of the textures in its texture lump.
+*	@param pszFileName Name of the BSP file.
+*	@param names List of names, in miptex order. Textures that are missing from the lump have an empty name. Cleared first.
+*	@return Whether the lump could be loaded.
 */
-const char* ParseKeyValue( const char* pszBuffer, char* pszKey, const size_t uiKeySize, char* pszValue, const size_t uiValueSize, bool& bError, bool& bEnd );
+bool LoadTextureNames( const char* const pszFileName, std::vector<std::string>& names );
 }
 
 #endif //COMMON_BSPIO_H
\ No newline at end of file
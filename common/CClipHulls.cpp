@@ -0,0 +1,366 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#include "mathlib.h"
+#include "const.h"
+
+#include "CClipHulls.h"
+
+namespace bsp
+{
+namespace
+{
+/**
+*	Distance to keep between the end of a trace and the plane it hit.
+*/
+const float DIST_EPSILON = 0.03125f;
+
+template<typename T>
+bool ReadLump( const std::vector<uint8_t>& data, std::vector<T>& elements )
+{
+	if( data.size() % sizeof( T ) != 0 )
+		return false;
+
+	elements.resize( data.size() / sizeof( T ) );
+
+	if( !elements.empty() )
+		memcpy( elements.data(), data.data(), data.size() );
+
+	return true;
+}
+}
+
+bool CClipHulls::Load( const std::vector<uint8_t>& planes, const std::vector<uint8_t>& nodes, const std::vector<uint8_t>& clipNodes,
+					   const std::vector<uint8_t>& leafs, const std::vector<uint8_t>& models )
+{
+	Clear();
+
+	std::vector<dplane_t> inPlanes;
+	std::vector<dnode_t> inNodes;
+	std::vector<dclipnode_t> inClipNodes;
+	std::vector<dleaf_t> inLeafs;
+	std::vector<dmodel_t> inModels;
+
+	if( !ReadLump( planes, inPlanes ) ||
+		!ReadLump( nodes, inNodes ) ||
+		!ReadLump( clipNodes, inClipNodes ) ||
+		!ReadLump( leafs, inLeafs ) ||
+		!ReadLump( models, inModels ) )
+		return false;
+
+	if( inPlanes.empty() || inNodes.empty() || inLeafs.empty() || inModels.empty() )
+		return false;
+
+	const int iNumPlanes = static_cast<int>( inPlanes.size() );
+
+	m_Planes.reserve( inPlanes.size() );
+
+	for( const auto& plane : inPlanes )
+	{
+		m_Planes.push_back( { Vector( plane.normal[ 0 ], plane.normal[ 1 ], plane.normal[ 2 ] ), plane.dist, plane.type } );
+	}
+
+	//Hull 0 stores leafs in its children, so replace those with the leaf's contents.
+	m_PointNodes.reserve( inNodes.size() );
+
+	for( const auto& node : inNodes )
+	{
+		if( node.planenum < 0 || node.planenum >= iNumPlanes )
+		{
+			Clear();
+			return false;
+		}
+
+		ClipNode clipNode{ node.planenum, { 0, 0 } };
+
+		for( int iChild = 0; iChild < 2; ++iChild )
+		{
+			const int iIndex = node.children[ iChild ];
+
+			if( iIndex >= 0 )
+			{
+				if( static_cast<size_t>( iIndex ) >= inNodes.size() )
+				{
+					Clear();
+					return false;
+				}
+
+				clipNode.children[ iChild ] = iIndex;
+			}
+			else
+			{
+				const int iLeaf = -( iIndex + 1 );
+
+				if( static_cast<size_t>( iLeaf ) >= inLeafs.size() )
+				{
+					Clear();
+					return false;
+				}
+
+				clipNode.children[ iChild ] = inLeafs[ iLeaf ].contents;
+			}
+		}
+
+		m_PointNodes.push_back( clipNode );
+	}
+
+	m_ClipNodes.reserve( inClipNodes.size() );
+
+	for( const auto& node : inClipNodes )
+	{
+		if( node.planenum < 0 || node.planenum >= iNumPlanes ||
+			node.children[ 0 ] >= static_cast<int>( inClipNodes.size() ) ||
+			node.children[ 1 ] >= static_cast<int>( inClipNodes.size() ) )
+		{
+			Clear();
+			return false;
+		}
+
+		m_ClipNodes.push_back( { node.planenum, { node.children[ 0 ], node.children[ 1 ] } } );
+	}
+
+	const auto& world = inModels[ 0 ];
+
+	for( int iHull = 0; iHull < MAX_MAP_HULLS; ++iHull )
+	{
+		const auto& hullNodes = GetNodes( iHull );
+
+		//A hull without nodes is empty.
+		if( world.headnode[ iHull ] < 0 || static_cast<size_t>( world.headnode[ iHull ] ) >= hullNodes.size() )
+			m_iHeadNodes[ iHull ] = CONTENTS_EMPTY;
+		else
+			m_iHeadNodes[ iHull ] = world.headnode[ iHull ];
+	}
+
+	return true;
+}
+
+bool CClipHulls::LoadFromFile( const char* const pszFileName, unsigned int* puiFileSize )
+{
+	Clear();
+
+	FILE* pFile = fopen( pszFileName, "rb" );
+
+	if( !pFile )
+	{
+		printf( "Couldn't open BSP file \"%s\"\n", pszFileName );
+		return false;
+	}
+
+	fseek( pFile, 0, SEEK_END );
+	const unsigned int uiFileSize = static_cast<unsigned int>( ftell( pFile ) );
+	fseek( pFile, 0, SEEK_SET );
+
+	if( puiFileSize )
+		*puiFileSize = uiFileSize;
+
+	dheader_t header;
+
+	if( fread( &header, sizeof( header ), 1, pFile ) != 1 )
+	{
+		printf( "Could not read BSP header for map [%s].\n", pszFileName );
+		fclose( pFile );
+		return false;
+	}
+
+	if( header.version != BSPVERSION_QUAKE && header.version != BSPVERSION )
+	{
+		printf( "Map [%s] has incorrect BSP version (%i should be %i).\n", pszFileName, header.version, BSPVERSION );
+		fclose( pFile );
+		return false;
+	}
+
+	const int lumps[] = { LUMP_PLANES, LUMP_NODES, LUMP_CLIPNODES, LUMP_LEAFS, LUMP_MODELS };
+
+	std::vector<uint8_t> data[ sizeof( lumps ) / sizeof( lumps[ 0 ] ) ];
+
+	for( size_t uiLump = 0; uiLump < sizeof( lumps ) / sizeof( lumps[ 0 ] ); ++uiLump )
+	{
+		const lump_t& lump = header.lumps[ lumps[ uiLump ] ];
+
+		if( lump.fileofs < 0 || lump.filelen < 0 || static_cast<unsigned int>( lump.fileofs ) + static_cast<unsigned int>( lump.filelen ) > uiFileSize )
+		{
+			printf( "Map [%s] has an invalid lump %d.\n", pszFileName, lumps[ uiLump ] );
+			fclose( pFile );
+			return false;
+		}
+
+		data[ uiLump ].resize( lump.filelen );
+
+		if( lump.filelen == 0 )
+			continue;
+
+		fseek( pFile, lump.fileofs, SEEK_SET );
+
+		if( fread( data[ uiLump ].data(), lump.filelen, 1, pFile ) != 1 )
+		{
+			printf( "Could not read lump %d for map [%s].\n", lumps[ uiLump ], pszFileName );
+			fclose( pFile );
+			return false;
+		}
+	}
+
+	fclose( pFile );
+
+	if( !Load( data[ 0 ], data[ 1 ], data[ 2 ], data[ 3 ], data[ 4 ] ) )
+	{
+		printf( "Map [%s] has invalid clip hulls.\n", pszFileName );
+		return false;
+	}
+
+	return true;
+}
+
+void CClipHulls::Clear()
+{
+	m_Planes.clear();
+	m_PointNodes.clear();
+	m_ClipNodes.clear();
+
+	for( auto& iHeadNode : m_iHeadNodes )
+	{
+		iHeadNode = CONTENTS_EMPTY;
+	}
+}
+
+int CClipHulls::PointContents( const Vector& vecPoint, const int iHull ) const
+{
+	assert( iHull >= 0 && iHull < MAX_MAP_HULLS );
+
+	return HullPointContents( GetNodes( iHull ), m_iHeadNodes[ iHull ], vecPoint );
+}
+
+void CClipHulls::Trace( const Vector& vecStart, const Vector& vecEnd, HullTrace& tr, const int iHull ) const
+{
+	assert( iHull >= 0 && iHull < MAX_MAP_HULLS );
+
+	tr.bAllSolid = true;
+	tr.bStartSolid = false;
+	tr.flFraction = 1;
+	tr.vecEndPos = vecEnd;
+	tr.vecPlaneNormal = Vector( 0, 0, 0 );
+	tr.flPlaneDist = 0;
+
+	const int iHeadNode = m_iHeadNodes[ iHull ];
+
+	RecursiveHullCheck( GetNodes( iHull ), iHeadNode, iHeadNode, 0, 1, vecStart, vecEnd, tr );
+
+	if( tr.bAllSolid )
+	{
+		tr.bStartSolid = true;
+		tr.flFraction = 0;
+		tr.vecEndPos = vecStart;
+	}
+}
+
+int CClipHulls::HullPointContents( const std::vector<ClipNode>& nodes, int iNode, const Vector& vecPoint ) const
+{
+	while( iNode >= 0 )
+	{
+		const auto& node = nodes[ iNode ];
+		const auto& plane = m_Planes[ node.iPlane ];
+
+		const float flDist = ( plane.iType < 3 ? vecPoint[ plane.iType ] : DotProduct( plane.vecNormal, vecPoint ) ) - plane.flDist;
+
+		iNode = node.children[ flDist < 0 ? 1 : 0 ];
+	}
+
+	return iNode;
+}
+
+bool CClipHulls::RecursiveHullCheck( const std::vector<ClipNode>& nodes, const int iHeadNode, const int iNode,
+									 const float flStartFrac, const float flEndFrac, const Vector& vecStart, const Vector& vecEnd, HullTrace& tr ) const
+{
+	//Reached a leaf.
+	if( iNode < 0 )
+	{
+		if( iNode != CONTENTS_SOLID )
+			tr.bAllSolid = false;
+		else
+			tr.bStartSolid = true;
+
+		return true;
+	}
+
+	const auto& node = nodes[ iNode ];
+	const auto& plane = m_Planes[ node.iPlane ];
+
+	float t1, t2;
+
+	if( plane.iType < 3 )
+	{
+		t1 = vecStart[ plane.iType ] - plane.flDist;
+		t2 = vecEnd[ plane.iType ] - plane.flDist;
+	}
+	else
+	{
+		t1 = DotProduct( plane.vecNormal, vecStart ) - plane.flDist;
+		t2 = DotProduct( plane.vecNormal, vecEnd ) - plane.flDist;
+	}
+
+	if( t1 >= 0 && t2 >= 0 )
+		return RecursiveHullCheck( nodes, iHeadNode, node.children[ 0 ], flStartFrac, flEndFrac, vecStart, vecEnd, tr );
+
+	if( t1 < 0 && t2 < 0 )
+		return RecursiveHullCheck( nodes, iHeadNode, node.children[ 1 ], flStartFrac, flEndFrac, vecStart, vecEnd, tr );
+
+	//Put the crosspoint DIST_EPSILON units on the near side.
+	float flFrac = t1 < 0 ? ( t1 + DIST_EPSILON ) / ( t1 - t2 ) : ( t1 - DIST_EPSILON ) / ( t1 - t2 );
+
+	if( flFrac < 0 )
+		flFrac = 0;
+	else if( flFrac > 1 )
+		flFrac = 1;
+
+	float flMidFrac = flStartFrac + ( flEndFrac - flStartFrac ) * flFrac;
+	Vector vecMid = vecStart + ( vecEnd - vecStart ) * flFrac;
+
+	const int iSide = t1 < 0 ? 1 : 0;
+
+	//Move up to the node.
+	if( !RecursiveHullCheck( nodes, iHeadNode, node.children[ iSide ], flStartFrac, flMidFrac, vecStart, vecMid, tr ) )
+		return false;
+
+	//Go past the node.
+	if( HullPointContents( nodes, node.children[ iSide ^ 1 ], vecMid ) != CONTENTS_SOLID )
+		return RecursiveHullCheck( nodes, iHeadNode, node.children[ iSide ^ 1 ], flMidFrac, flEndFrac, vecMid, vecEnd, tr );
+
+	//Never got out of the solid area.
+	if( tr.bAllSolid )
+		return false;
+
+	//The other side of the node is solid, this is the impact point.
+	if( iSide == 0 )
+	{
+		tr.vecPlaneNormal = plane.vecNormal;
+		tr.flPlaneDist = plane.flDist;
+	}
+	else
+	{
+		tr.vecPlaneNormal = -plane.vecNormal;
+		tr.flPlaneDist = -plane.flDist;
+	}
+
+	//Back off until the end point is out of solid. Rarely needed.
+	while( HullPointContents( nodes, iHeadNode, vecMid ) == CONTENTS_SOLID )
+	{
+		flFrac -= 0.1f;
+
+		if( flFrac < 0 )
+		{
+			tr.flFraction = flMidFrac;
+			tr.vecEndPos = vecMid;
+			return false;
+		}
+
+		flMidFrac = flStartFrac + ( flEndFrac - flStartFrac ) * flFrac;
+		vecMid = vecStart + ( vecEnd - vecStart ) * flFrac;
+	}
+
+	tr.flFraction = flMidFrac;
+	tr.vecEndPos = vecMid;
+
+	return false;
+}
+}
@@ -0,0 +1,139 @@
+#ifndef COMMON_CCLIPHULLS_H
+#define COMMON_CCLIPHULLS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "mathlib.h"
+
+#include "MiniBSPFile.h"
+
+namespace bsp
+{
+/**
+*	Result of a trace through a clip hull.
+*/
+struct HullTrace final
+{
+	/**
+	*	The entire trace was in solid.
+	*/
+	bool bAllSolid;
+
+	/**
+	*	The trace started in solid.
+	*/
+	bool bStartSolid;
+
+	/**
+	*	Fraction of the trace that was completed. 1 if nothing was hit.
+	*/
+	float flFraction;
+
+	Vector vecEndPos;
+
+	/**
+	*	Plane that was hit, if any.
+	*/
+	Vector vecPlaneNormal;
+	float flPlaneDist;
+};
+
+/**
+*	The world model's clip hulls, loaded from a BSP file's lumps.
+*	Traces the world like the engine does, without needing the engine, so tools can run the same line of sight checks as the game.
+*	Brush entities are not part of the world model and are ignored.
+*/
+class CClipHulls final
+{
+public:
+	/**
+	*	Hull used by line traces.
+	*/
+	static const int POINT_HULL = 0;
+
+private:
+	struct ClipNode final
+	{
+		int iPlane;
+
+		/**
+		*	Negative numbers are contents.
+		*/
+		int children[ 2 ];
+	};
+
+	struct Plane final
+	{
+		Vector vecNormal;
+		float flDist;
+		int iType;
+	};
+
+public:
+	CClipHulls() = default;
+	~CClipHulls() = default;
+
+	/**
+	*	Builds the hulls from the contents of the BSP lumps with the same names.
+	*	Hull 0 is built from the nodes and leafs, the other hulls use the clip nodes.
+	*	@return Whether the lumps contain a valid world model.
+	*/
+	bool Load( const std::vector<uint8_t>& planes, const std::vector<uint8_t>& nodes, const std::vector<uint8_t>& clipNodes,
+			   const std::vector<uint8_t>& leafs, const std::vector<uint8_t>& models );
+
+	/**
+	*	Loads the hulls from a BSP file. The file is read with the C standard library, so tools can load maps without the engine's filesystem.
+	*	Errors are printed to the standard output.
+	*	@param puiFileSize If not null, receives the size of the file.
+	*	@return Whether the file could be read and contains a valid world model.
+	*/
+	bool LoadFromFile( const char* const pszFileName, unsigned int* puiFileSize = nullptr );
+
+	void Clear();
+
+	bool IsLoaded() const { return !m_Planes.empty(); }
+
+	/**
+	*	@return Contents at the given point. One of the Contents constants.
+	*/
+	int PointContents( const Vector& vecPoint, const int iHull = POINT_HULL ) const;
+
+	/**
+	*	Traces a line through a hull. For hulls other than the point hull, the points are the center of the box.
+	*/
+	void Trace( const Vector& vecStart, const Vector& vecEnd, HullTrace& tr, const int iHull = POINT_HULL ) const;
+
+private:
+	const std::vector<ClipNode>& GetNodes( const int iHull ) const
+	{
+		return iHull == POINT_HULL ? m_PointNodes : m_ClipNodes;
+	}
+
+	int HullPointContents( const std::vector<ClipNode>& nodes, int iNode, const Vector& vecPoint ) const;
+
+	/**
+	*	@return Whether the trace should continue past this node.
+	*/
+	bool RecursiveHullCheck( const std::vector<ClipNode>& nodes, const int iHeadNode, const int iNode,
+							 const float flStartFrac, const float flEndFrac, const Vector& vecStart, const Vector& vecEnd, HullTrace& tr ) const;
+
+private:
+	std::vector<Plane> m_Planes;
+
+	/**
+	*	Hull 0, made from the BSP nodes.
+	*/
+	std::vector<ClipNode> m_PointNodes;
+
+	std::vector<ClipNode> m_ClipNodes;
+
+	int m_iHeadNodes[ MAX_MAP_HULLS ] = {};
+
+private:
+	CClipHulls( const CClipHulls& ) = delete;
+	CClipHulls& operator=( const CClipHulls& ) = delete;
+};
+}
+
+#endif //COMMON_CCLIPHULLS_H
@@ -0,0 +1,238 @@
+#include "CEntityLumpIndex.h"
+
+namespace bsp
+{
+namespace
+{
+bool IsSingleCharToken( const char c )
+{
+	return c == '{' || c == '}' || c == ')' || c == '(' || c == '\'' || c == ',';
+}
+
+bool IsToken( const std::vector<char>& buffer, const size_t uiOffset, const char c )
+{
+	return buffer[ uiOffset ] == c && buffer[ uiOffset + 1 ] == '\0';
+}
+}
+
+const char* CEntityLumpIndex::CEntity::GetValue( const char* const pszKey ) const
+{
+	for( const auto& keyValue : *this )
+	{
+		if( strcmp( keyValue.pszKey, pszKey ) == 0 )
+			return keyValue.pszValue;
+	}
+
+	return nullptr;
+}
+
+bool CEntityLumpIndex::Parse( const char* const pszData, const size_t uiLength )
+{
+	Clear();
+
+	if( !pszData )
+		return false;
+
+	const char* pszNext = pszData;
+	const char* const pszEnd = pszData + uiLength;
+
+	//Keys and values are usually smaller than they are in the lump since quotes are removed.
+	m_Buffer.reserve( uiLength + 1 );
+
+	std::vector<std::pair<size_t, size_t>> keyValueOffsets;
+	std::vector<std::pair<size_t, size_t>> entityRanges;
+
+	bool bSuccess = true;
+
+	while( true )
+	{
+		const size_t uiOpen = ReadToken( pszNext, pszEnd );
+
+		if( uiOpen == INVALID_OFFSET )
+			break;
+
+		//Didn't find opening brace?
+		if( !IsToken( m_Buffer, uiOpen, '{' ) )
+		{
+			bSuccess = false;
+			break;
+		}
+
+		m_Buffer.resize( uiOpen );
+
+		const size_t uiFirstKeyValue = keyValueOffsets.size();
+
+		bool bEntityComplete = false;
+
+		while( true )
+		{
+			const size_t uiKey = ReadToken( pszNext, pszEnd );
+
+			//Ran out of input.
+			if( uiKey == INVALID_OFFSET )
+				break;
+
+			if( IsToken( m_Buffer, uiKey, '}' ) )
+			{
+				m_Buffer.resize( uiKey );
+				bEntityComplete = true;
+				break;
+			}
+
+			//Fix keynames with trailing spaces.
+			while( m_Buffer.size() - uiKey > 1 && m_Buffer[ m_Buffer.size() - 2 ] == ' ' )
+			{
+				m_Buffer.pop_back();
+				m_Buffer.back() = '\0';
+			}
+
+			const size_t uiValue = ReadToken( pszNext, pszEnd );
+
+			//Ran out of input or hit the end instead of a value.
+			if( uiValue == INVALID_OFFSET || IsToken( m_Buffer, uiValue, '}' ) )
+				break;
+
+			keyValueOffsets.emplace_back( uiKey, uiValue );
+		}
+
+		if( !bEntityComplete )
+		{
+			keyValueOffsets.resize( uiFirstKeyValue );
+			bSuccess = false;
+			break;
+		}
+
+		entityRanges.emplace_back( uiFirstKeyValue, keyValueOffsets.size() - uiFirstKeyValue );
+	}
+
+	Finalize( keyValueOffsets, entityRanges );
+
+	return bSuccess;
+}
+
+void CEntityLumpIndex::Clear()
+{
+	m_ClassnameIndex.clear();
+	m_TargetnameIndex.clear();
+	m_Entities.clear();
+	m_KeyValues.clear();
+	m_Buffer.clear();
+}
+
+const CEntityLumpIndex::IndexList_t& CEntityLumpIndex::Find( const NameIndex_t& index, const char* const pszName )
+{
+	static const IndexList_t EMPTY_LIST;
+
+	if( !pszName )
+		return EMPTY_LIST;
+
+	auto it = index.find( pszName );
+
+	return it != index.end() ? it->second : EMPTY_LIST;
+}
+
+size_t CEntityLumpIndex::ReadToken( const char*& pszData, const char* const pszEnd )
+{
+	//Same rules as COM_Parse.
+	while( true )
+	{
+		//Skip whitespace.
+		while( pszData < pszEnd && *pszData && static_cast<unsigned char>( *pszData ) <= ' ' )
+			++pszData;
+
+		if( pszData >= pszEnd || !( *pszData ) )
+			return INVALID_OFFSET;
+
+		//Skip // comments.
+		if( pszData[ 0 ] == '/' && pszData + 1 < pszEnd && pszData[ 1 ] == '/' )
+		{
+			while( pszData < pszEnd && *pszData && *pszData != '\n' )
+				++pszData;
+
+			continue;
+		}
+
+		break;
+	}
+
+	const size_t uiOffset = m_Buffer.size();
+
+	char c = *pszData;
+
+	//Handle quoted strings specially.
+	if( c == '\"' )
+	{
+		++pszData;
+
+		while( pszData < pszEnd && *pszData && *pszData != '\"' )
+		{
+			m_Buffer.push_back( *pszData++ );
+		}
+
+		//Skip the closing quote.
+		if( pszData < pszEnd && *pszData )
+			++pszData;
+	}
+	else if( IsSingleCharToken( c ) )
+	{
+		m_Buffer.push_back( c );
+		++pszData;
+	}
+	else
+	{
+		//Parse a regular word.
+		do
+		{
+			m_Buffer.push_back( c );
+			++pszData;
+
+			if( pszData >= pszEnd )
+				break;
+
+			c = *pszData;
+		}
+		while( !IsSingleCharToken( c ) && static_cast<unsigned char>( c ) > ' ' );
+	}
+
+	m_Buffer.push_back( '\0' );
+
+	return uiOffset;
+}
+
+void CEntityLumpIndex::Finalize( const std::vector<std::pair<size_t, size_t>>& keyValueOffsets, const std::vector<std::pair<size_t, size_t>>& entityRanges )
+{
+	m_Buffer.shrink_to_fit();
+
+	const char* const pszBuffer = m_Buffer.data();
+
+	m_KeyValues.reserve( keyValueOffsets.size() );
+
+	for( const auto& offsets : keyValueOffsets )
+	{
+		m_KeyValues.push_back( { pszBuffer + offsets.first, pszBuffer + offsets.second } );
+	}
+
+	m_Entities.resize( entityRanges.size() );
+
+	for( size_t uiIndex = 0; uiIndex < entityRanges.size(); ++uiIndex )
+	{
+		auto& entity = m_Entities[ uiIndex ];
+
+		entity.m_uiIndex = uiIndex;
+		entity.m_pKeyValues = m_KeyValues.data() + entityRanges[ uiIndex ].first;
+		entity.m_uiCount = entityRanges[ uiIndex ].second;
+
+		if( auto pszClassname = entity.GetValue( "classname" ) )
+		{
+			entity.m_pszClassname = pszClassname;
+			m_ClassnameIndex[ pszClassname ].push_back( uiIndex );
+		}
+
+		if( auto pszTargetname = entity.GetValue( "targetname" ) )
+		{
+			entity.m_pszTargetname = pszTargetname;
+			m_TargetnameIndex[ pszTargetname ].push_back( uiIndex );
+		}
+	}
+}
+}
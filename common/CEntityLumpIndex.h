@@ -0,0 +1,184 @@
+#ifndef COMMON_CENTITYLUMPINDEX_H
+#define COMMON_CENTITYLUMPINDEX_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "StringUtils.h"
+
+namespace bsp
+{
+/**
+*	A key and its value. Both point into the index's buffer.
+*/
+struct EntityKeyValue final
+{
+	const char* pszKey;
+	const char* pszValue;
+};
+
+/**
+*	Parsed form of a BSP entity lump. The lump is tokenized once; all keys and values are stored in a single buffer owned by the index.
+*	Entities can be looked up by classname and targetname.
+*	Doesn't depend on the engine, so tools can use it on entity data they've loaded themselves.
+*/
+class CEntityLumpIndex final
+{
+public:
+	/**
+	*	View of a single entity's keyvalues.
+	*/
+	class CEntity final
+	{
+	public:
+		friend class CEntityLumpIndex;
+
+		CEntity() = default;
+
+		/**
+		*	@return Index of this entity in the lump. The first entity is the world.
+		*/
+		size_t GetIndex() const { return m_uiIndex; }
+
+		size_t GetKeyValueCount() const { return m_uiCount; }
+
+		const EntityKeyValue* begin() const { return m_pKeyValues; }
+		const EntityKeyValue* end() const { return m_pKeyValues + m_uiCount; }
+
+		/**
+		*	@return The value of the first key with the given name, or null if the entity doesn't have it.
+		*/
+		const char* GetValue( const char* const pszKey ) const;
+
+		/**
+		*	@return The classname, or an empty string if it has none.
+		*/
+		const char* GetClassname() const { return m_pszClassname; }
+
+		/**
+		*	@return The targetname, or an empty string if it has none.
+		*/
+		const char* GetTargetname() const { return m_pszTargetname; }
+
+	private:
+		size_t m_uiIndex = 0;
+
+		const EntityKeyValue* m_pKeyValues = nullptr;
+		size_t m_uiCount = 0;
+
+		const char* m_pszClassname = "";
+		const char* m_pszTargetname = "";
+	};
+
+	/**
+	*	List of entity indices, in lump order.
+	*/
+	using IndexList_t = std::vector<size_t>;
+
+public:
+	CEntityLumpIndex() = default;
+	~CEntityLumpIndex() = default;
+
+	bool IsEmpty() const { return m_Entities.empty(); }
+
+	size_t GetEntityCount() const { return m_Entities.size(); }
+
+	const CEntity& GetEntity( const size_t uiIndex ) const { return m_Entities[ uiIndex ]; }
+
+	const CEntity* begin() const { return m_Entities.data(); }
+	const CEntity* end() const { return m_Entities.data() + m_Entities.size(); }
+
+	/**
+	*	Parses the given entity data. Clears any previously parsed data.
+	*	@param pszData Entity data.
+	*	@param uiLength Length of the data. The data ends at the first null character if it occurs before this.
+	*	@return Whether the entire lump could be parsed. On failure, entities parsed up to the error are kept.
+	*/
+	bool Parse( const char* const pszData, const size_t uiLength );
+
+	/**
+	*	@copydoc Parse( const char* const pszData, const size_t uiLength )
+	*	Overload for null terminated data.
+	*/
+	bool Parse( const char* const pszData )
+	{
+		return Parse( pszData, pszData ? strlen( pszData ) : 0 );
+	}
+
+	void Clear();
+
+	/**
+	*	@return Indices of all entities with the given classname. Empty if there are none.
+	*/
+	const IndexList_t& FindEntitiesByClassname( const char* const pszClassname ) const
+	{
+		return Find( m_ClassnameIndex, pszClassname );
+	}
+
+	/**
+	*	@return Indices of all entities with the given targetname. Empty if there are none.
+	*/
+	const IndexList_t& FindEntitiesByTargetname( const char* const pszTargetname ) const
+	{
+		return Find( m_TargetnameIndex, pszTargetname );
+	}
+
+	/**
+	*	@return The first entity with the given classname, or null.
+	*/
+	const CEntity* FindEntityByClassname( const char* const pszClassname ) const
+	{
+		const auto& list = FindEntitiesByClassname( pszClassname );
+
+		return !list.empty() ? &m_Entities[ list.front() ] : nullptr;
+	}
+
+	/**
+	*	@return The first entity with the given targetname, or null.
+	*/
+	const CEntity* FindEntityByTargetname( const char* const pszTargetname ) const
+	{
+		const auto& list = FindEntitiesByTargetname( pszTargetname );
+
+		return !list.empty() ? &m_Entities[ list.front() ] : nullptr;
+	}
+
+private:
+	using NameIndex_t = std::unordered_map<const char*, IndexList_t, RawCharHash, RawCharEqualTo>;
+
+	static const IndexList_t& Find( const NameIndex_t& index, const char* const pszName );
+
+	/**
+	*	Reads the next token, copies it into the buffer.
+	*	@return Offset of the token in the buffer, or INVALID_OFFSET if the end of the data was reached.
+	*/
+	size_t ReadToken( const char*& pszData, const char* const pszEnd );
+
+	/**
+	*	Converts buffer offsets to pointers once the buffer won't be resized anymore and builds the name indices.
+	*	@param keyValueOffsets Buffer offsets of each key and value.
+	*	@param entityRanges First keyvalue and keyvalue count of each entity.
+	*/
+	void Finalize( const std::vector<std::pair<size_t, size_t>>& keyValueOffsets, const std::vector<std::pair<size_t, size_t>>& entityRanges );
+
+private:
+	static const size_t INVALID_OFFSET = static_cast<size_t>( -1 );
+
+	std::vector<char> m_Buffer;
+
+	std::vector<EntityKeyValue> m_KeyValues;
+
+	std::vector<CEntity> m_Entities;
+
+	NameIndex_t m_ClassnameIndex;
+	NameIndex_t m_TargetnameIndex;
+
+private:
+	CEntityLumpIndex( const CEntityLumpIndex& ) = delete;
+	CEntityLumpIndex& operator=( const CEntityLumpIndex& ) = delete;
+};
+}
+
+#endif //COMMON_CENTITYLUMPINDEX_H
@@ -0,0 +1,52 @@
+#ifndef COMMON_CSTOPWATCH_H
+#define COMMON_CSTOPWATCH_H
+
+#include <chrono>
+
+/**
+*	Measures elapsed real time using a monotonic clock.
+*	Used to profile code; game time should be used for gameplay logic.
+*/
+class CStopwatch final
+{
+public:
+	using Clock_t = std::chrono::steady_clock;
+
+public:
+	/**
+	*	Constructor. Starts timing immediately.
+	*/
+	CStopwatch()
+		: m_Start( Clock_t::now() )
+	{
+	}
+
+	/**
+	*	Restarts timing.
+	*/
+	void Reset()
+	{
+		m_Start = Clock_t::now();
+	}
+
+	/**
+	*	@return Time elapsed since construction or the last reset, in microseconds.
+	*/
+	long long GetElapsedMicroseconds() const
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>( Clock_t::now() - m_Start ).count();
+	}
+
+	/**
+	*	@return Time elapsed since construction or the last reset, in seconds.
+	*/
+	double GetElapsedSeconds() const
+	{
+		return std::chrono::duration<double>( Clock_t::now() - m_Start ).count();
+	}
+
+private:
+	Clock_t::time_point m_Start;
+};
+
+#endif //COMMON_CSTOPWATCH_H
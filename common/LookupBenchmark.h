@@ -0,0 +1,69 @@
+#ifndef COMMON_LOOKUPBENCHMARK_H
+#define COMMON_LOOKUPBENCHMARK_H
+
+#include <cstddef>
+#include <vector>
+
+#include "CStopwatch.h"
+
+/**
+*	Result of timing a lookup against the implementation it replaces.
+*/
+struct LookupBenchmarkResult final
+{
+	long long iReferenceMicroseconds = 0;
+	long long iMicroseconds = 0;
+
+	/**
+	*	Indices of the keys for which both implementations didn't return the same result.
+	*/
+	std::vector<size_t> mismatches;
+};
+
+/**
+*	Looks up each key a number of times using both a reference implementation and the implementation being measured,
+*	and checks that they return the same results.
+*	@param uiCount Number of keys. Both functions are called with key indices, and must return a scalar.
+*	@param iIterations Number of times to look up each key.
+*/
+template<typename REFERENCE, typename LOOKUP>
+LookupBenchmarkResult BenchmarkLookup( const size_t uiCount, const int iIterations, const REFERENCE& reference, const LOOKUP& lookup )
+{
+	using Result_t = decltype( reference( size_t() ) );
+
+	LookupBenchmarkResult result;
+
+	CStopwatch stopwatch;
+
+	for( size_t uiKey = 0; uiKey < uiCount; ++uiKey )
+	{
+		//Volatile so the repeated lookups aren't optimized out.
+		volatile Result_t expected{};
+		volatile Result_t actual{};
+
+		stopwatch.Reset();
+
+		for( int iIteration = 0; iIteration < iIterations; ++iIteration )
+		{
+			expected = reference( uiKey );
+		}
+
+		result.iReferenceMicroseconds += stopwatch.GetElapsedMicroseconds();
+
+		stopwatch.Reset();
+
+		for( int iIteration = 0; iIteration < iIterations; ++iIteration )
+		{
+			actual = lookup( uiKey );
+		}
+
+		result.iMicroseconds += stopwatch.GetElapsedMicroseconds();
+
+		if( expected != actual )
+			result.mismatches.push_back( uiKey );
+	}
+
+	return result;
+}
+
+#endif //COMMON_LOOKUPBENCHMARK_H
@@ -42,5 +42,70 @@ struct dheader_t
 	lump_t		lumps[HEADER_LUMPS];
 };
 
+#define MAX_MAP_HULLS	4
+
+struct dmodel_t
+{
+	float		mins[3], maxs[3];
+	float		origin[3];
+	int			headnode[MAX_MAP_HULLS];
+	int			visleafs;		// not including the solid leaf 0
+	int			firstface, numfaces;
+};
+
+struct dplane_t
+{
+	float	normal[3];
+	float	dist;
+	int		type;		// PLANE_X - PLANE_ANYZ ?remove? trivial to regenerate
+};
+
+struct dnode_t
+{
+	int			planenum;
+	short		children[2];	// negative numbers are -(leafs+1), not nodes
+	short		mins[3];		// for sphere culling
+	short		maxs[3];
+	unsigned short	firstface;
+	unsigned short	numfaces;	// counting both sides
+};
+
+struct dclipnode_t
+{
+	int			planenum;
+	short		children[2];	// negative numbers are contents
+};
+
+#define	NUM_AMBIENTS	4		// automatic ambient sounds
+
+struct dleaf_t
+{
+	int			contents;
+	int			visofs;				// -1 = no visibility info
+
+	short		mins[3];			// for frustum culling
+	short		maxs[3];
+
+	unsigned short		firstmarksurface;
+	unsigned short		nummarksurfaces;
+
+	unsigned char		ambient_level[NUM_AMBIENTS];
+};
+
+#define MIPLEVELS	4
+
+struct dmiptexlump_t
+{
+	int			nummiptex;
+	int			dataofs[4];		// [nummiptex]
+};
+
+struct miptex_t
+{
+	char		name[16];
+	unsigned	width, height;
+	unsigned	offsets[MIPLEVELS];		// four mip maps stored
+};
+
 
 #endif //COMMON_MINIBSPFILE_H
\ No newline at end of file
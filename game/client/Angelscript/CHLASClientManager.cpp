@@ -7,6 +7,8 @@
 
 #include "Angelscript/HLASConstants.h"
 
+#include "Angelscript/ScriptAPI/CASTimerScheduler.h"
+
 #include "Angelscript/CHLASClientInitializer.h"
 
 #include "Angelscript/CASMapModuleBuilder.h"
@@ -93,6 +95,7 @@ void CHLASClientManager::WorldEnded()
 			as::Call( pFunction );
 		}
 
+		CASModule_ClearScheduler( m_pModule );
 		m_Manager.GetModuleManager().RemoveModule( m_pModule );
 		m_pModule = nullptr;
 	}
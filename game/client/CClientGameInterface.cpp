@@ -6,7 +6,9 @@
 #include "cbase.h"
 #include "Weapons.h"
 
+#include "CKeyValueFileCache.h"
 #include "CWeaponInfoCache.h"
+#include "materials/Materials.h"
 
 #include "hl/hl_weapons.h"
 #include "com_weapons.h"
@@ -14,8 +16,6 @@
 
 #include "ammohistory.h"
 
-#include "BSPIO.h"
-
 #if USE_ANGELSCRIPT
 #include "Angelscript/CHLASClientManager.h"
 #endif
@@ -26,51 +26,6 @@
 
 CClientGameInterface g_Client;
 
-/**
-*	Parses in the map's data and gets the map script from it. - Solokiller
-*/
-const char* ParseMapDataCallback( const char* pszBuffer, bool& bError )
-{
-	char szKey[ MAX_COM_TOKEN ];
-	char token[ MAX_COM_TOKEN ];
-
-	char szMapScript[ MAX_PATH ] = {};
-
-	bool bIsWorldspawn = false;
-
-	bool bEnd = false;
-
-	while( true )
-	{
-		pszBuffer = bsp::ParseKeyValue( pszBuffer, szKey, sizeof( szKey ), token, sizeof( token ), bError, bEnd );
-
-		if( bEnd )
-			break;
-
-		if( bError )
-			return pszBuffer;
-
-		if( strcmp( szKey, "mapscript" ) == 0 )
-		{
-			strncpy( szMapScript, token, sizeof( szMapScript ) );
-			szMapScript[ sizeof( szMapScript ) - 1 ] = '\0';
-		}
-		else if( strcmp( szKey, "classname" ) == 0 && strcmp( token, "worldspawn" ) == 0 )
-		{
-			bIsWorldspawn = true;
-		}
-	}
-
-	if( bIsWorldspawn && *szMapScript )
-	{
-#if USE_ANGELSCRIPT
-		g_ASManager.WorldCreated( szMapScript );
-#endif
-	}
-
-	return pszBuffer;
-}
-
 bool CClientGameInterface::Initialize()
 {
 	if( !InitializeCommon() )
@@ -98,11 +53,36 @@ void CClientGameInterface::Shutdown()
 	ShutdownCommon();
 }
 
+const bsp::CEntityLumpIndex& CClientGameInterface::GetEntityIndex()
+{
+	if( !m_bEntityIndexValid )
+	{
+		cl_entity_t* pWorldModel = gEngfuncs.GetEntityByIndex( 0 );
+
+		//Map hasn't been loaded yet.
+		if( !pWorldModel || !pWorldModel->model )
+			return m_EntityIndex;
+
+		m_bEntityIndexValid = true;
+
+		if( !m_EntityIndex.Parse( pWorldModel->model->entities ) )
+			Con_Printf( "CClientGameInterface::GetEntityIndex: error parsing entities\n" );
+	}
+
+	return m_EntityIndex;
+}
+
 bool CClientGameInterface::ConnectionEstablished()
 {
 	m_bNewMapStarted = true;
 	m_bParseMapData = true;
 
+	m_bEntityIndexValid = false;
+	m_EntityIndex.Clear();
+
+	//Cached texture addresses belong to the previous map. Lookups fall back to searching by name until the new map's textures are loaded.
+	g_MaterialsList.ClearMapTextures();
+
 	return true;
 }
 
@@ -141,8 +121,23 @@ void CClientGameInterface::MapInit( cl_entity_t* pWorldModel )
 	g_Prediction.MapInit();
 	PrecacheWeapons();
 
+	g_KeyValueFileCache.Save();
+
+	//The world model's name is the BSP file, which is known to exist now that the map has been downloaded.
+	g_MaterialsList.LoadMapTextures( pWorldModel->model->name );
+
 	//Parse in map data now, since the map has been downloaded. - Solokiller
-	bsp::ProcessEnts( pWorldModel->model->entities, ParseMapDataCallback );
+	if( auto pWorld = GetEntityIndex().FindEntityByClassname( "worldspawn" ) )
+	{
+		const char* const pszMapScript = pWorld->GetValue( "mapscript" );
+
+		if( pszMapScript && *pszMapScript )
+		{
+#if USE_ANGELSCRIPT
+			g_ASManager.WorldCreated( pszMapScript );
+#endif
+		}
+	}
 
 	//TODO: call map script MapInit here - Solokiller
 
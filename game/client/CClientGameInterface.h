@@ -2,6 +2,7 @@
 #define GAME_CLIENT_CCLIENTGAMEINTERFACE_H
 
 #include "CBaseGameInterface.h"
+#include "CEntityLumpIndex.h"
 
 /**
 *	The client's representation of itself.
@@ -17,6 +18,12 @@ public:
 	*/
 	const char* GetMapName() const { return m_szMapName; }
 
+	/**
+	*	@return Index of the current map's entity lump. Parsed once per map, on first use.
+	*	Empty if no map is loaded.
+	*/
+	const bsp::CEntityLumpIndex& GetEntityIndex();
+
 	/**
 	*	Initializes the client.
 	*	@return true on success, false on failure.
@@ -57,9 +64,12 @@ private:
 private:
 	bool m_bNewMapStarted = false;
 	bool m_bParseMapData = false;
+	bool m_bEntityIndexValid = false;
 
 	char m_szMapName[ MAX_PATH ] = {};
 
+	bsp::CEntityLumpIndex m_EntityIndex;
+
 private:
 	CClientGameInterface( const CClientGameInterface& ) = delete;
 	CClientGameInterface& operator=( const CClientGameInterface& ) = delete;
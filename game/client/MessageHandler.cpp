@@ -1,5 +1,14 @@
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "cl_util.h"
 
+#include <UtlDict.h>
+
+#include "CStopwatch.h"
+
 #include "MessageHandler.h"
 
 namespace msghandler
@@ -8,6 +17,102 @@ namespace
 {
 //Enables more precise debugging than the engine's debug code since we've got our own handlers in addition to the engine hooks.
 static cvar_t* msghandler_debug = nullptr;
+
+struct MessageSlot final
+{
+	std::string szName;
+
+	unsigned int uiCount = 0;
+	unsigned long long uiBytes = 0;
+
+	//Time spent in handlers, in seconds.
+	double flHandlerTime = 0;
+};
+
+std::vector<MessageSlot> g_Slots;
+
+//Maps message names to slots.
+CUtlDict<size_t, unsigned short> g_SlotLookup;
+
+int Dispatch( const size_t slot, const char* pszName, int iSize, void* pBuf )
+{
+	auto& info = g_Slots[ slot ];
+
+	CStopwatch stopwatch;
+
+	const int iResult = MessageHandlers().Invoke( slot, pszName, iSize, pBuf );
+
+	++info.uiCount;
+	info.uiBytes += iSize;
+	info.flHandlerTime += stopwatch.GetElapsedSeconds();
+
+	return iResult;
+}
+
+template<size_t SLOT>
+int MsgFunc_Slot( const char* pszName, int iSize, void* pBuf )
+{
+	return Dispatch( SLOT, pszName, iSize, pBuf );
+}
+
+template<size_t... SLOTS>
+pfnUserMsgHook GetSlotDispatcher( const size_t slot, std::index_sequence<SLOTS...> )
+{
+	static const pfnUserMsgHook dispatchers[] = { &MsgFunc_Slot<SLOTS>... };
+
+	return dispatchers[ slot ];
+}
+
+/**
+*	@return Function that dispatches messages received for the given slot.
+*/
+pfnUserMsgHook GetSlotDispatcher( const size_t slot )
+{
+	return GetSlotDispatcher( slot, std::make_index_sequence<MAX_MESSAGE_SLOTS>() );
+}
+
+void PrintStats()
+{
+	if( gEngfuncs.Cmd_Argc() >= 2 && !strcmp( gEngfuncs.Cmd_Argv( 1 ), "reset" ) )
+	{
+		for( auto& slot : g_Slots )
+		{
+			slot.uiCount = 0;
+			slot.uiBytes = 0;
+			slot.flHandlerTime = 0;
+		}
+
+		Con_Printf( "Message handler statistics reset\n" );
+		return;
+	}
+
+	std::vector<const MessageSlot*> slots;
+
+	slots.reserve( g_Slots.size() );
+
+	for( const auto& slot : g_Slots )
+	{
+		if( slot.uiCount > 0 )
+			slots.push_back( &slot );
+	}
+
+	//Most expensive first.
+	std::sort( slots.begin(), slots.end(), []( const auto pLHS, const auto pRHS )
+	{
+		return pLHS->flHandlerTime > pRHS->flHandlerTime;
+	} );
+
+	Con_Printf( "%-20s %10s %12s %12s %10s\n", "message", "count", "bytes", "total ms", "avg us" );
+
+	for( const auto pSlot : slots )
+	{
+		Con_Printf( "%-20s %10u %12llu %12.3f %10.2f\n",
+					pSlot->szName.c_str(), pSlot->uiCount, pSlot->uiBytes,
+					pSlot->flHandlerTime * 1000.0, ( pSlot->flHandlerTime * 1000000.0 ) / pSlot->uiCount );
+	}
+
+	Con_Printf( "%u of %u hooked messages received\n", static_cast<unsigned int>( slots.size() ), static_cast<unsigned int>( g_Slots.size() ) );
+}
 }
 
 void Initialize()
@@ -16,32 +121,89 @@ void Initialize()
 	MessageHandlers().Clear();
 
 	msghandler_debug = CVAR_CREATE( "msghandler_debug", "0", 0 );
+
+	gEngfuncs.pfnAddCommand( "msghandler_stats", &PrintStats );
+}
+
+size_t GetMessageSlot( const char* pszName )
+{
+	const auto slot = FindMessageSlot( pszName );
+
+	if( slot != INVALID_SLOT )
+		return slot;
+
+	if( g_Slots.size() >= MAX_MESSAGE_SLOTS )
+		return INVALID_SLOT;
+
+	g_Slots.emplace_back();
+	g_Slots.back().szName = pszName;
+
+	g_SlotLookup.Insert( pszName, g_Slots.size() - 1 );
+
+	return g_Slots.size() - 1;
+}
+
+size_t FindMessageSlot( const char* pszName )
+{
+	const auto index = g_SlotLookup.Find( pszName );
+
+	if( index == g_SlotLookup.InvalidIndex() )
+		return INVALID_SLOT;
+
+	return g_SlotLookup.Element( index );
 }
 
 int MsgFunc_MessageHandlers( const char* pszName, int iSize, void* pBuf )
 {
-	return MessageHandlers().Invoke( pszName, iSize, pBuf );
+	const auto slot = FindMessageSlot( pszName );
+
+	if( slot == INVALID_SLOT )
+	{
+		if( msghandler_debug->value )
+		{
+			Con_Printf( "msghandler: Couldn't find handler for message \"%s\", size %d\n", pszName, iSize );
+		}
+
+		return false;
+	}
+
+	return Dispatch( slot, pszName, iSize, pBuf );
 }
 }
 
 bool CMessageHandlers::Invoke( const char* pszName, int iSize, void* pBuf )
 {
-	auto index = m_MessageHandlers.Find( pszName );
+	const auto slot = msghandler::FindMessageSlot( pszName );
 
-	if( index != m_MessageHandlers.InvalidIndex() )
+	if( slot == msghandler::INVALID_SLOT )
 	{
-		auto& handler = m_MessageHandlers.Element( index );
-
 		if( msghandler::msghandler_debug->value )
 		{
-			Con_Printf( "msghandler: Dispatching message \"%s\", size %d\n", pszName, iSize );
+			Con_Printf( "msghandler: Couldn't find handler for message \"%s\", size %d\n", pszName, iSize );
 		}
 
-		return ( *handler )( pszName, iSize, pBuf );
+		return false;
 	}
 
-	if( m_pFallbackHandlers )
-		return m_pFallbackHandlers->Invoke( pszName, iSize, pBuf );
+	return Invoke( slot, pszName, iSize, pBuf );
+}
+
+bool CMessageHandlers::Invoke( const size_t slot, const char* pszName, int iSize, void* pBuf )
+{
+	for( auto pHandlers = this; pHandlers; pHandlers = pHandlers->m_pFallbackHandlers )
+	{
+		auto& handler = pHandlers->m_Handlers[ slot ];
+
+		if( handler )
+		{
+			if( msghandler::msghandler_debug->value )
+			{
+				Con_Printf( "msghandler: Dispatching message \"%s\", size %d\n", pszName, iSize );
+			}
+
+			return handler( pszName, iSize, pBuf );
+		}
+	}
 
 	if( msghandler::msghandler_debug->value )
 	{
@@ -73,7 +235,7 @@ void CMessageHandlers::SetFallbackHandlers( CMessageHandlers* pFallbackHandlers
 	m_pFallbackHandlers = pFallbackHandlers;
 }
 
-void CMessageHandlers::HookMessage( const char* pszName )
+void CMessageHandlers::HookMessage( const char* pszName, const size_t slot )
 {
-	gEngfuncs.pfnHookUserMsg( pszName, &msghandler::MsgFunc_MessageHandlers );
+	gEngfuncs.pfnHookUserMsg( pszName, msghandler::GetSlotDispatcher( slot ) );
 }
@@ -6,12 +6,34 @@
 
 #include "tier0/platform.h"
 
-#include <UtlDict.h>
-
 #include "shared_game_utils.h"
 
+namespace msghandler
+{
+/**
+*	Maximum number of messages that can be hooked. The engine uses a byte for message IDs.
+*/
+const size_t MAX_MESSAGE_SLOTS = 256;
+
+const size_t INVALID_SLOT = static_cast<size_t>( -1 );
+
+/**
+*	Gets the slot that the given message is dispatched through, allocating one if needed.
+*	Slots are kept for the lifetime of the library so messages keep their slot through soft restarts.
+*	@return Slot, or INVALID_SLOT if all slots are in use.
+*/
+size_t GetMessageSlot( const char* pszName );
+
+/**
+*	@return Slot of the given message, or INVALID_SLOT if it has no slot.
+*/
+size_t FindMessageSlot( const char* pszName );
+}
+
 /**
 *	Stores network message handlers so the engine can invoke them correctly.
+*	Each message is given a slot when it's first hooked, and the engine calls a dispatcher for that slot,
+*	so handlers are found by index instead of by name.
 */
 class CMessageHandlers final
 {
@@ -20,14 +42,14 @@ private:
 
 public:
 	CMessageHandlers() = default;
-	~CMessageHandlers()
-	{
-		Clear();
-	}
+	~CMessageHandlers() = default;
 
 	void Clear()
 	{
-		m_MessageHandlers.PurgeAndDeleteElements();
+		for( auto& handler : m_Handlers )
+		{
+			handler = nullptr;
+		}
 	}
 
 private:
@@ -70,23 +92,25 @@ public:
 		ASSERT( *pszName );
 		ASSERT( handlerFn );
 
+		const auto slot = msghandler::GetMessageSlot( pszName );
+
+		if( slot == msghandler::INVALID_SLOT )
 		{
-			auto index = m_MessageHandlers.Find( pszName );
-
-			//Already in the map.
-			if( index != m_MessageHandlers.InvalidIndex() )
-			{
-				Con_DPrintf( "Tried to add a message handler for message \"%s\" twice!\n", pszName );
-				return;
-			}
+			Con_Printf( "Couldn't add a message handler for message \"%s\": too many messages\n", pszName );
+			return;
 		}
 
-		auto lambda = CreateLambda( &handler, handlerFn );
+		//Already in the map.
+		if( m_Handlers[ slot ] )
+		{
+			Con_DPrintf( "Tried to add a message handler for message \"%s\" twice!\n", pszName );
+			return;
+		}
 
-		m_MessageHandlers.Insert( pszName, new Handler_t( lambda ) );
+		m_Handlers[ slot ] = CreateLambda( &handler, handlerFn );
 
 		//Make sure it's hooked in the engine as well.
-		HookMessage( pszName );
+		HookMessage( pszName, slot );
 	}
 
 	/**
@@ -95,6 +119,12 @@ public:
 	*/
 	bool Invoke( const char* pszName, int iSize, void* pBuf );
 
+	/**
+	*	@copydoc Invoke( const char*, int, void* )
+	*	@param slot Slot of the message.
+	*/
+	bool Invoke( const size_t slot, const char* pszName, int iSize, void* pBuf );
+
 	CMessageHandlers* GetFallbackHandlers() { return m_pFallbackHandlers; }
 
 	/**
@@ -103,12 +133,11 @@ public:
 	void SetFallbackHandlers( CMessageHandlers* pFallbackHandlers );
 
 private:
-	static void HookMessage( const char* pszName );
+	static void HookMessage( const char* pszName, const size_t slot );
 
 private:
-	//We need to store pointers here because the utility containers don't copy construct; they memcpy.
-	//TODO: fix this bug in the containers? - Solokiller
-	CUtlDict<Handler_t*, unsigned short> m_MessageHandlers;
+	//Indexed by message slot.
+	Handler_t m_Handlers[ msghandler::MAX_MESSAGE_SLOTS ];
 
 	CMessageHandlers* m_pFallbackHandlers = nullptr;
 
@@ -123,6 +152,7 @@ void Initialize();
 
 /**
 *	The function used to invoke all message handlers. Fallback handlers are used for conditional invocation.
+*	Messages hooked through CMessageHandlers use a dispatcher for their slot instead; this finds the slot by name.
 */
 int MsgFunc_MessageHandlers( const char* pszName, int iSize, void* pBuf );
 }
@@ -0,0 +1,425 @@
+#include "hud.h"
+#include "cl_util.h"
+#include "event_api.h"
+#include "triangleapi.h"
+
+#include "pm_defs.h"
+#include "com_model.h"
+
+#include "r_studioint.h"
+
+#include "renderer/view.h"
+
+#include "CEffectParticles.h"
+
+extern engine_studio_api_t IEngineStudio;
+
+extern float in_fov;
+
+CEffectParticles g_EffectParticles;
+
+cvar_t* cl_fx_particles = nullptr;
+cvar_t* cl_fx_budget = nullptr;
+cvar_t* cl_fx_maxdist = nullptr;
+
+namespace
+{
+struct MaterialInfo final
+{
+	const char* pszSprite;
+	int iRenderMode;
+};
+
+const MaterialInfo g_MaterialInfos[] =
+{
+	{ "sprites/white.spr",		kRenderTransTexture },
+	{ "sprites/steam1.spr",		kRenderTransTexture },
+	{ "sprites/white.spr",		kRenderTransAdd }
+};
+
+static_assert( ARRAYSIZE( g_MaterialInfos ) == static_cast<size_t>( EffectMaterial::COUNT ), "Material info must match EffectMaterial" );
+
+//Fraction of speed kept when bouncing off of the world.
+const float PARTICLE_ELASTICITY = 0.3f;
+
+//Particles that bounce slower than this come to rest.
+const float PARTICLE_REST_SPEED = 20.0f;
+}
+
+void CEffectParticles::Initialize()
+{
+	for( size_t uiIndex = 0; uiIndex < ARRAYSIZE( g_MaterialInfos ); ++uiIndex )
+	{
+		m_pMaterials[ uiIndex ] = const_cast<model_t*>( gEngfuncs.GetSpritePointer( gEngfuncs.pfnSPR_Load( g_MaterialInfos[ uiIndex ].pszSprite ) ) );
+	}
+
+	Clear();
+}
+
+void CEffectParticles::Clear()
+{
+	m_iCount = 0;
+	m_iNumColliding = 0;
+}
+
+bool CEffectParticles::IsEnabled() const
+{
+	return cl_fx_particles->value != 0 && IEngineStudio.IsHardware();
+}
+
+bool CEffectParticles::Emit( const EffectMaterial material, const Vector& vecOrigin, const Vector& vecVelocity,
+							 const float flLife, const float flSize, const float flGrowth,
+							 const Vector& vecColor, const float flAlpha, const float flGravity, const int iFlags )
+{
+	if( m_iCount >= MAX_PARTICLES || m_iSpawnBudget <= 0 )
+		return false;
+
+	const float flMaxDist = cl_fx_maxdist->value;
+
+	if( flMaxDist > 0 )
+	{
+		const Vector vecDelta = vecOrigin - v_origin;
+
+		if( DotProduct( vecDelta, vecDelta ) > flMaxDist * flMaxDist )
+			return false;
+	}
+
+	--m_iSpawnBudget;
+
+	const int i = m_iCount++;
+
+	m_flOriginX[ i ] = vecOrigin.x;
+	m_flOriginY[ i ] = vecOrigin.y;
+	m_flOriginZ[ i ] = vecOrigin.z;
+
+	m_flVelocityX[ i ] = vecVelocity.x;
+	m_flVelocityY[ i ] = vecVelocity.y;
+	m_flVelocityZ[ i ] = vecVelocity.z;
+
+	m_flGravity[ i ] = flGravity;
+
+	m_flSize[ i ] = flSize;
+	m_flGrowth[ i ] = flGrowth;
+
+	m_flLife[ i ] = flLife;
+	m_flLifetime[ i ] = flLife;
+
+	m_flColorR[ i ] = vecColor.x;
+	m_flColorG[ i ] = vecColor.y;
+	m_flColorB[ i ] = vecColor.z;
+	m_flAlpha[ i ] = flAlpha;
+
+	m_Material[ i ] = static_cast<uint8_t>( material );
+	m_Flags[ i ] = static_cast<uint8_t>( iFlags );
+
+	return true;
+}
+
+bool CEffectParticles::BulletImpact( const Vector& vecOrigin, const Vector& vecNormal )
+{
+	if( !IsEnabled() )
+		return false;
+
+	//Start just off of the surface so the first trace doesn't start solid.
+	const Vector vecStart = vecOrigin + vecNormal * 2;
+
+	const int iDebris = gEngfuncs.pfnRandomLong( 4, 8 );
+
+	for( int iParticle = 0; iParticle < iDebris; ++iParticle )
+	{
+		const Vector vecDir = vecNormal + Vector(
+			gEngfuncs.pfnRandomFloat( -0.6, 0.6 ),
+			gEngfuncs.pfnRandomFloat( -0.6, 0.6 ),
+			gEngfuncs.pfnRandomFloat( -0.6, 0.6 ) );
+
+		const float flShade = gEngfuncs.pfnRandomFloat( 0.25, 0.45 );
+
+		Emit( EffectMaterial::DEBRIS, vecStart, vecDir * gEngfuncs.pfnRandomFloat( 80, 200 ),
+			  gEngfuncs.pfnRandomFloat( 0.6, 1.2 ), 0.6f, 0,
+			  Vector( flShade, flShade, flShade ), 1, 1, FLAG_COLLIDE | FLAG_FADE );
+	}
+
+	Emit( EffectMaterial::SMOKE, vecStart + vecNormal * 2, vecNormal * 12 + Vector( 0, 0, 8 ),
+		  gEngfuncs.pfnRandomFloat( 0.8, 1.2 ), 4, 10,
+		  Vector( 0.5, 0.5, 0.5 ), 0.5f, 0, FLAG_FADE );
+
+	if( gEngfuncs.pfnRandomLong( 0, 3 ) == 0 )
+	{
+		const int iSparks = gEngfuncs.pfnRandomLong( 2, 4 );
+
+		for( int iParticle = 0; iParticle < iSparks; ++iParticle )
+		{
+			const Vector vecDir = vecNormal + Vector(
+				gEngfuncs.pfnRandomFloat( -0.4, 0.4 ),
+				gEngfuncs.pfnRandomFloat( -0.4, 0.4 ),
+				gEngfuncs.pfnRandomFloat( -0.4, 0.4 ) );
+
+			Emit( EffectMaterial::SPARK, vecStart, vecDir * gEngfuncs.pfnRandomFloat( 150, 300 ),
+				  gEngfuncs.pfnRandomFloat( 0.2, 0.4 ), 0.5f, -0.5f,
+				  Vector( 1, 0.8, 0.4 ), 1, 0.5f, FLAG_COLLIDE | FLAG_FADE );
+		}
+	}
+
+	return true;
+}
+
+void CEffectParticles::Simulate( const float flFrameTime, const float flGravity )
+{
+	m_iSpawnBudget = max( 0, static_cast<int>( cl_fx_budget->value ) );
+
+	if( !m_iCount )
+		return;
+
+	if( !IsEnabled() )
+	{
+		Clear();
+		return;
+	}
+
+	//Paused.
+	if( flFrameTime <= 0 )
+		return;
+
+	for( int i = 0; i < m_iCount; )
+	{
+		m_flLife[ i ] -= flFrameTime;
+
+		if( m_flLife[ i ] <= 0 )
+			Remove( i );
+		else
+			++i;
+	}
+
+	const int iCount = m_iCount;
+
+	m_iNumColliding = 0;
+
+	for( int i = 0; i < iCount; ++i )
+	{
+		if( m_Flags[ i ] & FLAG_COLLIDE )
+		{
+			m_vecCollidingStart[ m_iNumColliding ] = Vector( m_flOriginX[ i ], m_flOriginY[ i ], m_flOriginZ[ i ] );
+			m_iColliding[ m_iNumColliding++ ] = i;
+		}
+	}
+
+	//Each attribute is integrated in its own loop so the compiler can vectorize them.
+	const float flGravityStep = flGravity * flFrameTime;
+
+	for( int i = 0; i < iCount; ++i )
+		m_flVelocityZ[ i ] -= m_flGravity[ i ] * flGravityStep;
+
+	for( int i = 0; i < iCount; ++i )
+		m_flOriginX[ i ] += m_flVelocityX[ i ] * flFrameTime;
+
+	for( int i = 0; i < iCount; ++i )
+		m_flOriginY[ i ] += m_flVelocityY[ i ] * flFrameTime;
+
+	for( int i = 0; i < iCount; ++i )
+		m_flOriginZ[ i ] += m_flVelocityZ[ i ] * flFrameTime;
+
+	for( int i = 0; i < iCount; ++i )
+		m_flSize[ i ] = max( 0.0f, m_flSize[ i ] + m_flGrowth[ i ] * flFrameTime );
+
+	if( m_iNumColliding > 0 )
+		Collide();
+}
+
+void CEffectParticles::Draw()
+{
+	if( !m_iCount || !IsEnabled() )
+		return;
+
+	Vector vecForward, vecRight, vecUp;
+
+	AngleVectors( v_angles, &vecForward, &vecRight, &vecUp );
+
+	const float flMaxDist = cl_fx_maxdist->value;
+	const float flMaxDistSqr = flMaxDist * flMaxDist;
+
+	//Half the size of the view frustum at a depth of 1. in_fov is horizontal, the vertical FOV follows from the aspect ratio like in CalcFov.
+	const float flFOV = ( in_fov >= 1 && in_fov <= 179 ) ? in_fov : 90;
+	const float flTanX = tan( flFOV / 360 * M_PI );
+	const float flTanY = ScreenWidth > 0 ? flTanX * ScreenHeight / ScreenWidth : flTanX;
+
+	//Particles are culled as spheres. A sphere touches a side plane when its center is within radius / cos( half FOV ) of it, measured across the view.
+	const float flSecX = sqrt( 1 + flTanX * flTanX );
+	const float flSecY = sqrt( 1 + flTanY * flTanY );
+
+	//Bucket the visible particles by material.
+	int iMaterialCounts[ static_cast<size_t>( EffectMaterial::COUNT ) ] = {};
+	int iMaterialStarts[ static_cast<size_t>( EffectMaterial::COUNT ) ];
+
+	for( int i = 0; i < m_iCount; ++i )
+		++iMaterialCounts[ m_Material[ i ] ];
+
+	int iStart = 0;
+
+	for( size_t uiMaterial = 0; uiMaterial < ARRAYSIZE( iMaterialCounts ); ++uiMaterial )
+	{
+		iMaterialStarts[ uiMaterial ] = iStart;
+		iStart += iMaterialCounts[ uiMaterial ];
+		iMaterialCounts[ uiMaterial ] = 0;
+	}
+
+	for( int i = 0; i < m_iCount; ++i )
+	{
+		const Vector vecDelta( m_flOriginX[ i ] - v_origin.x, m_flOriginY[ i ] - v_origin.y, m_flOriginZ[ i ] - v_origin.z );
+
+		const float flDepth = DotProduct( vecDelta, vecForward );
+
+		//Behind the view.
+		if( flDepth < -m_flSize[ i ] )
+			continue;
+
+		//Outside the sides of the view frustum.
+		if( fabs( DotProduct( vecDelta, vecRight ) ) > flDepth * flTanX + m_flSize[ i ] * flSecX ||
+			fabs( DotProduct( vecDelta, vecUp ) ) > flDepth * flTanY + m_flSize[ i ] * flSecY )
+			continue;
+
+		if( flMaxDist > 0 && DotProduct( vecDelta, vecDelta ) > flMaxDistSqr )
+			continue;
+
+		const int iMaterial = m_Material[ i ];
+
+		m_iDrawList[ iMaterialStarts[ iMaterial ] + iMaterialCounts[ iMaterial ]++ ] = i;
+	}
+
+	gEngfuncs.pTriAPI->CullFace( TRI_NONE );
+
+	for( size_t uiMaterial = 0; uiMaterial < ARRAYSIZE( iMaterialCounts ); ++uiMaterial )
+	{
+		if( !iMaterialCounts[ uiMaterial ] || !m_pMaterials[ uiMaterial ] )
+			continue;
+
+		const int iRenderMode = g_MaterialInfos[ uiMaterial ].iRenderMode;
+
+		if( !gEngfuncs.pTriAPI->SpriteTexture( m_pMaterials[ uiMaterial ], 0 ) )
+			continue;
+
+		gEngfuncs.pTriAPI->RenderMode( iRenderMode );
+		gEngfuncs.pTriAPI->Begin( TRI_QUADS );
+
+		const int* pIndex = &m_iDrawList[ iMaterialStarts[ uiMaterial ] ];
+		const int* const pEnd = pIndex + iMaterialCounts[ uiMaterial ];
+
+		for( ; pIndex != pEnd; ++pIndex )
+		{
+			const int i = *pIndex;
+
+			float flAlpha = m_flAlpha[ i ];
+
+			if( m_Flags[ i ] & FLAG_FADE )
+				flAlpha *= m_flLife[ i ] / m_flLifetime[ i ];
+
+			const Vector vecOrigin( m_flOriginX[ i ], m_flOriginY[ i ], m_flOriginZ[ i ] );
+			const Vector vecRightOfs = vecRight * m_flSize[ i ];
+			const Vector vecUpOfs = vecUp * m_flSize[ i ];
+
+			gEngfuncs.pTriAPI->Color4fRendermode( m_flColorR[ i ], m_flColorG[ i ], m_flColorB[ i ], flAlpha, iRenderMode );
+
+			gEngfuncs.pTriAPI->TexCoord2f( 0, 0 );
+			gEngfuncs.pTriAPI->Vertex3fv( vecOrigin - vecRightOfs + vecUpOfs );
+
+			gEngfuncs.pTriAPI->TexCoord2f( 1, 0 );
+			gEngfuncs.pTriAPI->Vertex3fv( vecOrigin + vecRightOfs + vecUpOfs );
+
+			gEngfuncs.pTriAPI->TexCoord2f( 1, 1 );
+			gEngfuncs.pTriAPI->Vertex3fv( vecOrigin + vecRightOfs - vecUpOfs );
+
+			gEngfuncs.pTriAPI->TexCoord2f( 0, 1 );
+			gEngfuncs.pTriAPI->Vertex3fv( vecOrigin - vecRightOfs - vecUpOfs );
+		}
+
+		gEngfuncs.pTriAPI->End();
+	}
+
+	gEngfuncs.pTriAPI->RenderMode( kRenderNormal );
+	gEngfuncs.pTriAPI->CullFace( TRI_FRONT );
+}
+
+void CEffectParticles::Remove( const int iIndex )
+{
+	//Order doesn't matter, so move the last particle into the gap.
+	const int iLast = --m_iCount;
+
+	if( iIndex == iLast )
+		return;
+
+	m_flOriginX[ iIndex ] = m_flOriginX[ iLast ];
+	m_flOriginY[ iIndex ] = m_flOriginY[ iLast ];
+	m_flOriginZ[ iIndex ] = m_flOriginZ[ iLast ];
+
+	m_flVelocityX[ iIndex ] = m_flVelocityX[ iLast ];
+	m_flVelocityY[ iIndex ] = m_flVelocityY[ iLast ];
+	m_flVelocityZ[ iIndex ] = m_flVelocityZ[ iLast ];
+
+	m_flGravity[ iIndex ] = m_flGravity[ iLast ];
+
+	m_flSize[ iIndex ] = m_flSize[ iLast ];
+	m_flGrowth[ iIndex ] = m_flGrowth[ iLast ];
+
+	m_flLife[ iIndex ] = m_flLife[ iLast ];
+	m_flLifetime[ iIndex ] = m_flLifetime[ iLast ];
+
+	m_flColorR[ iIndex ] = m_flColorR[ iLast ];
+	m_flColorG[ iIndex ] = m_flColorG[ iLast ];
+	m_flColorB[ iIndex ] = m_flColorB[ iLast ];
+	m_flAlpha[ iIndex ] = m_flAlpha[ iLast ];
+
+	m_Material[ iIndex ] = m_Material[ iLast ];
+	m_Flags[ iIndex ] = m_Flags[ iLast ];
+}
+
+void CEffectParticles::Collide()
+{
+	//Set up the trace state once for every colliding particle. Only the world is needed, so don't add players.
+	gEngfuncs.pEventAPI->EV_SetUpPlayerPrediction( false, true );
+
+	gEngfuncs.pEventAPI->EV_PushPMStates();
+
+	gEngfuncs.pEventAPI->EV_SetTraceHull( 2 );
+
+	pmtrace_t tr;
+
+	for( int iCollide = 0; iCollide < m_iNumColliding; ++iCollide )
+	{
+		const int i = m_iColliding[ iCollide ];
+
+		const Vector vecEnd( m_flOriginX[ i ], m_flOriginY[ i ], m_flOriginZ[ i ] );
+
+		gEngfuncs.pEventAPI->EV_PlayerTrace( m_vecCollidingStart[ iCollide ], vecEnd, PM_STUDIO_BOX | PM_WORLD_ONLY, -1, &tr );
+
+		if( tr.allsolid )
+		{
+			//Removed next frame.
+			m_flLife[ i ] = 0;
+			continue;
+		}
+
+		if( tr.fraction >= 1.0 )
+			continue;
+
+		Vector vecVelocity( m_flVelocityX[ i ], m_flVelocityY[ i ], m_flVelocityZ[ i ] );
+
+		vecVelocity = ( vecVelocity - tr.plane.normal * ( 2 * DotProduct( vecVelocity, tr.plane.normal ) ) ) * PARTICLE_ELASTICITY;
+
+		//Come to rest on floors.
+		if( tr.plane.normal.z > 0.7 && DotProduct( vecVelocity, vecVelocity ) < PARTICLE_REST_SPEED * PARTICLE_REST_SPEED )
+		{
+			vecVelocity = g_vecZero;
+			m_flGravity[ i ] = 0;
+			m_Flags[ i ] &= ~FLAG_COLLIDE;
+		}
+
+		m_flOriginX[ i ] = tr.endpos.x;
+		m_flOriginY[ i ] = tr.endpos.y;
+		m_flOriginZ[ i ] = tr.endpos.z;
+
+		m_flVelocityX[ i ] = vecVelocity.x;
+		m_flVelocityY[ i ] = vecVelocity.y;
+		m_flVelocityZ[ i ] = vecVelocity.z;
+	}
+
+	gEngfuncs.pEventAPI->EV_PopPMStates();
+}
@@ -0,0 +1,160 @@
+#ifndef GAME_CLIENT_EFFECTS_CEFFECTPARTICLES_H
+#define GAME_CLIENT_EFFECTS_CEFFECTPARTICLES_H
+
+#include <cstdint>
+
+/**
+*	Sprites that effect particles can be drawn with.
+*/
+enum class EffectMaterial
+{
+	/**
+	*	Small chips of material.
+	*/
+	DEBRIS = 0,
+
+	/**
+	*	Dust and smoke puffs.
+	*/
+	SMOKE,
+
+	/**
+	*	Additive sparks.
+	*/
+	SPARK,
+
+	COUNT
+};
+
+/**
+*	Short lived effect particles, such as bullet impact debris and smoke.
+*	Particles are kept in a fixed size pool stored as separate arrays for each attribute, so they can be integrated in tight loops.
+*	Colliding particles are traced against the world in one batch per frame, and particles are drawn in one pass for each material.
+*	Unlike engine temporary entities, nothing here needs the player list, so simulating these doesn't require player prediction to be set up.
+*/
+class CEffectParticles final
+{
+public:
+	static const int MAX_PARTICLES = 4096;
+
+	enum Flag
+	{
+		/**
+		*	Traced against the world, and bounces off of it.
+		*/
+		FLAG_COLLIDE	= 1 << 0,
+
+		/**
+		*	Fades out over its lifetime.
+		*/
+		FLAG_FADE		= 1 << 1
+	};
+
+public:
+	CEffectParticles() = default;
+
+	/**
+	*	Loads the materials and removes all particles. Called when the HUD is initialized.
+	*/
+	void Initialize();
+
+	void Clear();
+
+	/**
+	*	@return Whether particles are enabled. If not, the engine's effects should be used instead.
+	*/
+	bool IsEnabled() const;
+
+	int GetCount() const { return m_iCount; }
+
+	/**
+	*	Creates a particle.
+	*	@param flLife Lifetime in seconds.
+	*	@param flSize Half the width of the particle.
+	*	@param flGrowth Change in size per second.
+	*	@param vecColor Color, [ 0, 1 ].
+	*	@param flGravity Fraction of gravity that applies to the particle.
+	*	@param iFlags Flags.
+	*	@return Whether the particle was created. Particles aren't created if the pool is full, the frame's budget has been used up,
+	*		or they're too far away to see.
+	*/
+	bool Emit( const EffectMaterial material, const Vector& vecOrigin, const Vector& vecVelocity,
+			   const float flLife, const float flSize, const float flGrowth,
+			   const Vector& vecColor, const float flAlpha, const float flGravity, const int iFlags );
+
+	/**
+	*	Creates the debris and dust for a bullet hitting a surface.
+	*	@return Whether the effect was handled. If not, the engine's effect should be used.
+	*/
+	bool BulletImpact( const Vector& vecOrigin, const Vector& vecNormal );
+
+	/**
+	*	Moves all particles and removes those that have died.
+	*	@param flFrameTime Time since the last frame.
+	*	@param flGravity World gravity.
+	*/
+	void Simulate( const float flFrameTime, const float flGravity );
+
+	/**
+	*	Draws all visible particles.
+	*/
+	void Draw();
+
+private:
+	void Remove( const int iIndex );
+
+	void Collide();
+
+private:
+	model_t* m_pMaterials[ static_cast<size_t>( EffectMaterial::COUNT ) ] = {};
+
+	int m_iCount = 0;
+
+	//Particles that can still be created this frame.
+	int m_iSpawnBudget = 0;
+
+	float m_flOriginX[ MAX_PARTICLES ];
+	float m_flOriginY[ MAX_PARTICLES ];
+	float m_flOriginZ[ MAX_PARTICLES ];
+
+	float m_flVelocityX[ MAX_PARTICLES ];
+	float m_flVelocityY[ MAX_PARTICLES ];
+	float m_flVelocityZ[ MAX_PARTICLES ];
+
+	float m_flGravity[ MAX_PARTICLES ];
+
+	float m_flSize[ MAX_PARTICLES ];
+	float m_flGrowth[ MAX_PARTICLES ];
+
+	//Time left to live, and total lifetime.
+	float m_flLife[ MAX_PARTICLES ];
+	float m_flLifetime[ MAX_PARTICLES ];
+
+	float m_flColorR[ MAX_PARTICLES ];
+	float m_flColorG[ MAX_PARTICLES ];
+	float m_flColorB[ MAX_PARTICLES ];
+	float m_flAlpha[ MAX_PARTICLES ];
+
+	uint8_t m_Material[ MAX_PARTICLES ];
+	uint8_t m_Flags[ MAX_PARTICLES ];
+
+	//Colliding particles and where they were before this frame's move.
+	int m_iNumColliding = 0;
+	int m_iColliding[ MAX_PARTICLES ];
+	Vector m_vecCollidingStart[ MAX_PARTICLES ];
+
+	//Visible particles sorted by material.
+	int m_iDrawList[ MAX_PARTICLES ];
+
+private:
+	CEffectParticles( const CEffectParticles& ) = delete;
+	CEffectParticles& operator=( const CEffectParticles& ) = delete;
+};
+
+extern CEffectParticles g_EffectParticles;
+
+extern cvar_t* cl_fx_particles;
+extern cvar_t* cl_fx_budget;
+extern cvar_t* cl_fx_maxdist;
+
+#endif //GAME_CLIENT_EFFECTS_CEFFECTPARTICLES_H
@@ -246,23 +246,9 @@ void CEnvironment::UpdateGrass()
 		gEngfuncs.pEventAPI->EV_PlayerTrace( vecOrigin, vecEndPos, PM_WORLD_ONLY, -1, &trace );
 		const char* pszTexture = gEngfuncs.pEventAPI->EV_TraceTexture( trace.ent, trace.endpos, vecEndPos );
 
-		if( pszTexture )
+		if( pszTexture && g_MaterialsList.GetTextureType( pszTexture ) == CHAR_TEX_GRASS )
 		{
-			//Skip the +/- and number.
-			if( pszTexture[ 0 ] == '+' || 
-				pszTexture[ 0 ] == '-' )
-				pszTexture += 2;
-
-			if( pszTexture[ 0 ] == '!' || 
-				pszTexture[ 0 ] == '{' || 
-				pszTexture[ 0 ] == '~' || 
-				pszTexture[ 0 ] == ' ' )
-				++pszTexture;
-
-			if( PM_FindTextureType( pszTexture ) == CHAR_TEX_GRASS )
-			{
-				CreateGrassPiece( trace.endpos, Vector( 0, UTIL_RandomFloat( 0, 359.0 ), 0 ) );
-			}
+			CreateGrassPiece( trace.endpos, Vector( 0, UTIL_RandomFloat( 0, 359.0 ), 0 ) );
 		}
 	}
 }
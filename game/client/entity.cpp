@@ -23,6 +23,8 @@
 #include "CHudSpectator.h"
 
 #include "particleman.h"
+
+#include "effects/CEffectParticles.h"
 extern IParticleMan *g_pParticleMan;
 
 void Game_AddObjects( void );
@@ -405,21 +407,38 @@ void DLLEXPORT HUD_TempEntUpdate (
 	if ( g_pParticleMan )
 		 g_pParticleMan->SetVariables( cl_gravity, vAngles );
 
+	g_EffectParticles.Simulate( frametime, cl_gravity );
+
 	// Nothing to simulate
 	if ( !*ppTempEntActive )		
 		return;
 
-	// in order to have tents collide with players, we have to run the player prediction code so
-	// that the client has the player list. We run this code once when we detect any COLLIDEALL 
-	// tent, then set this bool to true so the code doesn't get run again if there's more than
-	// one COLLIDEALL ent for this update. (often are).
-	gEngfuncs.pEventAPI->EV_SetUpPlayerPrediction( false, true );
+	// Only tents that collide are traced, so skip setting up prediction if there are none.
+	bool bNeedsTrace = false;
+
+	for( auto pCheck = *ppTempEntActive; pCheck; pCheck = pCheck->next )
+	{
+		if( pCheck->flags & ( FTENT_COLLIDEALL | FTENT_COLLIDEWORLD ) )
+		{
+			bNeedsTrace = true;
+			break;
+		}
+	}
+
+	if( bNeedsTrace )
+	{
+		// in order to have tents collide with players, we have to run the player prediction code so
+		// that the client has the player list. We run this code once when we detect any COLLIDEALL 
+		// tent, then set this bool to true so the code doesn't get run again if there's more than
+		// one COLLIDEALL ent for this update. (often are).
+		gEngfuncs.pEventAPI->EV_SetUpPlayerPrediction( false, true );
 
-	// Store off the old count
-	gEngfuncs.pEventAPI->EV_PushPMStates();
+		// Store off the old count
+		gEngfuncs.pEventAPI->EV_PushPMStates();
 
-	// Now add in all of the players.
-	gEngfuncs.pEventAPI->EV_SetSolidPlayers ( -1 );	
+		// Now add in all of the players.
+		gEngfuncs.pEventAPI->EV_SetSolidPlayers ( -1 );	
+	}
 
 	// !!!BUGBUG	-- This needs to be time based
 	gTempEntFrame = (gTempEntFrame+1) & 31;
@@ -751,7 +770,8 @@ void DLLEXPORT HUD_TempEntUpdate (
 	}
 
 	// Restore state info
-	gEngfuncs.pEventAPI->EV_PopPMStates();
+	if( bNeedsTrace )
+		gEngfuncs.pEventAPI->EV_PopPMStates();
 }
 
 /*
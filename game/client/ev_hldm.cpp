@@ -21,6 +21,7 @@
 #include "usercmd.h"
 #include "pm_defs.h"
 #include "materials/Materials.h"
+#include "effects/CEffectParticles.h"
 
 #include "eventscripts.h"
 #include "ev_hldm.h"
@@ -80,9 +81,7 @@ float EV_HLDM_PlayTextureSound( int idx, pmtrace_t *ptr, const Vector& vecSrc, c
 {
 	// hit the world, try to play sound based on texture material type
 	int entity;
-	char *pTextureName;
-	char texname[ 64 ];
-	char szbuffer[ 64 ];
+	const char *pTextureName;
 
 	entity = gEngfuncs.pEventAPI->EV_IndexFromTrace( ptr );
 
@@ -100,31 +99,11 @@ float EV_HLDM_PlayTextureSound( int idx, pmtrace_t *ptr, const Vector& vecSrc, c
 	else if ( entity == 0 )
 	{
 		// get texture from entity or world (world is ent(0))
-		pTextureName = (char *)gEngfuncs.pEventAPI->EV_TraceTexture( ptr->ent, vecSrc, vecEnd );
+		pTextureName = gEngfuncs.pEventAPI->EV_TraceTexture( ptr->ent, vecSrc, vecEnd );
 		
+		// get texture type
 		if ( pTextureName )
-		{
-			strcpy( texname, pTextureName );
-			pTextureName = texname;
-
-			// strip leading '-0' or '+0~' or '{' or '!'
-			if (*pTextureName == '-' || *pTextureName == '+')
-			{
-				pTextureName += 2;
-			}
-
-			if (*pTextureName == '{' || *pTextureName == '!' || *pTextureName == '~' || *pTextureName == ' ')
-			{
-				pTextureName++;
-			}
-			
-			// '}}'
-			strcpy( szbuffer, pTextureName );
-			szbuffer[ CBTEXTURENAMEMAX - 1 ] = 0;
-				
-			// get texture type
-			chTextureType = g_MaterialsList.FindTextureType( szbuffer );	
-		}
+			chTextureType = g_MaterialsList.GetTextureType( pTextureName );
 	}
 
 	float fvol;
@@ -169,7 +148,8 @@ void EV_HLDM_GunshotDecalTrace( pmtrace_t *pTrace, char *decalName )
 	int iRand;
 	physent_t *pe;
 
-	gEngfuncs.pEfxAPI->R_BulletImpactParticles( pTrace->endpos );
+	if( !g_EffectParticles.BulletImpact( pTrace->endpos, pTrace->plane.normal ) )
+		gEngfuncs.pEfxAPI->R_BulletImpactParticles( pTrace->endpos );
 
 	iRand = gEngfuncs.pfnRandomLong(0,0x7FFF);
 	if ( iRand < (0x7fff/2) )// not every bullet makes a sound.
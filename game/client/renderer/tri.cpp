@@ -22,6 +22,7 @@
 #include "tri.h"
 extern IParticleMan *g_pParticleMan;
 
+#include "effects/CEffectParticles.h"
 #include "effects/CEnvironment.h"
 
 #include "CHudSpectator.h"
@@ -63,4 +64,6 @@ void DLLEXPORT HUD_DrawTransparentTriangles( void )
 
 		g_Environment.Update();
 	}
+
+	g_EffectParticles.Draw();
 }
@@ -760,128 +760,46 @@ void CHudSpectator::LoadMapSprites()
 
 bool UTIL_FindEntityInMap( const char* const pszName, Vector& vecOrigin, Vector& vecAngle )
 {
-	int				n;
-	char			keyname[256];
-	char			token[1024];
+	auto pEntity = g_Client.GetEntityIndex().FindEntityByClassname( pszName );
 
-	cl_entity_t *	pEnt = gEngfuncs.GetEntityByIndex( 0 );	// get world model
+	if( !pEntity )
+		return false;	// we search all entities, but didn't find the correct entity.
 
-	if ( !pEnt ) return false;
-
-	if ( !pEnt->model )	return false;
-
-	const char* data = pEnt->model->entities;
-
-	bool bFound = false;
-
-	while (data)
+	for( const auto& keyValue : *pEntity )
 	{
-		data = gEngfuncs.COM_ParseFile(data, token);
-		
-		if ( (token[0] == '}') ||  (token[0]=='\0') )
-			break;
-
-		if (!data)
+		if( !strcmp( keyValue.pszKey, "angle" ) )
 		{
-			gEngfuncs.Con_DPrintf("UTIL_FindEntityInMap: EOF without closing brace\n");
-			return false;
-		}
-
-		if (token[0] != '{')
-		{
-			gEngfuncs.Con_DPrintf("UTIL_FindEntityInMap: expected {\n");
-			return false;
-		}
-
-		// we parse the first { now parse entities properties
-		
-		while ( 1 )
-		{	
-			// parse key
-			data = gEngfuncs.COM_ParseFile(data, token);
-			if (token[0] == '}')
-				break; // finish parsing this entity
-
-			if (!data)
-			{	
-				gEngfuncs.Con_DPrintf("UTIL_FindEntityInMap: EOF without closing brace\n");
-				return false;
-			}
-			
-			strcpy (keyname, token);
-
-			// another hack to fix keynames with trailing spaces
-			n = strlen(keyname);
-			while (n && keyname[n-1] == ' ')
-			{
-				keyname[n-1] = '\0';
-				n--;
-			}
+			float y = atof( keyValue.pszValue );
 			
-			// parse value	
-			data = gEngfuncs.COM_ParseFile(data, token);
-			if (!data)
-			{	
-				gEngfuncs.Con_DPrintf("UTIL_FindEntityInMap: EOF without closing brace\n");
-				return false;
-			}
-	
-			if (token[0] == '}')
+			if (y >= 0)
 			{
-				gEngfuncs.Con_DPrintf("UTIL_FindEntityInMap: closing brace without data");
-				return false;
+				vecAngle[0] = 0.0f;
+				vecAngle[1] = y;
 			}
-
-			if (!strcmp(keyname,"classname"))
+			else if ((int)y == -1)
 			{
-				if (!strcmp(token, pszName ))
-				{
-					bFound = true;	// thats our entity
-				}
+				vecAngle[0] = -90.0f;
+				vecAngle[1] =   0.0f;
 			}
-
-			if( !strcmp( keyname, "angle" ) )
-			{
-				float y = atof( token );
-				
-				if (y >= 0)
-				{
-					vecAngle[0] = 0.0f;
-					vecAngle[1] = y;
-				}
-				else if ((int)y == -1)
-				{
-					vecAngle[0] = -90.0f;
-					vecAngle[1] =   0.0f;;
-				}
-				else
-				{
-					vecAngle[0] = 90.0f;
-					vecAngle[1] =  0.0f;
-				}
-
-				vecAngle[2] =  0.0f;
-			}
-
-			if( !strcmp( keyname, "angles" ) )
-			{
-				UTIL_StringToVector( vecAngle, token);
-			}
-			
-			if (!strcmp(keyname,"origin"))
+			else
 			{
-				UTIL_StringToVector( vecOrigin, token);
-
+				vecAngle[0] = 90.0f;
+				vecAngle[1] =  0.0f;
 			}
-				
-		} // while (1)
-
-		if (bFound)
-			return true;
 
+			vecAngle[2] =  0.0f;
+		}
+		else if( !strcmp( keyValue.pszKey, "angles" ) )
+		{
+			UTIL_StringToVector( vecAngle, keyValue.pszValue );
+		}
+		else if( !strcmp( keyValue.pszKey, "origin" ) )
+		{
+			UTIL_StringToVector( vecOrigin, keyValue.pszValue );
+		}
 	}
 
-	return false;	// we search all entities, but didn't find the correct entity.
+	return true;
 }
 
 void CHudSpectator::SetSpectatorStartPosition()
@@ -46,6 +46,7 @@
 #include "CHudStatusIcons.h"
 #include "CHudMenu.h"
 
+#include "effects/CEffectParticles.h"
 #include "effects/CEnvironment.h"
 
 class CHLVoiceStatusHelper : public IVoiceStatusHelper
@@ -141,6 +142,7 @@ void CHLHud::PreInit()
 	HOOK_HUD_MESSAGE( InitHUD );
 	HOOK_HUD_MESSAGE( ViewMode );
 	HOOK_HUD_MESSAGE( Concuss );
+	HOOK_HUD_MESSAGE( Tracers );
 	HOOK_HUD_MESSAGE( ReceiveW );
 	HOOK_HUD_MESSAGE( HudColors );
 
@@ -155,6 +157,10 @@ void CHLHud::PreInit()
 	m_pCvarStealMouse = CVAR_CREATE( "hud_capturemouse", "1", FCVAR_ARCHIVE );
 	m_pCvarDraw = CVAR_CREATE( "hud_draw", "1", FCVAR_ARCHIVE );
 	cl_weather = CVAR_CREATE( "cl_weather", "1", FCVAR_ARCHIVE );
+
+	cl_fx_particles = CVAR_CREATE( "cl_fx_particles", "1", FCVAR_ARCHIVE );
+	cl_fx_budget = CVAR_CREATE( "cl_fx_budget", "256", FCVAR_ARCHIVE );
+	cl_fx_maxdist = CVAR_CREATE( "cl_fx_maxdist", "2048", FCVAR_ARCHIVE );
 }
 
 void CHLHud::PostInit()
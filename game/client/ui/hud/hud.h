@@ -108,6 +108,7 @@ public:
 	void MsgFunc_InitHUD( const char *pszName, int iSize, void *pbuf );
 	void MsgFunc_ViewMode( const char *pszName, int iSize, void *pbuf );
 	void MsgFunc_Concuss( const char *pszName, int iSize, void *pbuf );
+	void MsgFunc_Tracers( const char *pszName, int iSize, void *pbuf );
 	void MsgFunc_ReceiveW( const char* pszName, int iSize, void* pBuf );
 
 	void MsgFunc_HudColors( const char* pszName, int iSize, void* pBuf );
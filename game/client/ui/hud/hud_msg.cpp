@@ -124,6 +124,22 @@ void CHLHud::MsgFunc_Concuss( const char *pszName, int iSize, void *pbuf )
 		pStatusIcons->DisableIcon("dmg_concuss");
 }
 
+void CHLHud::MsgFunc_Tracers( const char *pszName, int iSize, void *pbuf )
+{
+	CBufferReader reader( pbuf, iSize );
+
+	const int iCount = reader.ReadByte();
+
+	Vector vecSrc = reader.ReadCoordVector();
+
+	for( int iTracer = 0; iTracer < iCount; ++iTracer )
+	{
+		Vector vecEnd = reader.ReadCoordVector();
+
+		gEngfuncs.pEfxAPI->R_TracerEffect( vecSrc, vecEnd );
+	}
+}
+
 void CHLHud::MsgFunc_ReceiveW( const char* pszName, int iSize, void* pBuf )
 {
 	CBufferReader reader( pBuf, iSize );
@@ -8,6 +8,7 @@
 #include "particleman.h"
 extern IParticleMan *g_pParticleMan;
 
+#include "effects/CEffectParticles.h"
 #include "effects/CEnvironment.h"
 
 #if USE_VGUI2
@@ -142,6 +143,8 @@ void CBaseHud::InitHud()
 
 	g_Environment.Initialize();
 
+	g_EffectParticles.Initialize();
+
 	if( g_pParticleMan )
 		g_pParticleMan->ResetParticles();
 }
@@ -6,7 +6,6 @@
 
 #include <Angelscript/CASModule.h>
 
-#include <Angelscript/ScriptAPI/CASScheduler.h>
 #include <Angelscript/wrapper/ASCallable.h>
 
 #include "extdll.h"
@@ -15,6 +14,14 @@
 
 #include "CFile.h"
 
+#include "Angelscript/ScriptAPI/CASTimerScheduler.h"
+
+#include "ScriptAPI/CASEventDispatcher.h"
+
+#include "CASScriptProfiler.h"
+
+#include "CClientCommandTable.h"
+
 #include "CHLASServerManager.h"
 
 #include "CASPluginData.h"
@@ -187,7 +194,7 @@ void CASPluginManager::WorldCreated()
 	//Adjust all timers.
 	for( auto pPlugin : m_PluginList )
 	{
-		pPlugin->GetScheduler()->AdjustTime( m_flPrevThinkTime - 1 );
+		CASModule_GetScheduler( pPlugin )->AdjustTime( m_flPrevThinkTime - 1 );
 	}
 
 	//Reset to starting time. TODO: define this constant. - Solokiller
@@ -235,7 +242,7 @@ void CASPluginManager::Think()
 
 	for( auto pPlugin : m_PluginList )
 	{
-		pPlugin->GetScheduler()->Think( gpGlobals->time );
+		CASModule_GetScheduler( pPlugin )->Think( gpGlobals->time );
 	}
 
 	m_flPrevThinkTime = gpGlobals->time;
@@ -406,16 +413,21 @@ bool CASPluginManager::LoadPlugin( const char* const pszName, const char* const
 
 	CASPluginModuleBuilder builder( pszScript );
 
-	auto pluginData = std::make_unique<CASPluginData>( lifetime );
+	builder.SetUseCache( as_script_cache.value != 0 );
 
-	auto pModule = m_ASManager.GetASManager().GetModuleManager().BuildModule( "Plugin", pszName, builder, pluginData.get() );
+	auto& moduleManager = m_ASManager.GetASManager().GetModuleManager();
+
+	//The module manager takes ownership of the plugin data, and releases it if the build fails.
+	auto pModule = moduleManager.BuildModule( "Plugin", pszName, builder, new CASPluginData( lifetime ) );
+
+	//The cached bytecode couldn't be loaded, compile from source instead.
+	if( !pModule && builder.IsLoadedFromCache() )
+		pModule = moduleManager.BuildModule( "Plugin", pszName, builder, new CASPluginData( lifetime ) );
 
 	if( pModule )
 	{
 		m_PluginList.emplace_back( pModule );
 
-		pluginData.release();
-
 		if( auto pFunction = pModule->GetModule()->GetFunctionByDecl( "void PluginInit()" ) )
 		{
 			as::Call( pFunction );
@@ -439,6 +451,12 @@ void CASPluginManager::UnloadPlugin( CASModule* pPlugin )
 
 	//Plugin data is now removed by the module's destructor.
 
+	//Release scheduled functions now, they hold references to the module's functions and objects.
+	CASModule_ClearScheduler( pPlugin );
+	g_EventDispatcher.RemoveModule( pPlugin );
+	g_ScriptProfiler.RemoveModule( pPlugin );
+	g_ClientCommands.RemoveCommandsByOwner( pPlugin );
+
 	m_ASManager.GetASManager().GetModuleManager().RemoveModule( pPlugin );
 }
 
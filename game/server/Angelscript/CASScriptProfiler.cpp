@@ -0,0 +1,348 @@
+#include <algorithm>
+#include <string>
+
+#include <angelscript.h>
+
+#include <Angelscript/CASModule.h>
+#include <Angelscript/util/ASUtil.h>
+
+#include "extdll.h"
+#include "util.h"
+
+#include "CASScriptProfiler.h"
+
+CASScriptProfiler g_ScriptProfiler;
+
+void CASScriptProfiler::Initialize( asIScriptEngine& engine )
+{
+	m_pEngine = &engine;
+
+	m_pEngine->SetContextCallbacks( &CASScriptProfiler::RequestContext, &CASScriptProfiler::ReturnContext, this );
+}
+
+void CASScriptProfiler::Shutdown()
+{
+	Stop();
+
+	if( !m_pEngine )
+		return;
+
+	for( auto pContext : m_ContextPool )
+	{
+		pContext->Release();
+	}
+
+	m_ContextPool.clear();
+
+	//Restore the engine's own pooling.
+	m_pEngine->SetContextCallbacks( nullptr, nullptr, nullptr );
+
+	m_pEngine = nullptr;
+}
+
+void CASScriptProfiler::Start( const long long iSampleInterval )
+{
+	m_Functions.clear();
+	m_FunctionIndices.clear();
+	m_Stacks.clear();
+
+	m_iSampleInterval = std::max( 1LL, iSampleInterval ) * 1000;
+	m_iPendingTime = 0;
+	m_iTotalProfileTime = 0;
+	m_iTotalScriptTime = 0;
+
+	m_ActiveContexts.clear();
+
+	m_ProfileTime.Reset();
+
+	m_bProfiling = true;
+}
+
+void CASScriptProfiler::Stop()
+{
+	if( !m_bProfiling )
+		return;
+
+	m_iTotalProfileTime = m_ProfileTime.GetElapsedMicroseconds() * 1000;
+
+	m_ActiveContexts.clear();
+
+	//Line callbacks clear themselves the next time they are called.
+	m_bProfiling = false;
+}
+
+void CASScriptProfiler::RemoveModule( CASModule* pModule )
+{
+	for( auto it = m_FunctionIndices.begin(); it != m_FunctionIndices.end(); )
+	{
+		if( GetModuleFromScriptFunction( it->first ) == pModule )
+			it = m_FunctionIndices.erase( it );
+		else
+			++it;
+	}
+}
+
+void CASScriptProfiler::EnterContext( asIScriptContext& context )
+{
+	if( !m_bProfiling )
+		return;
+
+	const auto now = CStopwatch::Clock_t::now();
+
+	//Account for the time spent in the context that is being suspended.
+	if( !m_ActiveContexts.empty() )
+		AccumulateTime( *m_ActiveContexts.back().pContext, now );
+
+	context.SetLineCallback( asFUNCTION( CASScriptProfiler::LineCallback ), this, asCALL_CDECL );
+
+	m_ActiveContexts.push_back( { &context, now } );
+}
+
+void CASScriptProfiler::LeaveContext( asIScriptContext& context )
+{
+	if( !m_bProfiling )
+		return;
+
+	auto it = std::find_if( m_ActiveContexts.rbegin(), m_ActiveContexts.rend(), [ & ]( const ActiveContext& active )
+		{
+			return active.pContext == &context;
+		}
+	);
+
+	//Entered before profiling started.
+	if( it == m_ActiveContexts.rend() )
+		return;
+
+	const auto now = CStopwatch::Clock_t::now();
+
+	AccumulateTime( context, now );
+
+	m_ActiveContexts.erase( std::next( it ).base() );
+
+	//Resume the suspended context.
+	if( !m_ActiveContexts.empty() )
+		m_ActiveContexts.back().lastTime = now;
+}
+
+void CASScriptProfiler::PrintReport( const size_t uiMaxFunctions ) const
+{
+	if( m_Functions.empty() )
+	{
+		Alert( at_console, "No profiling data%s\n", m_bProfiling ? " yet" : ", use as_profile_start to start profiling" );
+		return;
+	}
+
+	const long long iProfileTime = m_bProfiling ? m_ProfileTime.GetElapsedMicroseconds() * 1000 : m_iTotalProfileTime;
+
+	Alert( at_console, "Profiled %.3f s, script time %.3f ms (%.2f%%), sample interval %lld us%s\n",
+		   iProfileTime / 1000000000.0, m_iTotalScriptTime / 1000000.0,
+		   iProfileTime > 0 ? ( m_iTotalScriptTime * 100.0 ) / iProfileTime : 0.0,
+		   m_iSampleInterval / 1000, m_bProfiling ? " (still profiling)" : "" );
+
+	std::vector<const FunctionStats*> functions;
+
+	functions.reserve( m_Functions.size() );
+
+	for( const auto& function : m_Functions )
+	{
+		functions.push_back( &function );
+	}
+
+	std::sort( functions.begin(), functions.end(), []( const FunctionStats* pLHS, const FunctionStats* pRHS )
+		{
+			return pLHS->iExclusiveTime > pRHS->iExclusiveTime;
+		}
+	);
+
+	const size_t uiCount = std::min( uiMaxFunctions, functions.size() );
+
+	Alert( at_console, "%12s %7s %12s %8s %-20s %s\n", "excl ms", "excl %", "incl ms", "samples", "module", "function" );
+
+	for( size_t uiIndex = 0; uiIndex < uiCount; ++uiIndex )
+	{
+		const auto& function = *functions[ uiIndex ];
+
+		Alert( at_console, "%12.3f %6.2f%% %12.3f %8u %-20s %s\n",
+			   function.iExclusiveTime / 1000000.0,
+			   m_iTotalScriptTime > 0 ? ( function.iExclusiveTime * 100.0 ) / m_iTotalScriptTime : 0.0,
+			   function.iInclusiveTime / 1000000.0,
+			   function.uiSamples,
+			   function.szModuleName.c_str(), function.szFunctionName.c_str() );
+	}
+
+	if( uiCount < functions.size() )
+		Alert( at_console, "%u more functions not shown\n", static_cast<unsigned int>( functions.size() - uiCount ) );
+}
+
+bool CASScriptProfiler::WriteCollapsedStacks( const char* const pszFileName ) const
+{
+	ASSERT( pszFileName );
+
+	FileHandle_t hFile = g_pFileSystem->Open( pszFileName, "w" );
+
+	if( hFile == FILESYSTEM_INVALID_HANDLE )
+		return false;
+
+	std::string szLine;
+
+	for( const auto& stack : m_Stacks )
+	{
+		szLine.clear();
+
+		for( auto uiIndex : stack.first )
+		{
+			if( !szLine.empty() )
+				szLine += ';';
+
+			const auto& function = m_Functions[ uiIndex ];
+
+			szLine += function.szModuleName;
+			szLine += ':';
+			szLine += function.szFunctionName;
+		}
+
+		szLine += ' ';
+		szLine += std::to_string( stack.second / 1000 );
+		szLine += '\n';
+
+		g_pFileSystem->Write( szLine.c_str(), szLine.length(), hFile );
+	}
+
+	g_pFileSystem->Close( hFile );
+
+	return true;
+}
+
+asIScriptContext* CASScriptProfiler::RequestContext( asIScriptEngine* pEngine, void* pParam )
+{
+	auto& profiler = *reinterpret_cast<CASScriptProfiler*>( pParam );
+
+	asIScriptContext* pContext;
+
+	if( !profiler.m_ContextPool.empty() )
+	{
+		pContext = profiler.m_ContextPool.back();
+		profiler.m_ContextPool.pop_back();
+	}
+	else
+	{
+		pContext = pEngine->CreateContext();
+	}
+
+	if( pContext )
+		profiler.EnterContext( *pContext );
+
+	return pContext;
+}
+
+void CASScriptProfiler::ReturnContext( asIScriptEngine*, asIScriptContext* pContext, void* pParam )
+{
+	auto& profiler = *reinterpret_cast<CASScriptProfiler*>( pParam );
+
+	profiler.LeaveContext( *pContext );
+
+	pContext->Unprepare();
+
+	profiler.m_ContextPool.push_back( pContext );
+}
+
+void CASScriptProfiler::LineCallback( asIScriptContext* pContext, void* pParam )
+{
+	auto& profiler = *reinterpret_cast<CASScriptProfiler*>( pParam );
+
+	if( !profiler.m_bProfiling )
+	{
+		pContext->ClearLineCallback();
+		return;
+	}
+
+	profiler.AccumulateTime( *pContext, CStopwatch::Clock_t::now() );
+}
+
+void CASScriptProfiler::AccumulateTime( asIScriptContext& context, const CStopwatch::Clock_t::time_point now )
+{
+	if( m_ActiveContexts.empty() || m_ActiveContexts.back().pContext != &context )
+		return;
+
+	auto& active = m_ActiveContexts.back();
+
+	const long long iElapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( now - active.lastTime ).count();
+
+	active.lastTime = now;
+
+	m_iTotalScriptTime += iElapsed;
+	m_iPendingTime += iElapsed;
+
+	if( m_iPendingTime < m_iSampleInterval )
+		return;
+
+	//Time is carried over between calls so short calls are sampled in proportion to how long they take.
+	const long long iSampleTime = ( m_iPendingTime / m_iSampleInterval ) * m_iSampleInterval;
+
+	m_iPendingTime -= iSampleTime;
+
+	Sample( context, iSampleTime );
+}
+
+void CASScriptProfiler::Sample( asIScriptContext& context, const long long iTime )
+{
+	m_Stack.clear();
+
+	//Outermost function first.
+	for( asUINT uiLevel = context.GetCallstackSize(); uiLevel-- > 0; )
+	{
+		//Null for nested call markers.
+		if( auto pFunction = context.GetFunction( uiLevel ) )
+			m_Stack.push_back( GetFunctionIndex( *pFunction ) );
+	}
+
+	//Context has already finished, attribute the time to the next sample.
+	if( m_Stack.empty() )
+	{
+		m_iPendingTime += iTime;
+		return;
+	}
+
+	for( auto it = m_Stack.begin(); it != m_Stack.end(); ++it )
+	{
+		//Recursive calls only count once.
+		if( std::find( m_Stack.begin(), it, *it ) == it )
+			m_Functions[ *it ].iInclusiveTime += iTime;
+	}
+
+	auto& leaf = m_Functions[ m_Stack.back() ];
+
+	++leaf.uiSamples;
+	leaf.iExclusiveTime += iTime;
+
+	m_Stacks[ m_Stack ] += iTime;
+}
+
+size_t CASScriptProfiler::GetFunctionIndex( asIScriptFunction& function )
+{
+	auto it = m_FunctionIndices.find( &function );
+
+	if( it != m_FunctionIndices.end() )
+		return it->second;
+
+	FunctionStats stats;
+
+	auto pModule = GetModuleFromScriptFunction( &function );
+
+	stats.szModuleName = pModule ? pModule->GetModuleName() : "Unknown";
+
+	char szFunctionName[ 512 ];
+
+	if( as::FormatFunctionName( function, szFunctionName, sizeof( szFunctionName ) ) )
+		stats.szFunctionName = szFunctionName;
+	else
+		stats.szFunctionName = function.GetName();
+
+	m_Functions.emplace_back( std::move( stats ) );
+
+	const size_t uiIndex = m_Functions.size() - 1;
+
+	m_FunctionIndices.emplace( &function, uiIndex );
+
+	return uiIndex;
+}
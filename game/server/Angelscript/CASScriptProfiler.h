@@ -0,0 +1,164 @@
+#ifndef GAME_SERVER_ANGELSCRIPT_CASSCRIPTPROFILER_H
+#define GAME_SERVER_ANGELSCRIPT_CASSCRIPTPROFILER_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CStopwatch.h"
+
+class asIScriptContext;
+class asIScriptEngine;
+class asIScriptFunction;
+class CASModule;
+
+/**
+*	Sampling profiler for server scripts.
+*	Contexts are handed out by the profiler so it knows which context is running. While profiling, a line callback
+*	accumulates script time and records the call stack every time the sample interval has elapsed.
+*	When not profiling, the only cost is handing out contexts from the profiler's own pool.
+*/
+class CASScriptProfiler final
+{
+public:
+	/**
+	*	Default time between samples, in microseconds.
+	*/
+	static const long long DEFAULT_SAMPLE_INTERVAL = 100;
+
+private:
+	/**
+	*	Sampled time for a single function.
+	*/
+	struct FunctionStats final
+	{
+		std::string szModuleName;
+		std::string szFunctionName;
+
+		unsigned int uiSamples = 0;
+
+		//In nanoseconds.
+		long long iInclusiveTime = 0;
+		long long iExclusiveTime = 0;
+	};
+
+	/**
+	*	A context that is currently executing, or suspended while another context executes.
+	*/
+	struct ActiveContext final
+	{
+		asIScriptContext* pContext;
+
+		//Start of the time that hasn't been accounted for yet.
+		CStopwatch::Clock_t::time_point lastTime;
+	};
+
+	using FunctionIndices_t = std::unordered_map<const asIScriptFunction*, size_t>;
+	using Stack_t = std::vector<size_t>;
+	using Stacks_t = std::map<Stack_t, long long>;
+
+public:
+	CASScriptProfiler() = default;
+	~CASScriptProfiler() = default;
+
+	/**
+	*	Installs the context callbacks on the given engine.
+	*/
+	void Initialize( asIScriptEngine& engine );
+
+	/**
+	*	Releases all pooled contexts and removes the context callbacks.
+	*/
+	void Shutdown();
+
+	bool IsProfiling() const { return m_bProfiling; }
+
+	/**
+	*	Starts profiling. Clears data from previous runs.
+	*	@param iSampleInterval Time between samples, in microseconds.
+	*/
+	void Start( const long long iSampleInterval );
+
+	void Stop();
+
+	/**
+	*	Must be called before a module is removed so its functions are no longer tracked.
+	*	Data gathered for the module is kept.
+	*/
+	void RemoveModule( CASModule* pModule );
+
+	/**
+	*	Must be called before executing a context that was not acquired using asIScriptEngine::RequestContext.
+	*/
+	void EnterContext( asIScriptContext& context );
+
+	/**
+	*	Must be called after executing a context that was passed to EnterContext.
+	*/
+	void LeaveContext( asIScriptContext& context );
+
+	/**
+	*	Prints the functions with the highest exclusive time.
+	*	@param uiMaxFunctions Maximum number of functions to print.
+	*/
+	void PrintReport( const size_t uiMaxFunctions ) const;
+
+	/**
+	*	Writes all sampled stacks in collapsed format, one stack per line with the time in microseconds.
+	*	@return Whether the file was written.
+	*/
+	bool WriteCollapsedStacks( const char* const pszFileName ) const;
+
+private:
+	static asIScriptContext* RequestContext( asIScriptEngine* pEngine, void* pParam );
+
+	static void ReturnContext( asIScriptEngine* pEngine, asIScriptContext* pContext, void* pParam );
+
+	static void LineCallback( asIScriptContext* pContext, void* pParam );
+
+	/**
+	*	Adds the time elapsed since the top context's last update, and samples if the interval has passed.
+	*/
+	void AccumulateTime( asIScriptContext& context, const CStopwatch::Clock_t::time_point now );
+
+	void Sample( asIScriptContext& context, const long long iTime );
+
+	size_t GetFunctionIndex( asIScriptFunction& function );
+
+private:
+	asIScriptEngine* m_pEngine = nullptr;
+
+	std::vector<asIScriptContext*> m_ContextPool;
+
+	std::vector<ActiveContext> m_ActiveContexts;
+
+	bool m_bProfiling = false;
+
+	//All times below are in nanoseconds.
+	long long m_iSampleInterval = DEFAULT_SAMPLE_INTERVAL * 1000;
+
+	//Script time not yet attributed to a sample.
+	long long m_iPendingTime = 0;
+
+	CStopwatch m_ProfileTime;
+	long long m_iTotalProfileTime = 0;
+
+	long long m_iTotalScriptTime = 0;
+
+	std::vector<FunctionStats> m_Functions;
+
+	FunctionIndices_t m_FunctionIndices;
+
+	Stacks_t m_Stacks;
+
+	Stack_t m_Stack;
+
+private:
+	CASScriptProfiler( const CASScriptProfiler& ) = delete;
+	CASScriptProfiler& operator=( const CASScriptProfiler& ) = delete;
+};
+
+extern CASScriptProfiler g_ScriptProfiler;
+
+#endif //GAME_SERVER_ANGELSCRIPT_CASSCRIPTPROFILER_H
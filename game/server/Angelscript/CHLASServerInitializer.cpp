@@ -29,6 +29,7 @@
 
 #include "ScriptAPI/Console/CASCommand.h"
 #include "ScriptAPI/CASSayArgs.h"
+#include "ScriptAPI/ASClientCommands.h"
 
 #if USE_AS_SQL
 #include "Angelscript/ScriptAPI/SQL/ASHLSQL.h"
@@ -68,6 +69,8 @@ bool CHLASServerInitializer::RegisterCoreAPI( CASManager& manager )
 
 	RegisterScriptCCommand( engine );
 
+	RegisterScriptClientCommands( engine );
+
 	RegisterScriptCSayArgs( engine );
 
 #if USE_AS_SQL
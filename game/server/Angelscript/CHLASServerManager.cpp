@@ -2,6 +2,7 @@
 #include "util.h"
 #include "cbase.h"
 #include "gamerules/GameRules.h"
+#include "Server.h"
 
 #include <Angelscript/CASModule.h>
 #include <Angelscript/util/ASExtendAdapter.h>
@@ -11,10 +12,10 @@
 #include <Angelscript/ScriptAPI/SQL/CASSQLThreadPool.h>
 #endif
 
-#include <Angelscript/ScriptAPI/CASScheduler.h>
-
 #include "Angelscript/HLASConstants.h"
 
+#include "Angelscript/ScriptAPI/CASTimerScheduler.h"
+
 #include "Angelscript/CHLASServerInitializer.h"
 
 #include "Angelscript/CASMapModuleBuilder.h"
@@ -25,10 +26,120 @@
 
 #include "ScriptAPI/SQL/ASHLSQL.h"
 
+#include "ScriptAPI/CASEventDispatcher.h"
+
+#include "CASScriptProfiler.h"
+
+#include "CClientCommandTable.h"
+
 #include "CHLASServerManager.h"
 
 CHLASServerManager g_ASManager;
 
+static void PrintSchedulerStats( CASModule* pModule )
+{
+	auto pScheduler = CASModule_FindScheduler( pModule );
+
+	if( !pScheduler )
+	{
+		Alert( at_console, "%-24s no scheduler\n", pModule->GetModuleName() );
+		return;
+	}
+
+	Alert( at_console, "%-24s pending: %6u peak: %6u last think calls: %6u total calls: %10llu total time: %10.3f ms worst think: %8lld us\n",
+		   pModule->GetModuleName(),
+		   pScheduler->GetFunctionCount(), pScheduler->GetPeakFunctionCount(), pScheduler->GetLastThinkCallCount(),
+		   pScheduler->GetTotalCallCount(), pScheduler->GetTotalThinkTime() / 1000.0, pScheduler->GetWorstThinkTime() );
+}
+
+static void ServerCommand_SchedulerStats()
+{
+	if( auto pModule = g_ASManager.GetMapModule() )
+	{
+		PrintSchedulerStats( pModule );
+	}
+
+	auto& pluginManager = g_ASManager.GetPluginManager();
+
+	for( size_t uiIndex = 0; uiIndex < pluginManager.GetPluginCount(); ++uiIndex )
+	{
+		PrintSchedulerStats( pluginManager.GetPluginByIndex( uiIndex ) );
+	}
+}
+
+static void ServerCommand_EventStats()
+{
+	if( CMD_ARGC() >= 2 && FStrEq( CMD_ARGV( 1 ), "reset" ) )
+	{
+		g_EventDispatcher.ResetStats();
+		Alert( at_console, "Event statistics reset\n" );
+		return;
+	}
+
+	g_EventDispatcher.DumpStats();
+}
+
+static void ServerCommand_ProfileStart()
+{
+	long long iInterval = CASScriptProfiler::DEFAULT_SAMPLE_INTERVAL;
+
+	if( CMD_ARGC() >= 2 )
+		iInterval = strtoll( CMD_ARGV( 1 ), nullptr, 10 );
+
+	if( iInterval <= 0 )
+	{
+		Alert( at_console, "Usage: as_profile_start [sample interval in microseconds]\n" );
+		return;
+	}
+
+	g_ScriptProfiler.Start( iInterval );
+
+	Alert( at_console, "Script profiling started, sample interval %lld us\n", iInterval );
+}
+
+static void ServerCommand_ProfileStop()
+{
+	if( !g_ScriptProfiler.IsProfiling() )
+	{
+		Alert( at_console, "Not profiling\n" );
+		return;
+	}
+
+	g_ScriptProfiler.Stop();
+
+	Alert( at_console, "Script profiling stopped\n" );
+}
+
+static void ServerCommand_ProfileReport()
+{
+	const int iCount = CMD_ARGC() >= 2 ? atoi( CMD_ARGV( 1 ) ) : 20;
+
+	g_ScriptProfiler.PrintReport( static_cast<size_t>( max( 1, iCount ) ) );
+}
+
+static void ServerCommand_ProfileDump()
+{
+	if( CMD_ARGC() < 2 )
+	{
+		Alert( at_console, "Usage: as_profile_dump <filename>\n" );
+		return;
+	}
+
+	if( g_ScriptProfiler.WriteCollapsedStacks( CMD_ARGV( 1 ) ) )
+		Alert( at_console, "Wrote collapsed stacks to \"%s\"\n", CMD_ARGV( 1 ) );
+	else
+		Alert( at_console, "Couldn't open \"%s\" for writing\n", CMD_ARGV( 1 ) );
+}
+
+#if USE_AS_SQL
+static void ServerCommand_SQLStats()
+{
+	Alert( at_console, "SQL worker threads: %u\n", static_cast<unsigned int>( g_pSQLThreadPools->GetThreadCount() ) );
+	Alert( at_console, "Completed commands waiting: %u\n", static_cast<unsigned int>( g_pSQLThreadPools->GetQueueSize() ) );
+	Alert( at_console, "Average completion cost: %.2f us (budget %.2f ms)\n", g_pSQLThreadPools->GetItemCost(), as_sql_frame_budget.value );
+}
+#endif
+
 CHLASServerManager::CHLASServerManager()
 	: m_PluginManager( *this )
 {
@@ -41,9 +152,22 @@ bool CHLASServerManager::Initialize()
 	if( !InitializeManager( initializer ) )
 		return false;
 
+	g_ScriptProfiler.Initialize( *m_Manager.GetEngine() );
+
 	if( !m_PluginManager.Initialize() )
 		return false;
 
+	g_engfuncs.pfnAddServerCommand( "as_scheduler_stats", &::ServerCommand_SchedulerStats );
+	g_engfuncs.pfnAddServerCommand( "as_event_stats", &::ServerCommand_EventStats );
+	g_engfuncs.pfnAddServerCommand( "as_profile_start", &::ServerCommand_ProfileStart );
+	g_engfuncs.pfnAddServerCommand( "as_profile_stop", &::ServerCommand_ProfileStop );
+	g_engfuncs.pfnAddServerCommand( "as_profile_report", &::ServerCommand_ProfileReport );
+	g_engfuncs.pfnAddServerCommand( "as_profile_dump", &::ServerCommand_ProfileDump );
+
+#if USE_AS_SQL
+	g_engfuncs.pfnAddServerCommand( "as_sql_stats", &::ServerCommand_SQLStats );
+#endif
+
 	//Map scripts are per-map scripts that always have their hooks executed before any other module.
 	auto descriptor = m_Manager.GetModuleManager().AddDescriptor( "MapScript", ModuleAccessMask::MAPSCRIPT, as::ModulePriority::HIGHEST );
 
@@ -74,17 +198,25 @@ void CHLASServerManager::Shutdown()
 	g_CustomEntities.Shutdown();
 
 #if USE_AS_SQL
-	g_pSQLThreadPool->Stop( false );
+	g_pSQLThreadPools->Stop( false );
 #endif
 
 	if( m_pModule )
 	{
+		CASModule_ClearScheduler( m_pModule );
+		g_EventDispatcher.RemoveModule( m_pModule );
+		g_ScriptProfiler.RemoveModule( m_pModule );
+		g_ClientCommands.RemoveCommandsByOwner( m_pModule );
 		m_Manager.GetModuleManager().RemoveModule( m_pModule );
 		m_pModule = nullptr;
 	}
 
 	m_PluginManager.Shutdown();
 
+	g_EventDispatcher.Shutdown();
+
+	g_ScriptProfiler.Shutdown();
+
 	CHLASManager::Shutdown();
 }
 
@@ -92,12 +224,12 @@ void CHLASServerManager::Think()
 {
 #if USE_AS_SQL
 	CASOwningContext ctx( *m_Manager.GetEngine() );
-	g_pSQLThreadPool->ProcessQueue( *ctx.GetContext() );
+	g_pSQLThreadPools->ProcessQueues( *ctx.GetContext(), static_cast<long long>( as_sql_frame_budget.value * 1000 ) );
 #endif
 
 	if( m_pModule )
 	{
-		m_pModule->GetScheduler()->Think( gpGlobals->time );
+		CASModule_GetScheduler( m_pModule )->Think( gpGlobals->time );
 	}
 
 	m_PluginManager.Think();
@@ -135,8 +267,14 @@ void CHLASServerManager::WorldCreated( const char* const pszMapScriptFileName )
 {
 	CASMapModuleBuilder builder( pszMapScriptFileName );
 
+	builder.SetUseCache( as_script_cache.value != 0 );
+
 	m_pModule = m_Manager.GetModuleManager().BuildModule( "MapScript", "MapModule", builder );
 
+	//The cached bytecode couldn't be loaded, compile from source instead.
+	if( !m_pModule && builder.IsLoadedFromCache() )
+		m_pModule = m_Manager.GetModuleManager().BuildModule( "MapScript", "MapModule", builder );
+
 	if( !m_pModule )
 	{
 		ALERT( at_console, "Failed to create map script\n" );
@@ -199,6 +337,10 @@ void CHLASServerManager::WorldEnded()
 
 	if( m_pModule )
 	{
+		CASModule_ClearScheduler( m_pModule );
+		g_EventDispatcher.RemoveModule( m_pModule );
+		g_ScriptProfiler.RemoveModule( m_pModule );
+		g_ClientCommands.RemoveCommandsByOwner( m_pModule );
 		m_Manager.GetModuleManager().RemoveModule( m_pModule );
 		m_pModule = nullptr;
 	}
@@ -20,6 +20,11 @@ public:
 
 	CASPluginManager& GetPluginManager() { return m_PluginManager; }
 
+	/**
+	*	@return The map script module, or null if no map script is loaded.
+	*/
+	CASModule* GetMapModule() { return m_pModule; }
+
 	bool Initialize() override;
 
 	void Shutdown() override;
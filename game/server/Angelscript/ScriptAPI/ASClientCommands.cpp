@@ -0,0 +1,82 @@
+#include <string>
+#include <vector>
+
+#include <angelscript.h>
+
+#include <Angelscript/CASModule.h>
+#include <Angelscript/util/CASRefPtr.h>
+#include <Angelscript/wrapper/ASCallable.h>
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "CBasePlayer.h"
+
+#include "CClientCommandTable.h"
+
+#include "Console/CASCommand.h"
+
+#include "ASClientCommands.h"
+
+static void CallScriptClientCommand( asIScriptFunction* pFunction, CBasePlayer& player )
+{
+	std::vector<char*> args;
+
+	args.reserve( CMD_ARGC() );
+
+	for( int iArg = 0; iArg < CMD_ARGC(); ++iArg )
+	{
+		args.push_back( const_cast<char*>( CMD_ARGV( iArg ) ) );
+	}
+
+	CASRefPtr<CASCommand> command( new CASCommand( static_cast<int>( args.size() ), args.data() ), true );
+
+	as::Call( pFunction, &player, command.Get() );
+}
+
+static bool ClientCommands_Register( const std::string& szName, asIScriptFunction* pFunction, const float flRate, const float flBurst )
+{
+	//Take ownership of the handle.
+	CASRefPtr<asIScriptFunction> function( pFunction, true );
+
+	auto pModule = GetModuleFromScriptContext( asGetActiveContext() );
+
+	if( !pModule || !function || szName.empty() )
+		return false;
+
+	return g_ClientCommands.Add( szName.c_str(),
+		[ function ]( CBasePlayer& player ) mutable
+		{
+			CallScriptClientCommand( function.Get(), player );
+		},
+		ClientCommandRate( flRate, flBurst ), pModule );
+}
+
+static bool ClientCommands_Unregister( const std::string& szName )
+{
+	auto pModule = GetModuleFromScriptContext( asGetActiveContext() );
+
+	if( !pModule )
+		return false;
+
+	return g_ClientCommands.Remove( szName.c_str(), pModule );
+}
+
+void RegisterScriptClientCommands( asIScriptEngine& engine )
+{
+	engine.RegisterFuncdef( "void ClientCommandCallback(CBasePlayer@ pPlayer, const CCommand@ args)" );
+
+	const std::string szOldNS = engine.GetDefaultNamespace();
+
+	engine.SetDefaultNamespace( "ClientCommands" );
+
+	engine.RegisterGlobalFunction(
+		"bool Register(const string& in szName, ClientCommandCallback@ pCallback, float flRate = 0, float flBurst = 0)",
+		asFUNCTION( ClientCommands_Register ), asCALL_CDECL );
+
+	engine.RegisterGlobalFunction(
+		"bool Unregister(const string& in szName)",
+		asFUNCTION( ClientCommands_Unregister ), asCALL_CDECL );
+
+	engine.SetDefaultNamespace( szOldNS.c_str() );
+}
@@ -0,0 +1,13 @@
+#ifndef GAME_SERVER_ANGELSCRIPT_SCRIPTAPI_ASCLIENTCOMMANDS_H
+#define GAME_SERVER_ANGELSCRIPT_SCRIPTAPI_ASCLIENTCOMMANDS_H
+
+class asIScriptEngine;
+
+/**
+*	Registers the ClientCommands namespace, which lets scripts add commands to the client command table.
+*	Commands are owned by the module that registered them and are removed when it is unloaded.
+*	@param engine Script engine.
+*/
+void RegisterScriptClientCommands( asIScriptEngine& engine );
+
+#endif //GAME_SERVER_ANGELSCRIPT_SCRIPTAPI_ASCLIENTCOMMANDS_H
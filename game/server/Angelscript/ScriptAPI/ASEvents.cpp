@@ -7,17 +7,21 @@
 //TODO: avoid using server specific code here. - Solokiller
 #include "Angelscript/CHLASServerManager.h"
 
+#include "CASEventDispatcher.h"
+
 #include "ASEvents.h"
 
 HookCallResult CallGlobalEvent( CASEvent& event, CallFlags_t flags, ... )
 {
+	//Most events aren't hooked by anything; avoid all call setup in that case.
+	if( event.GetFunctionCount() == 0 )
+		return HookCallResult::NONE_HANDLED;
+
 	va_list list;
 
 	va_start( list, flags );
 
-	CASEventCaller caller;
-
-	const auto result = caller.VCall( event, g_ASManager.GetASManager().GetEngine(), flags, list );
+	const auto result = g_EventDispatcher.VCall( event, *g_ASManager.GetASManager().GetEngine(), flags, list );
 
 	va_end( list );
 
@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <vector>
+
+#include <angelscript.h>
+
+#include <Angelscript/CASModule.h>
+#include <Angelscript/util/ASUtil.h>
+#include <Angelscript/wrapper/ASCallable.h>
+
+#include "extdll.h"
+#include "util.h"
+#include "Server.h"
+
+#include "CStopwatch.h"
+
+#include "Angelscript/CASScriptProfiler.h"
+
+#include "CASEventDispatcher.h"
+
+CASEventDispatcher g_EventDispatcher;
+
+/**
+*	Event caller that forwards to the dispatcher. The base class takes care of the event's call bookkeeping.
+*/
+class CASDispatchEventCaller final : public CASBaseEventCaller<CASDispatchEventCaller, CASEvent, HookCallResult, HookCallResult::FAILED>
+{
+public:
+	CASDispatchEventCaller( CASEventDispatcher& dispatcher )
+		: m_Dispatcher( dispatcher )
+	{
+	}
+
+	ReturnType_t CallEvent( EventType_t& event, asIScriptContext* pContext, CallFlags_t flags, va_list list )
+	{
+		return m_Dispatcher.CallHooks( event, *pContext, flags, list );
+	}
+
+private:
+	CASEventDispatcher& m_Dispatcher;
+};
+
+HookCallResult CASEventDispatcher::VCall( CASEvent& event, asIScriptEngine& scriptEngine, CallFlags_t flags, va_list list )
+{
+	//Nothing hooked, nothing to do.
+	if( event.GetFunctionCount() == 0 )
+		return HookCallResult::NONE_HANDLED;
+
+	bool bIsCached;
+
+	auto pContext = AcquireContext( event, scriptEngine, bIsCached );
+
+	//Pooled contexts are tracked by the profiler when they are requested.
+	if( bIsCached )
+		g_ScriptProfiler.EnterContext( *pContext );
+
+	CASDispatchEventCaller caller( *this );
+
+	const auto result = caller.VCall( event, pContext, flags, list );
+
+	if( bIsCached )
+		g_ScriptProfiler.LeaveContext( *pContext );
+	else
+		scriptEngine.ReturnContext( pContext );
+
+	return result;
+}
+
+void CASEventDispatcher::RemoveModule( CASModule* pModule )
+{
+	//Cached contexts may still be prepared with one of the module's functions, which would keep it alive.
+	for( auto& context : m_Contexts )
+	{
+		context.second->Unprepare();
+	}
+
+	for( auto it = m_HookStats.begin(); it != m_HookStats.end(); )
+	{
+		if( it->second.pModule == pModule )
+			it = m_HookStats.erase( it );
+		else
+			++it;
+	}
+}
+
+void CASEventDispatcher::ResetStats()
+{
+	m_HookStats.clear();
+}
+
+void CASEventDispatcher::DumpStats() const
+{
+	if( !as_event_profile.value )
+	{
+		Alert( at_console, "Event profiling is disabled, set as_event_profile to 1 to enable it\n" );
+	}
+
+	std::vector<const HookStats*> stats;
+
+	stats.reserve( m_HookStats.size() );
+
+	for( const auto& hook : m_HookStats )
+	{
+		stats.push_back( &hook.second );
+	}
+
+	//Group by module, most expensive first.
+	std::sort( stats.begin(), stats.end(), []( const HookStats* pLHS, const HookStats* pRHS )
+		{
+			if( pLHS->szModuleName != pRHS->szModuleName )
+				return pLHS->szModuleName < pRHS->szModuleName;
+
+			return pLHS->iTotalTime > pRHS->iTotalTime;
+		}
+	);
+
+	const std::string* pszCurrentModule = nullptr;
+
+	long long iModuleTime = 0;
+
+	for( auto pStats : stats )
+	{
+		if( !pszCurrentModule || *pszCurrentModule != pStats->szModuleName )
+		{
+			if( pszCurrentModule )
+				Alert( at_console, "Module total: %.3f ms\n\n", iModuleTime / 1000.0 );
+
+			pszCurrentModule = &pStats->szModuleName;
+			iModuleTime = 0;
+
+			Alert( at_console, "Module \"%s\":\n", pszCurrentModule->c_str() );
+		}
+
+		iModuleTime += pStats->iTotalTime;
+
+		Alert( at_console, "%-20s %-40s calls: %10llu total: %10.3f ms avg: %8.2f us worst: %8lld us\n",
+			   pStats->szEventName.c_str(), pStats->szFunctionName.c_str(),
+			   pStats->uiCallCount, pStats->iTotalTime / 1000.0,
+			   pStats->uiCallCount ? static_cast<double>( pStats->iTotalTime ) / pStats->uiCallCount : 0.0,
+			   pStats->iWorstTime );
+	}
+
+	if( pszCurrentModule )
+		Alert( at_console, "Module total: %.3f ms\n", iModuleTime / 1000.0 );
+
+	Alert( at_console, "%u hooked functions profiled\n", static_cast<unsigned int>( stats.size() ) );
+}
+
+void CASEventDispatcher::Shutdown()
+{
+	for( auto& context : m_Contexts )
+	{
+		context.second->Release();
+	}
+
+	m_Contexts.clear();
+
+	m_HookStats.clear();
+}
+
+asIScriptContext* CASEventDispatcher::AcquireContext( CASEvent& event, asIScriptEngine& scriptEngine, bool& bOutIsCached )
+{
+	//The cached context is in use further up the call stack.
+	if( event.IsTriggering() )
+	{
+		bOutIsCached = false;
+		return scriptEngine.RequestContext();
+	}
+
+	bOutIsCached = true;
+
+	auto it = m_Contexts.find( &event );
+
+	if( it != m_Contexts.end() )
+		return it->second;
+
+	auto pContext = scriptEngine.CreateContext();
+
+	m_Contexts.emplace( &event, pContext );
+
+	return pContext;
+}
+
+HookCallResult CASEventDispatcher::CallHooks( CASEvent& event, asIScriptContext& context, CallFlags_t flags, va_list list )
+{
+	const bool bProfile = as_event_profile.value != 0;
+
+	const auto stopMode = event.GetStopMode();
+
+	bool bHandled = false;
+
+	const CASModule* pLastModule = nullptr;
+
+	for( size_t uiIndex = 0; uiIndex < event.GetFunctionCount(); ++uiIndex )
+	{
+		auto pFunction = event.GetFunctionByIndex( uiIndex );
+
+		//Unhooked during this call.
+		if( !pFunction )
+			continue;
+
+		if( stopMode == EventStopMode::MODULE_HANDLED && bHandled )
+		{
+			//Finish calling the module that handled it.
+			if( GetModuleFromScriptFunction( pFunction ) != pLastModule )
+				break;
+		}
+
+		pLastModule = GetModuleFromScriptFunction( pFunction );
+
+		va_list functionList;
+
+		va_copy( functionList, list );
+
+		//Only read the clock when profiling.
+		const auto start = bProfile ? CStopwatch::Clock_t::now() : CStopwatch::Clock_t::time_point();
+
+		const bool bSuccess = as::VCall( &context, flags, pFunction, functionList );
+
+		if( bProfile )
+		{
+			const long long iElapsed = std::chrono::duration_cast<std::chrono::microseconds>( CStopwatch::Clock_t::now() - start ).count();
+
+			auto& stats = GetHookStats( event, *pFunction );
+
+			++stats.uiCallCount;
+			stats.iTotalTime += iElapsed;
+			stats.iWorstTime = std::max( stats.iWorstTime, iElapsed );
+		}
+
+		va_end( functionList );
+
+		if( !bSuccess )
+			continue;
+
+		if( static_cast<HookReturnCode>( context.GetReturnDWord() ) == HookReturnCode::HANDLED )
+		{
+			bHandled = true;
+
+			if( stopMode == EventStopMode::ON_HANDLED )
+				break;
+		}
+	}
+
+	return bHandled ? HookCallResult::HANDLED : HookCallResult::NONE_HANDLED;
+}
+
+CASEventDispatcher::HookStats& CASEventDispatcher::GetHookStats( const CASEvent& event, asIScriptFunction& function )
+{
+	auto it = m_HookStats.find( &function );
+
+	if( it != m_HookStats.end() )
+		return it->second;
+
+	HookStats stats;
+
+	stats.pModule = GetModuleFromScriptFunction( &function );
+	stats.szModuleName = stats.pModule ? stats.pModule->GetModuleName() : "Unknown";
+	stats.szEventName = event.GetName();
+
+	char szFunctionName[ 512 ];
+
+	if( as::FormatFunctionName( function, szFunctionName, sizeof( szFunctionName ) ) )
+		stats.szFunctionName = szFunctionName;
+	else
+		stats.szFunctionName = function.GetName();
+
+	return m_HookStats.emplace( &function, std::move( stats ) ).first->second;
+}
@@ -0,0 +1,108 @@
+#ifndef GAME_SERVER_ANGELSCRIPT_SCRIPTAPI_CASEVENTDISPATCHER_H
+#define GAME_SERVER_ANGELSCRIPT_SCRIPTAPI_CASEVENTDISPATCHER_H
+
+#include <cstdarg>
+#include <string>
+#include <unordered_map>
+
+#include <angelscript.h>
+
+#include <Angelscript/event/CASEvent.h>
+#include <Angelscript/event/CASEventCaller.h>
+
+class CASModule;
+class CASDispatchEventCaller;
+
+/**
+*	Calls global events using a context that is kept prepared for each event.
+*	Optionally records per hook timing, controlled by the as_event_profile cvar.
+*/
+class CASEventDispatcher final
+{
+private:
+	friend class CASDispatchEventCaller;
+
+public:
+	/**
+	*	Timing information for a single hooked function.
+	*/
+	struct HookStats final
+	{
+		CASModule* pModule = nullptr;
+
+		std::string szModuleName;
+		std::string szEventName;
+		std::string szFunctionName;
+
+		unsigned long long uiCallCount = 0;
+
+		//In microseconds.
+		long long iTotalTime = 0;
+		long long iWorstTime = 0;
+	};
+
+private:
+	using Contexts_t = std::unordered_map<const CASEvent*, asIScriptContext*>;
+	using HookStats_t = std::unordered_map<const asIScriptFunction*, HookStats>;
+
+public:
+	CASEventDispatcher() = default;
+	~CASEventDispatcher() = default;
+
+	/**
+	*	Calls the given event.
+	*	@param event Event to call.
+	*	@param scriptEngine Script engine.
+	*	@param flags Call flags.
+	*	@param list Event arguments.
+	*/
+	HookCallResult VCall( CASEvent& event, asIScriptEngine& scriptEngine, CallFlags_t flags, va_list list );
+
+	/**
+	*	Removes all timing information for the given module and releases cached references to its functions.
+	*	Must be called before a module is removed.
+	*/
+	void RemoveModule( CASModule* pModule );
+
+	/**
+	*	Clears all timing information.
+	*/
+	void ResetStats();
+
+	/**
+	*	Prints timing information for all hooks, grouped by module.
+	*/
+	void DumpStats() const;
+
+	/**
+	*	Releases all cached contexts.
+	*/
+	void Shutdown();
+
+private:
+	/**
+	*	Gets the context to use for the given event.
+	*	Events triggered from inside their own hooks get a context from the engine's pool.
+	*/
+	asIScriptContext* AcquireContext( CASEvent& event, asIScriptEngine& scriptEngine, bool& bOutIsCached );
+
+	/**
+	*	Calls all functions hooked into the given event.
+	*/
+	HookCallResult CallHooks( CASEvent& event, asIScriptContext& context, CallFlags_t flags, va_list list );
+
+	HookStats& GetHookStats( const CASEvent& event, asIScriptFunction& function );
+
+private:
+	Contexts_t m_Contexts;
+
+	HookStats_t m_HookStats;
+
+private:
+	CASEventDispatcher( const CASEventDispatcher& ) = delete;
+	CASEventDispatcher& operator=( const CASEventDispatcher& ) = delete;
+};
+
+extern CASEventDispatcher g_EventDispatcher;
+
+#endif //GAME_SERVER_ANGELSCRIPT_SCRIPTAPI_CASEVENTDISPATCHER_H
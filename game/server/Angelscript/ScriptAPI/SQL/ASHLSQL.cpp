@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <cstdarg>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -28,6 +30,8 @@
 #include "xml/XMLUtils.h"
 #include "xml/CXStr.h"
 
+#include "CStopwatch.h"
+
 #include "ASHLSQL.h"
 
 #define SQLITE_BASE_DIR "scripts/databases"
@@ -35,6 +39,9 @@
 
 #define MYSQL_DEFAULT_CONN_BLOCK "default_mysql_connection"
 
+//Upper limit for the automatically calculated thread count. Servers that need more can set as_sql_threads explicitly.
+#define SQL_MAX_AUTO_THREADS 4
+
 static void SQLLogFunc( const char* const pszFormat, ... )
 {
 	char szBuffer[ 4096 ];
@@ -58,16 +65,132 @@ static void SQLLogFunc( const char* const pszFormat, ... )
 
 static size_t CalculateThreadCount()
 {
+	const int iRequested = static_cast<int>( as_sql_threads.value );
+
+	if( iRequested > 0 )
+		return static_cast<size_t>( iRequested );
+
+	//Leave a core for the main thread.
 	const unsigned int uiThreads = std::thread::hardware_concurrency();
 
-	//Only use 1 thread for now. - Solokiller
-	if( uiThreads >= 1 )
+	if( uiThreads <= 1 )
 		return 1;
 
-	return 0;
+	return std::min<size_t>( uiThreads - 1, SQL_MAX_AUTO_THREADS );
 }
 
-CASSQLThreadPool* g_pSQLThreadPool = nullptr;
+CHLSQLThreadPools* g_pSQLThreadPools = nullptr;
+
+CHLSQLThreadPools::CHLSQLThreadPools()
+{
+}
+
+CHLSQLThreadPools::~CHLSQLThreadPools()
+{
+}
+
+size_t CHLSQLThreadPools::GetQueueSize() const
+{
+	size_t uiSize = 0;
+
+	for( const auto& pool : m_Pools )
+	{
+		uiSize += pool->GetThreadQueue().GetQueueSize();
+	}
+
+	return uiSize;
+}
+
+CASSQLThreadPool& CHLSQLThreadPools::GetPoolForDatabase( const std::string& szFilename )
+{
+	Start();
+
+	return *m_Pools[ std::hash<std::string>()( szFilename ) % m_Pools.size() ];
+}
+
+CASSQLThreadPool& CHLSQLThreadPools::GetNextPool()
+{
+	Start();
+
+	auto& pool = *m_Pools[ m_uiNextPool ];
+
+	m_uiNextPool = ( m_uiNextPool + 1 ) % m_Pools.size();
+
+	return pool;
+}
+
+bool CHLSQLThreadPools::ProcessQueues( asIScriptContext& context, const long long iBudget )
+{
+	//Started here as well so the count is read once the server config has run, even if no script uses SQL.
+	Start();
+
+	CStopwatch stopwatch;
+
+	bool bDidWork = false;
+	bool bProcessedItems = false;
+
+	for( size_t uiProcessed = 0; uiProcessed < m_Pools.size(); ++uiProcessed )
+	{
+		auto& pool = *m_Pools[ m_uiNextProcessPool ];
+
+		const size_t uiPending = pool.GetThreadQueue().GetQueueSize();
+
+		if( uiPending > 0 && bProcessedItems )
+		{
+			const long long iRemaining = iBudget - stopwatch.GetElapsedMicroseconds();
+
+			if( uiPending * m_flItemCost > iRemaining )
+				break;
+		}
+
+		m_uiNextProcessPool = ( m_uiNextProcessPool + 1 ) % m_Pools.size();
+
+		const long long iStart = stopwatch.GetElapsedMicroseconds();
+
+		//Always process, this also outputs log messages from the worker.
+		bDidWork = pool.ProcessQueue( context ) || bDidWork;
+
+		if( uiPending > 0 )
+		{
+			bProcessedItems = true;
+
+			//Commands that completed while processing are included in the time but not the count, which errs on the side of overestimating.
+			const double flCost = static_cast<double>( stopwatch.GetElapsedMicroseconds() - iStart ) / uiPending;
+
+			m_flItemCost = m_flItemCost > 0 ? m_flItemCost * 0.75 + flCost * 0.25 : flCost;
+		}
+
+		if( stopwatch.GetElapsedMicroseconds() >= iBudget )
+			break;
+	}
+
+	return bDidWork;
+}
+
+void CHLSQLThreadPools::Start()
+{
+	if( !m_Pools.empty() )
+		return;
+
+	const size_t uiThreadCount = CalculateThreadCount();
+
+	m_Pools.reserve( uiThreadCount );
+
+	for( size_t uiIndex = 0; uiIndex < uiThreadCount; ++uiIndex )
+	{
+		m_Pools.emplace_back( std::make_unique<CASSQLThreadPool>( 1, &::SQLLogFunc ) );
+	}
+
+	Alert( at_console, "SQL: Using %u worker threads\n", static_cast<unsigned int>( m_Pools.size() ) );
+}
+
+void CHLSQLThreadPools::Stop( const bool bWait )
+{
+	for( auto& pool : m_Pools )
+	{
+		pool->Stop( bWait );
+	}
+}
 
 static CASSQLiteConnection* HLCreateSQLiteConnection( const std::string& szDatabase )
 {
@@ -98,7 +221,7 @@ static CASSQLiteConnection* HLCreateSQLiteConnection( const std::string& szDatab
 
 	//TODO: filter access to databases here so only authorized access works - Solokiller
 
-	return new CASSQLiteConnection( *g_pSQLThreadPool, szFilename );
+	return new CASSQLiteConnection( g_pSQLThreadPools->GetPoolForDatabase( szFilename ), szFilename );
 }
 
 static unsigned int ParseMySQLPort( std::string& szHostName )
@@ -126,7 +249,7 @@ static CASMySQLConnection* HLCreateMySQLConnection( const std::string& szHost, c
 
 	const unsigned int uiPort = ParseMySQLPort( szHostName );
 
-	return new CASMySQLConnection( *g_pSQLThreadPool, szHostName.c_str(), szUser.c_str(), szPassword.c_str(), szDatabase.c_str(), uiPort, "", 0 );
+	return new CASMySQLConnection( g_pSQLThreadPools->GetNextPool(), szHostName.c_str(), szUser.c_str(), szPassword.c_str(), szDatabase.c_str(), uiPort, "", 0 );
 }
 
 /**
@@ -247,12 +370,12 @@ static CASMySQLConnection* HLCreateMySQLConnectionWithDefaults( const std::strin
 
 	const unsigned int uiPort = ParseMySQLPort( szHostName );
 
-	return new CASMySQLConnection( *g_pSQLThreadPool, szHostName.c_str(), szUser.LocalForm(), szPass.LocalForm(), szDatabase.c_str(), uiPort, "", 0 );
+	return new CASMySQLConnection( g_pSQLThreadPools->GetNextPool(), szHostName.c_str(), szUser.LocalForm(), szPass.LocalForm(), szDatabase.c_str(), uiPort, "", 0 );
 }
 
 void RegisterScriptHLSQL( asIScriptEngine& engine )
 {
-	g_pSQLThreadPool = new CASSQLThreadPool( CalculateThreadCount(), &::SQLLogFunc );
+	g_pSQLThreadPools = new CHLSQLThreadPools();
 
 	//Call an SQLite function to load the library. - Solokiller
 	Alert( at_console, "SQLite library version: %s\n", sqlite3_libversion() );
@@ -1,11 +1,93 @@
 #ifndef GAME_SERVER_ANGELSCRIPT_SCRIPTAPI_SQL_ASHLSQL_H
 #define GAME_SERVER_ANGELSCRIPT_SCRIPTAPI_SQL_ASHLSQL_H
 
+#include <memory>
+#include <string>
+#include <vector>
+
+class asIScriptContext;
 class asIScriptEngine;
 class CASSQLThreadPool;
 
-extern CASSQLThreadPool* g_pSQLThreadPool;
+/**
+*	Set of single threaded SQL thread pools.
+*	Each connection is bound to one pool, so commands issued on a connection are executed and completed in order,
+*	while commands for different connections can run in parallel.
+*	The pools are started on first use rather than when scripts are registered, so as_sql_threads can be set in the server config.
+*/
+class CHLSQLThreadPools final
+{
+private:
+	using Pools_t = std::vector<std::unique_ptr<CASSQLThreadPool>>;
+
+public:
+	CHLSQLThreadPools();
+	~CHLSQLThreadPools();
+
+	/**
+	*	@return Number of worker threads. 0 if the pools haven't been started yet.
+	*/
+	size_t GetThreadCount() const { return m_Pools.size(); }
+
+	/**
+	*	@return Number of completed commands waiting to be processed.
+	*/
+	size_t GetQueueSize() const;
+
+	/**
+	*	@return Estimated time it takes to process a completed command, in microseconds.
+	*/
+	double GetItemCost() const { return m_flItemCost; }
+
+	/**
+	*	Gets the pool to use for a SQLite database. Connections to the same database share a pool to avoid lock contention between workers.
+	*	@param szFilename Database filename.
+	*/
+	CASSQLThreadPool& GetPoolForDatabase( const std::string& szFilename );
+
+	/**
+	*	Gets the pool to use for a new connection. Pools are assigned round robin.
+	*/
+	CASSQLThreadPool& GetNextPool();
+
+	/**
+	*	Invokes callbacks for completed commands.
+	*	The SQL library processes a pool's completions as a batch, so the budget is charged per completed command using the measured cost of a command:
+	*	a pool is skipped if its pending commands won't fit in what's left of the budget. The next call resumes at the first pool that was skipped.
+	*	@param context Context to use for callbacks.
+	*	@param iBudget Time budget, in microseconds. The first pool with pending commands is always processed so that large batches still make progress.
+	*	@return Whether any work was done.
+	*/
+	bool ProcessQueues( asIScriptContext& context, const long long iBudget );
+
+	/**
+	*	Stops all threads.
+	*	@see CASSQLThreadPool::Stop
+	*/
+	void Stop( const bool bWait = false );
+
+private:
+	/**
+	*	Starts the pools if they haven't been started yet.
+	*/
+	void Start();
+
+private:
+	Pools_t m_Pools;
+
+	//Moving average of the time it takes to process a completed command, in microseconds.
+	double m_flItemCost = 0;
+
+	size_t m_uiNextPool = 0;
+	size_t m_uiNextProcessPool = 0;
+
+private:
+	CHLSQLThreadPools( const CHLSQLThreadPools& ) = delete;
+	CHLSQLThreadPools& operator=( const CHLSQLThreadPools& ) = delete;
+};
+
+extern CHLSQLThreadPools* g_pSQLThreadPools;
 
 void RegisterScriptHLSQL( asIScriptEngine& engine );
 
-#endif //GAME_SERVER_ANGELSCRIPT_SCRIPTAPI_SQL_ASHLSQL_H
\ No newline at end of file
+#endif //GAME_SERVER_ANGELSCRIPT_SCRIPTAPI_SQL_ASHLSQL_H
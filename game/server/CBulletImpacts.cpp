@@ -0,0 +1,110 @@
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "gamerules/GameRules.h"
+#include "materials/Materials.h"
+#include "sound/Sound.h"
+#include "UserMessages.h"
+
+#include "CBulletImpacts.h"
+
+CBulletImpacts g_BulletImpacts;
+
+void CBulletImpacts::Begin()
+{
+	if( m_bActive )
+		End();
+
+	m_bActive = true;
+}
+
+void CBulletImpacts::End()
+{
+	SendTracers();
+
+	//Surfaces can move or change between shots.
+	m_Surfaces.clear();
+
+	m_bActive = false;
+
+	for( const auto& impact : m_Impacts )
+	{
+		TEXTURETYPE_PlayHitSound( impact.tr, impact.chTextureType, impact.iBulletType, impact.bBreakable );
+	}
+
+	m_Impacts.clear();
+}
+
+void CBulletImpacts::AddTracer( const Vector& vecSrc, const Vector& vecEnd )
+{
+	//Player tracers are offset using the global vectors, which can change while a shot is being fired.
+	if( !m_TracerEnds.empty() && ( m_TracerEnds.size() >= MAX_TRACERS_PER_MESSAGE || vecSrc != m_vecTracerSrc ) )
+		SendTracers();
+
+	m_vecTracerSrc = vecSrc;
+	m_TracerEnds.push_back( vecEnd );
+
+	if( !m_bActive )
+		SendTracers();
+}
+
+void CBulletImpacts::AddHit( const TraceResult& tr, const Vector& vecSrc, const Vector& vecEnd, const int iBulletType )
+{
+	if( !g_pGameRules->PlayTextureSounds() )
+		return;
+
+	if( !m_bActive )
+	{
+		TEXTURETYPE_PlaySound( tr, vecSrc, vecEnd, iBulletType );
+		return;
+	}
+
+	const char chTextureType = GetTextureType( tr, vecSrc, vecEnd );
+
+	for( const auto& impact : m_Impacts )
+	{
+		if( impact.chTextureType == chTextureType && impact.iBulletType == iBulletType )
+			return;
+	}
+
+	CBaseEntity* pEntity = CBaseEntity::Instance( tr.pHit );
+
+	m_Impacts.push_back( { chTextureType, iBulletType, pEntity && pEntity->ClassnameIs( "func_breakable" ), tr } );
+}
+
+char CBulletImpacts::GetTextureType( const TraceResult& tr, const Vector& vecSrc, const Vector& vecEnd )
+{
+	for( const auto& surface : m_Surfaces )
+	{
+		if( surface.pHit == tr.pHit && surface.flDist == tr.flPlaneDist && surface.vecNormal == tr.vecPlaneNormal )
+			return surface.chTextureType;
+	}
+
+	const char chTextureType = TEXTURETYPE_GetHitType( tr, vecSrc, vecEnd );
+
+	m_Surfaces.push_back( { tr.pHit, tr.vecPlaneNormal, tr.flPlaneDist, chTextureType } );
+
+	return chTextureType;
+}
+
+void CBulletImpacts::SendTracers()
+{
+	if( m_TracerEnds.empty() )
+		return;
+
+	MESSAGE_BEGIN( MSG_PAS, gmsgTracers, m_vecTracerSrc );
+		WRITE_BYTE( m_TracerEnds.size() );
+		WRITE_COORD( m_vecTracerSrc.x );
+		WRITE_COORD( m_vecTracerSrc.y );
+		WRITE_COORD( m_vecTracerSrc.z );
+
+		for( const auto& vecEnd : m_TracerEnds )
+		{
+			WRITE_COORD( vecEnd.x );
+			WRITE_COORD( vecEnd.y );
+			WRITE_COORD( vecEnd.z );
+		}
+	MESSAGE_END();
+
+	m_TracerEnds.clear();
+}
@@ -0,0 +1,103 @@
+#ifndef GAME_SERVER_CBULLETIMPACTS_H
+#define GAME_SERVER_CBULLETIMPACTS_H
+
+#include <vector>
+
+/**
+*	Collects the impacts of all pellets in a single shot.
+*	The material type of each surface that is hit is only looked up once, each material plays at most one strike sound,
+*	and all tracers that share a source are sent to clients in one Tracers message.
+*	Hits and tracers added outside of Begin/End are handled right away.
+*/
+class CBulletImpacts final
+{
+public:
+	/**
+	*	Tracers in a single message: a byte count and the source, followed by an end point for each tracer, all within the 192 byte user message limit.
+	*/
+	static const size_t MAX_TRACERS_PER_MESSAGE = 30;
+
+private:
+	/**
+	*	A surface whose material type was looked up this shot.
+	*/
+	struct Surface final
+	{
+		edict_t* pHit;
+		Vector vecNormal;
+		float flDist;
+		char chTextureType;
+	};
+
+	/**
+	*	The first hit on a material this shot. Its sound is played at the end of the shot.
+	*/
+	struct Impact final
+	{
+		char chTextureType;
+		int iBulletType;
+		bool bBreakable;
+		TraceResult tr;
+	};
+
+	/**
+	*	Most shots hit only a few surfaces.
+	*/
+	static const size_t INITIAL_SURFACE_COUNT = 8;
+
+public:
+	CBulletImpacts()
+	{
+		m_Surfaces.reserve( INITIAL_SURFACE_COUNT );
+		m_Impacts.reserve( INITIAL_SURFACE_COUNT );
+		m_TracerEnds.reserve( MAX_TRACERS_PER_MESSAGE );
+	}
+
+	~CBulletImpacts() = default;
+
+	/**
+	*	Starts collecting impacts for a shot. Impacts for a shot that wasn't ended are played first.
+	*/
+	void Begin();
+
+	/**
+	*	Plays the strike sounds and sends the tracers collected since Begin was called.
+	*/
+	void End();
+
+	/**
+	*	Adds a tracer from vecSrc to vecEnd.
+	*/
+	void AddTracer( const Vector& vecSrc, const Vector& vecEnd );
+
+	/**
+	*	Adds a pellet hit. Its strike sound is played unless another pellet already hit the same material this shot.
+	*	@see TEXTURETYPE_PlaySound
+	*/
+	void AddHit( const TraceResult& tr, const Vector& vecSrc, const Vector& vecEnd, const int iBulletType );
+
+private:
+	/**
+	*	@return Material type of the surface hit by the given trace, looked up once per surface per shot.
+	*/
+	char GetTextureType( const TraceResult& tr, const Vector& vecSrc, const Vector& vecEnd );
+
+	void SendTracers();
+
+private:
+	bool m_bActive = false;
+
+	std::vector<Surface> m_Surfaces;
+	std::vector<Impact> m_Impacts;
+
+	Vector m_vecTracerSrc;
+	std::vector<Vector> m_TracerEnds;
+
+private:
+	CBulletImpacts( const CBulletImpacts& ) = delete;
+	CBulletImpacts& operator=( const CBulletImpacts& ) = delete;
+};
+
+extern CBulletImpacts g_BulletImpacts;
+
+#endif //GAME_SERVER_CBULLETIMPACTS_H
@@ -0,0 +1,252 @@
+#include <algorithm>
+#include <vector>
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "CBasePlayer.h"
+#include "Server.h"
+
+#include "CStopwatch.h"
+
+#include "CClientCommandTable.h"
+
+CClientCommandTable g_ClientCommands;
+
+namespace
+{
+void ServerCommand_CommandStats()
+{
+	if( CMD_ARGC() >= 2 && FStrEq( CMD_ARGV( 1 ), "reset" ) )
+	{
+		g_ClientCommands.ResetStats();
+		Alert( at_console, "Client command statistics reset\n" );
+		return;
+	}
+
+	g_ClientCommands.PrintStats();
+}
+
+/**
+*	@return Index into the bucket arrays for the given player, or -1 if out of range.
+*/
+int GetClientSlot( CBasePlayer& player )
+{
+	const int iSlot = player.entindex() - 1;
+
+	if( iSlot < 0 || iSlot >= CClientCommandTable::MAX_TRACKED_CLIENTS )
+		return -1;
+
+	return iSlot;
+}
+}
+
+void CClientCommandTable::Initialize()
+{
+	g_engfuncs.pfnAddServerCommand( "sv_cmd_stats", &::ServerCommand_CommandStats );
+}
+
+bool CClientCommandTable::Add( const char* const pszName, Handler_t&& handler, const ClientCommandRate& rate, const void* const pOwner )
+{
+	ASSERT( pszName && *pszName );
+	ASSERT( handler );
+
+	if( !pszName || !( *pszName ) || !handler )
+		return false;
+
+	if( m_Commands.find( pszName ) != m_Commands.end() )
+	{
+		Alert( at_console, "CClientCommandTable::Add: client command \"%s\" already exists\n", pszName );
+		return false;
+	}
+
+	auto command = std::make_unique<Command>();
+
+	command->szName = pszName;
+	command->handler = std::move( handler );
+	command->pOwner = pOwner;
+	command->rate = rate;
+
+	m_Commands.emplace( command->szName, std::move( command ) );
+
+	return true;
+}
+
+bool CClientCommandTable::Remove( const char* const pszName, const void* const pOwner )
+{
+	auto it = m_Commands.find( pszName );
+
+	if( it == m_Commands.end() || it->second->pOwner != pOwner )
+		return false;
+
+	//Keep handlers alive until they return.
+	if( m_pExecuting )
+		m_RemovedWhileExecuting.emplace_back( std::move( it->second ) );
+
+	m_Commands.erase( it );
+
+	return true;
+}
+
+void CClientCommandTable::RemoveCommandsByOwner( const void* const pOwner )
+{
+	for( auto it = m_Commands.begin(); it != m_Commands.end(); )
+	{
+		if( it->second->pOwner == pOwner )
+		{
+			if( m_pExecuting )
+				m_RemovedWhileExecuting.emplace_back( std::move( it->second ) );
+
+			it = m_Commands.erase( it );
+		}
+		else
+			++it;
+	}
+}
+
+ClientCommandResult CClientCommandTable::Execute( CBasePlayer& player, const char* const pszName )
+{
+	auto it = m_Commands.find( pszName );
+
+	if( it == m_Commands.end() )
+		return ClientCommandResult::NOT_FOUND;
+
+	auto& command = *it->second;
+
+	++command.uiReceived;
+
+	const int iSlot = GetClientSlot( player );
+
+	if( iSlot != -1 && sv_cmd_ratelimit.value && !ConsumeToken( command.buckets[ iSlot ], command.rate ) )
+	{
+		++command.uiRejected;
+		return ClientCommandResult::RATE_LIMITED;
+	}
+
+	//Commands can be executed from other commands' handlers.
+	auto pPrevious = m_pExecuting;
+
+	m_pExecuting = &command;
+
+	CStopwatch stopwatch;
+
+	command.handler( player );
+
+	const long long iTime = stopwatch.GetElapsedMicroseconds();
+
+	m_pExecuting = pPrevious;
+
+	command.iTotalTime += iTime;
+	command.iWorstTime = std::max( command.iWorstTime, iTime );
+
+	if( !m_pExecuting )
+		m_RemovedWhileExecuting.clear();
+
+	return ClientCommandResult::EXECUTED;
+}
+
+bool CClientCommandTable::CheckUnknownCommandRate( CBasePlayer& player )
+{
+	++m_uiUnknownReceived;
+
+	const int iSlot = GetClientSlot( player );
+
+	if( iSlot != -1 && sv_cmd_ratelimit.value && !ConsumeToken( m_UnknownBuckets[ iSlot ], m_UnknownRate ) )
+	{
+		++m_uiUnknownRejected;
+		return false;
+	}
+
+	return true;
+}
+
+void CClientCommandTable::ClientConnected( CBasePlayer& player )
+{
+	const int iSlot = GetClientSlot( player );
+
+	if( iSlot == -1 )
+		return;
+
+	for( auto& command : m_Commands )
+	{
+		command.second->buckets[ iSlot ] = TokenBucket();
+	}
+
+	m_UnknownBuckets[ iSlot ] = TokenBucket();
+}
+
+void CClientCommandTable::ResetStats()
+{
+	for( auto& command : m_Commands )
+	{
+		auto& data = *command.second;
+
+		data.uiReceived = 0;
+		data.uiRejected = 0;
+		data.iTotalTime = 0;
+		data.iWorstTime = 0;
+	}
+
+	m_uiUnknownReceived = 0;
+	m_uiUnknownRejected = 0;
+}
+
+void CClientCommandTable::PrintStats() const
+{
+	std::vector<const Command*> commands;
+
+	commands.reserve( m_Commands.size() );
+
+	for( const auto& command : m_Commands )
+	{
+		commands.push_back( command.second.get() );
+	}
+
+	std::sort( commands.begin(), commands.end(), []( const Command* pLHS, const Command* pRHS )
+		{
+			return pLHS->iTotalTime > pRHS->iTotalTime;
+		}
+	);
+
+	Alert( at_console, "Rate limiting is %s\n", sv_cmd_ratelimit.value ? "enabled" : "disabled" );
+
+	Alert( at_console, "%-20s %10s %10s %12s %10s %10s %s\n", "command", "received", "rejected", "total ms", "worst us", "rate/s", "burst" );
+
+	for( auto pCommand : commands )
+	{
+		Alert( at_console, "%-20s %10llu %10llu %12.3f %10lld %10.1f %.0f\n",
+			   pCommand->szName.c_str(), pCommand->uiReceived, pCommand->uiRejected,
+			   pCommand->iTotalTime / 1000.0, pCommand->iWorstTime,
+			   pCommand->rate.flRate, pCommand->rate.flBurst );
+	}
+
+	Alert( at_console, "%-20s %10llu %10llu\n", "<unknown>", m_uiUnknownReceived, m_uiUnknownRejected );
+}
+
+bool CClientCommandTable::ConsumeToken( TokenBucket& bucket, const ClientCommandRate& rate )
+{
+	if( rate.flRate <= 0 )
+		return true;
+
+	const float flTime = gpGlobals->time;
+
+	//Time goes back to 0 on map change.
+	if( !bucket.bInitialized || flTime < bucket.flLastTime )
+	{
+		bucket.flTokens = rate.flBurst;
+		bucket.bInitialized = true;
+	}
+	else
+	{
+		bucket.flTokens = std::min( rate.flBurst, bucket.flTokens + ( flTime - bucket.flLastTime ) * rate.flRate );
+	}
+
+	bucket.flLastTime = flTime;
+
+	if( bucket.flTokens < 1 )
+		return false;
+
+	bucket.flTokens -= 1;
+
+	return true;
+}
@@ -0,0 +1,180 @@
+#ifndef GAME_SERVER_CCLIENTCOMMANDTABLE_H
+#define GAME_SERVER_CCLIENTCOMMANDTABLE_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "StringUtils.h"
+
+class CBasePlayer;
+
+/**
+*	Rate limit for a client command. Each client gets a token bucket that holds up to flBurst tokens and refills at flRate tokens per second.
+*	Every command execution costs one token.
+*/
+struct ClientCommandRate final
+{
+	/**
+	*	Tokens per second. 0 means unlimited.
+	*/
+	float flRate = 0;
+
+	/**
+	*	Bucket size.
+	*/
+	float flBurst = 0;
+
+	ClientCommandRate() = default;
+
+	ClientCommandRate( const float flRateIn, const float flBurstIn )
+		: flRate( flRateIn )
+		, flBurst( flBurstIn )
+	{
+	}
+};
+
+enum class ClientCommandResult
+{
+	/**
+	*	The command was found and executed.
+	*/
+	EXECUTED = 0,
+
+	/**
+	*	The command was found but the client exceeded its rate limit.
+	*/
+	RATE_LIMITED,
+
+	/**
+	*	No such command.
+	*/
+	NOT_FOUND
+};
+
+/**
+*	Table of commands that clients can send to the server.
+*	The server, game rules and scripts register their commands here. Commands are looked up by name (case insensitive).
+*/
+class CClientCommandTable final
+{
+public:
+	/**
+	*	Handles a command. Use CMD_ARGC and CMD_ARGV to get the arguments.
+	*/
+	using Handler_t = std::function<void( CBasePlayer& player )>;
+
+	/**
+	*	Maximum number of clients the engine supports.
+	*/
+	static const int MAX_TRACKED_CLIENTS = 32;
+
+private:
+	struct TokenBucket final
+	{
+		float flTokens = 0;
+		float flLastTime = 0;
+		bool bInitialized = false;
+	};
+
+	struct Command final
+	{
+		std::string szName;
+		Handler_t handler;
+		const void* pOwner = nullptr;
+		ClientCommandRate rate;
+
+		TokenBucket buckets[ MAX_TRACKED_CLIENTS ];
+
+		unsigned long long uiReceived = 0;
+		unsigned long long uiRejected = 0;
+
+		//In microseconds.
+		long long iTotalTime = 0;
+		long long iWorstTime = 0;
+	};
+
+	using Commands_t = std::unordered_map<std::string, std::unique_ptr<Command>, CStdStringHashI, CStdStringEqualToI>;
+
+public:
+	CClientCommandTable() = default;
+	~CClientCommandTable() = default;
+
+	/**
+	*	Registers the stats command.
+	*/
+	void Initialize();
+
+	/**
+	*	Adds a command.
+	*	@param pszName Command name.
+	*	@param handler Handler to call.
+	*	@param rate Rate limit for each client.
+	*	@param pOwner Owner of the command. Used to remove all of an owner's commands at once.
+	*	@return Whether the command was added. Fails if a command with the same name already exists.
+	*/
+	bool Add( const char* const pszName, Handler_t&& handler, const ClientCommandRate& rate = ClientCommandRate(), const void* const pOwner = nullptr );
+
+	/**
+	*	Removes a command if it's owned by the given owner.
+	*	@return Whether the command was removed.
+	*/
+	bool Remove( const char* const pszName, const void* const pOwner );
+
+	/**
+	*	Removes all commands owned by the given owner.
+	*/
+	void RemoveCommandsByOwner( const void* const pOwner );
+
+	/**
+	*	Looks up and executes a command.
+	*	@param player Player that sent the command.
+	*	@param pszName Command name.
+	*/
+	ClientCommandResult Execute( CBasePlayer& player, const char* const pszName );
+
+	/**
+	*	Checks the rate limit for commands that aren't in the table.
+	*	@return Whether the unknown command should be processed.
+	*/
+	bool CheckUnknownCommandRate( CBasePlayer& player );
+
+	/**
+	*	Resets the rate limits for the given client. Called when a client connects.
+	*/
+	void ClientConnected( CBasePlayer& player );
+
+	void ResetStats();
+
+	void PrintStats() const;
+
+private:
+	/**
+	*	Takes a token from the given bucket.
+	*	@return Whether a token was available.
+	*/
+	static bool ConsumeToken( TokenBucket& bucket, const ClientCommandRate& rate );
+
+private:
+	Commands_t m_Commands;
+
+	//Innermost command that is currently executing, and commands removed while handlers were running.
+	Command* m_pExecuting = nullptr;
+	std::vector<std::unique_ptr<Command>> m_RemovedWhileExecuting;
+
+	ClientCommandRate m_UnknownRate{ 5, 10 };
+	TokenBucket m_UnknownBuckets[ MAX_TRACKED_CLIENTS ];
+
+	unsigned long long m_uiUnknownReceived = 0;
+	unsigned long long m_uiUnknownRejected = 0;
+
+private:
+	CClientCommandTable( const CClientCommandTable& ) = delete;
+	CClientCommandTable& operator=( const CClientCommandTable& ) = delete;
+};
+
+extern CClientCommandTable g_ClientCommands;
+
+#endif //GAME_SERVER_CCLIENTCOMMANDTABLE_H
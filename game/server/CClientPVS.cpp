@@ -0,0 +1,472 @@
+#include <algorithm>
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "CBasePlayer.h"
+
+#include "BSPIO.h"
+
+#include "CClientPVS.h"
+
+CClientPVS g_ClientPVS;
+
+namespace
+{
+template<typename T>
+bool CopyLump( const std::vector<uint8_t>& data, std::vector<T>& out )
+{
+	if( data.size() % sizeof( T ) != 0 )
+		return false;
+
+	out.resize( data.size() / sizeof( T ) );
+
+	if( !data.empty() )
+		memcpy( out.data(), data.data(), data.size() );
+
+	return true;
+}
+
+inline bool IsLeafInRow( const int iLeafBit, const uint8_t* pRow )
+{
+	return ( pRow[ iLeafBit >> 3 ] & ( 1 << ( iLeafBit & 7 ) ) ) != 0;
+}
+}
+
+bool CClientPVS::LoadMap( const char* const pszFileName )
+{
+	ASSERT( pszFileName );
+
+	Clear();
+
+	std::vector<uint8_t> planes, nodes, leafs, models;
+
+	if( !bsp::LoadLumps( pszFileName,
+		{
+			{ LUMP_PLANES, &planes },
+			{ LUMP_NODES, &nodes },
+			{ LUMP_LEAFS, &leafs },
+			{ LUMP_MODELS, &models },
+			{ LUMP_VISIBILITY, &m_VisData }
+		} ) )
+	{
+		Alert( at_console, "CClientPVS::LoadMap: Couldn't load \"%s\"; using the engine's PVS\n", pszFileName );
+		Clear();
+		return false;
+	}
+
+	std::vector<dmodel_t> modelList;
+
+	if( !CopyLump( planes, m_Planes ) || !CopyLump( nodes, m_Nodes ) || !CopyLump( leafs, m_Leafs ) || !CopyLump( models, modelList ) ||
+		m_Nodes.empty() || m_Leafs.empty() || modelList.empty() )
+	{
+		Alert( at_console, "CClientPVS::LoadMap: \"%s\" has invalid BSP data; using the engine's PVS\n", pszFileName );
+		Clear();
+		return false;
+	}
+
+	//Make sure walking the tree can't go out of bounds.
+	for( const auto& node : m_Nodes )
+	{
+		bool bValid = node.planenum >= 0 && static_cast<size_t>( node.planenum ) < m_Planes.size();
+
+		for( const auto child : node.children )
+		{
+			if( child >= 0 ? static_cast<size_t>( child ) >= m_Nodes.size() : static_cast<size_t>( -1 - child ) >= m_Leafs.size() )
+				bValid = false;
+		}
+
+		if( !bValid )
+		{
+			Alert( at_console, "CClientPVS::LoadMap: \"%s\" has an invalid BSP tree; using the engine's PVS\n", pszFileName );
+			Clear();
+			return false;
+		}
+	}
+
+	m_iVisLeafs = min( modelList[ 0 ].visleafs, static_cast<int>( m_Leafs.size() ) - 1 );
+	m_uiRowSize = ( m_iVisLeafs + 7 ) >> 3;
+
+	m_LeafClients.resize( m_iVisLeafs );
+	m_Row.resize( m_uiRowSize );
+
+	m_bLoaded = true;
+
+	Alert( at_aiconsole, "CClientPVS::LoadMap: %d leafs, %u bytes of visibility data\n", m_iVisLeafs, static_cast<unsigned int>( m_VisData.size() ) );
+
+	return true;
+}
+
+void CClientPVS::Clear()
+{
+	m_bLoaded = false;
+
+	m_Planes.clear();
+	m_Nodes.clear();
+	m_Leafs.clear();
+	m_VisData.clear();
+
+	m_iVisLeafs = 0;
+	m_uiRowSize = 0;
+
+	m_LeafClients.clear();
+
+	std::fill( std::begin( m_iClientLeafs ), std::end( m_iClientLeafs ), -1 );
+
+	m_iCheckClient = 0;
+
+	m_EntityLeafs.clear();
+	m_Row.clear();
+}
+
+void CClientPVS::Update()
+{
+	if( !m_bLoaded )
+		return;
+
+	const int iMaxClients = min( gpGlobals->maxClients, MAX_TRACKED_CLIENTS );
+
+	m_iCheckClient = iMaxClients > 0 ? ( m_iCheckClient + 1 ) % iMaxClients : 0;
+
+	int iClientLeafs[ MAX_TRACKED_CLIENTS ];
+
+	bool bChanged = false;
+
+	for( int iClient = 0; iClient < MAX_TRACKED_CLIENTS; ++iClient )
+	{
+		iClientLeafs[ iClient ] = -1;
+
+		if( iClient < iMaxClients )
+		{
+			auto pPlayer = UTIL_PlayerByIndex( iClient + 1 );
+
+			//Same rules as the engine: clients that can't be targeted aren't considered.
+			if( pPlayer && pPlayer->IsConnected() && !pPlayer->GetFlags().Any( FL_NOTARGET ) )
+				iClientLeafs[ iClient ] = FindLeaf( pPlayer->GetAbsOrigin() + pPlayer->GetViewOffset() );
+		}
+
+		if( iClientLeafs[ iClient ] != m_iClientLeafs[ iClient ] )
+			bChanged = true;
+	}
+
+	//Clients rarely change leafs, so only rebuild when one did.
+	if( !bChanged )
+		return;
+
+	std::copy( std::begin( iClientLeafs ), std::end( iClientLeafs ), std::begin( m_iClientLeafs ) );
+
+	std::fill( m_LeafClients.begin(), m_LeafClients.end(), 0 );
+
+	for( int iClient = 0; iClient < MAX_TRACKED_CLIENTS; ++iClient )
+	{
+		if( m_iClientLeafs[ iClient ] == -1 )
+			continue;
+
+		DecompressVis( m_iClientLeafs[ iClient ], m_Row.data() );
+
+		const ClientMask_t clientBit = static_cast<ClientMask_t>( 1 ) << iClient;
+
+		for( size_t uiByte = 0; uiByte < m_uiRowSize; ++uiByte )
+		{
+			const uint8_t bits = m_Row[ uiByte ];
+
+			if( !bits )
+				continue;
+
+			const size_t uiFirstLeaf = uiByte << 3;
+			const size_t uiLastLeaf = min( uiFirstLeaf + 8, m_LeafClients.size() );
+
+			for( size_t uiLeaf = uiFirstLeaf; uiLeaf < uiLastLeaf; ++uiLeaf )
+			{
+				if( bits & ( 1 << ( uiLeaf - uiFirstLeaf ) ) )
+					m_LeafClients[ uiLeaf ] |= clientBit;
+			}
+		}
+	}
+}
+
+int CClientPVS::FindLeaf( const Vector& vecPoint ) const
+{
+	if( !m_bLoaded )
+		return 0;
+
+	int iNode = 0;
+
+	while( iNode >= 0 )
+	{
+		const auto& node = m_Nodes[ iNode ];
+		const auto& plane = m_Planes[ node.planenum ];
+
+		float flDist;
+
+		if( plane.type < 3 )
+			flDist = vecPoint[ plane.type ] - plane.dist;
+		else
+			flDist = vecPoint.x * plane.normal[ 0 ] + vecPoint.y * plane.normal[ 1 ] + vecPoint.z * plane.normal[ 2 ] - plane.dist;
+
+		iNode = node.children[ flDist > 0 ? 0 : 1 ];
+	}
+
+	return -1 - iNode;
+}
+
+CClientPVS::ClientMask_t CClientPVS::GetClientsForPoint( const Vector& vecPoint ) const
+{
+	const int iLeaf = FindLeaf( vecPoint );
+
+	//Nothing can see into solid space.
+	if( iLeaf <= 0 || iLeaf > m_iVisLeafs )
+		return 0;
+
+	return m_LeafClients[ iLeaf - 1 ];
+}
+
+CClientPVS::ClientMask_t CClientPVS::GetClientsForEntity( CBaseEntity* pEntity )
+{
+	if( !pEntity )
+		return 0;
+
+	if( !m_bLoaded )
+	{
+		//Fall back to the engine's check, which only finds one client.
+		auto pClient = UTIL_FindClientInPVS( pEntity );
+
+		return pClient ? static_cast<ClientMask_t>( 1 ) << ( pClient->entindex() - 1 ) : 0;
+	}
+
+	//Followers are where their target is.
+	if( pEntity->GetMoveType() == MOVETYPE_FOLLOW && pEntity->GetAimEntity() )
+		pEntity = pEntity->GetAimEntity();
+
+	//Point entities aren't linked into leafs; use their position.
+	if( !pEntity->GetModelIndex() )
+		return GetClientsForPoint( pEntity->GetAbsOrigin() );
+
+	const auto& leafs = GetEntityLeafs( pEntity );
+
+	if( leafs.bOverflow )
+	{
+		ClientMask_t clients = 0;
+
+		for( int iClient = 0; iClient < MAX_TRACKED_CLIENTS; ++iClient )
+		{
+			if( m_iClientLeafs[ iClient ] != -1 )
+				clients |= static_cast<ClientMask_t>( 1 ) << iClient;
+		}
+
+		return clients;
+	}
+
+	ClientMask_t clients = 0;
+
+	for( int iLeaf = 0; iLeaf < leafs.iNumLeafs; ++iLeaf )
+		clients |= m_LeafClients[ leafs.iLeafs[ iLeaf ] ];
+
+	return clients;
+}
+
+CBaseEntity* CClientPVS::FindClientInPVS( const CBaseEntity* const pPVSEntity ) const
+{
+	ASSERT( m_bLoaded );
+
+	const ClientMask_t clients = GetClientsForPoint( pPVSEntity->GetAbsOrigin() + pPVSEntity->GetViewOffset() );
+
+	if( !clients )
+		return nullptr;
+
+	//Start from a different client every frame, like the engine does.
+	for( int iOffset = 0; iOffset < MAX_TRACKED_CLIENTS; ++iOffset )
+	{
+		const int iClient = ( m_iCheckClient + iOffset ) % MAX_TRACKED_CLIENTS;
+
+		if( clients & ( static_cast<ClientMask_t>( 1 ) << iClient ) )
+			return UTIL_PlayerByIndex( iClient + 1 );
+	}
+
+	return nullptr;
+}
+
+edict_t* CClientPVS::EntitiesInPVS( edict_t* pPVSEntity )
+{
+	ASSERT( m_bLoaded );
+
+	edict_t* pChain = g_engfuncs.pfnPEntityOfEntIndex( 0 );
+
+	if( !pPVSEntity )
+		return pChain;
+
+	const int iLeaf = FindLeaf( pPVSEntity->v.origin + pPVSEntity->v.view_ofs );
+
+	DecompressVis( iLeaf, m_Row.data() );
+
+	for( int iIndex = 1; iIndex < gpGlobals->maxEntities; ++iIndex )
+	{
+		edict_t* pEdict = g_engfuncs.pfnPEntityOfEntIndex( iIndex );
+
+		if( !pEdict || pEdict->free )
+			continue;
+
+		auto pEntity = GET_PRIVATE( pEdict );
+
+		if( !pEntity )
+			continue;
+
+		//Followers are where their target is.
+		if( pEntity->GetMoveType() == MOVETYPE_FOLLOW && pEntity->GetAimEntity() )
+			pEntity = pEntity->GetAimEntity();
+
+		//The engine only links entities with models into leafs.
+		if( !pEntity->GetModelIndex() )
+			continue;
+
+		const auto& leafs = GetEntityLeafs( pEntity );
+
+		if( !leafs.bOverflow && !IsInRow( leafs, m_Row.data() ) )
+			continue;
+
+		pEdict->v.chain = pChain;
+		pChain = pEdict;
+	}
+
+	return pChain;
+}
+
+void CClientPVS::DecompressVis( const int iLeaf, uint8_t* pRow ) const
+{
+	//The solid leaf and leafs without visibility data can see everything.
+	if( iLeaf <= 0 || static_cast<size_t>( iLeaf ) >= m_Leafs.size() || m_VisData.empty() ||
+		m_Leafs[ iLeaf ].visofs < 0 || static_cast<size_t>( m_Leafs[ iLeaf ].visofs ) >= m_VisData.size() )
+	{
+		memset( pRow, 0xFF, m_uiRowSize );
+		return;
+	}
+
+	const uint8_t* pIn = m_VisData.data() + m_Leafs[ iLeaf ].visofs;
+	const uint8_t* const pEnd = m_VisData.data() + m_VisData.size();
+
+	uint8_t* pOut = pRow;
+	uint8_t* const pOutEnd = pRow + m_uiRowSize;
+
+	//Runs of zero bytes are stored as a zero followed by the run length.
+	while( pOut < pOutEnd && pIn < pEnd )
+	{
+		if( *pIn )
+		{
+			*pOut++ = *pIn++;
+			continue;
+		}
+
+		if( pIn + 1 >= pEnd )
+			break;
+
+		const size_t uiCount = min( static_cast<size_t>( pIn[ 1 ] ), static_cast<size_t>( pOutEnd - pOut ) );
+
+		memset( pOut, 0, uiCount );
+
+		pOut += uiCount;
+		pIn += 2;
+	}
+
+	//Truncated data; treat the rest as not visible.
+	if( pOut < pOutEnd )
+		memset( pOut, 0, pOutEnd - pOut );
+}
+
+const CClientPVS::EntityLeafs& CClientPVS::GetEntityLeafs( CBaseEntity* pEntity )
+{
+	const size_t uiIndex = static_cast<size_t>( pEntity->entindex() );
+
+	if( uiIndex >= m_EntityLeafs.size() )
+		m_EntityLeafs.resize( max( static_cast<size_t>( gpGlobals->maxEntities ), uiIndex + 1 ) );
+
+	auto& leafs = m_EntityLeafs[ uiIndex ];
+
+	const Vector& vecAbsMin = pEntity->GetAbsMin();
+	const Vector& vecAbsMax = pEntity->GetAbsMax();
+
+	//Most entities don't move between queries.
+	if( leafs.bValid && leafs.vecAbsMin == vecAbsMin && leafs.vecAbsMax == vecAbsMax )
+		return leafs;
+
+	leafs.vecAbsMin = vecAbsMin;
+	leafs.vecAbsMax = vecAbsMax;
+	leafs.bValid = true;
+	leafs.bOverflow = false;
+	leafs.iNumLeafs = 0;
+
+	FindTouchedLeafs( leafs, vecAbsMin, vecAbsMax, 0 );
+
+	return leafs;
+}
+
+void CClientPVS::FindTouchedLeafs( EntityLeafs& leafs, const Vector& vecMins, const Vector& vecMaxs, int iNode ) const
+{
+	while( !leafs.bOverflow )
+	{
+		if( iNode < 0 )
+		{
+			const int iLeaf = -1 - iNode;
+
+			//Nothing to see in solid space.
+			if( iLeaf == 0 || iLeaf > m_iVisLeafs || m_Leafs[ iLeaf ].contents == CONTENTS_SOLID )
+				return;
+
+			if( leafs.iNumLeafs == MAX_ENT_LEAFS )
+			{
+				leafs.bOverflow = true;
+				return;
+			}
+
+			leafs.iLeafs[ leafs.iNumLeafs++ ] = iLeaf - 1;
+
+			return;
+		}
+
+		const auto& node = m_Nodes[ iNode ];
+		const auto& plane = m_Planes[ node.planenum ];
+
+		//Find the corners nearest to and furthest along the plane normal.
+		float flNear = -plane.dist;
+		float flFar = -plane.dist;
+
+		for( int iAxis = 0; iAxis < 3; ++iAxis )
+		{
+			if( plane.normal[ iAxis ] >= 0 )
+			{
+				flNear += plane.normal[ iAxis ] * vecMins[ iAxis ];
+				flFar += plane.normal[ iAxis ] * vecMaxs[ iAxis ];
+			}
+			else
+			{
+				flNear += plane.normal[ iAxis ] * vecMaxs[ iAxis ];
+				flFar += plane.normal[ iAxis ] * vecMins[ iAxis ];
+			}
+		}
+
+		if( flNear >= 0 )
+		{
+			iNode = node.children[ 0 ];
+		}
+		else if( flFar < 0 )
+		{
+			iNode = node.children[ 1 ];
+		}
+		else
+		{
+			//Straddles the plane.
+			FindTouchedLeafs( leafs, vecMins, vecMaxs, node.children[ 0 ] );
+			iNode = node.children[ 1 ];
+		}
+	}
+}
+
+bool CClientPVS::IsInRow( const EntityLeafs& leafs, const uint8_t* pRow )
+{
+	for( int iLeaf = 0; iLeaf < leafs.iNumLeafs; ++iLeaf )
+	{
+		if( IsLeafInRow( leafs.iLeafs[ iLeaf ], pRow ) )
+			return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,169 @@
+#ifndef GAME_SERVER_CCLIENTPVS_H
+#define GAME_SERVER_CCLIENTPVS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "MiniBSPFile.h"
+
+class CBaseEntity;
+
+/**
+*	Potentially visible set of every client, kept up to date once per frame.
+*	The map's BSP tree and visibility data are loaded on map start. Each frame, the leaf that each client's view is in is found,
+*	and every leaf is given a bit mask of the clients whose PVS contains it. Entities are mapped to the leafs their bounds touch,
+*	so visibility tests become a few bit operations instead of engine calls.
+*
+*	If the map's data can't be loaded, the engine's PVS functions are used instead.
+*/
+class CClientPVS final
+{
+public:
+	/**
+	*	Bit mask of clients. Client index n is bit n - 1.
+	*/
+	using ClientMask_t = uint32_t;
+
+	/**
+	*	Maximum number of clients the engine supports.
+	*/
+	static const int MAX_TRACKED_CLIENTS = 32;
+
+	static_assert( sizeof( ClientMask_t ) * 8 >= MAX_TRACKED_CLIENTS, "Client mask must have a bit for every client" );
+
+private:
+	struct EntityLeafs final
+	{
+		//Bounds that the leafs were found for.
+		Vector vecAbsMin;
+		Vector vecAbsMax;
+
+		bool bValid = false;
+
+		//Touches too many leafs; treat as visible from everywhere.
+		bool bOverflow = false;
+
+		int iNumLeafs = 0;
+
+		//Leaf numbers minus 1, which is the bit in a visibility row. Uses the engine's limit; entities that touch more leafs are treated as visible everywhere.
+		int iLeafs[ MAX_ENT_LEAFS ];
+	};
+
+public:
+	CClientPVS()
+	{
+		Clear();
+	}
+
+	~CClientPVS() = default;
+
+	/**
+	*	@return Whether the current map's data is loaded.
+	*/
+	bool IsLoaded() const { return m_bLoaded; }
+
+	/**
+	*	Loads the BSP tree and visibility data for a map.
+	*	@param pszFileName Name of the BSP file.
+	*/
+	bool LoadMap( const char* const pszFileName );
+
+	/**
+	*	Frees the current map's data.
+	*/
+	void Clear();
+
+	/**
+	*	Finds the PVS of every client. Called once per frame.
+	*/
+	void Update();
+
+	/**
+	*	@return Number of the leaf that contains the given point. 0 is the solid leaf.
+	*/
+	int FindLeaf( const Vector& vecPoint ) const;
+
+	/**
+	*	@return Mask of clients whose PVS contains the given point.
+	*/
+	ClientMask_t GetClientsForPoint( const Vector& vecPoint ) const;
+
+	/**
+	*	@return Mask of clients whose PVS contains any part of the given entity.
+	*/
+	ClientMask_t GetClientsForEntity( CBaseEntity* pEntity );
+
+	/**
+	*	@return Whether any part of the given entity is in the PVS of any client.
+	*/
+	bool IsVisibleToAnyClient( CBaseEntity* pEntity ) { return GetClientsForEntity( pEntity ) != 0; }
+
+	/**
+	*	Finds a client whose PVS contains the given entity's view position. Successive frames favor different clients.
+	*	@see enginefuncs_t::pfnFindClientInPVS
+	*/
+	CBaseEntity* FindClientInPVS( const CBaseEntity* const pPVSEntity ) const;
+
+	/**
+	*	Finds all entities that are in the PVS of the given entity's view position.
+	*	The entities are linked through their chain member.
+	*	@return First entity in the list. The list ends with the world.
+	*	@see enginefuncs_t::pfnEntitiesInPVS
+	*/
+	edict_t* EntitiesInPVS( edict_t* pPVSEntity );
+
+private:
+	/**
+	*	Decompresses a leaf's visibility row.
+	*	@param iLeaf Leaf number.
+	*	@param pRow Row to decompress into. Must hold m_uiRowSize bytes.
+	*/
+	void DecompressVis( const int iLeaf, uint8_t* pRow ) const;
+
+	/**
+	*	Finds the leafs that the given entity touches.
+	*/
+	const EntityLeafs& GetEntityLeafs( CBaseEntity* pEntity );
+
+	void FindTouchedLeafs( EntityLeafs& leafs, const Vector& vecMins, const Vector& vecMaxs, int iNode ) const;
+
+	/**
+	*	@return Whether any of the leafs are set in the given row.
+	*/
+	static bool IsInRow( const EntityLeafs& leafs, const uint8_t* pRow );
+
+private:
+	bool m_bLoaded = false;
+
+	std::vector<dplane_t> m_Planes;
+	std::vector<dnode_t> m_Nodes;
+	std::vector<dleaf_t> m_Leafs;
+	std::vector<uint8_t> m_VisData;
+
+	//Number of leafs in the world, not counting the solid leaf, and the size in bytes of a visibility row that has a bit for each.
+	int m_iVisLeafs = 0;
+	size_t m_uiRowSize = 0;
+
+	//Clients whose PVS contains each leaf, indexed by leaf number minus 1.
+	std::vector<ClientMask_t> m_LeafClients;
+
+	//Leaf that each client's view was in when m_LeafClients was last built. -1 if not in the game.
+	int m_iClientLeafs[ MAX_TRACKED_CLIENTS ];
+
+	//Client to start searching from in FindClientInPVS.
+	int m_iCheckClient = 0;
+
+	//Leafs of each entity, by entity index.
+	std::vector<EntityLeafs> m_EntityLeafs;
+
+	//Scratch row.
+	std::vector<uint8_t> m_Row;
+
+private:
+	CClientPVS( const CClientPVS& ) = delete;
+	CClientPVS& operator=( const CClientPVS& ) = delete;
+};
+
+extern CClientPVS g_ClientPVS;
+
+#endif //GAME_SERVER_CCLIENTPVS_H
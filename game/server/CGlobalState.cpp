@@ -38,8 +38,12 @@ CGlobalState::CGlobalState( void )
 
 void CGlobalState::Reset( void )
 {
-	m_pList = NULL;
+	m_Hashes.clear();
+	m_Index.clear();
 	m_listCount = 0;
+
+	m_uiLookups = 0;
+	m_uiProbes = 0;
 }
 
 globalentity_t *CGlobalState::Find( string_t globalname )
@@ -47,20 +51,84 @@ globalentity_t *CGlobalState::Find( string_t globalname )
 	if( !globalname )
 		return NULL;
 
-	globalentity_t *pTest;
+	++m_uiLookups;
+
+	if( m_Index.empty() )
+		return NULL;
+
 	const char *pEntityName = STRING( globalname );
 
+	const unsigned int uiHash = HashName( pEntityName );
+	const size_t uiMask = m_Index.size() - 1;
+
+	//The index is never more than half full, so there's always an empty slot to stop at.
+	for( size_t uiSlot = uiHash & uiMask; ; uiSlot = ( uiSlot + 1 ) & uiMask )
+	{
+		const int iIndex = m_Index[ uiSlot ];
+
+		if( iIndex == -1 )
+			return NULL;
+
+		++m_uiProbes;
+
+		if( m_Hashes[ iIndex ] == uiHash )
+		{
+			globalentity_t& entity = GetEntity( iIndex );
+
+			if( FStrEq( pEntityName, entity.name ) )
+				return &entity;
+		}
+	}
+}
+
+globalentity_t& CGlobalState::GetEntity( const int iIndex )
+{
+	return m_Blocks[ iIndex / BLOCK_SIZE ][ iIndex % BLOCK_SIZE ];
+}
+
+void CGlobalState::AddToIndex( const int iIndex, const unsigned int uiHash )
+{
+	if( m_Hashes.size() * 2 > m_Index.size() )
+	{
+		//Also adds the new entity.
+		RebuildIndex( max( static_cast<size_t>( 32 ), m_Index.size() * 2 ) );
+		return;
+	}
+
+	const size_t uiMask = m_Index.size() - 1;
+
+	size_t uiSlot = uiHash & uiMask;
 
-	pTest = m_pList;
-	while( pTest )
+	while( m_Index[ uiSlot ] != -1 )
+		uiSlot = ( uiSlot + 1 ) & uiMask;
+
+	m_Index[ uiSlot ] = iIndex;
+}
+
+void CGlobalState::RebuildIndex( const size_t uiSize )
+{
+	m_Index.assign( uiSize, -1 );
+
+	const int iCount = static_cast<int>( m_Hashes.size() );
+
+	for( int iIndex = 0; iIndex < iCount; ++iIndex )
 	{
-		if( FStrEq( pEntityName, pTest->name ) )
-			break;
+		AddToIndex( iIndex, m_Hashes[ iIndex ] );
+	}
+}
 
-		pTest = pTest->pNext;
+unsigned int CGlobalState::HashName( const char* pszName )
+{
+	//FNV-1a. Names are compared case sensitively, so they're hashed that way too.
+	unsigned int uiHash = 2166136261U;
+
+	for( ; *pszName; ++pszName )
+	{
+		uiHash ^= static_cast<unsigned char>( *pszName );
+		uiHash *= 16777619U;
 	}
 
-	return pTest;
+	return uiHash;
 }
 
 
@@ -70,10 +138,16 @@ void CGlobalState::DumpGlobals( void )
 {
 	ALERT( at_console, "-- Globals --\n" );
 	
-	for( globalentity_t *pTest = m_pList; pTest; pTest = pTest->pNext )
+	for( int i = 0; i < m_listCount; ++i )
 	{
-		ALERT( at_console, "%s: %s (%s)\n", pTest->name, pTest->levelName, GLOBALESTATEToString( pTest->state ) );
+		const globalentity_t& entity = GetEntity( i );
+
+		ALERT( at_console, "%s: %s (%s)\n", entity.name, entity.levelName, GLOBALESTATEToString( entity.state ) );
 	}
+
+	ALERT( at_console, "%d globals, %u index slots, %u blocks; %u lookups, %.2f average probes\n",
+		   m_listCount, static_cast<unsigned int>( m_Index.size() ), static_cast<unsigned int>( m_Blocks.size() ),
+		   m_uiLookups, m_uiLookups ? static_cast<double>( m_uiProbes ) / m_uiLookups : 0.0 );
 }
 //#endif
 
@@ -82,14 +156,22 @@ void CGlobalState::EntityAdd( string_t globalname, string_t mapName, GLOBALESTAT
 {
 	ASSERT( !Find( globalname ) );
 
-	globalentity_t *pNewEntity = ( globalentity_t * ) calloc( sizeof( globalentity_t ), 1 );
-	ASSERT( pNewEntity != NULL );
-	pNewEntity->pNext = m_pList;
-	m_pList = pNewEntity;
-	strcpy( pNewEntity->name, STRING( globalname ) );
-	strcpy( pNewEntity->levelName, STRING( mapName ) );
-	pNewEntity->state = state;
-	m_listCount++;
+	const int iIndex = static_cast<int>( m_Hashes.size() );
+
+	if( static_cast<size_t>( iIndex / BLOCK_SIZE ) >= m_Blocks.size() )
+		m_Blocks.emplace_back( new globalentity_t[ BLOCK_SIZE ] );
+
+	globalentity_t& entity = GetEntity( iIndex );
+
+	memset( &entity, 0, sizeof( entity ) );
+	strcpy( entity.name, STRING( globalname ) );
+	strcpy( entity.levelName, STRING( mapName ) );
+	entity.state = state;
+
+	m_Hashes.push_back( HashName( entity.name ) );
+	m_listCount = static_cast<int>( m_Hashes.size() );
+
+	AddToIndex( iIndex, m_Hashes.back() );
 }
 
 
@@ -141,13 +223,10 @@ bool CGlobalState::Save( CSave &save )
 
 	const DataMap_t* pGlobalDataMap = globalentity_t::GetThisDataMap();
 
-	globalentity_t *pEntity = m_pList;
-	for( int i = 0; i < m_listCount && pEntity; i++ )
+	for( int i = 0; i < m_listCount; i++ )
 	{
-		if( !save.WriteFields( "GENT", pEntity, *pGlobalDataMap, pGlobalDataMap->pTypeDesc, pGlobalDataMap->uiNumDescriptors ) )
+		if( !save.WriteFields( "GENT", &GetEntity( i ), *pGlobalDataMap, pGlobalDataMap->pTypeDesc, pGlobalDataMap->uiNumDescriptors ) )
 			return false;
-
-		pEntity = pEntity->pNext;
 	}
 
 	return true;
@@ -188,13 +267,7 @@ void CGlobalState::EntityUpdate( string_t globalname, string_t mapname )
 
 void CGlobalState::ClearStates( void )
 {
-	globalentity_t *pFree = m_pList;
-	while( pFree )
-	{
-		globalentity_t *pNext = pFree->pNext;
-		free( pFree );
-		pFree = pNext;
-	}
+	//Keep the blocks around for the next game.
 	Reset();
 }
 
@@ -15,6 +15,9 @@
 #ifndef GAME_SERVER_CGLOBALSTATE_H
 #define GAME_SERVER_CGLOBALSTATE_H
 
+#include <memory>
+#include <vector>
+
 enum GLOBALESTATE
 {
 	GLOBAL_OFF		= 0,
@@ -36,7 +39,6 @@ struct globalentity_t
 	char			name[ 64 ];
 	char			levelName[ cchMapNameMost ];
 	GLOBALESTATE	state;
-	globalentity_t	*pNext;
 };
 
 class CGlobalState
@@ -63,8 +65,38 @@ public:
 
 private:
 	globalentity_t	*Find( string_t globalname );
-	globalentity_t	*m_pList;
+
+	globalentity_t&	GetEntity( const int iIndex );
+
+	/**
+	*	Adds an entity to the hash index. Grows the index if needed.
+	*/
+	void			AddToIndex( const int iIndex, const unsigned int uiHash );
+
+	void			RebuildIndex( const size_t uiSize );
+
+	static unsigned int HashName( const char* pszName );
+
+private:
+	/**
+	*	Number of entities in each arena block.
+	*/
+	static const int BLOCK_SIZE = 64;
+
+	//Entities are stored in fixed size blocks so pointers returned by EntityFromTable stay valid when entities are added.
+	std::vector<std::unique_ptr<globalentity_t[]>> m_Blocks;
+
+	//Hash of each entity's name.
+	std::vector<unsigned int> m_Hashes;
+
+	//Open addressing index of entity indices, -1 for empty. Size is a power of 2.
+	std::vector<int> m_Index;
+
 	int				m_listCount;
+
+	//Lookup statistics.
+	unsigned int	m_uiLookups = 0;
+	unsigned int	m_uiProbes = 0;
 };
 
 extern CGlobalState gGlobalState;
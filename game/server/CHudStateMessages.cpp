@@ -0,0 +1,263 @@
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "CBasePlayer.h"
+#include "Server.h"
+#include "UserMessages.h"
+
+#include "CHudStateMessages.h"
+
+CHudStateMessages g_HudStateMessages;
+
+namespace
+{
+enum class MsgArgType
+{
+	NONE = 0,
+	INT8,
+	INT16
+};
+
+struct MessageInfo final
+{
+	const char* pszName;
+	const int& iMessage;
+	MsgArgType args[ 3 ];
+};
+
+const MessageInfo g_MessageInfos[] =
+{
+	{ "Health",		gmsgHealth,			{ MsgArgType::INT8, MsgArgType::NONE, MsgArgType::NONE } },
+	{ "Battery",	gmsgBattery,		{ MsgArgType::INT16, MsgArgType::NONE, MsgArgType::NONE } },
+	{ "FlashBat",	gmsgFlashBattery,	{ MsgArgType::INT8, MsgArgType::NONE, MsgArgType::NONE } },
+	{ "AmmoX",		gmsgAmmoX,			{ MsgArgType::INT8, MsgArgType::INT8, MsgArgType::NONE } },
+	{ "CurWeapon",	gmsgCurWeapon,		{ MsgArgType::INT8, MsgArgType::INT8, MsgArgType::INT8 } }
+};
+
+static_assert( ARRAYSIZE( g_MessageInfos ) == static_cast<size_t>( HudStateMsg::COUNT ), "Message info must match HudStateMsg" );
+
+void ServerCommand_Stats()
+{
+	if( CMD_ARGC() >= 2 && FStrEq( CMD_ARGV( 1 ), "reset" ) )
+	{
+		g_HudStateMessages.ResetStats();
+		Alert( at_console, "HUD message statistics reset\n" );
+		return;
+	}
+
+	g_HudStateMessages.PrintStats();
+}
+}
+
+void CHudStateMessages::Initialize()
+{
+	g_engfuncs.pfnAddServerCommand( "sv_hudmsg_stats", &::ServerCommand_Stats );
+}
+
+void CHudStateMessages::ClientConnected( CBasePlayer& player )
+{
+	if( auto pState = GetClientState( player ) )
+		*pState = ClientState();
+}
+
+void CHudStateMessages::ClientHUDReset( CBasePlayer& player )
+{
+	if( auto pState = GetClientState( player ) )
+	{
+		for( auto& slot : pState->slots )
+		{
+			slot.bSent = false;
+		}
+	}
+}
+
+void CHudStateMessages::SetHealth( CBasePlayer& player, const int iHealth, const HudSend send )
+{
+	Set( player, SLOT_HEALTH, HudStateMsg::HEALTH, iHealth, 0, 0, send );
+}
+
+void CHudStateMessages::SetBattery( CBasePlayer& player, const int iBattery, const HudSend send )
+{
+	Set( player, SLOT_BATTERY, HudStateMsg::BATTERY, iBattery, 0, 0, send );
+}
+
+void CHudStateMessages::SetFlashBattery( CBasePlayer& player, const int iBattery, const HudSend send )
+{
+	Set( player, SLOT_FLASHBATTERY, HudStateMsg::FLASHBATTERY, iBattery, 0, 0, send );
+}
+
+void CHudStateMessages::SetAmmo( CBasePlayer& player, const int iAmmoType, const int iCount, const HudSend send )
+{
+	ASSERT( iAmmoType >= 0 && iAmmoType < CAmmoTypes::MAX_AMMO_TYPES );
+
+	if( iAmmoType < 0 || iAmmoType >= CAmmoTypes::MAX_AMMO_TYPES )
+		return;
+
+	Set( player, SLOT_FIRST_AMMO + iAmmoType, HudStateMsg::AMMO, iAmmoType, iCount, 0, send );
+}
+
+void CHudStateMessages::SetCurWeapon( CBasePlayer& player, const int iState, const int iId, const int iClip, const HudSend send )
+{
+	int iSlot = SLOT_CURWEAPON;
+
+	//Messages for inactive weapons only update that weapon's clip, so each weapon needs its own slot.
+	if( iState == static_cast<int>( WpnOnTargetState::NOT_ACTIVE_WEAPON ) && iId > 0 && iId < MAX_WEAPONS )
+		iSlot = SLOT_FIRST_WEAPON_CLIP + iId;
+
+	Set( player, iSlot, HudStateMsg::CURWEAPON, iState, iId, iClip, send );
+}
+
+void CHudStateMessages::Flush( CBasePlayer& player )
+{
+	auto pState = GetClientState( player );
+
+	if( !pState )
+		return;
+
+	for( int iSlot = 0; iSlot < SLOT_COUNT; ++iSlot )
+	{
+		auto& slot = pState->slots[ iSlot ];
+
+		if( !slot.bPending )
+			continue;
+
+		slot.bPending = false;
+
+		const auto type = GetSlotType( iSlot );
+
+		if( slot.bSent && !memcmp( slot.iValues, slot.iSentValues, sizeof( slot.iValues ) ) )
+		{
+			++m_Stats[ static_cast<size_t>( type ) ].uiUnchanged;
+			continue;
+		}
+
+		Send( player, slot, type );
+	}
+}
+
+void CHudStateMessages::ResetStats()
+{
+	for( auto& stats : m_Stats )
+	{
+		stats = MessageStats();
+	}
+}
+
+void CHudStateMessages::PrintStats() const
+{
+	Alert( at_console, "HUD state messages%s:\n", sv_hudmsg_coalesce.value != 0 ? "" : " (coalescing disabled)" );
+	Alert( at_console, "%-10s %10s %10s %10s %10s %10s\n", "message", "requests", "coalesced", "unchanged", "sent", "bytes" );
+
+	MessageStats total;
+
+	for( size_t uiIndex = 0; uiIndex < ARRAYSIZE( m_Stats ); ++uiIndex )
+	{
+		const auto& stats = m_Stats[ uiIndex ];
+
+		Alert( at_console, "%-10s %10u %10u %10u %10u %10u\n",
+			   g_MessageInfos[ uiIndex ].pszName, stats.uiRequests, stats.uiCoalesced, stats.uiUnchanged, stats.uiSent, stats.uiBytes );
+
+		total.uiRequests += stats.uiRequests;
+		total.uiCoalesced += stats.uiCoalesced;
+		total.uiUnchanged += stats.uiUnchanged;
+		total.uiSent += stats.uiSent;
+		total.uiBytes += stats.uiBytes;
+	}
+
+	Alert( at_console, "%-10s %10u %10u %10u %10u %10u\n",
+		   "total", total.uiRequests, total.uiCoalesced, total.uiUnchanged, total.uiSent, total.uiBytes );
+}
+
+CHudStateMessages::ClientState* CHudStateMessages::GetClientState( CBasePlayer& player )
+{
+	const int iSlot = player.entindex() - 1;
+
+	if( iSlot < 0 || iSlot >= MAX_TRACKED_CLIENTS )
+		return nullptr;
+
+	return &m_Clients[ iSlot ];
+}
+
+void CHudStateMessages::Set( CBasePlayer& player, const int iSlot, const HudStateMsg type,
+							 const int iValue1, const int iValue2, const int iValue3, const HudSend send )
+{
+	auto pState = GetClientState( player );
+
+	if( !pState )
+		return;
+
+	auto& stats = m_Stats[ static_cast<size_t>( type ) ];
+
+	++stats.uiRequests;
+
+	auto& slot = pState->slots[ iSlot ];
+
+	if( slot.bPending )
+		++stats.uiCoalesced;
+
+	slot.iValues[ 0 ] = iValue1;
+	slot.iValues[ 1 ] = iValue2;
+	slot.iValues[ 2 ] = iValue3;
+
+	if( send == HudSend::NOW || sv_hudmsg_coalesce.value == 0 )
+	{
+		slot.bPending = false;
+		Send( player, slot, type );
+	}
+	else
+		slot.bPending = true;
+}
+
+void CHudStateMessages::Send( CBasePlayer& player, Slot& slot, const HudStateMsg type )
+{
+	const auto& info = g_MessageInfos[ static_cast<size_t>( type ) ];
+
+	//Message ID comes first.
+	unsigned int uiBytes = 1;
+
+	MESSAGE_BEGIN( MSG_ONE, info.iMessage, NULL, &player );
+
+	for( int iArg = 0; iArg < MAX_VALUES; ++iArg )
+	{
+		switch( info.args[ iArg ] )
+		{
+		case MsgArgType::INT8:
+			WRITE_BYTE( slot.iValues[ iArg ] );
+			uiBytes += 1;
+			break;
+
+		case MsgArgType::INT16:
+			WRITE_SHORT( slot.iValues[ iArg ] );
+			uiBytes += 2;
+			break;
+
+		default: break;
+		}
+	}
+
+	MESSAGE_END();
+
+	memcpy( slot.iSentValues, slot.iValues, sizeof( slot.iSentValues ) );
+	slot.bSent = true;
+
+	auto& stats = m_Stats[ static_cast<size_t>( type ) ];
+
+	++stats.uiSent;
+	stats.uiBytes += uiBytes;
+}
+
+HudStateMsg CHudStateMessages::GetSlotType( const int iSlot )
+{
+	switch( iSlot )
+	{
+	case SLOT_HEALTH:		return HudStateMsg::HEALTH;
+	case SLOT_BATTERY:		return HudStateMsg::BATTERY;
+	case SLOT_FLASHBATTERY:	return HudStateMsg::FLASHBATTERY;
+	default: break;
+	}
+
+	if( iSlot < SLOT_FIRST_WEAPON_CLIP )
+		return HudStateMsg::AMMO;
+
+	return HudStateMsg::CURWEAPON;
+}
@@ -0,0 +1,170 @@
+#ifndef GAME_SERVER_CHUDSTATEMESSAGES_H
+#define GAME_SERVER_CHUDSTATEMESSAGES_H
+
+#include "cdll_dll.h"
+#include "WeaponsConst.h"
+#include "entities/weapons/CAmmoTypes.h"
+
+class CBasePlayer;
+
+/**
+*	HUD messages whose only purpose is to tell the client the current value of something.
+*/
+enum class HudStateMsg
+{
+	HEALTH = 0,
+	BATTERY,
+	FLASHBATTERY,
+	AMMO,
+	CURWEAPON,
+
+	COUNT
+};
+
+/**
+*	How a HUD state message is sent.
+*/
+enum class HudSend
+{
+	/**
+	*	Keep the latest value and send it when the player's client data is next updated, if it differs from what the client has.
+	*/
+	DEFERRED = 0,
+
+	/**
+	*	Send it right away. Use this when the message has to arrive in order with messages that don't go through here.
+	*/
+	NOW
+};
+
+/**
+*	Coalesces per player HUD state messages.
+*	Values set during a frame replace each other, and only the final values that differ from what the client last received are sent,
+*	once per frame from CBasePlayer::UpdateClientData.
+*	Message counts and sizes are kept for each message type; see sv_hudmsg_stats.
+*/
+class CHudStateMessages final
+{
+public:
+	/**
+	*	Maximum number of clients the engine supports.
+	*/
+	static const int MAX_TRACKED_CLIENTS = 32;
+
+private:
+	enum SlotIndex
+	{
+		SLOT_HEALTH = 0,
+		SLOT_BATTERY,
+		SLOT_FLASHBATTERY,
+
+		//One for each ammo type.
+		SLOT_FIRST_AMMO,
+
+		//Clip updates for weapons that aren't the active weapon, one for each weapon ID.
+		SLOT_FIRST_WEAPON_CLIP = SLOT_FIRST_AMMO + CAmmoTypes::MAX_AMMO_TYPES,
+
+		//The active weapon. Last so the client ends up with the right current weapon.
+		SLOT_CURWEAPON = SLOT_FIRST_WEAPON_CLIP + MAX_WEAPONS,
+
+		SLOT_COUNT
+	};
+
+	static const int MAX_VALUES = 3;
+
+	struct Slot final
+	{
+		int iValues[ MAX_VALUES ];
+		int iSentValues[ MAX_VALUES ];
+
+		//Whether iValues has to be sent.
+		bool bPending = false;
+
+		//Whether iSentValues is what the client has.
+		bool bSent = false;
+	};
+
+	struct ClientState final
+	{
+		Slot slots[ SLOT_COUNT ];
+	};
+
+	struct MessageStats final
+	{
+		//Number of values set.
+		unsigned int uiRequests = 0;
+
+		//Values that were replaced before they were sent.
+		unsigned int uiCoalesced = 0;
+
+		//Values that weren't sent because the client already had them.
+		unsigned int uiUnchanged = 0;
+
+		unsigned int uiSent = 0;
+		unsigned int uiBytes = 0;
+	};
+
+public:
+	CHudStateMessages() = default;
+	~CHudStateMessages() = default;
+
+	/**
+	*	Registers the stats command.
+	*/
+	void Initialize();
+
+	/**
+	*	Forgets everything about the given client. Called when a client connects.
+	*/
+	void ClientConnected( CBasePlayer& player );
+
+	/**
+	*	The given client's HUD was reset, so every value has to be sent again. Pending values are kept.
+	*/
+	void ClientHUDReset( CBasePlayer& player );
+
+	void SetHealth( CBasePlayer& player, const int iHealth, const HudSend send = HudSend::DEFERRED );
+
+	void SetBattery( CBasePlayer& player, const int iBattery, const HudSend send = HudSend::DEFERRED );
+
+	void SetFlashBattery( CBasePlayer& player, const int iBattery, const HudSend send = HudSend::DEFERRED );
+
+	void SetAmmo( CBasePlayer& player, const int iAmmoType, const int iCount, const HudSend send = HudSend::DEFERRED );
+
+	/**
+	*	Sets the state of a weapon.
+	*	@param iState WpnOnTargetState, or 0 along with an ID of 0 or 0xFF to clear the current weapon.
+	*/
+	void SetCurWeapon( CBasePlayer& player, const int iState, const int iId, const int iClip, const HudSend send = HudSend::DEFERRED );
+
+	/**
+	*	Sends the given client's pending values.
+	*/
+	void Flush( CBasePlayer& player );
+
+	void ResetStats();
+
+	void PrintStats() const;
+
+private:
+	ClientState* GetClientState( CBasePlayer& player );
+
+	void Set( CBasePlayer& player, const int iSlot, const HudStateMsg type, const int iValue1, const int iValue2, const int iValue3, const HudSend send );
+
+	void Send( CBasePlayer& player, Slot& slot, const HudStateMsg type );
+
+	static HudStateMsg GetSlotType( const int iSlot );
+
+private:
+	ClientState m_Clients[ MAX_TRACKED_CLIENTS ];
+
+	MessageStats m_Stats[ static_cast<size_t>( HudStateMsg::COUNT ) ];
+
+private:
+	CHudStateMessages( const CHudStateMessages& ) = delete;
+	CHudStateMessages& operator=( const CHudStateMessages& ) = delete;
+};
+
+extern CHudStateMessages g_HudStateMessages;
+
+#endif //GAME_SERVER_CHUDSTATEMESSAGES_H
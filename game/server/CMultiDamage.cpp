@@ -15,9 +15,20 @@
 #include "extdll.h"
 #include "util.h"
 #include "cbase.h"
+#include "Weapons.h"
 
 #include "CMultiDamage.h"
 
+float CMultiDamage::GetAmount() const
+{
+	float flAmount = 0;
+
+	for( const auto& target : m_Targets )
+		flAmount += target.flAmount;
+
+	return flAmount;
+}
+
 void CMultiDamage::AddMultiDamage( const CTakeDamageInfo& info, CBaseEntity* pEntity )
 {
 	if( !pEntity )
@@ -25,21 +36,97 @@ void CMultiDamage::AddMultiDamage( const CTakeDamageInfo& info, CBaseEntity* pEn
 
 	m_bitsDamageTypes |= info.GetDamageTypes();
 
-	if( pEntity != m_pEntity )
+	auto& target = GetTarget( pEntity );
+
+	target.bTakeDamage = true;
+	target.flAmount += info.GetDamage();
+	target.bitsDamageTypes |= info.GetDamageTypes();
+}
+
+void CMultiDamage::AddBlood( CBaseEntity* pEntity, const CTakeDamageInfo& info, const Vector& vecOrigin, const Vector& vecDir, TraceResult& tr )
+{
+	if( !pEntity )
+		return;
+
+	const int iBloodColor = pEntity->BloodColor();
+
+	if( iBloodColor == DONT_BLEED )
+		return;
+
+	if( !m_bDeferBlood )
+	{
+		SpawnBlood( vecOrigin, iBloodColor, info.GetDamage() );// a little surface blood.
+		pEntity->TraceBleed( info, vecDir, tr );
+		return;
+	}
+
+	auto& target = GetTarget( pEntity );
+
+	//The first hit decides where the blood goes; the rest only add to the amount.
+	if( !target.bBleed )
 	{
-		//TODO: replace this - Solokiller
-		ApplyMultiDamage( info.GetInflictor(), info.GetInflictor() ); // UNDONE: wrong attacker!
-		m_pEntity = pEntity;
-		m_flAmount = 0;
+		target.bBleed = true;
+		target.vecBloodOrigin = vecOrigin;
+		target.vecBloodDir = vecDir;
+		target.bloodTrace = tr;
 	}
 
-	m_flAmount += info.GetDamage();
+	target.flBloodAmount += info.GetDamage();
+	target.bitsBloodDamageTypes |= info.GetDamageTypes();
 }
 
 void CMultiDamage::ApplyMultiDamage( CBaseEntity* pInflictor, CBaseEntity* pAttacker )
 {
-	if( !m_pEntity )
-		return;
+	//Taking damage can start other attacks that use the accumulator, so work on a copy.
+	std::vector<Target> targets;
+
+	targets.swap( m_Targets );
+
+	m_bDeferBlood = false;
+
+	for( auto& target : targets )
+	{
+		if( target.bBleed )
+		{
+			const int iBloodColor = target.pEntity->BloodColor();
+
+			SpawnBlood( target.vecBloodOrigin, iBloodColor, target.flBloodAmount );
+			target.pEntity->TraceBleed(
+				CTakeDamageInfo( pInflictor, pAttacker, target.flBloodAmount, target.bitsBloodDamageTypes ), target.vecBloodDir, target.bloodTrace );
+		}
+
+		//Bleeding alone doesn't cause damage.
+		if( target.bTakeDamage )
+			target.pEntity->TakeDamage( pInflictor, pAttacker, target.flAmount, m_bitsBaseDamageTypes | target.bitsDamageTypes );
+	}
+
+	//Reuse the memory if nothing was added while applying.
+	if( m_Targets.empty() )
+	{
+		targets.clear();
+		m_Targets.swap( targets );
+	}
+}
+
+CMultiDamage::Target& CMultiDamage::GetTarget( CBaseEntity* pEntity )
+{
+	for( auto& target : m_Targets )
+	{
+		if( target.pEntity == pEntity )
+			return target;
+	}
+
+	m_Targets.emplace_back();
+
+	auto& target = m_Targets.back();
 
-	m_pEntity->TakeDamage( pInflictor, pAttacker, m_flAmount, m_bitsDamageTypes );
-}
\ No newline at end of file
+	target.pEntity = pEntity;
+	target.bTakeDamage = false;
+	target.flAmount = 0;
+	target.bitsDamageTypes = 0;
+	target.bBleed = false;
+	target.flBloodAmount = 0;
+	target.bitsBloodDamageTypes = 0;
+
+	return target;
+}
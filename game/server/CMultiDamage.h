@@ -15,6 +15,8 @@
 #ifndef GAME_SERVER_CMULTIDAMAGE_H
 #define GAME_SERVER_CMULTIDAMAGE_H
 
+#include <vector>
+
 #include "CTakeDamageInfo.h"
 
 class CBaseEntity;
@@ -22,28 +24,59 @@ class CBaseEntity;
 /**
 *	MULTI - DAMAGE
 *
-*	Collects multiple small damages into a single damage
+*	Collects multiple small damages into a single damage per target.
+*	Damage is accumulated for every target that is hit, and each target's total is applied once by ApplyMultiDamage.
+*	Blood effects for the hits can also be deferred so each target bleeds once, scaled by its total damage.
 */
 class CMultiDamage final
 {
+private:
+	struct Target final
+	{
+		CBaseEntity* pEntity;
+		bool bTakeDamage;
+		float flAmount;
+		int bitsDamageTypes;
+
+		//Blood effects for the first hit on this target, if any.
+		bool bBleed;
+		float flBloodAmount;
+		int bitsBloodDamageTypes;
+		Vector vecBloodOrigin;
+		Vector vecBloodDir;
+		TraceResult bloodTrace;
+	};
+
+	/**
+	*	Most attacks hit only a few targets.
+	*/
+	static const size_t INITIAL_TARGET_COUNT = 8;
+
 public:
 	/**
 	*	Constructor.
 	*/
 	CMultiDamage()
 	{
+		m_Targets.reserve( INITIAL_TARGET_COUNT );
+
 		Clear();
 	}
 
 	/**
-	*	@return The entity currently being attacked.
+	*	@return The entity that was attacked first, or null if no entity was attacked.
+	*/
+	CBaseEntity* GetEntity() { return !m_Targets.empty() ? m_Targets.front().pEntity : nullptr; }
+
+	/**
+	*	@return The number of entities that have been attacked.
 	*/
-	CBaseEntity* GetEntity() { return m_pEntity; }
+	size_t GetTargetCount() const { return m_Targets.size(); }
 
 	/**
-	*	@return The total amount of damage to deal so far.
+	*	@return The total amount of damage to deal so far, to all targets.
 	*/
-	float GetAmount() const { return m_flAmount; }
+	float GetAmount() const;
 
 	/**
 	*	@return Bit vector of damage types to deal so far.
@@ -51,21 +84,32 @@ public:
 	int GetDamageTypes() const { return m_bitsDamageTypes; }
 
 	/**
-	*	Sets the damage types.
+	*	Sets the damage types that all targets take. Damage types added later are combined with these.
 	*/
 	void SetDamageTypes( const int bitsDamageTypes )
 	{
+		m_bitsBaseDamageTypes = bitsDamageTypes;
 		m_bitsDamageTypes = bitsDamageTypes;
 	}
 
 	/**
-	*	Resets the multi damage accumulator.
+	*	Resets the multi damage accumulator. Pending blood effects are discarded and blood is no longer deferred.
 	*/
 	void Clear()
 	{
-		m_pEntity = nullptr;
-		m_flAmount = 0;
+		m_Targets.clear();
+		m_bitsBaseDamageTypes = 0;
 		m_bitsDamageTypes = 0;
+		m_bDeferBlood = false;
+	}
+
+	/**
+	*	Defers blood effects added with AddBlood until damage is applied, so each target bleeds once.
+	*	Used by attacks that hit many times at once, like shotgun blasts.
+	*/
+	void DeferBlood()
+	{
+		m_bDeferBlood = true;
 	}
 
 	/**
@@ -76,16 +120,36 @@ public:
 	void AddMultiDamage( const CTakeDamageInfo& info, CBaseEntity* pEntity );
 
 	/**
-	*	Applies multi-damage to the target.
+	*	Adds blood effects for a hit on the given entity.
+	*	If blood is deferred, the effects are spawned when damage is applied. Otherwise they are spawned immediately.
+	*	@param pEntity Entity that was hit.
+	*	@param info Damage info for the hit.
+	*	@param vecOrigin Where to spawn surface blood.
+	*	@param vecDir Direction of the attack.
+	*	@param tr Trace that hit the entity.
+	*/
+	void AddBlood( CBaseEntity* pEntity, const CTakeDamageInfo& info, const Vector& vecOrigin, const Vector& vecDir, TraceResult& tr );
+
+	/**
+	*	Applies multi-damage to all targets, and spawns any deferred blood effects. Clears the accumulator.
 	*	@param pInflictor Inflictor to pass to TakeDamage.
 	*	@param pAttacker Attacker to pass to TakeDamage.
 	*/
 	void ApplyMultiDamage( CBaseEntity* pInflictor, CBaseEntity* pAttacker );
 
 private:
-	CBaseEntity* m_pEntity;
-	float m_flAmount;
+	/**
+	*	Finds or adds the given target.
+	*/
+	Target& GetTarget( CBaseEntity* pEntity );
+
+private:
+	std::vector<Target> m_Targets;
+
+	//Types that all targets take, and types of all damage added so far.
+	int m_bitsBaseDamageTypes;
 	int m_bitsDamageTypes;
+	bool m_bDeferBlood;
 };
 
 #endif //GAME_SERVER_CMULTIDAMAGE_H
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include <vector>
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "CBasePlayer.h"
+
+#include "pm_defs.h"
+#include "pm_movevars.h"
+#include "pm_recording.h"
+#include "pm_shared.h"
+
+#include "CPlayerMoveRecorder.h"
+
+CPlayerMoveRecorder g_PlayerMoveRecorder;
+
+const char* const CPlayerMoveRecorder::RECORDING_DIR = "pmove";
+
+namespace
+{
+void ServerCommand_Record()
+{
+	if( CMD_ARGC() >= 2 && FStrEq( CMD_ARGV( 1 ), "stop" ) )
+	{
+		g_PlayerMoveRecorder.StopRecording();
+		return;
+	}
+
+	if( CMD_ARGC() < 3 )
+	{
+		Alert( at_console, "Usage: pm_record <player index> <name>\n       pm_record stop\n" );
+		return;
+	}
+
+	g_PlayerMoveRecorder.StartRecording( atoi( CMD_ARGV( 1 ) ), CMD_ARGV( 2 ) );
+}
+}
+
+void CPlayerMoveRecorder::Initialize()
+{
+	g_engfuncs.pfnAddServerCommand( "pm_record", &::ServerCommand_Record );
+}
+
+void CPlayerMoveRecorder::Move( playermove_t* ppmove, const int server )
+{
+	m_pPlayerMove = ppmove;
+
+	if( !IsRecording() || ppmove->player_index + 1 != m_iPlayerIndex )
+	{
+		PM_Move( ppmove, server );
+		return;
+	}
+
+	//Capture the input before the move changes it.
+	std::vector<uint8_t> frame( pmrec::GetFrameSize( pmrec::GetStateSize( *ppmove ) ) );
+
+	const int iNumPhysEnts = ppmove->numphysent;
+	const int iNumMoveEnts = ppmove->nummoveent;
+
+	pmrec::WriteFrameInput( *ppmove, frame.data() );
+
+	PM_Move( ppmove, server );
+
+	pmrec::WriteFrameResult( *ppmove, iNumPhysEnts, iNumMoveEnts, frame.data() );
+
+	if( m_File.Write( frame.data(), frame.size() ) != static_cast<int>( frame.size() ) )
+	{
+		Alert( at_console, "pm_record: Couldn't write to the recording, stopping\n" );
+		StopRecording();
+		return;
+	}
+
+	++m_uiRecordedFrames;
+}
+
+bool CPlayerMoveRecorder::StartRecording( const int iPlayerIndex, const char* const pszName )
+{
+	StopRecording();
+
+	auto pPlayer = UTIL_PlayerByIndex( iPlayerIndex );
+
+	if( !pPlayer )
+	{
+		Alert( at_console, "pm_record: No player with index %d\n", iPlayerIndex );
+		return false;
+	}
+
+	if( !m_pPlayerMove )
+	{
+		Alert( at_console, "pm_record: No player movement has run yet\n" );
+		return false;
+	}
+
+	char szPath[ MAX_PATH ];
+
+	if( !FormatPath( pszName, szPath, sizeof( szPath ) ) )
+	{
+		Alert( at_console, "pm_record: Recording name \"%s\" is too long\n", pszName );
+		return false;
+	}
+
+	g_pFileSystem->CreateDirHierarchy( RECORDING_DIR, nullptr );
+
+	m_File = CFile( szPath, "wb" );
+
+	if( !m_File.IsOpen() )
+	{
+		Alert( at_console, "pm_record: Couldn't open \"%s\" for writing\n", szPath );
+		return false;
+	}
+
+	pmrec::RecordingHeader header;
+
+	pmrec::InitHeader( header, *m_pPlayerMove, STRING( gpGlobals->mapname ) );
+
+	if( m_File.Write( &header, sizeof( header ) ) != sizeof( header ) )
+	{
+		Alert( at_console, "pm_record: Couldn't write to \"%s\"\n", szPath );
+		m_File.Close();
+		return false;
+	}
+
+	m_iPlayerIndex = iPlayerIndex;
+	m_uiRecordedFrames = 0;
+
+	Alert( at_console, "pm_record: Recording \"%s\" to \"%s\"\n", pPlayer->GetNetName(), szPath );
+
+	return true;
+}
+
+void CPlayerMoveRecorder::StopRecording()
+{
+	if( !IsRecording() )
+		return;
+
+	m_File.Close();
+
+	Alert( at_console, "pm_record: Recorded %u moves\n", m_uiRecordedFrames );
+
+	m_iPlayerIndex = 0;
+	m_uiRecordedFrames = 0;
+}
+
+bool CPlayerMoveRecorder::FormatPath( const char* const pszName, char* pszBuffer, const size_t uiBufferSize )
+{
+	const int iResult = snprintf( pszBuffer, uiBufferSize, "%s/%s.%s", RECORDING_DIR, pszName, pmrec::RECORDING_EXT );
+
+	return iResult >= 0 && static_cast<size_t>( iResult ) < uiBufferSize;
+}
+
+void PM_Move_Server( playermove_t* ppmove, int server )
+{
+	g_PlayerMoveRecorder.Move( ppmove, server );
+}
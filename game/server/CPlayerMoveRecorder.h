@@ -0,0 +1,77 @@
+#ifndef GAME_SERVER_CPLAYERMOVERECORDER_H
+#define GAME_SERVER_CPLAYERMOVERECORDER_H
+
+#include "CFile.h"
+
+struct playermove_t;
+
+/**
+*	Records a player's movement to a file.
+*	A recording holds the player state, usercmd and movevars going into each move, and the origin and velocity that came out of it.
+*	The pmreplay tool runs the same moves again against the map's clip hulls, checks the results against the recording and reports how long the moves took.
+*	Used to verify that changes to the movement code don't change its results, and to measure their cost.
+*	@see pm_recording.h
+*/
+class CPlayerMoveRecorder final
+{
+public:
+	/**
+	*	Directory that recordings are stored in.
+	*/
+	static const char* const RECORDING_DIR;
+
+public:
+	CPlayerMoveRecorder() = default;
+	~CPlayerMoveRecorder() = default;
+
+	/**
+	*	Registers the record command.
+	*/
+	void Initialize();
+
+	bool IsRecording() const { return m_File.IsOpen(); }
+
+	/**
+	*	Runs a player move, recording it if needed. Called by the engine instead of PM_Move.
+	*/
+	void Move( playermove_t* ppmove, const int server );
+
+	/**
+	*	Starts recording the given player's movement.
+	*	@param iPlayerIndex Player entity index.
+	*	@param pszName Name of the recording, without extension.
+	*/
+	bool StartRecording( const int iPlayerIndex, const char* const pszName );
+
+	void StopRecording();
+
+private:
+	/**
+	*	Formats the path to a recording.
+	*/
+	static bool FormatPath( const char* const pszName, char* pszBuffer, const size_t uiBufferSize );
+
+private:
+	CFile m_File;
+
+	//Entity index of the player being recorded.
+	int m_iPlayerIndex = 0;
+
+	unsigned int m_uiRecordedFrames = 0;
+
+	//Most recent move that the engine ran. Used to get the size of the player state.
+	playermove_t* m_pPlayerMove = nullptr;
+
+private:
+	CPlayerMoveRecorder( const CPlayerMoveRecorder& ) = delete;
+	CPlayerMoveRecorder& operator=( const CPlayerMoveRecorder& ) = delete;
+};
+
+extern CPlayerMoveRecorder g_PlayerMoveRecorder;
+
+/**
+*	Server version of player movement. Runs the move through g_PlayerMoveRecorder.
+*/
+void PM_Move_Server( playermove_t* ppmove, int server );
+
+#endif //GAME_SERVER_CPLAYERMOVERECORDER_H
@@ -4,14 +4,26 @@
 #include "Weapons.h"
 #include "CBasePlayer.h"
 #include "entities/CSoundEnt.h"
+#include "entities/NPCs/MonsterLOD.h"
+#include "entities/NPCs/MonsterScheduleTrace.h"
+#include "entities/NPCs/CMonsterRegistry.h"
+#include "entities/plats/CPathTrackTables.h"
 #include "entities/CBaseSpectator.h"
 
+#include "CKeyValueFileCache.h"
 #include "CWeaponInfoCache.h"
+#include "materials/Materials.h"
 
 #include "gamerules/GameRules.h"
 #include "Server.h"
 #include "CMap.h"
 #include "config/CServerConfig.h"
+#include "CServerProfiler.h"
+#include "CClientCommandTable.h"
+#include "CPlayerMoveRecorder.h"
+#include "CClientPVS.h"
+#include "CHudStateMessages.h"
+#include "CTargetnameGraph.h"
 
 #include "nodes/Nodes.h"
 #include "nodes/CTestHull.h"
@@ -37,6 +49,316 @@ void Host_Say( CBasePlayer* pPlayer, const bool bTeamOnly );
 
 CServerGameInterface g_Server;
 
+namespace
+{
+void ClientCommand_Say( CBasePlayer& player )
+{
+	Host_Say( &player, false );
+}
+
+void ClientCommand_SayTeam( CBasePlayer& player )
+{
+	Host_Say( &player, true );
+}
+
+void ClientCommand_FullUpdate( CBasePlayer& player )
+{
+	player.ForceClientDllUpdate();
+}
+
+void ClientCommand_Give( CBasePlayer& player )
+{
+	if( UTIL_CheatsAllowed() )
+	{
+		int iszItem = ALLOC_STRING( CMD_ARGV( 1 ) );	// Make a copy of the classname
+		player.GiveNamedItem( STRING( iszItem ) );
+	}
+}
+
+void ClientCommand_Drop( CBasePlayer& player )
+{
+	// player is dropping an item. 
+	player.DropPlayerItem( ( char * ) CMD_ARGV( 1 ) );
+}
+
+void ClientCommand_FOV( CBasePlayer& player )
+{
+	if( UTIL_CheatsAllowed() && CMD_ARGC() > 1 )
+	{
+		player.m_iFOV = atoi( CMD_ARGV( 1 ) );
+	}
+	else
+	{
+		ClientPrint( &player, HUD_PRINTCONSOLE, UTIL_VarArgs( "\"fov\" is \"%d\"\n", ( int ) player.m_iFOV ) );
+	}
+}
+
+void ClientCommand_Use( CBasePlayer& player )
+{
+	player.SelectItem( ( char * ) CMD_ARGV( 1 ) );
+}
+
+void ClientCommand_LastInv( CBasePlayer& player )
+{
+	player.SelectLastItem();
+}
+
+// clients wants to become a spectator
+void ClientCommand_Spectate( CBasePlayer& player )
+{
+	// always allow proxies to become a spectator
+	if( player.GetFlags().Any( FL_PROXY ) || allow_spectators.value )
+	{
+		CBaseEntity *pSpawnSpot = g_pGameRules->GetPlayerSpawnSpot( &player );
+		player.StartObserver( player.GetAbsOrigin(), pSpawnSpot->GetAbsAngles() );
+
+		// notify other clients of player switching to spectator mode
+		UTIL_ClientPrintAll( HUD_PRINTNOTIFY, UTIL_VarArgs( "%s switched to spectator mode\n",
+			player.HasNetName() ? player.GetNetName() : "unconnected" ) );
+	}
+	else
+		ClientPrint( &player, HUD_PRINTCONSOLE, "Spectator mode is disabled.\n" );
+}
+
+// new spectator mode
+void ClientCommand_SpecMode( CBasePlayer& player )
+{
+	if( player.IsObserver() )
+		player.Observer_SetMode( atoi( CMD_ARGV( 1 ) ) );
+}
+
+void ClientCommand_CloseMenus( CBasePlayer& )
+{
+	// just ignore it
+}
+
+// follow next player
+void ClientCommand_FollowNext( CBasePlayer& player )
+{
+	if( player.IsObserver() )
+		player.Observer_FindNextPlayer( atoi( CMD_ARGV( 1 ) ) != 0 );
+}
+
+void ClientCommand_NumEntities( CBasePlayer& player )
+{
+	edict_t* pEdict = ENT( 0 );
+
+	size_t uiCount = 0;
+
+	for( int i = 0; i < gpGlobals->maxEntities; ++i, ++pEdict )
+	{
+		if( !pEdict->free && pEdict->pvPrivateData )
+			++uiCount;
+	}
+
+	ClientPrint( &player, HUD_PRINTCONSOLE, UTIL_VarArgs( "Number of entities: %u (max: %d)\n", uiCount, gpGlobals->maxEntities ) );
+}
+
+void ClientCommand_EntSetName( CBasePlayer& player )
+{
+	if( UTIL_CheatsAllowed() )
+	{
+		if( CMD_ARGC() >= 1 )
+		{
+			if( CBaseEntity* pEnt = UTIL_FindEntityForward( &player ) )
+			{
+				pEnt->SetTargetname( ALLOC_STRING( CMD_ARGV( 1 ) ) );
+
+				ClientPrint( &player, HUD_PRINTCONSOLE, "Set name on entity\n" );
+			}
+			else
+			{
+				ClientPrint( &player, HUD_PRINTCONSOLE, "No entity in front of you\n" );
+			}
+		}
+		else
+		{
+			ClientPrint( &player, HUD_PRINTCONSOLE, "Usage: ent_setname <name>\n" );
+		}
+	}
+}
+
+void ClientCommand_EntTrigger( CBasePlayer& player )
+{
+	if( UTIL_CheatsAllowed() )
+	{
+		if( CMD_ARGC() >= 1 )
+		{
+			ClientPrint( &player, HUD_PRINTCONSOLE, UTIL_VarArgs( "\tent_trigger: Firing targets \"%s\"\n", CMD_ARGV( 1 ) ) );
+			FireTargets( CMD_ARGV( 1 ), &player, &player, USE_TOGGLE, 0 );
+		}
+		else
+		{
+			ClientPrint( &player, HUD_PRINTCONSOLE, "Usage: ent_trigger <targetname>\n" );
+		}
+	}
+}
+
+void ClientCommand_ListEntityClass( CBasePlayer& player )
+{
+	if( UTIL_CheatsAllowed() )
+	{
+		if( CMD_ARGC() >= 1 )
+		{
+			if( auto pReg = GetEntityDict().FindEntityClassByEntityName( CMD_ARGV( 1 ) ) )
+			{
+				ClientPrint( &player, HUD_PRINTCONSOLE, UTIL_VarArgs( "Class \"%s\": \"%s\" (%u bytes)\n", pReg->GetEntityname(), pReg->GetClassname(), pReg->GetSize() ) );
+			}
+			else
+			{
+				ClientPrint( &player, HUD_PRINTCONSOLE, "Couldn't find entity class \"%s\"\n", CMD_ARGV( 1 ) );
+			}
+		}
+		else
+		{
+			ClientPrint( &player, HUD_PRINTCONSOLE, "Usage: listentityclass <entity class name>\n" );
+		}
+	}
+}
+
+void ClientCommand_ListEntityClasses( CBasePlayer& )
+{
+	if( UTIL_CheatsAllowed() )
+	{
+		GetEntityDict().EnumEntityClasses(
+			[]( CBaseEntityRegistry& reg ) -> bool
+		{
+			//Using Alert here since it's a lot of data.
+			Alert( at_console, "Class \"%s\": \"%s\" (%u bytes)\n", reg.GetEntityname(), reg.GetClassname(), reg.GetSize() );
+
+			return true;
+		}
+		);
+	}
+}
+
+void ClientCommand_WpnInfo( CBasePlayer& player )
+{
+	//Verify integrity. - Solokiller
+
+	bool bSuccess = false;
+
+	const char* pszMessage = nullptr;
+
+	player.SetWeaponValidationReceived( true );
+
+	if( CMD_ARGC() == 5 )
+	{
+		const size_t uiNumAmmoTypes = strtoul( CMD_ARGV( 1 ), nullptr, 10 );
+		const size_t uiClientAmmoHash = strtoul( CMD_ARGV( 2 ), nullptr, 10 );
+		const size_t uiNumWeapons = strtoul( CMD_ARGV( 3 ), nullptr, 10 );
+		const size_t uiClientWeaponHash = strtoul( CMD_ARGV( 4 ), nullptr, 10 );
+
+		const size_t uiAmmoHash = g_AmmoTypes.GenerateHash();
+		const size_t uiWeaponHash = g_WeaponInfoCache.GenerateHash();
+
+		if( g_AmmoTypes.GetAmmoTypesCount() != uiNumAmmoTypes )
+		{
+			pszMessage = UTIL_VarArgs( "Ammo count verification failed: Server has %u, Client has %u", g_AmmoTypes.GetAmmoTypesCount(), uiNumAmmoTypes );
+		}
+		else if( uiClientAmmoHash != uiAmmoHash )
+		{
+			pszMessage = UTIL_VarArgs( "Ammo hash verification failed: Server has %u, Client has %u", uiAmmoHash, uiClientAmmoHash );
+		}
+		else if( g_WeaponInfoCache.GetWeaponCount() != uiNumWeapons )
+		{
+			pszMessage = UTIL_VarArgs( "Weapon count verification failed: Server has %u, Client has %u", g_WeaponInfoCache.GetWeaponCount(), uiNumWeapons );
+		}
+		else if( uiClientWeaponHash != uiWeaponHash )
+		{
+			pszMessage = UTIL_VarArgs( "Weapon hash verification failed: Server has %u, Client has %u", uiWeaponHash, uiClientWeaponHash );
+		}
+		else
+		{
+			bSuccess = true;
+
+			//Have to do this because player weapons on the client side are created after messages containing clips arrive. - Solokiller
+			//This tells the server to resend weapon clips on demand.
+			CBasePlayerWeapon* pWeapon;
+
+			for( int iBucket = 0; iBucket < MAX_WEAPON_SLOTS; ++iBucket )
+			{
+				pWeapon = player.m_rgpPlayerItems[ iBucket ];
+
+				while( pWeapon )
+				{
+					pWeapon->m_iClientClip = 0;
+
+					pWeapon = pWeapon->m_pNext;
+				}
+			}
+		}
+	}
+	else
+	{
+		pszMessage = "Invalid weapon verification message received\n";
+	}
+
+	if( !bSuccess )
+	{
+		ALERT( at_logged, "Client ammo & weapon verification failed for \"%s\", disconnecting\n", player.GetNetName() );
+
+		if( pszMessage )
+			ALERT( at_logged, "The reason given was: %s\n", pszMessage );
+
+		if( !IS_DEDICATED_SERVER() )
+		{
+			//Listen server hosts usually don't have logging enabled, so echo to console unconditionally for them. - Solokiller
+			UTIL_ServerPrintf( "Client ammo & weapon verification failed for \"%s\", disconnecting\n", player.GetNetName() );
+
+			if( pszMessage )
+				UTIL_ServerPrintf( "The reason given was: %s\n", pszMessage );
+		}
+
+		if( IS_DEDICATED_SERVER() || player.entindex() != 1 )
+		{
+			const char* pszCommand;
+
+			if( pszMessage )
+			{
+				pszCommand = UTIL_VarArgs( "kick \"%s\" \"%s\"\n", player.GetNetName(), pszMessage );
+			}
+			else
+			{
+				pszCommand = UTIL_VarArgs( "kick \"%s\"\n", player.GetNetName() );
+			}
+
+			SERVER_COMMAND( pszCommand );
+		}
+		else
+		{
+			//The local player can't be kicked, so terminate the session instead - Solokiller
+			CLIENT_COMMAND( player.edict(), "disconnect\n" );
+		}
+	}
+}
+
+/**
+*	Registers the built-in client commands.
+*/
+void RegisterClientCommands()
+{
+	g_ClientCommands.Add( "say", &ClientCommand_Say, { 2, 8 } );
+	g_ClientCommands.Add( "say_team", &ClientCommand_SayTeam, { 2, 8 } );
+	g_ClientCommands.Add( "fullupdate", &ClientCommand_FullUpdate, { 1, 3 } );
+	g_ClientCommands.Add( "give", &ClientCommand_Give );
+	g_ClientCommands.Add( "drop", &ClientCommand_Drop, { 10, 20 } );
+	g_ClientCommands.Add( "fov", &ClientCommand_FOV, { 5, 10 } );
+	g_ClientCommands.Add( "use", &ClientCommand_Use, { 20, 40 } );
+	g_ClientCommands.Add( "lastinv", &ClientCommand_LastInv, { 20, 40 } );
+	g_ClientCommands.Add( "spectate", &ClientCommand_Spectate, { 1, 3 } );
+	g_ClientCommands.Add( "specmode", &ClientCommand_SpecMode, { 10, 20 } );
+	g_ClientCommands.Add( "closemenus", &ClientCommand_CloseMenus, { 10, 20 } );
+	g_ClientCommands.Add( "follownext", &ClientCommand_FollowNext, { 10, 20 } );
+	g_ClientCommands.Add( "numentities", &ClientCommand_NumEntities, { 2, 5 } );
+	g_ClientCommands.Add( "ent_setname", &ClientCommand_EntSetName, { 2, 5 } );
+	g_ClientCommands.Add( "ent_trigger", &ClientCommand_EntTrigger, { 2, 5 } );
+	g_ClientCommands.Add( "listentityclass", &ClientCommand_ListEntityClass, { 2, 5 } );
+	g_ClientCommands.Add( "listentityclasses", &ClientCommand_ListEntityClasses, { 2, 5 } );
+	g_ClientCommands.Add( "WpnInfo", &ClientCommand_WpnInfo, { 1, 3 } );
+}
+}
+
 bool CServerGameInterface::Initialize()
 {
 	if( !InitializeCommon() )
@@ -44,6 +366,22 @@ bool CServerGameInterface::Initialize()
 
 	EntityClassifications().Initialize();
 
+	g_MonsterLOD.Initialize();
+
+	g_MonsterScheduleTrace.Initialize();
+
+	g_ClientCommands.Initialize();
+
+	RegisterClientCommands();
+
+	g_PlayerMoveRecorder.Initialize();
+
+	g_HudStateMessages.Initialize();
+
+	g_Sentences.RegisterCommands();
+
+	SV_PROF_INITIALIZE();
+
 #if USE_ANGELSCRIPT
 	if( !g_ASManager.Initialize() )
 	{
@@ -143,6 +481,10 @@ void CServerGameInterface::ClientPutInServer( edict_t* pEntity )
 	// Allocate a CBasePlayer for pev, and call spawn
 	auto pPlayer = GetClassPtr( ( CBasePlayer* ) &pEntity->v );
 
+	g_ClientCommands.ClientConnected( *pPlayer );
+
+	g_HudStateMessages.ClientConnected( *pPlayer );
+
 	pPlayer->InitialSpawn();
 
 #if USE_ANGELSCRIPT
@@ -163,272 +505,17 @@ void CServerGameInterface::ClientCommand( edict_t* pEntity )
 
 	auto* pPlayer = GetClassPtr( ( CBasePlayer* ) &pEntity->v );
 
-	if( FStrEq( pcmd, "say" ) )
-	{
-		Host_Say( pPlayer, false );
-	}
-	else if( FStrEq( pcmd, "say_team" ) )
-	{
-		Host_Say( pPlayer, true );
-	}
-	else if( FStrEq( pcmd, "fullupdate" ) )
-	{
-		pPlayer->ForceClientDllUpdate();
-	}
-	else if( FStrEq( pcmd, "give" ) )
-	{
-		if( UTIL_CheatsAllowed() )
-		{
-			int iszItem = ALLOC_STRING( CMD_ARGV( 1 ) );	// Make a copy of the classname
-			pPlayer->GiveNamedItem( STRING( iszItem ) );
-		}
-	}
-
-	else if( FStrEq( pcmd, "drop" ) )
-	{
-		// player is dropping an item. 
-		pPlayer->DropPlayerItem( ( char * ) CMD_ARGV( 1 ) );
-	}
-	else if( FStrEq( pcmd, "fov" ) )
-	{
-		if( UTIL_CheatsAllowed() && CMD_ARGC() > 1 )
-		{
-			pPlayer->m_iFOV = atoi( CMD_ARGV( 1 ) );
-		}
-		else
-		{
-			ClientPrint( pPlayer, HUD_PRINTCONSOLE, UTIL_VarArgs( "\"fov\" is \"%d\"\n", ( int ) pPlayer->m_iFOV ) );
-		}
-	}
-	else if( FStrEq( pcmd, "use" ) )
+	if( g_ClientCommands.Execute( *pPlayer, pcmd ) != ClientCommandResult::NOT_FOUND )
 	{
-		pPlayer->SelectItem( ( char * ) CMD_ARGV( 1 ) );
+		//Executed or dropped due to rate limiting.
 	}
 	else if( ( ( pstr = strstr( pcmd, "weapon_" ) ) != NULL ) && ( pstr == pcmd ) )
 	{
 		pPlayer->SelectItem( pcmd );
 	}
-	else if( FStrEq( pcmd, "lastinv" ) )
-	{
-		pPlayer->SelectLastItem();
-	}
-	else if( FStrEq( pcmd, "spectate" ) )	// clients wants to become a spectator
-	{
-		// always allow proxies to become a spectator
-		if( pPlayer->GetFlags().Any( FL_PROXY ) || allow_spectators.value )
-		{
-			CBaseEntity *pSpawnSpot = g_pGameRules->GetPlayerSpawnSpot( pPlayer );
-			pPlayer->StartObserver( pPlayer->GetAbsOrigin(), pSpawnSpot->GetAbsAngles() );
-
-			// notify other clients of player switching to spectator mode
-			UTIL_ClientPrintAll( HUD_PRINTNOTIFY, UTIL_VarArgs( "%s switched to spectator mode\n",
-				pPlayer->HasNetName() ? pPlayer->GetNetName() : "unconnected" ) );
-		}
-		else
-			ClientPrint( pPlayer, HUD_PRINTCONSOLE, "Spectator mode is disabled.\n" );
-
-	}
-	else if( FStrEq( pcmd, "specmode" ) )	// new spectator mode
-	{
-		if( pPlayer->IsObserver() )
-			pPlayer->Observer_SetMode( atoi( CMD_ARGV( 1 ) ) );
-	}
-	else if( FStrEq( pcmd, "closemenus" ) )
-	{
-		// just ignore it
-	}
-	else if( FStrEq( pcmd, "follownext" ) )	// follow next player
-	{
-		if( pPlayer->IsObserver() )
-			pPlayer->Observer_FindNextPlayer( atoi( CMD_ARGV( 1 ) ) != 0 );
-	}
-	else if( FStrEq( pcmd, "numentities" ) )
-	{
-		edict_t* pEdict = ENT( 0 );
-
-		size_t uiCount = 0;
-
-		for( int i = 0; i < gpGlobals->maxEntities; ++i, ++pEdict )
-		{
-			if( !pEdict->free && pEdict->pvPrivateData )
-				++uiCount;
-		}
-
-		ClientPrint( pPlayer, HUD_PRINTCONSOLE, UTIL_VarArgs( "Number of entities: %u (max: %d)\n", uiCount, gpGlobals->maxEntities ) );
-	}
-	else if( FStrEq( pcmd, "ent_setname" ) )
-	{
-		if( UTIL_CheatsAllowed() )
-		{
-			if( CMD_ARGC() >= 1 )
-			{
-				if( CBaseEntity* pEnt = UTIL_FindEntityForward( pPlayer ) )
-				{
-					pEnt->SetTargetname( ALLOC_STRING( CMD_ARGV( 1 ) ) );
-
-					ClientPrint( pPlayer, HUD_PRINTCONSOLE, "Set name on entity\n" );
-				}
-				else
-				{
-					ClientPrint( pPlayer, HUD_PRINTCONSOLE, "No entity in front of you\n" );
-				}
-			}
-			else
-			{
-				ClientPrint( pPlayer, HUD_PRINTCONSOLE, "Usage: ent_setname <name>\n" );
-			}
-		}
-	}
-	else if( FStrEq( pcmd, "ent_trigger" ) )
-	{
-		if( UTIL_CheatsAllowed() )
-		{
-			if( CMD_ARGC() >= 1 )
-			{
-				ClientPrint( pPlayer, HUD_PRINTCONSOLE, UTIL_VarArgs( "\tent_trigger: Firing targets \"%s\"\n", CMD_ARGV( 1 ) ) );
-				FireTargets( CMD_ARGV( 1 ), pPlayer, pPlayer, USE_TOGGLE, 0 );
-			}
-			else
-			{
-				ClientPrint( pPlayer, HUD_PRINTCONSOLE, "Usage: ent_trigger <targetname>\n" );
-			}
-		}
-	}
-	else if( FStrEq( pcmd, "listentityclass" ) )
+	else if( !g_ClientCommands.CheckUnknownCommandRate( *pPlayer ) )
 	{
-		if( UTIL_CheatsAllowed() )
-		{
-			if( CMD_ARGC() >= 1 )
-			{
-				if( auto pReg = GetEntityDict().FindEntityClassByEntityName( CMD_ARGV( 1 ) ) )
-				{
-					ClientPrint( pPlayer, HUD_PRINTCONSOLE, UTIL_VarArgs( "Class \"%s\": \"%s\" (%u bytes)\n", pReg->GetEntityname(), pReg->GetClassname(), pReg->GetSize() ) );
-				}
-				else
-				{
-					ClientPrint( pPlayer, HUD_PRINTCONSOLE, "Couldn't find entity class \"%s\"\n", CMD_ARGV( 1 ) );
-				}
-			}
-			else
-			{
-				ClientPrint( pPlayer, HUD_PRINTCONSOLE, "Usage: listentityclass <entity class name>\n" );
-			}
-		}
-	}
-	else if( FStrEq( pcmd, "listentityclasses" ) )
-	{
-		if( UTIL_CheatsAllowed() )
-		{
-			GetEntityDict().EnumEntityClasses(
-				[]( CBaseEntityRegistry& reg ) -> bool
-			{
-				//Using Alert here since it's a lot of data.
-				Alert( at_console, "Class \"%s\": \"%s\" (%u bytes)\n", reg.GetEntityname(), reg.GetClassname(), reg.GetSize() );
-
-				return true;
-			}
-			);
-		}
-	}
-	else if( FStrEq( pcmd, "WpnInfo" ) )
-	{
-		//Verify integrity. - Solokiller
-
-		bool bSuccess = false;
-
-		const char* pszMessage = nullptr;
-
-		pPlayer->SetWeaponValidationReceived( true );
-
-		if( CMD_ARGC() == 5 )
-		{
-			const size_t uiNumAmmoTypes = strtoul( CMD_ARGV( 1 ), nullptr, 10 );
-			const size_t uiClientAmmoHash = strtoul( CMD_ARGV( 2 ), nullptr, 10 );
-			const size_t uiNumWeapons = strtoul( CMD_ARGV( 3 ), nullptr, 10 );
-			const size_t uiClientWeaponHash = strtoul( CMD_ARGV( 4 ), nullptr, 10 );
-
-			const size_t uiAmmoHash = g_AmmoTypes.GenerateHash();
-			const size_t uiWeaponHash = g_WeaponInfoCache.GenerateHash();
-
-			if( g_AmmoTypes.GetAmmoTypesCount() != uiNumAmmoTypes )
-			{
-				pszMessage = UTIL_VarArgs( "Ammo count verification failed: Server has %u, Client has %u", g_AmmoTypes.GetAmmoTypesCount(), uiNumAmmoTypes );
-			}
-			else if( uiClientAmmoHash != uiAmmoHash )
-			{
-				pszMessage = UTIL_VarArgs( "Ammo hash verification failed: Server has %u, Client has %u", uiAmmoHash, uiClientAmmoHash );
-			}
-			else if( g_WeaponInfoCache.GetWeaponCount() != uiNumWeapons )
-			{
-				pszMessage = UTIL_VarArgs( "Weapon count verification failed: Server has %u, Client has %u", g_WeaponInfoCache.GetWeaponCount(), uiNumWeapons );
-			}
-			else if( uiClientWeaponHash != uiWeaponHash )
-			{
-				pszMessage = UTIL_VarArgs( "Weapon hash verification failed: Server has %u, Client has %u", uiWeaponHash, uiClientWeaponHash );
-			}
-			else
-			{
-				bSuccess = true;
-
-				//Have to do this because player weapons on the client side are created after messages containing clips arrive. - Solokiller
-				//This tells the server to resend weapon clips on demand.
-				CBasePlayerWeapon* pWeapon;
-
-				for( int iBucket = 0; iBucket < MAX_WEAPON_SLOTS; ++iBucket )
-				{
-					pWeapon = pPlayer->m_rgpPlayerItems[ iBucket ];
-
-					while( pWeapon )
-					{
-						pWeapon->m_iClientClip = 0;
-
-						pWeapon = pWeapon->m_pNext;
-					}
-				}
-			}
-		}
-		else
-		{
-			pszMessage = "Invalid weapon verification message received\n";
-		}
-
-		if( !bSuccess )
-		{
-			ALERT( at_logged, "Client ammo & weapon verification failed for \"%s\", disconnecting\n", pPlayer->GetNetName() );
-
-			if( pszMessage )
-				ALERT( at_logged, "The reason given was: %s\n", pszMessage );
-
-			if( !IS_DEDICATED_SERVER() )
-			{
-				//Listen server hosts usually don't have logging enabled, so echo to console unconditionally for them. - Solokiller
-				UTIL_ServerPrintf( "Client ammo & weapon verification failed for \"%s\", disconnecting\n", pPlayer->GetNetName() );
-
-				if( pszMessage )
-					UTIL_ServerPrintf( "The reason given was: %s\n", pszMessage );
-			}
-
-			if( IS_DEDICATED_SERVER() || pPlayer->entindex() != 1 )
-			{
-				const char* pszCommand;
-
-				if( pszMessage )
-				{
-					pszCommand = UTIL_VarArgs( "kick \"%s\" \"%s\"\n", pPlayer->GetNetName(), pszMessage );
-				}
-				else
-				{
-					pszCommand = UTIL_VarArgs( "kick \"%s\"\n", pPlayer->GetNetName() );
-				}
-
-				SERVER_COMMAND( pszCommand );
-			}
-			else
-			{
-				//The local player can't be kicked, so terminate the session instead - Solokiller
-				CLIENT_COMMAND( pEntity, "disconnect\n" );
-			}
-		}
+		//Client is spamming unknown commands, ignore.
 	}
 	else if( g_pGameRules->ClientCommand( pPlayer, pcmd ) )
 	{
@@ -523,6 +610,11 @@ void CServerGameInterface::WorldInit()
 	//This will be worldspawn for new maps and multiplayer maps, the first restored entity when transitioning or loading maps.
 	CMap::CreateIfNeeded();
 
+	//Resolve texture materials before anything can trace against the new map.
+	g_MaterialsList.LoadMapTextures( UTIL_VarArgs( "maps/%s.bsp", STRING( gpGlobals->mapname ) ) );
+
+	g_ClientPVS.LoadMap( UTIL_VarArgs( "maps/%s.bsp", STRING( gpGlobals->mapname ) ) );
+
 	if( m_ServerConfig )
 	{
 		//Apply server classification settings first.
@@ -573,6 +665,9 @@ void CServerGameInterface::Activate( edict_t* pEdictList, const int edictCount,
 	g_ASManager.WorldActivated();
 #endif
 
+	//All weapon info and replacement files for this map have been loaded by now.
+	g_KeyValueFileCache.Save();
+
 	//If no graph is present, build it.
 	if( !WorldGraph.m_fGraphPresent )
 	{
@@ -598,6 +693,9 @@ void CServerGameInterface::Activate( edict_t* pEdictList, const int edictCount,
 			ALERT( at_console, "**Graph Pointers Set!\n" );
 		}
 	}
+
+	//Every entity has its name by now.
+	g_TargetnameGraph.Build();
 }
 
 void CServerGameInterface::Deactivate()
@@ -614,15 +712,30 @@ void CServerGameInterface::Deactivate()
 	//Set this up for the next map. This requires no entities to be created after the server has deactivated. - Solokiller
 	m_bMapStartedLoading = true;
 
+	//Recordings are tied to the map they were made on.
+	g_PlayerMoveRecorder.StopRecording();
+
+	g_TargetnameGraph.Clear();
+
+	g_MonsterRegistry.Clear();
+
+	g_PathTrackTables.Clear();
+
 	// Peform any shutdown operations here...
 	//
 }
 
 void CServerGameInterface::StartFrame()
 {
+	SV_PROF_BEGIN_FRAME();
+	SV_PROF_ZONE( ProfZone::START_FRAME );
+
 	if( g_pGameRules )
 		g_pGameRules->Think();
 
+	//Entities think after this, so client visibility must be current.
+	g_ClientPVS.Update();
+
 	if( g_fGameOver )
 		return;
 
@@ -632,6 +745,8 @@ void CServerGameInterface::StartFrame()
 	CMap::GetInstance()->Think();
 
 #if USE_ANGELSCRIPT
+	SV_PROF_ZONE( ProfZone::SCRIPT_THINK );
+
 	g_ASManager.Think();
 #endif
 }
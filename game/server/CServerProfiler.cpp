@@ -0,0 +1,395 @@
+#if USE_SERVER_PROFILER
+
+#include <algorithm>
+#include <string>
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+
+#include "entities/CEntityDictionary.h"
+#include "entities/CEntityRegistry.h"
+
+#include "CServerProfiler.h"
+
+CServerProfiler g_ServerProfiler;
+
+namespace
+{
+const char* const g_pszZoneNames[] =
+{
+	"StartFrame",
+	"ScriptThink",
+	"EntityThink",
+	"EntityTouch",
+	"PlayerPreThink",
+	"PlayerPostThink",
+	"AddToFullPack"
+};
+
+static_assert( ARRAYSIZE( g_pszZoneNames ) == static_cast<size_t>( ProfZone::COUNT ), "Zone names must match ProfZone" );
+
+long long ElapsedNanoseconds( const CServerProfiler::TimePoint_t start, const CServerProfiler::TimePoint_t end )
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>( end - start ).count();
+}
+
+void ServerCommand_ProfStart()
+{
+	g_ServerProfiler.Start();
+
+	Alert( at_console, "Server profiling started\n" );
+}
+
+void ServerCommand_ProfStop()
+{
+	g_ServerProfiler.Stop();
+
+	Alert( at_console, "Server profiling stopped\n" );
+}
+
+void ServerCommand_ProfReport()
+{
+	const int iCount = CMD_ARGC() >= 2 ? atoi( CMD_ARGV( 1 ) ) : 20;
+
+	g_ServerProfiler.PrintReport( static_cast<size_t>( max( 1, iCount ) ) );
+}
+
+void ServerCommand_ProfTrace()
+{
+	if( CMD_ARGC() < 2 )
+	{
+		Alert( at_console, "Usage: sv_prof_trace <frames> [filename]\n" );
+		return;
+	}
+
+	const int iFrames = atoi( CMD_ARGV( 1 ) );
+
+	const char* pszFileName = CMD_ARGC() >= 3 ? CMD_ARGV( 2 ) : "sv_prof_trace.json";
+
+	if( iFrames <= 0 || iFrames > CServerProfiler::MAX_TRACE_FRAMES )
+	{
+		Alert( at_console, "sv_prof_trace: frame count must be between 1 and %d\n", CServerProfiler::MAX_TRACE_FRAMES );
+		return;
+	}
+
+	if( g_ServerProfiler.StartTrace( iFrames, pszFileName ) )
+		Alert( at_console, "Tracing %d frames to \"%s\"\n", iFrames, pszFileName );
+}
+}
+
+void CServerProfiler::Initialize()
+{
+	g_engfuncs.pfnAddServerCommand( "sv_prof_start", &::ServerCommand_ProfStart );
+	g_engfuncs.pfnAddServerCommand( "sv_prof_stop", &::ServerCommand_ProfStop );
+	g_engfuncs.pfnAddServerCommand( "sv_prof_report", &::ServerCommand_ProfReport );
+	g_engfuncs.pfnAddServerCommand( "sv_prof_trace", &::ServerCommand_ProfTrace );
+}
+
+void CServerProfiler::Start()
+{
+	m_uiFrameCount = 0;
+	m_iTotalFrameTime = 0;
+
+	std::fill( std::begin( m_iZoneTime ), std::end( m_iZoneTime ), 0 );
+
+	m_Classes.clear();
+	m_RegisteredClasses.clear();
+	m_UnregisteredClasses.clear();
+
+	m_bInFrame = false;
+	m_CurrentFrame = FrameBreakdown();
+	m_FrameClassTime.clear();
+	m_FrameClasses.clear();
+
+	m_WorstFrame = FrameBreakdown();
+
+	m_iTraceFramesLeft = 0;
+	m_TraceEvents.clear();
+
+	m_bActive = true;
+}
+
+void CServerProfiler::Stop()
+{
+	m_bActive = false;
+	m_bInFrame = false;
+
+	//Write whatever was recorded so far.
+	if( m_iTraceFramesLeft > 0 )
+		WriteTrace();
+}
+
+void CServerProfiler::BeginFrame()
+{
+	if( !m_bActive )
+		return;
+
+	const auto now = CStopwatch::Clock_t::now();
+
+	if( m_bInFrame )
+		EndFrame( now );
+
+	m_bInFrame = true;
+	m_FrameStart = now;
+}
+
+size_t CServerProfiler::GetClassIndex( CBaseEntity& entity )
+{
+	const char* const pszClassname = entity.GetClassname();
+
+	if( auto pRegistry = GetEntityDict().FindEntityClassByEntityName( pszClassname ) )
+	{
+		auto it = m_RegisteredClasses.find( pRegistry );
+
+		if( it != m_RegisteredClasses.end() )
+			return it->second;
+
+		ClassStats stats;
+
+		stats.szName = std::string( pRegistry->GetEntityname() ) + " (" + pRegistry->GetClassname() + ')';
+
+		m_Classes.emplace_back( std::move( stats ) );
+
+		return m_RegisteredClasses.emplace( pRegistry, m_Classes.size() - 1 ).first->second;
+	}
+
+	//Entities created by scripts aren't in the dictionary.
+	auto it = m_UnregisteredClasses.find( pszClassname );
+
+	if( it != m_UnregisteredClasses.end() )
+		return it->second;
+
+	ClassStats stats;
+
+	stats.szName = pszClassname;
+
+	m_Classes.emplace_back( std::move( stats ) );
+
+	return m_UnregisteredClasses.emplace( pszClassname, m_Classes.size() - 1 ).first->second;
+}
+
+void CServerProfiler::AddZoneTime( const ProfZone zone, const size_t uiClassIndex, const TimePoint_t start, const TimePoint_t end )
+{
+	//Stopped while in this zone.
+	if( !m_bActive )
+		return;
+
+	const long long iTime = ElapsedNanoseconds( start, end );
+
+	m_CurrentFrame.iZoneTime[ static_cast<size_t>( zone ) ] += iTime;
+
+	if( uiClassIndex != INVALID_CLASS )
+	{
+		auto& stats = m_Classes[ uiClassIndex ];
+
+		if( zone == ProfZone::ENTITY_TOUCH )
+		{
+			++stats.uiTouches;
+			stats.iTouchTime += iTime;
+		}
+		else
+		{
+			++stats.uiThinks;
+			stats.iThinkTime += iTime;
+			stats.iWorstThink = std::max( stats.iWorstThink, iTime );
+		}
+
+		if( m_FrameClassTime.size() < m_Classes.size() )
+			m_FrameClassTime.resize( m_Classes.size(), 0 );
+
+		if( m_FrameClassTime[ uiClassIndex ] == 0 )
+			m_FrameClasses.push_back( uiClassIndex );
+
+		m_FrameClassTime[ uiClassIndex ] += iTime;
+	}
+
+	if( m_iTraceFramesLeft > 0 )
+		m_TraceEvents.push_back( { zone, uiClassIndex, ElapsedNanoseconds( m_TraceStart, start ), iTime } );
+}
+
+void CServerProfiler::PrintReport( const size_t uiMaxClasses ) const
+{
+	if( m_uiFrameCount == 0 )
+	{
+		Alert( at_console, "No frames profiled%s\n", m_bActive ? " yet" : ", use sv_prof_start to start profiling" );
+		return;
+	}
+
+	Alert( at_console, "%llu frames, average %.3f ms, worst %.3f ms (frame %llu)\n",
+		   m_uiFrameCount, ( m_iTotalFrameTime / static_cast<double>( m_uiFrameCount ) ) / 1000000.0,
+		   m_WorstFrame.iFrameTime / 1000000.0, m_WorstFrame.uiFrame );
+
+	Alert( at_console, "%-16s %12s %14s %14s\n", "zone", "total ms", "avg us/frame", "worst frame us" );
+
+	for( size_t uiZone = 0; uiZone < ZONE_COUNT; ++uiZone )
+	{
+		Alert( at_console, "%-16s %12.3f %14.2f %14.2f\n",
+			   g_pszZoneNames[ uiZone ], m_iZoneTime[ uiZone ] / 1000000.0,
+			   ( m_iZoneTime[ uiZone ] / static_cast<double>( m_uiFrameCount ) ) / 1000.0,
+			   m_WorstFrame.iZoneTime[ uiZone ] / 1000.0 );
+	}
+
+	Alert( at_console, "\nWorst frame entity classes:\n" );
+
+	for( const auto& frameClass : m_WorstFrame.Classes )
+	{
+		Alert( at_console, "%10.2f us %s\n", frameClass.second / 1000.0, m_Classes[ frameClass.first ].szName.c_str() );
+	}
+
+	std::vector<const ClassStats*> classes;
+
+	classes.reserve( m_Classes.size() );
+
+	for( const auto& stats : m_Classes )
+	{
+		classes.push_back( &stats );
+	}
+
+	std::sort( classes.begin(), classes.end(), []( const ClassStats* pLHS, const ClassStats* pRHS )
+		{
+			return ( pLHS->iThinkTime + pLHS->iTouchTime ) > ( pRHS->iThinkTime + pRHS->iTouchTime );
+		}
+	);
+
+	const size_t uiCount = std::min( uiMaxClasses, classes.size() );
+
+	Alert( at_console, "\n%12s %10s %10s %10s %12s %10s  %s\n", "think ms", "thinks", "avg us", "worst us", "touch ms", "touches", "class" );
+
+	for( size_t uiIndex = 0; uiIndex < uiCount; ++uiIndex )
+	{
+		const auto& stats = *classes[ uiIndex ];
+
+		Alert( at_console, "%12.3f %10llu %10.2f %10.2f %12.3f %10llu  %s\n",
+			   stats.iThinkTime / 1000000.0, stats.uiThinks,
+			   stats.uiThinks ? ( stats.iThinkTime / static_cast<double>( stats.uiThinks ) ) / 1000.0 : 0.0,
+			   stats.iWorstThink / 1000.0,
+			   stats.iTouchTime / 1000000.0, stats.uiTouches,
+			   stats.szName.c_str() );
+	}
+}
+
+bool CServerProfiler::StartTrace( const int iFrames, const char* const pszFileName )
+{
+	if( !m_bActive )
+		Start();
+
+	m_iTraceFramesLeft = iFrames;
+	m_TraceStart = CStopwatch::Clock_t::now();
+	m_szTraceFileName = pszFileName;
+	m_TraceEvents.clear();
+
+	return true;
+}
+
+void CServerProfiler::EndFrame( const TimePoint_t now )
+{
+	m_CurrentFrame.uiFrame = m_uiFrameCount++;
+	m_CurrentFrame.iFrameTime = ElapsedNanoseconds( m_FrameStart, now );
+
+	m_iTotalFrameTime += m_CurrentFrame.iFrameTime;
+
+	for( size_t uiZone = 0; uiZone < ZONE_COUNT; ++uiZone )
+	{
+		m_iZoneTime[ uiZone ] += m_CurrentFrame.iZoneTime[ uiZone ];
+	}
+
+	if( m_CurrentFrame.iFrameTime > m_WorstFrame.iFrameTime )
+	{
+		m_WorstFrame = m_CurrentFrame;
+
+		for( auto uiClassIndex : m_FrameClasses )
+		{
+			m_WorstFrame.Classes.emplace_back( uiClassIndex, m_FrameClassTime[ uiClassIndex ] );
+		}
+
+		std::sort( m_WorstFrame.Classes.begin(), m_WorstFrame.Classes.end(), []( const auto& lhs, const auto& rhs )
+			{
+				return lhs.second > rhs.second;
+			}
+		);
+
+		if( m_WorstFrame.Classes.size() > WORST_FRAME_CLASSES )
+			m_WorstFrame.Classes.resize( WORST_FRAME_CLASSES );
+	}
+
+	for( auto uiClassIndex : m_FrameClasses )
+	{
+		m_FrameClassTime[ uiClassIndex ] = 0;
+	}
+
+	m_FrameClasses.clear();
+
+	m_CurrentFrame = FrameBreakdown();
+
+	if( m_iTraceFramesLeft > 0 )
+	{
+		m_TraceEvents.push_back( { ProfZone::COUNT, INVALID_CLASS, ElapsedNanoseconds( m_TraceStart, m_FrameStart ), ElapsedNanoseconds( m_FrameStart, now ) } );
+
+		if( --m_iTraceFramesLeft == 0 )
+			WriteTrace();
+	}
+}
+
+void CServerProfiler::WriteTrace()
+{
+	m_iTraceFramesLeft = 0;
+
+	FileHandle_t hFile = g_pFileSystem->Open( m_szTraceFileName.c_str(), "w" );
+
+	if( hFile == FILESYSTEM_INVALID_HANDLE )
+	{
+		Alert( at_console, "Couldn't open \"%s\" for writing\n", m_szTraceFileName.c_str() );
+		m_TraceEvents.clear();
+		return;
+	}
+
+	std::string szOutput = "{\"traceEvents\":[\n";
+
+	char szEvent[ 512 ];
+
+	bool bFirst = true;
+
+	for( const auto& event : m_TraceEvents )
+	{
+		const char* pszName;
+		const char* pszCategory;
+
+		if( event.zone == ProfZone::COUNT )
+		{
+			pszName = "Frame";
+			pszCategory = "frame";
+		}
+		else if( event.uiClassIndex != INVALID_CLASS )
+		{
+			pszName = m_Classes[ event.uiClassIndex ].szName.c_str();
+			pszCategory = g_pszZoneNames[ static_cast<size_t>( event.zone ) ];
+		}
+		else
+		{
+			pszName = g_pszZoneNames[ static_cast<size_t>( event.zone ) ];
+			pszCategory = "zone";
+		}
+
+		//Entity and zone names don't contain characters that need escaping.
+		snprintf( szEvent, sizeof( szEvent ), "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+				  bFirst ? "" : ",\n", pszName, pszCategory, event.iStart / 1000.0, event.iDuration / 1000.0 );
+
+		szOutput += szEvent;
+
+		bFirst = false;
+	}
+
+	szOutput += "\n]}\n";
+
+	g_pFileSystem->Write( szOutput.c_str(), szOutput.length(), hFile );
+
+	g_pFileSystem->Close( hFile );
+
+	Alert( at_console, "Wrote %u trace events to \"%s\"\n", static_cast<unsigned int>( m_TraceEvents.size() ), m_szTraceFileName.c_str() );
+
+	m_TraceEvents.clear();
+	m_TraceEvents.shrink_to_fit();
+}
+
+#endif //USE_SERVER_PROFILER
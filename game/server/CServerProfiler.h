@@ -0,0 +1,231 @@
+#ifndef GAME_SERVER_CSERVERPROFILER_H
+#define GAME_SERVER_CSERVERPROFILER_H
+
+/**
+*	@file
+*
+*	Frame profiler for the server library. Only compiled in if USE_SERVER_PROFILER is enabled;
+*	otherwise the SV_PROF macros expand to nothing.
+*/
+
+#if USE_SERVER_PROFILER
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CStopwatch.h"
+
+class CBaseEntity;
+class CBaseEntityRegistry;
+
+/**
+*	Server entry points that are timed.
+*/
+enum class ProfZone
+{
+	START_FRAME = 0,
+	SCRIPT_THINK,
+	ENTITY_THINK,
+	ENTITY_TOUCH,
+	PLAYER_PRETHINK,
+	PLAYER_POSTTHINK,
+	ADD_TO_FULLPACK,
+
+	COUNT
+};
+
+/**
+*	Times server entry points and aggregates entity think and touch time per entity class.
+*	Frames start at StartFrame and end when the next StartFrame is called.
+*/
+class CServerProfiler final
+{
+public:
+	using TimePoint_t = CStopwatch::Clock_t::time_point;
+
+	static const size_t INVALID_CLASS = static_cast<size_t>( -1 );
+
+	static const int MAX_TRACE_FRAMES = 1000;
+
+	/**
+	*	Number of classes listed in the worst frame breakdown.
+	*/
+	static const size_t WORST_FRAME_CLASSES = 10;
+
+private:
+	static const size_t ZONE_COUNT = static_cast<size_t>( ProfZone::COUNT );
+
+	/**
+	*	Time spent in an entity class. All times are in nanoseconds.
+	*/
+	struct ClassStats final
+	{
+		std::string szName;
+
+		unsigned long long uiThinks = 0;
+		long long iThinkTime = 0;
+		long long iWorstThink = 0;
+
+		unsigned long long uiTouches = 0;
+		long long iTouchTime = 0;
+	};
+
+	struct FrameBreakdown final
+	{
+		unsigned long long uiFrame = 0;
+
+		long long iFrameTime = 0;
+
+		long long iZoneTime[ ZONE_COUNT ] = {};
+
+		std::vector<std::pair<size_t, long long>> Classes;
+	};
+
+	struct TraceEvent final
+	{
+		ProfZone zone;
+		size_t uiClassIndex;
+
+		//Relative to the start of the trace.
+		long long iStart;
+		long long iDuration;
+	};
+
+public:
+	CServerProfiler() = default;
+	~CServerProfiler() = default;
+
+	/**
+	*	Registers the profiler commands.
+	*/
+	void Initialize();
+
+	bool IsActive() const { return m_bActive; }
+
+	/**
+	*	Starts profiling. Clears data from previous runs.
+	*/
+	void Start();
+
+	void Stop();
+
+	/**
+	*	Ends the current frame and starts the next one.
+	*/
+	void BeginFrame();
+
+	/**
+	*	@return Index of the given entity's class.
+	*/
+	size_t GetClassIndex( CBaseEntity& entity );
+
+	/**
+	*	Adds time spent in a zone.
+	*	@param zone Zone.
+	*	@param uiClassIndex Index of the entity class to charge, or INVALID_CLASS.
+	*	@param start When the zone was entered.
+	*	@param end When the zone was left.
+	*/
+	void AddZoneTime( const ProfZone zone, const size_t uiClassIndex, const TimePoint_t start, const TimePoint_t end );
+
+	void PrintReport( const size_t uiMaxClasses ) const;
+
+	/**
+	*	Records the given number of frames and writes them to a file as Chrome trace events.
+	*	Starts profiling if needed.
+	*/
+	bool StartTrace( const int iFrames, const char* const pszFileName );
+
+private:
+	void EndFrame( const TimePoint_t now );
+
+	void WriteTrace();
+
+private:
+	bool m_bActive = false;
+
+	unsigned long long m_uiFrameCount = 0;
+	long long m_iTotalFrameTime = 0;
+
+	long long m_iZoneTime[ ZONE_COUNT ] = {};
+
+	std::vector<ClassStats> m_Classes;
+
+	std::unordered_map<const CBaseEntityRegistry*, size_t> m_RegisteredClasses;
+	std::unordered_map<std::string, size_t> m_UnregisteredClasses;
+
+	//Current frame.
+	bool m_bInFrame = false;
+	TimePoint_t m_FrameStart;
+	FrameBreakdown m_CurrentFrame;
+	std::vector<long long> m_FrameClassTime;
+	std::vector<size_t> m_FrameClasses;
+
+	FrameBreakdown m_WorstFrame;
+
+	//Trace.
+	int m_iTraceFramesLeft = 0;
+	TimePoint_t m_TraceStart;
+	std::string m_szTraceFileName;
+	std::vector<TraceEvent> m_TraceEvents;
+
+private:
+	CServerProfiler( const CServerProfiler& ) = delete;
+	CServerProfiler& operator=( const CServerProfiler& ) = delete;
+};
+
+extern CServerProfiler g_ServerProfiler;
+
+/**
+*	Times the scope it's declared in.
+*/
+class CServerProfileScope final
+{
+public:
+	CServerProfileScope( const ProfZone zone, CBaseEntity* pEntity = nullptr )
+	{
+		if( !g_ServerProfiler.IsActive() )
+			return;
+
+		m_bActive = true;
+		m_Zone = zone;
+		m_uiClassIndex = pEntity ? g_ServerProfiler.GetClassIndex( *pEntity ) : CServerProfiler::INVALID_CLASS;
+		m_Start = CStopwatch::Clock_t::now();
+	}
+
+	~CServerProfileScope()
+	{
+		if( m_bActive )
+			g_ServerProfiler.AddZoneTime( m_Zone, m_uiClassIndex, m_Start, CStopwatch::Clock_t::now() );
+	}
+
+private:
+	bool m_bActive = false;
+	ProfZone m_Zone;
+	size_t m_uiClassIndex;
+	CServerProfiler::TimePoint_t m_Start;
+
+private:
+	CServerProfileScope( const CServerProfileScope& ) = delete;
+	CServerProfileScope& operator=( const CServerProfileScope& ) = delete;
+};
+
+#define SV_PROF_CONCAT_IMPL( a, b ) a##b
+#define SV_PROF_CONCAT( a, b ) SV_PROF_CONCAT_IMPL( a, b )
+
+#define SV_PROF_INITIALIZE() g_ServerProfiler.Initialize()
+#define SV_PROF_BEGIN_FRAME() g_ServerProfiler.BeginFrame()
+#define SV_PROF_ZONE( zone ) CServerProfileScope SV_PROF_CONCAT( svProfScope, __LINE__ )( zone )
+#define SV_PROF_ENTITY_ZONE( zone, pEntity ) CServerProfileScope SV_PROF_CONCAT( svProfScope, __LINE__ )( zone, pEntity )
+
+#else
+
+#define SV_PROF_INITIALIZE()
+#define SV_PROF_BEGIN_FRAME()
+#define SV_PROF_ZONE( zone )
+#define SV_PROF_ENTITY_ZONE( zone, pEntity )
+
+#endif //USE_SERVER_PROFILER
+
+#endif //GAME_SERVER_CSERVERPROFILER_H
@@ -0,0 +1,133 @@
+#include <algorithm>
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+
+#include "CTargetnameGraph.h"
+
+CTargetnameGraph g_TargetnameGraph;
+
+void CTargetnameGraph::Build()
+{
+	Clear();
+
+	m_bBuilt = true;
+
+	//Index order, so every list is already sorted.
+	for( int iIndex = 1; iIndex < gpGlobals->maxEntities; ++iIndex )
+	{
+		edict_t* pEdict = INDEXENT( iIndex );
+
+		if( !pEdict || pEdict->free )
+			continue;
+
+		if( auto pEntity = CBaseEntity::Instance( pEdict ) )
+			Add( pEntity );
+	}
+
+	ALERT( at_aiconsole, "Targetname graph: %u names\n", static_cast<unsigned int>( m_Names.size() ) );
+}
+
+void CTargetnameGraph::Clear()
+{
+	m_Names.clear();
+	m_bBuilt = false;
+}
+
+void CTargetnameGraph::EntityRenamed( CBaseEntity* pEntity )
+{
+	//The entry under the old name is dropped the next time that name is looked up.
+	if( m_bBuilt && pEntity )
+		Add( pEntity );
+}
+
+void CTargetnameGraph::EntityRemoved( CBaseEntity* pEntity )
+{
+	if( !m_bBuilt || !pEntity || !pEntity->HasTargetname() )
+		return;
+
+	auto it = m_Names.find( pEntity->GetTargetname() );
+
+	if( it == m_Names.end() )
+		return;
+
+	auto& entries = it->second;
+
+	const int iIndex = pEntity->entindex();
+
+	auto entryIt = std::lower_bound( entries.begin(), entries.end(), iIndex, []( const Entry& entry, const int iIndex )
+	{
+		return entry.iIndex < iIndex;
+	} );
+
+	if( entryIt != entries.end() && entryIt->iIndex == iIndex )
+		entries.erase( entryIt );
+}
+
+CBaseEntity* CTargetnameGraph::FindNext( CBaseEntity* pStartEntity, const char* pszName )
+{
+	if( !m_bBuilt )
+		return UTIL_FindEntityByString( pStartEntity, "targetname", pszName );
+
+	if( !pszName || !( *pszName ) )
+		return nullptr;
+
+	auto it = m_Names.find( pszName );
+
+	if( it == m_Names.end() )
+		return nullptr;
+
+	auto& entries = it->second;
+
+	const int iStartIndex = pStartEntity ? pStartEntity->entindex() : 0;
+
+	//Targets can create, remove and rename entities when they're used, so always search by index instead of keeping a position.
+	auto entryIt = std::upper_bound( entries.begin(), entries.end(), iStartIndex, []( const int iIndex, const Entry& entry )
+	{
+		return iIndex < entry.iIndex;
+	} );
+
+	while( entryIt != entries.end() )
+	{
+		CBaseEntity* pEntity = entryIt->hEntity;
+
+		if( pEntity && FStrEq( pEntity->GetTargetname(), pszName ) )
+			return pEntity;
+
+		//Freed or renamed.
+		entryIt = entries.erase( entryIt );
+	}
+
+	return nullptr;
+}
+
+void CTargetnameGraph::Add( CBaseEntity* pEntity )
+{
+	if( !pEntity->HasTargetname() )
+		return;
+
+	auto it = m_Names.find( pEntity->GetTargetname() );
+
+	//Names aren't always allocated for the whole map, so keep a copy.
+	if( it == m_Names.end() )
+		it = m_Names.emplace( g_StringPool.Allocate( pEntity->GetTargetname() ), Entries_t() ).first;
+
+	auto& entries = it->second;
+
+	const int iIndex = pEntity->entindex();
+
+	auto entryIt = std::lower_bound( entries.begin(), entries.end(), iIndex, []( const Entry& entry, const int iIndex )
+	{
+		return entry.iIndex < iIndex;
+	} );
+
+	if( entryIt != entries.end() && entryIt->iIndex == iIndex )
+	{
+		//Might be a different entity using the same edict.
+		entryIt->hEntity = pEntity;
+		return;
+	}
+
+	entries.insert( entryIt, Entry{ pEntity, iIndex } );
+}
@@ -0,0 +1,84 @@
+#ifndef GAME_SERVER_CTARGETNAMEGRAPH_H
+#define GAME_SERVER_CTARGETNAMEGRAPH_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "StringUtils.h"
+
+#include "entities/EHandle.h"
+
+class CBaseEntity;
+
+/**
+*	Maps targetnames to the entities that have them, so firing targets doesn't have to scan every edict.
+*	Built once the map has activated. Each name has a list of handles sorted by entity index, so lookups return entities
+*	in the same order as a scan of the edict list would.
+*
+*	Entities are added when they're given a name, and removed when they're removed from the world.
+*	Entries whose entity has since been freed or renamed are dropped when they're next looked at.
+*	Until the graph has been built, lookups fall back to scanning the edict list.
+*/
+class CTargetnameGraph final
+{
+private:
+	struct Entry final
+	{
+		EHANDLE hEntity;
+		int iIndex;
+	};
+
+	using Entries_t = std::vector<Entry>;
+
+	//Keys are pooled copies of the names, so lookups don't have to allocate.
+	using Names_t = std::unordered_map<const char*, Entries_t, RawCharHash, RawCharEqualTo>;
+
+public:
+	CTargetnameGraph() = default;
+	~CTargetnameGraph() = default;
+
+	bool IsBuilt() const { return m_bBuilt; }
+
+	/**
+	*	Adds every named entity. Called after all entities have been activated.
+	*/
+	void Build();
+
+	/**
+	*	Removes everything. Lookups scan the edict list until the graph is built again.
+	*/
+	void Clear();
+
+	/**
+	*	The given entity's targetname has been set. Call after the name has changed.
+	*/
+	void EntityRenamed( CBaseEntity* pEntity );
+
+	/**
+	*	The given entity is being removed from the world.
+	*/
+	void EntityRemoved( CBaseEntity* pEntity );
+
+	/**
+	*	Finds the next entity with the given targetname.
+	*	@param pStartEntity Entity to start searching after. Null to start at the beginning.
+	*	@return Next entity, or null if there are no more.
+	*/
+	CBaseEntity* FindNext( CBaseEntity* pStartEntity, const char* pszName );
+
+private:
+	void Add( CBaseEntity* pEntity );
+
+private:
+	Names_t m_Names;
+
+	bool m_bBuilt = false;
+
+private:
+	CTargetnameGraph( const CTargetnameGraph& ) = delete;
+	CTargetnameGraph& operator=( const CTargetnameGraph& ) = delete;
+};
+
+extern CTargetnameGraph g_TargetnameGraph;
+
+#endif //GAME_SERVER_CTARGETNAMEGRAPH_H
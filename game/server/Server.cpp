@@ -60,9 +60,46 @@ cvar_t	server_cfg = { "server_cfg", "server/default_server_config.xml", FCVAR_SE
 
 cvar_t	as_plugin_list_file = { "as_plugin_list_file", "default_plugins.xml", FCVAR_SERVER | FCVAR_UNLOGGED };
 
+//Whether to record per hook timing for Angelscript events. See as_event_stats.
+cvar_t	as_event_profile = { "as_event_profile", "0", FCVAR_SERVER | FCVAR_UNLOGGED };
+
+//Whether to load map scripts and plugins from the bytecode cache when their sources haven't changed.
+cvar_t	as_script_cache = { "as_script_cache", "1", FCVAR_SERVER | FCVAR_UNLOGGED };
+
 //Config file that contains the MySQL settings to use for default connections.
 cvar_t	as_mysql_config = { "as_mysql_config", "server/default_mysql_config.xml", FCVAR_SERVER | FCVAR_UNLOGGED };
 
+//Number of SQL worker threads. 0 picks a count based on the number of cores. Only read on startup.
+cvar_t	as_sql_threads = { "as_sql_threads", "0", FCVAR_SERVER | FCVAR_UNLOGGED };
+
+//Time in milliseconds that SQL completion callbacks may use each frame.
+cvar_t	as_sql_frame_budget = { "as_sql_frame_budget", "2", FCVAR_SERVER | FCVAR_UNLOGGED };
+
+//Whether monsters far away from players sense less often. See ai_lod_report.
+cvar_t	ai_lod = { "ai_lod", "1", FCVAR_SERVER };
+
+//Monsters further than this from the nearest player use the reduced sensing tier.
+cvar_t	ai_lod_reduced_dist = { "ai_lod_reduced_dist", "1024", FCVAR_SERVER };
+
+//Monsters further than this from the nearest player use the low sensing tier.
+cvar_t	ai_lod_low_dist = { "ai_lod_low_dist", "2048", FCVAR_SERVER };
+
+//Seconds without player contact after which monsters drop down a tier.
+cvar_t	ai_lod_contact_time = { "ai_lod_contact_time", "10", FCVAR_SERVER };
+
+//Time in seconds between sensing passes in the reduced and low tiers.
+cvar_t	ai_lod_reduced_interval = { "ai_lod_reduced_interval", "0.3", FCVAR_SERVER };
+cvar_t	ai_lod_low_interval = { "ai_lod_low_interval", "1", FCVAR_SERVER };
+
+//Whether client commands are rate limited.
+cvar_t	sv_cmd_ratelimit = { "sv_cmd_ratelimit", "1", FCVAR_SERVER };
+
+//Whether monster schedule and task transitions are recorded. See ai_sched_trace_dump and ai_sched_stats.
+cvar_t	ai_sched_trace = { "ai_sched_trace", "0", FCVAR_SERVER };
+
+//Whether HUD state messages are coalesced and sent once per frame. See sv_hudmsg_stats.
+cvar_t	sv_hudmsg_coalesce = { "sv_hudmsg_coalesce", "1", FCVAR_SERVER };
+
 // Engine Cvars
 cvar_t 	*g_psv_gravity = NULL;
 cvar_t	*g_psv_aim = NULL;
@@ -629,7 +666,26 @@ void GameDLLInit( void )
 
 	CVAR_REGISTER( &as_plugin_list_file );
 
+	CVAR_REGISTER( &as_event_profile );
+
+	CVAR_REGISTER( &as_script_cache );
+
 	CVAR_REGISTER( &as_mysql_config );
+	CVAR_REGISTER( &as_sql_threads );
+	CVAR_REGISTER( &as_sql_frame_budget );
+
+	CVAR_REGISTER( &ai_lod );
+	CVAR_REGISTER( &ai_lod_reduced_dist );
+	CVAR_REGISTER( &ai_lod_low_dist );
+	CVAR_REGISTER( &ai_lod_contact_time );
+	CVAR_REGISTER( &ai_lod_reduced_interval );
+	CVAR_REGISTER( &ai_lod_low_interval );
+
+	CVAR_REGISTER( &sv_cmd_ratelimit );
+
+	CVAR_REGISTER( &ai_sched_trace );
+
+	CVAR_REGISTER( &sv_hudmsg_coalesce );
 
 // REGISTER CVARS FOR SKILL LEVEL STUFF
 	// Agrunt
@@ -43,7 +43,23 @@ extern cvar_t	allowmonsters;
 extern cvar_t	sv_new_impulse_check;
 extern cvar_t	server_cfg;
 extern cvar_t	as_plugin_list_file;
+extern cvar_t	as_event_profile;
+extern cvar_t	as_script_cache;
 extern cvar_t	as_mysql_config;
+extern cvar_t	as_sql_threads;
+extern cvar_t	as_sql_frame_budget;
+extern cvar_t	ai_lod;
+extern cvar_t	ai_lod_reduced_dist;
+extern cvar_t	ai_lod_low_dist;
+extern cvar_t	ai_lod_contact_time;
+extern cvar_t	ai_lod_reduced_interval;
+extern cvar_t	ai_lod_low_interval;
+
+extern cvar_t	sv_cmd_ratelimit;
+
+extern cvar_t	ai_sched_trace;
+
+extern cvar_t	sv_hudmsg_coalesce;
 
 // Engine Cvars
 extern cvar_t	*g_psv_gravity;
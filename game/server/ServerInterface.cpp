@@ -28,6 +28,11 @@
 #include "CStudioBlending.h"
 
 #include "CMap.h"
+#include "CPlayerMoveRecorder.h"
+#include "CServerProfiler.h"
+#include "CTargetnameGraph.h"
+
+#include "entities/NPCs/CMonsterRegistry.h"
 
 #include "engine/saverestore/CSaveRestoreBuffer.h"
 #include "engine/saverestore/CSave.h"
@@ -95,7 +100,7 @@ DLL_FUNCTIONS gFunctionTable =
 
 	Sys_Error,					//pfnSys_Error				Called when engine has encountered an error
 
-	PM_Move,					//pfnPM_Move
+	PM_Move_Server,				//pfnPM_Move				Server version of player movement
 	PM_Init,					//pfnPM_Init				Server version of player movement initialization
 	PM_FindTextureType,			//pfnPM_FindTextureType
 
@@ -225,6 +230,9 @@ int DispatchSpawn( edict_t *pent )
 			}
 		}
 
+		//Registered here rather than in MonsterInit, since not every monster calls it.
+		if( pEntity && pEntity->MyMonsterPointer() && pEntity->IsAlive() )
+			g_MonsterRegistry.Register( pEntity->MyMonsterPointer() );
 	}
 
 	return 0;
@@ -238,6 +246,8 @@ void DispatchThink( edict_t *pent )
 		if( pEntity->GetFlags().Any( FL_DORMANT ) )
 			ALERT( at_error, "Dormant entity %s is thinking!!\n", pEntity->GetClassname() );
 
+		SV_PROF_ENTITY_ZONE( ProfZone::ENTITY_THINK, pEntity );
+
 		pEntity->Think();
 	}
 }
@@ -263,7 +273,11 @@ void DispatchTouch( edict_t *pentTouched, edict_t *pentOther )
 	CBaseEntity *pOther = ( CBaseEntity * ) GET_PRIVATE( pentOther );
 
 	if( pEntity && pOther && !( ( pEntity->GetFlags() | pOther->GetFlags() ) & FL_KILLME ) )
+	{
+		SV_PROF_ENTITY_ZONE( ProfZone::ENTITY_TOUCH, pEntity );
+
 		pEntity->Touch( pOther );
+	}
 }
 
 void DispatchBlocked( edict_t *pentBlocked, edict_t *pentOther )
@@ -282,6 +296,10 @@ void DispatchKeyValue( edict_t *pentKeyvalue, KeyValueData *pkvd )
 
 	EntvarsKeyvalue( VARS( pentKeyvalue ), pkvd );
 
+	//Entities created after the map has activated can be given a name this way.
+	if( pkvd->fHandled && g_TargetnameGraph.IsBuilt() && FStrEq( pkvd->szKeyName, "targetname" ) )
+		g_TargetnameGraph.EntityRenamed( static_cast<CBaseEntity*>( GET_PRIVATE( pentKeyvalue ) ) );
+
 	// If the key was an entity variable, or there's no class set yet, don't look for the object, it may
 	// not exist yet.
 	if( pkvd->fHandled || pkvd->szClassName == NULL )
@@ -68,6 +68,14 @@ int gmsgWpnBody = 0;
 */
 int gmsgGameState = 0;
 
+/**
+*	Tracers for a single shot that share a source.
+*	Byte: Number of tracers.
+*	Coord x 3: Source.
+*	For each tracer: Coord x 3: End.
+*/
+int gmsgTracers = 0;
+
 void LinkUserMessages()
 {
 	// Already taken care of?
@@ -120,6 +128,8 @@ void LinkUserMessages()
 	gmsgWpnBody = REG_USER_MSG( "WpnBody", 2 );
 
 	gmsgGameState = REG_USER_MSG( "GameState", 1 );
+
+	gmsgTracers = REG_USER_MSG( "Tracers", -1 );
 }
 
 void UMSG_SendGameState( CBasePlayer& player )
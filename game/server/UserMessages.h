@@ -57,6 +57,8 @@ extern int gmsgHudColors;
 
 extern int gmsgWpnBody;
 
+extern int gmsgTracers;
+
 void LinkUserMessages();
 
 /**
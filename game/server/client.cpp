@@ -45,6 +45,7 @@
 #include "UTFUtils.h"
 
 #include "CServerGameInterface.h"
+#include "CServerProfiler.h"
 
 #include "voice_gamemgr.h"
 
@@ -277,12 +278,16 @@ void ServerActivate( edict_t *pEdictList, int edictCount, int clientMax )
 
 void PlayerPreThink( edict_t *pEntity )
 {
+	SV_PROF_ZONE( ProfZone::PLAYER_PRETHINK );
+
 	if( auto pPlayer = ( CBasePlayer* ) GET_PRIVATE( pEntity ) )
 		pPlayer->PreThink();
 }
 
 void PlayerPostThink( edict_t *pEntity )
 {
+	SV_PROF_ZONE( ProfZone::PLAYER_POSTTHINK );
+
 	if( auto pPlayer = ( CBasePlayer* ) GET_PRIVATE( pEntity ) )
 		pPlayer->PostThink();
 }
@@ -398,6 +403,8 @@ we could also use the pas/ pvs that we set in SetupVisibility, if we wanted to.
 */
 int AddToFullPack( entity_state_t *state, int e, edict_t *ent, edict_t *host, int hostflags, int player, unsigned char *pSet )
 {
+	SV_PROF_ZONE( ProfZone::ADD_TO_FULLPACK );
+
 	int					i;
 
 	// don't send if flagged for NODRAW and it's not the host getting the message
@@ -18,6 +18,7 @@
 #include "Decals.h"
 #include "cbase.h"
 #include "Weapons.h"
+#include "CBulletImpacts.h"
 
 void CBaseEntity::TraceAttack( const CTakeDamageInfo& info, Vector vecDir, TraceResult& tr )
 {
@@ -27,13 +28,7 @@ void CBaseEntity::TraceAttack( const CTakeDamageInfo& info, Vector vecDir, Trace
 	{
 		g_MultiDamage.AddMultiDamage( info, this );
 
-		int blood = BloodColor();
-
-		if( blood != DONT_BLEED )
-		{
-			SpawnBlood( vecOrigin, blood, info.GetDamage() );// a little surface blood.
-			TraceBleed( info, vecDir, tr );
-		}
+		g_MultiDamage.AddBlood( this, info, vecOrigin, vecDir, tr );// a little surface blood.
 	}
 }
 
@@ -164,6 +159,8 @@ void CBaseEntity::FireBullets( const unsigned int cShots,
 
 	g_MultiDamage.Clear();
 	g_MultiDamage.SetDamageTypes( DMG_BULLET | DMG_NEVERGIB );
+	g_MultiDamage.DeferBlood();
+	g_BulletImpacts.Begin();
 
 	for( unsigned int iShot = 1; iShot <= cShots; iShot++ )
 	{
@@ -202,15 +199,7 @@ void CBaseEntity::FireBullets( const unsigned int cShots,
 			case BULLET_MONSTER_9MM:
 			case BULLET_MONSTER_12MM:
 			default:
-				MESSAGE_BEGIN( MSG_PAS, SVC_TEMPENTITY, vecTracerSrc );
-				WRITE_BYTE( TE_TRACER );
-				WRITE_COORD( vecTracerSrc.x );
-				WRITE_COORD( vecTracerSrc.y );
-				WRITE_COORD( vecTracerSrc.z );
-				WRITE_COORD( tr.vecEndPos.x );
-				WRITE_COORD( tr.vecEndPos.y );
-				WRITE_COORD( tr.vecEndPos.z );
-				MESSAGE_END();
+				g_BulletImpacts.AddTracer( vecTracerSrc, tr.vecEndPos );
 				break;
 			}
 		}
@@ -223,7 +212,7 @@ void CBaseEntity::FireBullets( const unsigned int cShots,
 			{
 				pEntity->TraceAttack( CTakeDamageInfo( pAttacker, iDamage, DMG_BULLET | ( ( iDamage > 16 ) ? DMG_ALWAYSGIB : DMG_NEVERGIB ) ), vecDir, tr );
 
-				TEXTURETYPE_PlaySound( tr, vecSrc, vecEnd, iBulletType );
+				g_BulletImpacts.AddHit( tr, vecSrc, vecEnd, iBulletType );
 				DecalGunshot( &tr, iBulletType );
 			}
 			else switch( iBulletType )
@@ -232,7 +221,7 @@ void CBaseEntity::FireBullets( const unsigned int cShots,
 			case BULLET_MONSTER_9MM:
 				pEntity->TraceAttack( CTakeDamageInfo( pAttacker, gSkillData.GetMonDmg9MM(), DMG_BULLET ), vecDir, tr );
 
-				TEXTURETYPE_PlaySound( tr, vecSrc, vecEnd, iBulletType );
+				g_BulletImpacts.AddHit( tr, vecSrc, vecEnd, iBulletType );
 				DecalGunshot( &tr, iBulletType );
 
 				break;
@@ -240,7 +229,7 @@ void CBaseEntity::FireBullets( const unsigned int cShots,
 			case BULLET_MONSTER_MP5:
 				pEntity->TraceAttack( CTakeDamageInfo( pAttacker, gSkillData.GetMonDmgMP5(), DMG_BULLET ), vecDir, tr );
 
-				TEXTURETYPE_PlaySound( tr, vecSrc, vecEnd, iBulletType );
+				g_BulletImpacts.AddHit( tr, vecSrc, vecEnd, iBulletType );
 				DecalGunshot( &tr, iBulletType );
 
 				break;
@@ -249,14 +238,14 @@ void CBaseEntity::FireBullets( const unsigned int cShots,
 				pEntity->TraceAttack( CTakeDamageInfo( pAttacker, gSkillData.GetMonDmg12MM(), DMG_BULLET ), vecDir, tr );
 				if( !tracer )
 				{
-					TEXTURETYPE_PlaySound( tr, vecSrc, vecEnd, iBulletType );
+					g_BulletImpacts.AddHit( tr, vecSrc, vecEnd, iBulletType );
 					DecalGunshot( &tr, iBulletType );
 				}
 				break;
 
 			case BULLET_NONE: // FIX 
 				pEntity->TraceAttack( CTakeDamageInfo( pAttacker, 50, DMG_CLUB ), vecDir, tr );
-				TEXTURETYPE_PlaySound( tr, vecSrc, vecEnd, iBulletType );
+				g_BulletImpacts.AddHit( tr, vecSrc, vecEnd, iBulletType );
 				// only decal glass
 				if( !FNullEnt( tr.pHit ) && GET_PRIVATE( tr.pHit )->GetRenderMode() != kRenderNormal )
 				{
@@ -269,6 +258,7 @@ void CBaseEntity::FireBullets( const unsigned int cShots,
 		// make bullet trails
 		UTIL_BubbleTrail( vecSrc, tr.vecEndPos, ( flDistance * tr.flFraction ) / 64.0 );
 	}
+	g_BulletImpacts.End();
 	g_MultiDamage.ApplyMultiDamage( this, pAttacker );
 }
 
@@ -297,6 +287,8 @@ Vector CBaseEntity::FireBulletsPlayer( const unsigned int cShots,
 
 	g_MultiDamage.Clear();
 	g_MultiDamage.SetDamageTypes( DMG_BULLET | DMG_NEVERGIB );
+	g_MultiDamage.DeferBlood();
+	g_BulletImpacts.Begin();
 
 	for( unsigned int iShot = 1; iShot <= cShots; iShot++ )
 	{
@@ -321,7 +313,7 @@ Vector CBaseEntity::FireBulletsPlayer( const unsigned int cShots,
 			{
 				pEntity->TraceAttack( CTakeDamageInfo( pAttacker, iDamage, DMG_BULLET | ( ( iDamage > 16 ) ? DMG_ALWAYSGIB : DMG_NEVERGIB ) ), vecDir, tr );
 
-				TEXTURETYPE_PlaySound( tr, vecSrc, vecEnd, iBulletType );
+				g_BulletImpacts.AddHit( tr, vecSrc, vecEnd, iBulletType );
 				DecalGunshot( &tr, iBulletType );
 			}
 			else switch( iBulletType )
@@ -360,7 +352,7 @@ Vector CBaseEntity::FireBulletsPlayer( const unsigned int cShots,
 
 			case BULLET_NONE: // FIX 
 				pEntity->TraceAttack( CTakeDamageInfo( pAttacker, 50, DMG_CLUB ), vecDir, tr );
-				TEXTURETYPE_PlaySound( tr, vecSrc, vecEnd, iBulletType );
+				g_BulletImpacts.AddHit( tr, vecSrc, vecEnd, iBulletType );
 				// only decal glass
 				if( !FNullEnt( tr.pHit ) && GET_PRIVATE( tr.pHit )->GetRenderMode() != kRenderNormal )
 				{
@@ -373,6 +365,7 @@ Vector CBaseEntity::FireBulletsPlayer( const unsigned int cShots,
 		// make bullet trails
 		UTIL_BubbleTrail( vecSrc, tr.vecEndPos, ( flDistance * tr.flFraction ) / 64.0 );
 	}
+	g_BulletImpacts.End();
 	g_MultiDamage.ApplyMultiDamage( this, pAttacker );
 
 	return Vector( x * vecSpread.x, y * vecSpread.y, 0.0 );
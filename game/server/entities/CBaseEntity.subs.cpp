@@ -26,6 +26,7 @@
 #include "SaveRestore.h"
 #include "nodes/Nodes.h"
 #include "DoorConstants.h"
+#include "CTargetnameGraph.h"
 
 extern CGraph WorldGraph;
 
@@ -58,6 +59,13 @@ void CBaseEntity::UpdateOnRemove( void )
 	{
 		pOwner->DeathNotice( this );
 	}
+
+	g_TargetnameGraph.EntityRemoved( this );
+}
+
+void CBaseEntity::TargetnameChanged()
+{
+	g_TargetnameGraph.EntityRenamed( this );
 }
 
 // Convenient way to delay removing oneself
@@ -95,6 +103,7 @@ void FireTargets( const char *targetName, CBaseEntity *pActivator, CBaseEntity *
 
 	CBaseEntity* pTarget = nullptr;
 
+	//Uses the targetname graph once the map has activated.
 	while( ( pTarget = UTIL_FindEntityByTargetname( pTarget, targetName ) ) != nullptr )
 	{
 		if( !pTarget->GetFlags().Any( FL_KILLME ) ) // Don't use dying ents
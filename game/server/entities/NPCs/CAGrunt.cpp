@@ -152,8 +152,7 @@ void CAGrunt :: TraceAttack( const CTakeDamageInfo& info, Vector vecDir, TraceRe
 	}
 	else
 	{
-		SpawnBlood( tr.vecEndPos, BloodColor(), newInfo.GetDamage());// a little surface blood.
-		TraceBleed( newInfo, vecDir, tr );
+		g_MultiDamage.AddBlood( this, newInfo, tr.vecEndPos, vecDir, tr );// a little surface blood.
 	}
 
 	g_MultiDamage.AddMultiDamage( info, this );
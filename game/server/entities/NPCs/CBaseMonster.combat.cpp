@@ -29,6 +29,7 @@
 #include "animation.h"
 #include "Weapons.h"
 #include "entities/effects/CGib.h"
+#include "CMonsterRegistry.h"
 
 bool CBaseMonster::HasHumanGibs()
 {
@@ -374,6 +375,8 @@ void CBaseMonster::Killed( const CTakeDamageInfo& info, GibAction gibAction )
 
 	Remember( bits_MEMORY_KILLED );
 
+	g_MonsterRegistry.Unregister( this );
+
 	// clear the deceased's sound channels.(may have been firing or reloading when killed)
 	EMIT_SOUND( this, CHAN_WEAPON, "common/null.wav", 1, ATTN_NORM);
 	m_IdealMonsterState = MONSTERSTATE_DEAD;
@@ -848,8 +851,7 @@ void CBaseMonster::TraceAttack( const CTakeDamageInfo& info, Vector vecDir, Trac
 			break;
 		}
 
-		SpawnBlood( tr.vecEndPos, BloodColor(), newInfo.GetDamage());// a little surface blood.
-		TraceBleed( newInfo, vecDir, tr );
+		g_MultiDamage.AddBlood( this, newInfo, tr.vecEndPos, vecDir, tr );// a little surface blood.
 		g_MultiDamage.AddMultiDamage( newInfo, this );
 	}
 }
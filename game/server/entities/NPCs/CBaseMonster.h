@@ -16,6 +16,7 @@
 #define GAME_SERVER_ENTITIES_NPCS_BASEMONSTER_H
 
 #include "Monsters.h"
+#include "MonsterLOD.h"
 
 #define	ROUTE_SIZE			8 // how many waypoints a monster can store at one time
 #define MAX_OLD_ENEMIES		4 // how many old enemies to remember
@@ -234,8 +235,15 @@ public:
 	SCRIPTSTATE			m_scriptState;		// internal cinematic state
 	CCineMonster		*m_pCine;
 
+// AI level of detail. Not saved, monsters start at full detail after a restore.
+	MonsterLOD			m_LODTier;
+	float				m_flNextSenseTime;		// when the next sensing pass is allowed
+	float				m_flLastPlayerContact;	// last time a player was in our PVS, or fought or led us
+
 	virtual bool Restore( CRestore& restore ) override;
 
+	void UpdateOnRemove() override;
+
 	void KeyValue( KeyValueData *pkvd ) override;
 
 // monster use function
@@ -409,6 +417,7 @@ public:
 		virtual void CheckAmmo( void ) { return; };
 		virtual int IgnoreConditions ( void );
 		
+		inline int	GetConditions() const { return m_afConditions; }
 		inline void	SetConditions( int iConditions ) { m_afConditions |= iConditions; }
 		inline void	ClearConditions( int iConditions ) { m_afConditions &= ~iConditions; }
 		inline bool HasConditions( int iConditions ) const { return ( m_afConditions & iConditions ) != 0; }
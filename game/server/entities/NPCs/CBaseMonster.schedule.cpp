@@ -25,6 +25,7 @@
 #include "nodes/Nodes.h"
 #include "entities/NPCs/DefaultAI.h"
 #include "entities/CSoundEnt.h"
+#include "MonsterScheduleTrace.h"
 
 extern CGraph WorldGraph;
 
@@ -78,6 +79,9 @@ void CBaseMonster :: ChangeSchedule ( Schedule_t *pNewSchedule )
 {
 	ASSERT( pNewSchedule != NULL );
 
+	if( g_MonsterScheduleTrace.IsEnabled() )
+		g_MonsterScheduleTrace.ScheduleChanging( *this, pNewSchedule );
+
 	m_pSchedule			= pNewSchedule;
 	m_iScheduleIndex	= 0;
 	m_iTaskStatus		= TASKSTATUS_NEW;
@@ -139,6 +143,9 @@ void CBaseMonster :: NextScheduledTask ( void )
 {
 	ASSERT( m_pSchedule != NULL );
 
+	if( g_MonsterScheduleTrace.IsEnabled() )
+		g_MonsterScheduleTrace.TaskDone( *this );
+
 	m_iTaskStatus = TASKSTATUS_NEW;
 	m_iScheduleIndex++;
 
@@ -270,7 +277,11 @@ void CBaseMonster :: MaintainSchedule ( void )
 			const Task_t* pTask = GetTask();
 			ASSERT( pTask != nullptr );
 			TaskBegin();
-			StartTask( *pTask );
+
+			if( g_MonsterScheduleTrace.IsEnabled() )
+				g_MonsterScheduleTrace.StartTask( *this, *pTask );
+			else
+				StartTask( *pTask );
 		}
 
 		// UNDONE: Twice?!!!
@@ -287,7 +298,11 @@ void CBaseMonster :: MaintainSchedule ( void )
 	{
 		const Task_t* pTask = GetTask();
 		ASSERT( pTask != nullptr );
-		RunTask( *pTask );
+
+		if( g_MonsterScheduleTrace.IsEnabled() )
+			g_MonsterScheduleTrace.RunTask( *this, *pTask );
+		else
+			RunTask( *pTask );
 	}
 
 	// UNDONE: We have to do this so that we have an animation set to blend to if RunTask changes the animation
@@ -81,15 +81,25 @@ void CBaseMonster :: RunAI ( void )
 		// things will happen before the player gets there!
 		// UPDATE: We now let COMBAT state monsters think and act fully outside of player PVS. This allows the player to leave 
 		// an area where monsters are fighting, and the fight will continue.
-		if ( UTIL_FindClientInPVS( this ) || ( m_MonsterState == MONSTERSTATE_COMBAT ) )
+		// Monsters far from players, or that haven't seen one in a while, sense less often (see MonsterLOD.h).
+		// Conditions from the last pass are kept until the next one.
+		if ( g_MonsterLOD.ShouldSense( *this ) )
 		{
-			Look( m_flDistLook );
-			Listen();// check for audible sounds. 
+			const bool bClientInPVS = UTIL_FindClientInPVS( this ) != nullptr;
 
-			// now filter conditions.
-			ClearConditions( IgnoreConditions() );
+			if ( bClientInPVS )
+				m_flLastPlayerContact = gpGlobals->time;
 
-			GetEnemy();
+			if ( bClientInPVS || ( m_MonsterState == MONSTERSTATE_COMBAT ) )
+			{
+				Look( m_flDistLook );
+				Listen();// check for audible sounds. 
+
+				// now filter conditions.
+				ClearConditions( IgnoreConditions() );
+
+				GetEnemy();
+			}
 		}
 
 		// do these calculations if monster has an enemy.
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <utility>
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "entities/NPCs/Monsters.h"
+
+#include "CMonsterRegistry.h"
+
+CMonsterRegistry g_MonsterRegistry;
+
+void CMonsterRegistry::Clear()
+{
+	m_Records.clear();
+	m_ByClassification.clear();
+	m_ByClassname.clear();
+}
+
+void CMonsterRegistry::Register( CBaseMonster* pMonster )
+{
+	ASSERT( pMonster );
+
+	//Players restore through CBaseMonster, but they aren't monsters.
+	if( pMonster->IsPlayer() )
+		return;
+
+	auto pRecord = GetRecord( pMonster, true );
+
+	if( !pRecord )
+		return;
+
+	//Edicts are reused, so the record could belong to a monster that was freed without being removed.
+	if( pRecord->bRegistered && static_cast<CBaseEntity*>( pRecord->hMonster ) == pMonster )
+	{
+		Update( pMonster );
+		return;
+	}
+
+	pRecord->hMonster = pMonster;
+	pRecord->classification = pMonster->Classify();
+	pRecord->bRegistered = true;
+
+	AddToBucket( m_ByClassification[ pRecord->classification ], pMonster );
+	AddToBucket( m_ByClassname[ pMonster->GetClassname() ], pMonster );
+}
+
+void CMonsterRegistry::Unregister( CBaseMonster* pMonster )
+{
+	ASSERT( pMonster );
+
+	auto pRecord = GetRecord( pMonster, false );
+
+	if( !pRecord || !pRecord->bRegistered || static_cast<CBaseEntity*>( pRecord->hMonster ) != pMonster )
+		return;
+
+	pRecord->bRegistered = false;
+
+	auto classIt = m_ByClassification.find( pRecord->classification );
+
+	if( classIt != m_ByClassification.end() )
+		RemoveFromBucket( classIt->second, pMonster );
+
+	auto nameIt = m_ByClassname.find( pMonster->GetClassname() );
+
+	if( nameIt != m_ByClassname.end() )
+		RemoveFromBucket( nameIt->second, pMonster );
+}
+
+void CMonsterRegistry::Update( CBaseMonster* pMonster )
+{
+	ASSERT( pMonster );
+
+	auto pRecord = GetRecord( pMonster, false );
+
+	if( !pRecord || !pRecord->bRegistered || static_cast<CBaseEntity*>( pRecord->hMonster ) != pMonster )
+		return;
+
+	const auto classification = pMonster->Classify();
+
+	if( classification == pRecord->classification )
+		return;
+
+	auto classIt = m_ByClassification.find( pRecord->classification );
+
+	if( classIt != m_ByClassification.end() )
+		RemoveFromBucket( classIt->second, pMonster );
+
+	pRecord->classification = classification;
+
+	AddToBucket( m_ByClassification[ classification ], pMonster );
+}
+
+void CMonsterRegistry::FindByClassification( const EntityClassification_t classification, const Vector& vecOrigin, const float flRadius, Monsters_t& monsters )
+{
+	monsters.clear();
+
+	auto it = m_ByClassification.find( classification );
+
+	if( it != m_ByClassification.end() )
+		FindInBucket( it->second, vecOrigin, flRadius, monsters );
+}
+
+void CMonsterRegistry::FindByClassname( const char* const pszClassname, const Vector& vecOrigin, const float flRadius, Monsters_t& monsters )
+{
+	monsters.clear();
+
+	if( !pszClassname )
+		return;
+
+	auto it = m_ByClassname.find( pszClassname );
+
+	if( it != m_ByClassname.end() )
+		FindInBucket( it->second, vecOrigin, flRadius, monsters );
+}
+
+CMonsterRegistry::Record* CMonsterRegistry::GetRecord( CBaseMonster* pMonster, const bool bCreate )
+{
+	const int iIndex = pMonster->entindex();
+
+	if( iIndex <= 0 )
+		return nullptr;
+
+	if( static_cast<size_t>( iIndex ) >= m_Records.size() )
+	{
+		if( !bCreate )
+			return nullptr;
+
+		m_Records.resize( iIndex + 1 );
+	}
+
+	return &m_Records[ iIndex ];
+}
+
+void CMonsterRegistry::AddToBucket( Bucket_t& bucket, CBaseMonster* pMonster )
+{
+	bucket.emplace_back( pMonster );
+}
+
+void CMonsterRegistry::RemoveFromBucket( Bucket_t& bucket, CBaseMonster* pMonster )
+{
+	auto it = std::find_if( bucket.begin(), bucket.end(), [ = ]( const EHANDLE& handle )
+	{
+		return handle.GetEntity() == pMonster;
+	} );
+
+	if( it != bucket.end() )
+	{
+		*it = bucket.back();
+		bucket.pop_back();
+	}
+}
+
+void CMonsterRegistry::FindInBucket( Bucket_t& bucket, const Vector& vecOrigin, const float flRadius, Monsters_t& monsters )
+{
+	const float flRadiusSquared = flRadius * flRadius;
+
+	std::vector<std::pair<float, CBaseMonster*>> found;
+
+	for( size_t uiIndex = 0; uiIndex < bucket.size(); )
+	{
+		CBaseEntity* pEntity = bucket[ uiIndex ];
+
+		//Freed without being removed, drop it.
+		if( !pEntity )
+		{
+			bucket[ uiIndex ] = bucket.back();
+			bucket.pop_back();
+			continue;
+		}
+
+		++uiIndex;
+
+		if( !pEntity->IsAlive() )
+			continue;
+
+		const Vector vecDelta = pEntity->GetAbsOrigin() - vecOrigin;
+		const float flDistSquared = DotProduct( vecDelta, vecDelta );
+
+		if( flRadius > 0 && flDistSquared > flRadiusSquared )
+			continue;
+
+		found.emplace_back( flDistSquared, pEntity->MyMonsterPointer() );
+	}
+
+	std::sort( found.begin(), found.end(), []( const auto& lhs, const auto& rhs )
+	{
+		return lhs.first < rhs.first;
+	} );
+
+	monsters.reserve( found.size() );
+
+	for( const auto& entry : found )
+	{
+		monsters.push_back( entry.second );
+	}
+}
@@ -0,0 +1,89 @@
+#ifndef GAME_SERVER_ENTITIES_NPCS_CMONSTERREGISTRY_H
+#define GAME_SERVER_ENTITIES_NPCS_CMONSTERREGISTRY_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "EntityClasses.h"
+#include "entities/EHandle.h"
+
+class CBaseMonster;
+
+/**
+*	Keeps track of living monsters, bucketed by classification and by classname.
+*	Living monsters are registered when they're spawned or restored, and unregistered when they die or are removed.
+*	A monster whose classification changes is moved to its new bucket the next time it thinks.
+*	Lookups only visit the requested bucket and return monsters nearest first.
+*/
+class CMonsterRegistry final
+{
+public:
+	using Monsters_t = std::vector<CBaseMonster*>;
+
+private:
+	using Bucket_t = std::vector<EHANDLE>;
+
+	struct Record final
+	{
+		EHANDLE hMonster;
+		EntityClassification_t classification = INVALID_ENTITY_CLASSIFICATION;
+		bool bRegistered = false;
+	};
+
+public:
+	CMonsterRegistry() = default;
+	~CMonsterRegistry() = default;
+
+	/**
+	*	Removes all monsters. Called when the map ends.
+	*/
+	void Clear();
+
+	void Register( CBaseMonster* pMonster );
+
+	void Unregister( CBaseMonster* pMonster );
+
+	/**
+	*	Moves the given monster to another bucket if its classification has changed.
+	*/
+	void Update( CBaseMonster* pMonster );
+
+	/**
+	*	Finds living monsters with the given classification.
+	*	@param vecOrigin Point to sort by distance to.
+	*	@param flRadius Maximum distance to vecOrigin. 0 for no limit.
+	*	@param[ out ] monsters Monsters, nearest first.
+	*/
+	void FindByClassification( const EntityClassification_t classification, const Vector& vecOrigin, const float flRadius, Monsters_t& monsters );
+
+	/**
+	*	Finds living monsters with the given classname.
+	*	@see FindByClassification
+	*/
+	void FindByClassname( const char* const pszClassname, const Vector& vecOrigin, const float flRadius, Monsters_t& monsters );
+
+private:
+	Record* GetRecord( CBaseMonster* pMonster, const bool bCreate );
+
+	static void AddToBucket( Bucket_t& bucket, CBaseMonster* pMonster );
+
+	static void RemoveFromBucket( Bucket_t& bucket, CBaseMonster* pMonster );
+
+	static void FindInBucket( Bucket_t& bucket, const Vector& vecOrigin, const float flRadius, Monsters_t& monsters );
+
+private:
+	//Indexed by entity index.
+	std::vector<Record> m_Records;
+
+	std::unordered_map<EntityClassification_t, Bucket_t> m_ByClassification;
+	std::unordered_map<std::string, Bucket_t> m_ByClassname;
+
+private:
+	CMonsterRegistry( const CMonsterRegistry& ) = delete;
+	CMonsterRegistry& operator=( const CMonsterRegistry& ) = delete;
+};
+
+extern CMonsterRegistry g_MonsterRegistry;
+
+#endif //GAME_SERVER_ENTITIES_NPCS_CMONSTERREGISTRY_H
@@ -24,6 +24,7 @@
 #include "SaveRestore.h"
 #include "CSquadMonster.h"
 #include "CPlane.h"
+#include "CMonsterRegistry.h"
 
 //=========================================================
 // Save/Restore
@@ -316,17 +317,19 @@ int CSquadMonster :: SquadRecruit( int searchRadius, int maxMembers )
 	m_hSquadLeader = this;
 	squadCount = 1;
 
-	CBaseEntity *pEntity = NULL;
+	//Only monsters of my classification can be recruited, nearest first.
+	CMonsterRegistry::Monsters_t candidates;
 
 	if ( HasNetName() )
 	{
 		// I have a netname, so unconditionally recruit everyone else with that name.
-		pEntity = UTIL_FindEntityByString( pEntity, "netname", GetNetName() );
-		while ( pEntity )
+		g_MonsterRegistry.FindByClassification( iMyClass, GetAbsOrigin(), 0, candidates );
+
+		for( auto pCandidate : candidates )
 		{
-			CSquadMonster *pRecruit = pEntity->MySquadMonsterPointer();
+			CSquadMonster *pRecruit = pCandidate->MySquadMonsterPointer();
 
-			if ( pRecruit )
+			if ( pRecruit && FStrEq( pRecruit->GetNetName(), GetNetName() ) )
 			{
 				if ( !pRecruit->InSquad() && pRecruit->Classify() == iMyClass && pRecruit != this )
 				{
@@ -336,15 +339,15 @@ int CSquadMonster :: SquadRecruit( int searchRadius, int maxMembers )
 					squadCount++;
 				}
 			}
-	
-			pEntity = UTIL_FindEntityByString( pEntity, "netname", GetNetName() );
 		}
 	}
 	else 
 	{
-		while ((pEntity = UTIL_FindEntityInSphere( pEntity, GetAbsOrigin(), searchRadius )) != NULL)
+		g_MonsterRegistry.FindByClassification( iMyClass, GetAbsOrigin(), searchRadius, candidates );
+
+		for( auto pCandidate : candidates )
 		{
-			CSquadMonster *pRecruit = pEntity->MySquadMonsterPointer( );
+			CSquadMonster *pRecruit = pCandidate->MySquadMonsterPointer( );
 
 			if ( pRecruit && pRecruit != this && pRecruit->IsAlive() && !pRecruit->m_pCine )
 			{
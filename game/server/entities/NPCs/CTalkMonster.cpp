@@ -12,6 +12,8 @@
 *   use or distribution of this code by or to any unlicensed person is illegal.
 *
 ****/
+#include <algorithm>
+
 #include	"extdll.h"
 #include	"util.h"
 #include	"cbase.h"
@@ -661,50 +663,50 @@ void CTalkMonster::Killed( const CTakeDamageInfo& info, GibAction gibAction )
 
 
 
-CBaseEntity	*CTalkMonster::EnumFriends( CBaseEntity *pPrevious, int listNumber, const bool bTrace )
+//=========================================================
+// EnumFriends - gets the living friends in the given friend
+// list, nearest first.
+//=========================================================
+void CTalkMonster::EnumFriends( CMonsterRegistry::Monsters_t& friends, int listNumber, const bool bTrace )
 {
-	CBaseEntity *pFriend = pPrevious;
-	const char* pszFriend;
 	TraceResult tr;
 	Vector vecCheck;
 
-	pszFriend = m_szFriends[ FriendNumber(listNumber) ];
-	while( ( pFriend = UTIL_FindEntityByClassname( pFriend, pszFriend ) ) != nullptr )
+	g_MonsterRegistry.FindByClassname( m_szFriends[ FriendNumber(listNumber) ], GetAbsOrigin(), 0, friends );
+
+	// don't talk to self, the registry has no dead people
+	friends.erase( std::remove_if( friends.begin(), friends.end(), [ & ]( CBaseMonster* pFriend )
 	{
-		if (pFriend == this || !pFriend->IsAlive())
-			// don't talk to self or dead people
-			continue;
+		if ( pFriend == this )
+			return true;
+
 		if ( bTrace )
 		{
 			vecCheck = pFriend->GetAbsOrigin();
 			vecCheck.z = pFriend->GetAbsMax().z;
 
 			UTIL_TraceLine( GetAbsOrigin(), vecCheck, ignore_monsters, ENT(pev), &tr);
-		}
-		else
-			tr.flFraction = 1.0;
 
-		if (tr.flFraction == 1.0)
-		{
-			return pFriend;
+			return tr.flFraction != 1.0;
 		}
-	}
 
-	return NULL;
+		return false;
+	} ), friends.end() );
 }
 
 
 void CTalkMonster::AlertFriends( void )
 {
-	CBaseEntity *pFriend = NULL;
+	CMonsterRegistry::Monsters_t friends;
 	int i;
 
 	// for each friend in this bsp...
 	for ( i = 0; i < TLK_CFRIENDS; i++ )
 	{
-		while( ( pFriend = EnumFriends( pFriend, i, true ) ) != nullptr )
+		EnumFriends( friends, i, true );
+
+		for( auto pMonster : friends )
 		{
-			CBaseMonster *pMonster = pFriend->MyMonsterPointer();
 			if ( pMonster->IsAlive() )
 			{
 				// don't provoke a friend that's playing a death animation. They're a goner
@@ -718,19 +720,17 @@ void CTalkMonster::AlertFriends( void )
 
 void CTalkMonster::ShutUpFriends( void )
 {
-	CBaseEntity *pFriend = NULL;
+	CMonsterRegistry::Monsters_t friends;
 	int i;
 
 	// for each friend in this bsp...
 	for ( i = 0; i < TLK_CFRIENDS; i++ )
 	{
-		while( ( pFriend = EnumFriends( pFriend, i, true ) ) != nullptr )
+		EnumFriends( friends, i, true );
+
+		for( auto pMonster : friends )
 		{
-			CBaseMonster *pMonster = pFriend->MyMonsterPointer();
-			if ( pMonster )
-			{
-				pMonster->SentenceStop();
-			}
+			pMonster->SentenceStop();
 		}
 	}
 }
@@ -740,24 +740,22 @@ void CTalkMonster::ShutUpFriends( void )
 // UNDONE: Check this in Restore to keep restored monsters from joining a full list of followers
 void CTalkMonster::LimitFollowers( CBaseEntity *pPlayer, int maxFollowers )
 {
-	CBaseEntity *pFriend = NULL;
+	CMonsterRegistry::Monsters_t friends;
 	int i, count;
 
 	count = 0;
 	// for each friend in this bsp...
 	for ( i = 0; i < TLK_CFRIENDS; i++ )
 	{
-		while( ( pFriend = EnumFriends( pFriend, i, false ) ) != nullptr )
+		EnumFriends( friends, i, false );
+
+		for( auto pMonster : friends )
 		{
-			CBaseMonster *pMonster = pFriend->MyMonsterPointer();
-			if ( pMonster )
+			if ( pMonster->m_hTargetEnt == pPlayer )
 			{
-				if ( pMonster->m_hTargetEnt == pPlayer )
-				{
-					count++;
-					if ( count > maxFollowers )
-						pMonster->StopFollowing( true );
-				}
+				count++;
+				if ( count > maxFollowers )
+					pMonster->StopFollowing( true );
 			}
 		}
 	}
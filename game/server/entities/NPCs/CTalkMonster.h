@@ -17,6 +17,7 @@
 
 #ifndef MONSTERS_H
 #include "entities/NPCs/Monsters.h"
+#include "entities/NPCs/CMonsterRegistry.h"
 #endif
 
 //=========================================================
@@ -135,7 +136,7 @@ public:
 	void			IdleHeadTurn( const Vector &vecFriend );
 	bool			FOkToSpeak() const;
 	void			TrySmellTalk( void );
-	CBaseEntity		*EnumFriends( CBaseEntity *pentPrevious, int listNumber, const bool bTrace );
+	void			EnumFriends( CMonsterRegistry::Monsters_t& friends, int listNumber, const bool bTrace );
 	void			AlertFriends( void );
 	void			ShutUpFriends( void );
 	bool			IsTalking() const;
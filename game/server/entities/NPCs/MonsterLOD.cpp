@@ -0,0 +1,198 @@
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "CBasePlayer.h"
+#include "Server.h"
+
+#include "MonsterLOD.h"
+
+CMonsterLODManager g_MonsterLOD;
+
+namespace
+{
+const char* const g_pszTierNames[] =
+{
+	"full",
+	"reduced",
+	"low"
+};
+
+static_assert( ARRAYSIZE( g_pszTierNames ) == static_cast<size_t>( MonsterLOD::COUNT ), "Tier names must match MonsterLOD" );
+
+/**
+*	@return Squared distance to the nearest connected player, or -1 if there are no players.
+*/
+float NearestPlayerDistanceSquared( const Vector& vecOrigin )
+{
+	float flBestDist = -1;
+
+	for( int iPlayer = 1; iPlayer <= gpGlobals->maxClients; ++iPlayer )
+	{
+		auto pPlayer = UTIL_PlayerByIndex( iPlayer );
+
+		if( !pPlayer || !pPlayer->IsConnected() )
+			continue;
+
+		const Vector vecDelta = pPlayer->GetAbsOrigin() - vecOrigin;
+
+		const float flDist = DotProduct( vecDelta, vecDelta );
+
+		if( flBestDist < 0 || flDist < flBestDist )
+			flBestDist = flDist;
+	}
+
+	return flBestDist;
+}
+
+/**
+*	@return Whether the monster is fighting or following a player.
+*/
+bool IsEngagedWithPlayer( const CBaseMonster& monster )
+{
+	return ( monster.m_hEnemy && monster.m_hEnemy->IsPlayer() ) || ( monster.m_hTargetEnt && monster.m_hTargetEnt->IsPlayer() );
+}
+
+void ServerCommand_LODReport()
+{
+	g_MonsterLOD.PrintReport();
+}
+}
+
+void CMonsterLODManager::Initialize()
+{
+	g_engfuncs.pfnAddServerCommand( "ai_lod_report", &::ServerCommand_LODReport );
+}
+
+MonsterLOD CMonsterLODManager::GetTier( const CBaseMonster& monster ) const
+{
+	if( !ai_lod.value )
+		return MonsterLOD::FULL;
+
+	//Scripts rely on monsters responding immediately.
+	if( monster.m_MonsterState == MONSTERSTATE_SCRIPT || monster.m_pCine )
+		return MonsterLOD::FULL;
+
+	if( monster.HasConditions( bits_COND_LIGHT_DAMAGE | bits_COND_HEAVY_DAMAGE | bits_COND_PROVOKED ) )
+		return MonsterLOD::FULL;
+
+	if( IsEngagedWithPlayer( monster ) )
+		return MonsterLOD::FULL;
+
+	const float flDist = NearestPlayerDistanceSquared( monster.GetAbsOrigin() );
+
+	MonsterLOD tier;
+
+	if( flDist < 0 )
+		tier = MonsterLOD::LOW;
+	else if( flDist < ai_lod_reduced_dist.value * ai_lod_reduced_dist.value )
+		tier = MonsterLOD::FULL;
+	else if( flDist < ai_lod_low_dist.value * ai_lod_low_dist.value )
+		tier = MonsterLOD::REDUCED;
+	else
+		tier = MonsterLOD::LOW;
+
+	//Nobody has seen this monster in a while.
+	if( tier != MonsterLOD::LOW && ( gpGlobals->time - monster.m_flLastPlayerContact ) > ai_lod_contact_time.value )
+		tier = static_cast<MonsterLOD>( static_cast<int>( tier ) + 1 );
+
+	//Monsters fighting each other keep fighting outside of the player's PVS, so don't let them slow down too much.
+	if( tier == MonsterLOD::LOW && monster.m_MonsterState == MONSTERSTATE_COMBAT )
+		tier = MonsterLOD::REDUCED;
+
+	return tier;
+}
+
+float CMonsterLODManager::GetSenseInterval( const MonsterLOD tier ) const
+{
+	switch( tier )
+	{
+	default:
+	case MonsterLOD::FULL:		return 0;
+	case MonsterLOD::REDUCED:	return max( 0.0f, ai_lod_reduced_interval.value );
+	case MonsterLOD::LOW:		return max( 0.0f, ai_lod_low_interval.value );
+	}
+}
+
+bool CMonsterLODManager::ShouldSense( CBaseMonster& monster )
+{
+	const MonsterLOD tier = GetTier( monster );
+
+	if( tier != monster.m_LODTier )
+	{
+		//Slower tiers start at a phase based on the entity index so they're spread out over multiple frames.
+		//Moving to a faster tier senses right away.
+		if( tier > monster.m_LODTier )
+		{
+			const int iPhase = ( monster.entindex() % NUM_PHASES ) + 1;
+
+			monster.m_flNextSenseTime = gpGlobals->time + ( GetSenseInterval( tier ) * iPhase ) / NUM_PHASES;
+		}
+		else
+			monster.m_flNextSenseTime = 0;
+
+		monster.m_LODTier = tier;
+	}
+
+	if( tier != MonsterLOD::FULL && monster.m_flNextSenseTime > gpGlobals->time )
+	{
+		++m_uiSkippedSenses;
+		return false;
+	}
+
+	//Being in a player's PVS is recorded by RunAI.
+	if( IsEngagedWithPlayer( monster ) )
+		monster.m_flLastPlayerContact = gpGlobals->time;
+
+	monster.m_flNextSenseTime = gpGlobals->time + GetSenseInterval( tier );
+
+	++m_uiSenses;
+
+	return true;
+}
+
+void CMonsterLODManager::PrintReport()
+{
+	unsigned int uiCounts[ static_cast<size_t>( MonsterLOD::COUNT ) ] = {};
+	unsigned int uiInactive = 0;
+
+	for( int iIndex = 1; iIndex < gpGlobals->maxEntities; ++iIndex )
+	{
+		auto pEntity = UTIL_EntityByIndex( iIndex );
+
+		if( !pEntity || pEntity->IsPlayer() )
+			continue;
+
+		auto pMonster = pEntity->MyMonsterPointer();
+
+		if( !pMonster )
+			continue;
+
+		if( pMonster->m_MonsterState == MONSTERSTATE_NONE ||
+			pMonster->m_MonsterState == MONSTERSTATE_PRONE ||
+			pMonster->m_MonsterState == MONSTERSTATE_DEAD )
+		{
+			++uiInactive;
+			continue;
+		}
+
+		++uiCounts[ static_cast<size_t>( pMonster->m_LODTier ) ];
+	}
+
+	Alert( at_console, "AI LOD is %s\n", ai_lod.value ? "enabled" : "disabled" );
+
+	for( size_t uiTier = 0; uiTier < static_cast<size_t>( MonsterLOD::COUNT ); ++uiTier )
+	{
+		Alert( at_console, "%-8s %u monsters (sense interval %.2f s)\n",
+			   g_pszTierNames[ uiTier ], uiCounts[ uiTier ], GetSenseInterval( static_cast<MonsterLOD>( uiTier ) ) );
+	}
+
+	Alert( at_console, "%-8s %u monsters (not sensing)\n", "inactive", uiInactive );
+
+	const unsigned int uiTotal = m_uiSenses + m_uiSkippedSenses;
+
+	Alert( at_console, "%u sensing passes since last report, %u skipped (%.1f%%)\n",
+		   m_uiSenses, m_uiSkippedSenses, uiTotal ? ( m_uiSkippedSenses * 100.0 ) / uiTotal : 0.0 );
+
+	m_uiSenses = 0;
+	m_uiSkippedSenses = 0;
+}
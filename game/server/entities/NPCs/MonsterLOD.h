@@ -0,0 +1,80 @@
+#ifndef GAME_SERVER_ENTITIES_NPCS_MONSTERLOD_H
+#define GAME_SERVER_ENTITIES_NPCS_MONSTERLOD_H
+
+class CBaseMonster;
+
+/**
+*	AI level of detail. Determines how often a monster runs its sensing code (Look, Listen, GetEnemy).
+*	Monsters that are far away from players, or haven't had contact with a player for a while, sense less often.
+*/
+enum class MonsterLOD
+{
+	/**
+	*	Sense every think.
+	*/
+	FULL = 0,
+
+	/**
+	*	Sense every ai_lod_reduced_interval seconds.
+	*/
+	REDUCED,
+
+	/**
+	*	Sense every ai_lod_low_interval seconds.
+	*/
+	LOW,
+
+	COUNT
+};
+
+/**
+*	Assigns sensing tiers to monsters and keeps statistics.
+*/
+class CMonsterLODManager final
+{
+public:
+	/**
+	*	Number of phases that monsters entering a slower tier are spread over.
+	*	Keeps monsters that change tiers in the same frame from sensing in the same frame afterwards.
+	*/
+	static const int NUM_PHASES = 8;
+
+public:
+	CMonsterLODManager() = default;
+	~CMonsterLODManager() = default;
+
+	/**
+	*	Registers the report command.
+	*/
+	void Initialize();
+
+	/**
+	*	Determines the tier that the given monster should be in.
+	*/
+	MonsterLOD GetTier( const CBaseMonster& monster ) const;
+
+	/**
+	*	@return Time between sensing passes for the given tier, in seconds.
+	*/
+	float GetSenseInterval( const MonsterLOD tier ) const;
+
+	/**
+	*	Updates the monster's tier and decides whether it should sense this think.
+	*/
+	bool ShouldSense( CBaseMonster& monster );
+
+	void PrintReport();
+
+private:
+	//Sensing passes since the last report.
+	unsigned int m_uiSenses = 0;
+	unsigned int m_uiSkippedSenses = 0;
+
+private:
+	CMonsterLODManager( const CMonsterLODManager& ) = delete;
+	CMonsterLODManager& operator=( const CMonsterLODManager& ) = delete;
+};
+
+extern CMonsterLODManager g_MonsterLOD;
+
+#endif //GAME_SERVER_ENTITIES_NPCS_MONSTERLOD_H
@@ -0,0 +1,272 @@
+#include <algorithm>
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+#include "Server.h"
+
+#include "CStopwatch.h"
+
+#include "MonsterScheduleTrace.h"
+
+CMonsterScheduleTrace g_MonsterScheduleTrace;
+
+namespace
+{
+const char* const g_pszEventNames[] =
+{
+	"start",
+	"done",
+	"FAILED",
+	"interrupted",
+	"task start",
+	"task done"
+};
+
+static_assert( ARRAYSIZE( g_pszEventNames ) == static_cast<size_t>( ScheduleTraceEvent::COUNT ), "Event names must match ScheduleTraceEvent" );
+
+const char* GetScheduleName( const Schedule_t* pSchedule )
+{
+	if( !pSchedule )
+		return "No Schedule";
+
+	return pSchedule->pName ? pSchedule->pName : "Unknown";
+}
+
+void ServerCommand_TraceDump()
+{
+	const int iEntIndex = CMD_ARGC() >= 2 ? atoi( CMD_ARGV( 1 ) ) : 0;
+	const int iCount = CMD_ARGC() >= 3 ? atoi( CMD_ARGV( 2 ) ) : 50;
+
+	g_MonsterScheduleTrace.PrintEvents( iEntIndex, static_cast<size_t>( max( 1, iCount ) ) );
+}
+
+void ServerCommand_Stats()
+{
+	if( CMD_ARGC() >= 2 && FStrEq( CMD_ARGV( 1 ), "reset" ) )
+	{
+		g_MonsterScheduleTrace.Reset();
+		Alert( at_console, "Schedule trace reset\n" );
+		return;
+	}
+
+	const int iCount = CMD_ARGC() >= 2 ? atoi( CMD_ARGV( 1 ) ) : 20;
+
+	g_MonsterScheduleTrace.PrintStats( static_cast<size_t>( max( 1, iCount ) ) );
+}
+}
+
+void CMonsterScheduleTrace::Initialize()
+{
+	g_engfuncs.pfnAddServerCommand( "ai_sched_trace_dump", &::ServerCommand_TraceDump );
+	g_engfuncs.pfnAddServerCommand( "ai_sched_stats", &::ServerCommand_Stats );
+}
+
+void CMonsterScheduleTrace::ScheduleChanging( const CBaseMonster& monster, const Schedule_t* pNewSchedule )
+{
+	auto& state = GetMonsterState( monster );
+
+	//Finish the old schedule. Entity indices are reused, so only trust the state if it matches the monster's schedule.
+	if( monster.m_pSchedule && state.pSchedule == monster.m_pSchedule )
+	{
+		ScheduleTraceEvent type;
+
+		if( monster.HasConditions( bits_COND_TASK_FAILED ) )
+			type = ScheduleTraceEvent::SCHEDULE_FAILED;
+		else if( monster.FScheduleDone() )
+			type = ScheduleTraceEvent::SCHEDULE_DONE;
+		else
+			type = ScheduleTraceEvent::SCHEDULE_INTERRUPTED;
+
+		auto& stats = m_Stats[ monster.m_pSchedule ];
+
+		switch( type )
+		{
+		case ScheduleTraceEvent::SCHEDULE_FAILED:		++stats.uiFailures; break;
+		case ScheduleTraceEvent::SCHEDULE_DONE:			++stats.uiDone; break;
+		default:										++stats.uiInterrupts; break;
+		}
+
+		stats.flTotalDuration += gpGlobals->time - state.flStartTime;
+
+		const Task_t* pTask = monster.FScheduleDone() ? nullptr : monster.GetTask();
+
+		AddEvent( monster, type, monster.m_pSchedule, pTask ? static_cast<int>( monster.m_iScheduleIndex ) : -1, pTask ? pTask->iTask : -1 );
+	}
+
+	++m_Stats[ pNewSchedule ].uiEntries;
+
+	state.pSchedule = pNewSchedule;
+	state.flStartTime = gpGlobals->time;
+
+	AddEvent( monster, ScheduleTraceEvent::SCHEDULE_START, pNewSchedule, -1, -1 );
+}
+
+void CMonsterScheduleTrace::TaskDone( const CBaseMonster& monster )
+{
+	if( const Task_t* pTask = monster.GetTask() )
+		AddEvent( monster, ScheduleTraceEvent::TASK_DONE, monster.m_pSchedule, static_cast<int>( monster.m_iScheduleIndex ), pTask->iTask );
+}
+
+void CMonsterScheduleTrace::StartTask( CBaseMonster& monster, const Task_t& task )
+{
+	//The task can change the schedule, so get the stats for the one it was started by.
+	const Schedule_t* pSchedule = monster.m_pSchedule;
+
+	AddEvent( monster, ScheduleTraceEvent::TASK_START, pSchedule, static_cast<int>( monster.m_iScheduleIndex ), task.iTask );
+
+	CStopwatch stopwatch;
+
+	monster.StartTask( task );
+
+	auto& stats = m_Stats[ pSchedule ];
+
+	++stats.uiStartTaskCalls;
+	stats.iStartTaskTime += stopwatch.GetElapsedMicroseconds();
+}
+
+void CMonsterScheduleTrace::RunTask( CBaseMonster& monster, const Task_t& task )
+{
+	const Schedule_t* pSchedule = monster.m_pSchedule;
+
+	CStopwatch stopwatch;
+
+	monster.RunTask( task );
+
+	auto& stats = m_Stats[ pSchedule ];
+
+	++stats.uiRunTaskCalls;
+	stats.iRunTaskTime += stopwatch.GetElapsedMicroseconds();
+}
+
+void CMonsterScheduleTrace::Reset()
+{
+	m_Events.clear();
+	m_uiNextEvent = 0;
+	m_uiEventCount = 0;
+	m_Stats.clear();
+	m_MonsterStates.clear();
+	m_flStatsStartTime = gpGlobals->time;
+}
+
+void CMonsterScheduleTrace::PrintEvents( const int iEntIndex, const size_t uiCount ) const
+{
+	if( m_Events.empty() )
+	{
+		Alert( at_console, "No schedule events recorded%s\n", IsEnabled() ? "" : "; set ai_sched_trace 1 to enable tracing" );
+		return;
+	}
+
+	//Walk backwards from the newest event to find the ones to print, then print them oldest first.
+	std::vector<const Event*> events;
+
+	for( size_t uiIndex = 0; uiIndex < m_uiEventCount && events.size() < uiCount; ++uiIndex )
+	{
+		const auto& event = m_Events[ ( m_uiNextEvent + m_Events.size() - 1 - uiIndex ) % m_Events.size() ];
+
+		if( iEntIndex == 0 || event.iEntIndex == iEntIndex )
+			events.push_back( &event );
+	}
+
+	Alert( at_console, "%-10s %-6s %-12s %-32s %-10s %s\n", "time", "entity", "event", "schedule", "task", "conditions" );
+
+	for( auto it = events.rbegin(); it != events.rend(); ++it )
+	{
+		const auto& event = **it;
+
+		char szTask[ 32 ] = "";
+
+		if( event.iTaskIndex != -1 )
+			snprintf( szTask, sizeof( szTask ), "%d:%d", event.iTaskIndex, event.iTask );
+
+		Alert( at_console, "%-10.3f %-6d %-12s %-32s %-10s %08X\n",
+			   event.flTime, event.iEntIndex, g_pszEventNames[ static_cast<size_t>( event.type ) ], GetScheduleName( event.pSchedule ), szTask, event.iConditions );
+	}
+}
+
+void CMonsterScheduleTrace::PrintStats( const size_t uiCount ) const
+{
+	if( m_Stats.empty() )
+	{
+		Alert( at_console, "No schedule statistics recorded%s\n", IsEnabled() ? "" : "; set ai_sched_trace 1 to enable tracing" );
+		return;
+	}
+
+	std::vector<std::pair<const Schedule_t*, const ScheduleStats*>> stats;
+
+	stats.reserve( m_Stats.size() );
+
+	for( const auto& entry : m_Stats )
+		stats.emplace_back( entry.first, &entry.second );
+
+	//Worst offenders first: schedules that fail the most, then those that restart the most.
+	std::sort( stats.begin(), stats.end(), []( const auto& lhs, const auto& rhs )
+	{
+		if( lhs.second->uiFailures != rhs.second->uiFailures )
+			return lhs.second->uiFailures > rhs.second->uiFailures;
+
+		return lhs.second->uiEntries > rhs.second->uiEntries;
+	} );
+
+	const float flElapsed = max( gpGlobals->time - m_flStatsStartTime, 0.001f );
+
+	Alert( at_console, "Schedule statistics over %.1f seconds:\n", flElapsed );
+	Alert( at_console, "%-32s %8s %8s %8s %10s %12s %12s %13s\n",
+		   "schedule", "entries", "per sec", "fail %", "avg dur s", "StartTask us", "RunTask us", "RunTask calls" );
+
+	const size_t uiEnd = min( uiCount, stats.size() );
+
+	for( size_t uiIndex = 0; uiIndex < uiEnd; ++uiIndex )
+	{
+		const auto& entry = *stats[ uiIndex ].second;
+
+		const unsigned int uiEnded = entry.uiDone + entry.uiFailures + entry.uiInterrupts;
+
+		Alert( at_console, "%-32s %8u %8.2f %7.1f%% %10.3f %12lld %12lld %13u\n",
+			   GetScheduleName( stats[ uiIndex ].first ),
+			   entry.uiEntries,
+			   entry.uiEntries / flElapsed,
+			   uiEnded ? ( entry.uiFailures * 100.0 ) / uiEnded : 0.0,
+			   uiEnded ? entry.flTotalDuration / uiEnded : 0.0,
+			   entry.iStartTaskTime,
+			   entry.iRunTaskTime,
+			   entry.uiRunTaskCalls );
+	}
+}
+
+void CMonsterScheduleTrace::AddEvent( const CBaseMonster& monster, const ScheduleTraceEvent type, const Schedule_t* pSchedule, const int iTaskIndex, const int iTask )
+{
+	if( m_Events.empty() )
+	{
+		m_Events.resize( MAX_EVENTS );
+		m_uiNextEvent = 0;
+		m_uiEventCount = 0;
+
+		//Only count from the first event; the game may have been running for a while before tracing was enabled.
+		if( m_Stats.empty() )
+			m_flStatsStartTime = gpGlobals->time;
+	}
+
+	auto& event = m_Events[ m_uiNextEvent ];
+
+	event.flTime = gpGlobals->time;
+	event.iEntIndex = monster.entindex();
+	event.type = type;
+	event.pSchedule = pSchedule;
+	event.iTaskIndex = iTaskIndex;
+	event.iTask = iTask;
+	event.iConditions = monster.GetConditions();
+
+	m_uiNextEvent = ( m_uiNextEvent + 1 ) % m_Events.size();
+	m_uiEventCount = min( m_uiEventCount + 1, m_Events.size() );
+}
+
+CMonsterScheduleTrace::MonsterState& CMonsterScheduleTrace::GetMonsterState( const CBaseMonster& monster )
+{
+	const size_t uiIndex = static_cast<size_t>( monster.entindex() );
+
+	if( uiIndex >= m_MonsterStates.size() )
+		m_MonsterStates.resize( max( static_cast<size_t>( gpGlobals->maxEntities ), uiIndex + 1 ) );
+
+	return m_MonsterStates[ uiIndex ];
+}
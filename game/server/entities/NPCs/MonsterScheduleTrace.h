@@ -0,0 +1,173 @@
+#ifndef GAME_SERVER_ENTITIES_NPCS_MONSTERSCHEDULETRACE_H
+#define GAME_SERVER_ENTITIES_NPCS_MONSTERSCHEDULETRACE_H
+
+#include <unordered_map>
+#include <vector>
+
+#include "Server.h"
+
+class CBaseMonster;
+struct Schedule_t;
+struct Task_t;
+
+/**
+*	Types of events recorded by the schedule tracer.
+*/
+enum class ScheduleTraceEvent
+{
+	/**
+	*	The monster picked a new schedule.
+	*/
+	SCHEDULE_START = 0,
+
+	/**
+	*	The previous schedule ran all of its tasks.
+	*/
+	SCHEDULE_DONE,
+
+	/**
+	*	A task in the previous schedule failed.
+	*/
+	SCHEDULE_FAILED,
+
+	/**
+	*	The previous schedule was interrupted by conditions or a state change.
+	*/
+	SCHEDULE_INTERRUPTED,
+
+	TASK_START,
+	TASK_DONE,
+
+	COUNT
+};
+
+/**
+*	Records monster schedule and task transitions in a ring buffer, and keeps statistics for each schedule.
+*	Used to find schedules that thrash (fail and restart every think) and schedules whose tasks are expensive.
+*	Enabled with ai_sched_trace. When disabled, the only cost is a cvar check per transition.
+*/
+class CMonsterScheduleTrace final
+{
+public:
+	/**
+	*	Number of events kept in the ring buffer.
+	*/
+	static const size_t MAX_EVENTS = 4096;
+
+private:
+	struct Event final
+	{
+		float flTime;
+		int iEntIndex;
+		ScheduleTraceEvent type;
+		const Schedule_t* pSchedule;
+
+		//Task index and type, or -1 for schedule events.
+		int iTaskIndex;
+		int iTask;
+
+		//Conditions that were set when the event occurred.
+		int iConditions;
+	};
+
+	struct ScheduleStats final
+	{
+		unsigned int uiEntries = 0;
+		unsigned int uiDone = 0;
+		unsigned int uiFailures = 0;
+		unsigned int uiInterrupts = 0;
+
+		//Time spent in the schedule, in seconds. Only counts schedules that have ended.
+		double flTotalDuration = 0;
+
+		unsigned int uiStartTaskCalls = 0;
+		unsigned int uiRunTaskCalls = 0;
+
+		//In microseconds.
+		long long iStartTaskTime = 0;
+		long long iRunTaskTime = 0;
+	};
+
+	//Schedule that each monster is running, by entity index.
+	struct MonsterState final
+	{
+		const Schedule_t* pSchedule = nullptr;
+		float flStartTime = 0;
+	};
+
+public:
+	CMonsterScheduleTrace() = default;
+	~CMonsterScheduleTrace() = default;
+
+	/**
+	*	Registers the dump and stats commands.
+	*/
+	void Initialize();
+
+	bool IsEnabled() const { return ai_sched_trace.value != 0; }
+
+	/**
+	*	Called before a monster changes its schedule. Works out why the old schedule ended.
+	*/
+	void ScheduleChanging( const CBaseMonster& monster, const Schedule_t* pNewSchedule );
+
+	/**
+	*	Called when a monster completes a task.
+	*/
+	void TaskDone( const CBaseMonster& monster );
+
+	/**
+	*	Starts the given task and records how long it took.
+	*/
+	void StartTask( CBaseMonster& monster, const Task_t& task );
+
+	/**
+	*	Runs the given task and records how long it took.
+	*/
+	void RunTask( CBaseMonster& monster, const Task_t& task );
+
+	/**
+	*	Clears the event buffer and statistics.
+	*/
+	void Reset();
+
+	/**
+	*	Prints the most recent events.
+	*	@param iEntIndex If not 0, only print events for this entity.
+	*	@param uiCount Maximum number of events to print.
+	*/
+	void PrintEvents( const int iEntIndex, const size_t uiCount ) const;
+
+	/**
+	*	Prints the schedules that fail or restart most often.
+	*	@param uiCount Maximum number of schedules to print.
+	*/
+	void PrintStats( const size_t uiCount ) const;
+
+private:
+	void AddEvent( const CBaseMonster& monster, const ScheduleTraceEvent type, const Schedule_t* pSchedule, const int iTaskIndex, const int iTask );
+
+	MonsterState& GetMonsterState( const CBaseMonster& monster );
+
+private:
+	std::vector<Event> m_Events;
+
+	//Index where the next event is written, and number of events in the buffer.
+	size_t m_uiNextEvent = 0;
+	size_t m_uiEventCount = 0;
+
+	std::unordered_map<const Schedule_t*, ScheduleStats> m_Stats;
+
+	std::vector<MonsterState> m_MonsterStates;
+
+	//Time when the statistics were last reset.
+	float m_flStatsStartTime = 0;
+
+private:
+	CMonsterScheduleTrace( const CMonsterScheduleTrace& ) = delete;
+	CMonsterScheduleTrace& operator=( const CMonsterScheduleTrace& ) = delete;
+};
+
+extern CMonsterScheduleTrace g_MonsterScheduleTrace;
+
+#endif //GAME_SERVER_ENTITIES_NPCS_MONSTERSCHEDULETRACE_H
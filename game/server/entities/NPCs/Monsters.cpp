@@ -33,6 +33,7 @@
 #include "Decals.h"
 #include "entities/CSoundEnt.h"
 #include "gamerules/GameRules.h"
+#include "CMonsterRegistry.h"
 
 #define MONSTER_CUT_CORNER_DIST		8 // 8 means the monster's bounding box is contained without the box of the node in WC
 
@@ -60,9 +61,20 @@ bool CBaseMonster::Restore( CRestore &restore )
 	if ( m_hEnemy == NULL )
 		m_afConditions = 0;
 
+	//The registry isn't saved.
+	if( IsAlive() )
+		g_MonsterRegistry.Register( this );
+
 	return true;
 }
 
+void CBaseMonster::UpdateOnRemove()
+{
+	g_MonsterRegistry.Unregister( this );
+
+	BaseClass::UpdateOnRemove();
+}
+
 
 //=========================================================
 // Eat - makes a monster full for a little while.
@@ -449,6 +461,7 @@ void CBaseMonster :: MonsterThink ( void )
 {
 	SetNextThink( gpGlobals->time + 0.1 );// keep monster thinking.
 
+	g_MonsterRegistry.Update( this );
 
 	RunAI();
 
@@ -3,6 +3,7 @@
 #include "cbase.h"
 
 #include "CPathTrack.h"
+#include "CPathTrackTables.h"
 #include "CFuncTrackTrain.h"
 
 #include "CFuncTrackAuto.h"
@@ -72,11 +73,15 @@ void CFuncTrackAuto::UpdateAutoTargets( int toggleState )
 	if( pTarget )
 	{
 		pTarget->GetSpawnFlags().ClearFlags( SF_PATH_DISABLED );
+		g_PathTrackTables.Invalidate( pTarget );
+
 		if( m_code == TRAIN_FOLLOWING && m_train && m_train->GetSpeed() == 0 )
 			m_train->Use( this, this, USE_ON, 0 );
 	}
 
 	if( pNextTarget )
+	{
 		pNextTarget->GetSpawnFlags().AddFlags( SF_PATH_DISABLED );
-
+		g_PathTrackTables.Invalidate( pNextTarget );
+	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "cbase.h"
 
 #include "CPathTrack.h"
+#include "CPathTrackTables.h"
 #include "CFuncTrackTrain.h"
 
 #include "CFuncTrackChange.h"
@@ -335,6 +336,9 @@ void CFuncTrackChange::UpdateAutoTargets( int toggleState )
 		m_trackBottom->GetSpawnFlags().ClearFlags( SF_PATH_DISABLED );
 	else
 		m_trackBottom->GetSpawnFlags().AddFlags( SF_PATH_DISABLED );
+
+	g_PathTrackTables.Invalidate( m_trackTop );
+	g_PathTrackTables.Invalidate( m_trackBottom );
 }
 
 void CFuncTrackChange::OverrideReset( void )
@@ -3,6 +3,7 @@
 #include "cbase.h"
 
 #include "CPathTrack.h"
+#include "CPathTrackTables.h"
 
 BEGIN_DATADESC( CPathTrack )
 	DEFINE_FIELD( m_length, FIELD_FLOAT ),
@@ -36,6 +37,8 @@ void CPathTrack::Activate( void )
 {
 	if( HasTargetname() )		// Link to next, and back-link
 		Link();
+
+	g_PathTrackTables.Invalidate();
 }
 
 //
@@ -123,6 +126,8 @@ void CPathTrack::Use( CBaseEntity *pActivator, CBaseEntity *pCaller, USE_TYPE us
 				GetSpawnFlags().ClearFlags( SF_PATH_DISABLED );
 		}
 	}
+
+	g_PathTrackTables.Invalidate( this );
 }
 
 CPathTrack	*CPathTrack::ValidPath( CPathTrack *ppath, const bool bTestFlag )
@@ -189,9 +194,15 @@ CPathTrack *CPathTrack::LookAhead( Vector& origin, float dist, const bool bMove
 			{
 				dist -= length;
 				currentPos = pcurrent->GetAbsOrigin();
-				origin = currentPos;
 				if( !ValidPath( pcurrent->GetPrevious(), bMove ) )	// If there is no previous node, or it's disabled, return now.
+				{
+					origin = currentPos;
 					return NULL;
+				}
+
+				// Skip over whole segments
+				pcurrent = g_PathTrackTables.Advance( pcurrent, CPathTrackTables::Direction::BACKWARD, dist, bMove, currentPos );
+				origin = currentPos;
 
 				pcurrent = pcurrent->GetPrevious();
 			}
@@ -227,6 +238,9 @@ CPathTrack *CPathTrack::LookAhead( Vector& origin, float dist, const bool bMove
 				dist -= length;
 				currentPos = pcurrent->GetNext()->GetAbsOrigin();
 				pcurrent = pcurrent->GetNext();
+
+				// Skip over whole segments
+				pcurrent = g_PathTrackTables.Advance( pcurrent, CPathTrackTables::Direction::FORWARD, dist, bMove, currentPos );
 				origin = currentPos;
 			}
 		}
@@ -239,39 +253,7 @@ CPathTrack *CPathTrack::LookAhead( Vector& origin, float dist, const bool bMove
 // Assumes this is ALWAYS enabled
 CPathTrack *CPathTrack::Nearest( Vector origin )
 {
-	int			deadCount;
-	float		minDist, dist;
-	Vector		delta;
-	CPathTrack	*ppath, *pnearest;
-
-
-	delta = origin - GetAbsOrigin();
-	delta.z = 0;
-	minDist = delta.Length();
-	pnearest = this;
-	ppath = GetNext();
-
-	// Hey, I could use the old 2 racing pointers solution to this, but I'm lazy :)
-	deadCount = 0;
-	while( ppath && ppath != this )
-	{
-		deadCount++;
-		if( deadCount > 9999 )
-		{
-			ALERT( at_error, "Bad sequence of path_tracks from %s", GetTargetname() );
-			return NULL;
-		}
-		delta = origin - ppath->GetAbsOrigin();
-		delta.z = 0;
-		dist = delta.Length();
-		if( dist < minDist )
-		{
-			minDist = dist;
-			pnearest = ppath;
-		}
-		ppath = ppath->GetNext();
-	}
-	return pnearest;
+	return g_PathTrackTables.Nearest( this, origin );
 }
 
 CPathTrack *CPathTrack::GetNext( void )
@@ -0,0 +1,358 @@
+#include <algorithm>
+
+#include "extdll.h"
+#include "util.h"
+#include "cbase.h"
+
+#include "CPathTrack.h"
+
+#include "CPathTrackTables.h"
+
+CPathTrackTables g_PathTrackTables;
+
+void CPathTrackTables::Clear()
+{
+	for( auto& table : m_Tables )
+	{
+		table.runs.clear();
+		table.refs.clear();
+		table.dirtyRuns.clear();
+	}
+
+	m_uiNumTracks = 0;
+	m_bDirty = true;
+}
+
+void CPathTrackTables::Invalidate( CPathTrack* pTrack )
+{
+	if( m_bDirty )
+		return;
+
+	for( auto& table : m_Tables )
+	{
+		auto pRef = GetRef( table, pTrack );
+
+		//Not in the tables yet, so everything needs to be built.
+		if( !pRef )
+		{
+			m_bDirty = true;
+			return;
+		}
+
+		auto& run = table.runs[ pRef->iRun ];
+
+		if( !run.bDirty )
+		{
+			run.bDirty = true;
+			table.dirtyRuns.push_back( pRef->iRun );
+		}
+	}
+}
+
+CPathTrack* CPathTrackTables::Advance( CPathTrack* pStart, const Direction direction, float& flDist, const bool bTestFlag, Vector& vecPos )
+{
+	Update();
+
+	const auto& table = m_Tables[ static_cast<size_t>( direction ) ];
+
+	auto pRef = GetRef( table, pStart );
+
+	if( !pRef )
+		return pStart;
+
+	const auto& run = table.runs[ pRef->iRun ];
+
+	const int iStart = pRef->iIndex;
+
+	//The nodes moved to must be valid, as must the node after the last one.
+	int iEnd = static_cast<int>( run.nodes.size() );
+
+	if( bTestFlag && iStart + 1 < iEnd )
+		iEnd = run.nextDisabled[ iStart + 1 ];
+
+	const int iLast = iEnd - 2;
+
+	if( iLast <= iStart )
+		return pStart;
+
+	//First node that is too far away to reach.
+	const auto first = run.lengths.begin() + iStart;
+	const auto it = std::lower_bound( first + 1, run.lengths.begin() + iLast + 1, *first + flDist );
+
+	const int iReached = static_cast<int>( it - run.lengths.begin() ) - 1;
+
+	if( iReached == iStart )
+		return pStart;
+
+	flDist -= run.lengths[ iReached ] - run.lengths[ iStart ];
+	vecPos = run.positions[ iReached ];
+
+	return run.nodes[ iReached ];
+}
+
+CPathTrack* CPathTrackTables::Nearest( CPathTrack* pStart, const Vector& vecOrigin )
+{
+	Update();
+
+	const auto& table = m_Tables[ static_cast<size_t>( Direction::FORWARD ) ];
+
+	Vector delta = vecOrigin - pStart->GetAbsOrigin();
+	delta.z = 0;
+
+	float flMinDist = delta.Length();
+	CPathTrack* pNearest = pStart;
+
+	auto pRef = GetRef( table, pStart );
+
+	if( !pRef )
+		return pNearest;
+
+	int iRun = pRef->iRun;
+	int iIndex = pRef->iIndex + 1;
+
+	//A sequence that loops without coming back to the start visits more nodes than there are.
+	size_t uiCount = 0;
+
+	while( uiCount <= m_uiNumTracks )
+	{
+		const auto& run = table.runs[ iRun ];
+
+		if( iIndex >= static_cast<int>( run.nodes.size() ) )
+		{
+			auto pContinueRef = GetRef( table, run.pContinue );
+
+			if( !pContinueRef )
+				return pNearest;
+
+			iRun = pContinueRef->iRun;
+			iIndex = pContinueRef->iIndex;
+			continue;
+		}
+
+		if( run.nodes[ iIndex ] == pStart )
+			return pNearest;
+
+		++uiCount;
+
+		delta = vecOrigin - run.positions[ iIndex ];
+		delta.z = 0;
+
+		const float flDist = delta.Length();
+
+		if( flDist < flMinDist )
+		{
+			flMinDist = flDist;
+			pNearest = run.nodes[ iIndex ];
+		}
+
+		++iIndex;
+	}
+
+	ALERT( at_error, "Bad sequence of path_tracks from %s", pStart->GetTargetname() );
+
+	return nullptr;
+}
+
+void CPathTrackTables::Update()
+{
+	if( m_bDirty )
+	{
+		Build();
+		return;
+	}
+
+	for( size_t uiDirection = 0; uiDirection < static_cast<size_t>( Direction::COUNT ); ++uiDirection )
+	{
+		auto& table = m_Tables[ uiDirection ];
+
+		//Rebuilding a run can add runs, so don't hold on to iterators.
+		for( size_t uiDirty = 0; uiDirty < table.dirtyRuns.size(); ++uiDirty )
+		{
+			RebuildRun( table, table.dirtyRuns[ uiDirty ], static_cast<Direction>( uiDirection ) );
+		}
+
+		table.dirtyRuns.clear();
+	}
+}
+
+void CPathTrackTables::Build()
+{
+	m_bDirty = false;
+
+	std::vector<CPathTrack*> tracks;
+
+	CBaseEntity* pEntity = nullptr;
+
+	while( ( pEntity = UTIL_FindEntityByClassname( pEntity, "path_track" ) ) != nullptr )
+	{
+		if( auto pTrack = CPathTrack::Instance( pEntity ) )
+			tracks.push_back( pTrack );
+	}
+
+	m_uiNumTracks = tracks.size();
+
+	for( size_t uiDirection = 0; uiDirection < static_cast<size_t>( Direction::COUNT ); ++uiDirection )
+	{
+		BuildTable( m_Tables[ uiDirection ], static_cast<Direction>( uiDirection ), tracks );
+	}
+}
+
+void CPathTrackTables::BuildTable( Table& table, const Direction direction, const std::vector<CPathTrack*>& tracks )
+{
+	table.runs.clear();
+	table.refs.clear();
+	table.dirtyRuns.clear();
+
+	int iMaxIndex = 0;
+
+	for( auto pTrack : tracks )
+	{
+		iMaxIndex = max( iMaxIndex, pTrack->entindex() );
+	}
+
+	table.refs.resize( iMaxIndex + 1 );
+
+	//Start runs at nodes that nothing leads to, so runs are as long as possible. Whatever is left is part of a loop.
+	std::vector<bool> hasPredecessor( iMaxIndex + 1, false );
+
+	for( auto pTrack : tracks )
+	{
+		if( auto pSuccessor = GetSuccessor( pTrack, direction ) )
+		{
+			const int iIndex = pSuccessor->entindex();
+
+			if( iIndex > 0 && iIndex <= iMaxIndex )
+				hasPredecessor[ iIndex ] = true;
+		}
+	}
+
+	for( int iPass = 0; iPass < 2; ++iPass )
+	{
+		for( auto pStart : tracks )
+		{
+			if( table.refs[ pStart->entindex() ].iRun != -1 )
+				continue;
+
+			if( iPass == 0 && hasPredecessor[ pStart->entindex() ] )
+				continue;
+
+			const int iRun = static_cast<int>( table.runs.size() );
+
+			table.runs.emplace_back();
+
+			BuildRun( table, iRun, pStart, direction );
+		}
+	}
+}
+
+void CPathTrackTables::BuildRun( Table& table, const int iRun, CPathTrack* pStart, const Direction direction )
+{
+	auto& run = table.runs[ iRun ];
+
+	CPathTrack* pTrack = pStart;
+
+	while( pTrack )
+	{
+		const int iIndex = pTrack->entindex();
+
+		//Tracks created after the tables were built. Treated as the end of the run.
+		if( iIndex <= 0 || static_cast<size_t>( iIndex ) >= table.refs.size() )
+		{
+			pTrack = nullptr;
+			break;
+		}
+
+		auto& ref = table.refs[ iIndex ];
+
+		//Joins a run that's already been built.
+		if( ref.iRun != -1 )
+			break;
+
+		ref.iRun = iRun;
+		ref.iIndex = static_cast<int>( run.nodes.size() );
+
+		const Vector vecPos = pTrack->GetAbsOrigin();
+
+		run.lengths.push_back( run.nodes.empty() ? 0 : run.lengths.back() + ( vecPos - run.positions.back() ).Length() );
+		run.nodes.push_back( pTrack );
+		run.positions.push_back( vecPos );
+
+		pTrack = GetSuccessor( pTrack, direction );
+	}
+
+	run.pContinue = pTrack;
+
+	const int iCount = static_cast<int>( run.nodes.size() );
+
+	run.nextDisabled.resize( iCount );
+
+	int iNextDisabled = iCount;
+
+	for( int iIndex = iCount - 1; iIndex >= 0; --iIndex )
+	{
+		if( run.nodes[ iIndex ]->GetSpawnFlags().Any( SF_PATH_DISABLED ) )
+			iNextDisabled = iIndex;
+
+		run.nextDisabled[ iIndex ] = iNextDisabled;
+	}
+}
+
+void CPathTrackTables::RebuildRun( Table& table, const int iRun, const Direction direction )
+{
+	std::vector<CPathTrack*> nodes;
+
+	{
+		auto& run = table.runs[ iRun ];
+
+		nodes.swap( run.nodes );
+
+		run.positions.clear();
+		run.lengths.clear();
+		run.nextDisabled.clear();
+		run.pContinue = nullptr;
+		run.bDirty = false;
+	}
+
+	for( auto pTrack : nodes )
+	{
+		table.refs[ pTrack->entindex() ] = NodeRef();
+	}
+
+	BuildRun( table, iRun, nodes.front(), direction );
+
+	//If the track now leads somewhere else, the rest of the old run is no longer reached from here.
+	for( auto pTrack : nodes )
+	{
+		if( table.refs[ pTrack->entindex() ].iRun != -1 )
+			continue;
+
+		const int iNewRun = static_cast<int>( table.runs.size() );
+
+		table.runs.emplace_back();
+
+		BuildRun( table, iNewRun, pTrack, direction );
+	}
+}
+
+const CPathTrackTables::NodeRef* CPathTrackTables::GetRef( const Table& table, CPathTrack* pTrack ) const
+{
+	if( !pTrack )
+		return nullptr;
+
+	const int iIndex = pTrack->entindex();
+
+	if( iIndex <= 0 || static_cast<size_t>( iIndex ) >= table.refs.size() )
+		return nullptr;
+
+	const auto& ref = table.refs[ iIndex ];
+
+	if( ref.iRun == -1 || table.runs[ ref.iRun ].nodes[ ref.iIndex ] != pTrack )
+		return nullptr;
+
+	return &ref;
+}
+
+CPathTrack* CPathTrackTables::GetSuccessor( CPathTrack* pTrack, const Direction direction )
+{
+	return direction == Direction::FORWARD ? pTrack->GetNext() : pTrack->GetPrevious();
+}
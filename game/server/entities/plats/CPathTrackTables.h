@@ -0,0 +1,145 @@
+#ifndef GAME_SERVER_ENTITIES_PLATS_CPATHTRACKTABLES_H
+#define GAME_SERVER_ENTITIES_PLATS_CPATHTRACKTABLES_H
+
+#include <vector>
+
+class CPathTrack;
+
+/**
+*	Flat tables of path_track chains, so trains don't have to walk the linked tracks node by node.
+*	For each direction, tracks are split into runs of nodes that follow each other, with the position and cumulative length of each node.
+*	A run that ends by joining another run, such as at a merge or in a loop, links to the node it continues at.
+*
+*	Tables are built when they're first needed, and rebuilt after tracks are linked. When a track is toggled,
+*	only the runs that contain it are rebuilt. Tracks are assumed not to move.
+*/
+class CPathTrackTables final
+{
+public:
+	enum class Direction
+	{
+		/**
+		*	Follows CPathTrack::GetNext.
+		*/
+		FORWARD = 0,
+
+		/**
+		*	Follows CPathTrack::GetPrevious.
+		*/
+		BACKWARD,
+
+		COUNT
+	};
+
+private:
+	struct Run final
+	{
+		std::vector<CPathTrack*> nodes;
+		std::vector<Vector> positions;
+
+		//Distance from the first node to each node, along the run.
+		std::vector<float> lengths;
+
+		//For each node, the index of the first disabled node at or after it, or the number of nodes.
+		std::vector<int> nextDisabled;
+
+		//Node the run continues at, or null if it ends.
+		CPathTrack* pContinue = nullptr;
+
+		bool bDirty = false;
+	};
+
+	struct NodeRef final
+	{
+		int iRun = -1;
+		int iIndex = -1;
+	};
+
+	struct Table final
+	{
+		std::vector<Run> runs;
+
+		//Indexed by entity index.
+		std::vector<NodeRef> refs;
+
+		//Runs to rebuild the next time the table is needed.
+		std::vector<int> dirtyRuns;
+	};
+
+public:
+	CPathTrackTables() = default;
+	~CPathTrackTables() = default;
+
+	/**
+	*	Removes all tables. Called when the map ends.
+	*/
+	void Clear();
+
+	/**
+	*	Rebuilds the tables the next time they're needed.
+	*/
+	void Invalidate() { m_bDirty = true; }
+
+	/**
+	*	Rebuilds the runs that contain the given track the next time they're needed.
+	*	Call this when the track's flags change.
+	*/
+	void Invalidate( CPathTrack* pTrack );
+
+	/**
+	*	Moves along whole segments, starting at the given node.
+	*	Stops before the last 2 nodes that can be moved to, so the caller can handle the end of the path.
+	*	@param pStart Node to start at.
+	*	@param direction Direction to move in.
+	*	@param[ in, out ] flDist Distance left to move. Only segments shorter than the remaining distance are moved along.
+	*	@param bTestFlag Whether disabled nodes end the path.
+	*	@param[ out ] vecPos Position of the node that was reached. Only set if the node isn't pStart.
+	*	@return Node that was reached.
+	*/
+	CPathTrack* Advance( CPathTrack* pStart, const Direction direction, float& flDist, const bool bTestFlag, Vector& vecPos );
+
+	/**
+	*	@see CPathTrack::Nearest
+	*/
+	CPathTrack* Nearest( CPathTrack* pStart, const Vector& vecOrigin );
+
+private:
+	/**
+	*	Rebuilds the tables or the runs that have been invalidated.
+	*/
+	void Update();
+
+	void Build();
+
+	void BuildTable( Table& table, const Direction direction, const std::vector<CPathTrack*>& tracks );
+
+	/**
+	*	Builds a run, starting at the given node and ending at the first node that's already in a run.
+	*	@param iRun Index of the run. Must be empty.
+	*/
+	void BuildRun( Table& table, const int iRun, CPathTrack* pStart, const Direction direction );
+
+	/**
+	*	Rebuilds a run from its first node. Nodes that are no longer in it are put in new runs.
+	*/
+	void RebuildRun( Table& table, const int iRun, const Direction direction );
+
+	const NodeRef* GetRef( const Table& table, CPathTrack* pTrack ) const;
+
+	static CPathTrack* GetSuccessor( CPathTrack* pTrack, const Direction direction );
+
+private:
+	Table m_Tables[ static_cast<size_t>( Direction::COUNT ) ];
+
+	size_t m_uiNumTracks = 0;
+
+	bool m_bDirty = true;
+
+private:
+	CPathTrackTables( const CPathTrackTables& ) = delete;
+	CPathTrackTables& operator=( const CPathTrackTables& ) = delete;
+};
+
+extern CPathTrackTables g_PathTrackTables;
+
+#endif //GAME_SERVER_ENTITIES_PLATS_CPATHTRACKTABLES_H
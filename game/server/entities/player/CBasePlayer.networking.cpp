@@ -18,6 +18,7 @@
 #include "CBasePlayer.h"
 #include "Weapons.h"
 #include "CWeaponInfoCache.h"
+#include "CHudStateMessages.h"
 
 #include "CMap.h"
 
@@ -93,6 +94,8 @@ void CBasePlayer::UpdateClientData()
 			WRITE_BYTE( 0 );
 		MESSAGE_END();
 
+		g_HudStateMessages.ClientHUDReset( *this );
+
 		if( !m_fGameHUDInitialized )
 		{
 			MESSAGE_BEGIN( MSG_ONE, gmsgInitHUD, NULL, this );
@@ -153,9 +156,7 @@ void CBasePlayer::UpdateClientData()
 			iHealth = 1;
 
 		// send "health" update message
-		MESSAGE_BEGIN( MSG_ONE, gmsgHealth, NULL, this );
-			WRITE_BYTE( iHealth );
-		MESSAGE_END();
+		g_HudStateMessages.SetHealth( *this, iHealth );
 
 		m_iClientHealth = GetHealth();
 	}
@@ -166,10 +167,8 @@ void CBasePlayer::UpdateClientData()
 		m_iClientBattery = GetArmorAmount();
 
 		ASSERT( gmsgBattery > 0 );
-		// send "health" update message
-		MESSAGE_BEGIN( MSG_ONE, gmsgBattery, NULL, this );
-			WRITE_SHORT( ( int ) GetArmorAmount() );
-		MESSAGE_END();
+		// send "battery" update message
+		g_HudStateMessages.SetBattery( *this, ( int ) GetArmorAmount() );
 	}
 
 	if( pev->dmg_take || pev->dmg_save || m_bitsHUDDamage != m_bitsDamageType )
@@ -232,9 +231,7 @@ void CBasePlayer::UpdateClientData()
 				m_flFlashLightTime = 0;
 		}
 
-		MESSAGE_BEGIN( MSG_ONE, gmsgFlashBattery, NULL, this );
-			WRITE_BYTE( m_iFlashBattery );
-		MESSAGE_END();
+		g_HudStateMessages.SetFlashBattery( *this, m_iFlashBattery );
 	}
 
 	if( m_iTrain & TRAIN_NEW )
@@ -257,6 +254,9 @@ void CBasePlayer::UpdateClientData()
 			m_rgpPlayerItems[ i ]->UpdateClientData( this );
 	}
 
+	// Send the final values of everything that changed this frame
+	g_HudStateMessages.Flush( *this );
+
 	// Cache and client weapon change
 	m_pClientActiveItem = m_pActiveItem;
 	m_iClientFOV = m_iFOV;
@@ -22,6 +22,7 @@
 #include "Weapons.h"
 #include "pm_shared.h"
 #include "entities/CCorpse.h"
+#include "CHudStateMessages.h"
 
 // Find the next client in the game for this player to spectate
 void CBasePlayer::Observer_FindNextPlayer( bool bReverse )
@@ -197,11 +198,8 @@ void CBasePlayer::Observer_CheckProperties()
 
 			m_iObserverWeapon = weapon;
 			//send weapon update
-			MESSAGE_BEGIN( MSG_ONE, gmsgCurWeapon, NULL, this );
-				WRITE_BYTE( 1 );	// 1 = current weapon, not on target
-				WRITE_BYTE( m_iObserverWeapon );	
-				WRITE_BYTE( 0 );	// clip
-			MESSAGE_END();
+			// 1 = current weapon, not on target
+			g_HudStateMessages.SetCurWeapon( *this, 1, m_iObserverWeapon, 0, HudSend::NOW );
 		}
 	}
 	else
@@ -212,11 +210,8 @@ void CBasePlayer::Observer_CheckProperties()
 		{
 			m_iObserverWeapon = 0;
 
-			MESSAGE_BEGIN( MSG_ONE, gmsgCurWeapon, NULL, this );
-				WRITE_BYTE( 1 );	// 1 = current weapon
-				WRITE_BYTE( m_iObserverWeapon );	
-				WRITE_BYTE( 0 );	// clip
-			MESSAGE_END();
+			// 1 = current weapon
+			g_HudStateMessages.SetCurWeapon( *this, 1, m_iObserverWeapon, 0, HudSend::NOW );
 		}
 	}
 }
@@ -362,11 +357,7 @@ void CBasePlayer::StartObserver( Vector vecPosition, Vector vecViewAngle )
 	SetSuitUpdate( NULL, SUIT_SENTENCE, 0 );
 
 	// Tell Ammo Hud that the player is dead
-	MESSAGE_BEGIN( MSG_ONE, gmsgCurWeapon, NULL, this );
-		WRITE_BYTE( 0 );
-		WRITE_BYTE( 0XFF );
-		WRITE_BYTE( 0xFF );
-	MESSAGE_END();
+	g_HudStateMessages.SetCurWeapon( *this, 0, 0xFF, 0xFF, HudSend::NOW );
 
 	// reset FOV
 	m_iFOV = m_iClientFOV = 0;
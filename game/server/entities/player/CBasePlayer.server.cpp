@@ -34,6 +34,7 @@
 #include "gamerules/GameRules.h"
 #include "nodes/Nodes.h"
 #include "hltv.h"
+#include "CHudStateMessages.h"
 
 extern DLL_GLOBAL unsigned int	g_ulModelIndexPlayer;
 extern DLL_GLOBAL bool			g_fGameOver;
@@ -260,8 +261,7 @@ void CBasePlayer::TraceAttack( const CTakeDamageInfo& info, Vector vecDir, Trace
 			break;
 		}
 
-		SpawnBlood( tr.vecEndPos, BloodColor(), newInfo .GetDamage());// a little surface blood.
-		TraceBleed( newInfo, vecDir, tr );
+		g_MultiDamage.AddBlood( this, newInfo, tr.vecEndPos, vecDir, tr );// a little surface blood.
 		g_MultiDamage.AddMultiDamage( newInfo, this );
 	}
 }
@@ -552,16 +552,11 @@ void CBasePlayer::Killed( const CTakeDamageInfo& info, GibAction gibAction )
 
 	// send "health" update message to zero
 	m_iClientHealth = 0;
-	MESSAGE_BEGIN( MSG_ONE, gmsgHealth, NULL, this );
-		WRITE_BYTE( m_iClientHealth );
-	MESSAGE_END();
+	g_HudStateMessages.SetHealth( *this, m_iClientHealth, HudSend::NOW );
 
 	// Tell Ammo Hud that the player is dead
-	MESSAGE_BEGIN( MSG_ONE, gmsgCurWeapon, NULL, this );
-		WRITE_BYTE(0);
-		WRITE_BYTE(0XFF);
-		WRITE_BYTE(0xFF);
-	MESSAGE_END();
+	// Has to arrive before the FOV reset below
+	g_HudStateMessages.SetCurWeapon( *this, 0, 0xFF, 0xFF, HudSend::NOW );
 
 	// reset FOV
 	SetFOV( m_iFOV );
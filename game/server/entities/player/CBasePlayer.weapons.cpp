@@ -23,6 +23,7 @@
 #include "gamerules/GameRules.h"
 #include "Server.h"
 #include "ServerInterface.h"
+#include "CHudStateMessages.h"
 
 #include "CBasePlayerUtils.h"
 
@@ -218,11 +219,7 @@ void CBasePlayer::RemoveAllItems( const bool removeSuit )
 
 	UpdateClientData();
 	// send Selected Weapon Message to our client
-	MESSAGE_BEGIN( MSG_ONE, gmsgCurWeapon, NULL, this );
-		WRITE_BYTE( 0 );
-		WRITE_BYTE( 0 );
-		WRITE_BYTE( 0 );
-	MESSAGE_END();
+	g_HudStateMessages.SetCurWeapon( *this, 0, 0, 0 );
 }
 
 //=========================================================
@@ -776,10 +773,7 @@ void CBasePlayer::SendAmmoUpdate()
 			ASSERT( m_rgAmmo[ i ] < 255 );
 
 			// send "Ammo" update message
-			MESSAGE_BEGIN( MSG_ONE, gmsgAmmoX, NULL, this );
-			WRITE_BYTE( i );
-			WRITE_BYTE( max( min( m_rgAmmo[ i ], 254 ), 0 ) );  // clamp the value to one byte
-			MESSAGE_END();
+			g_HudStateMessages.SetAmmo( *this, i, max( min( m_rgAmmo[ i ], 254 ), 0 ) );  // clamp the value to one byte
 		}
 	}
 }
@@ -6,6 +6,7 @@
 #include "Weapons.h"
 
 #include "entities/weapons/CBasePlayerWeapon.h"
+#include "CHudStateMessages.h"
 
 extern bool gEvilImpulse101;
 
@@ -423,11 +424,7 @@ bool CBasePlayerWeapon::UpdateClientData( CBasePlayer *pPlayer )
 
 	if( bSend )
 	{
-		MESSAGE_BEGIN( MSG_ONE, gmsgCurWeapon, NULL, pPlayer );
-		WRITE_BYTE( static_cast<int>( state ) );
-		WRITE_BYTE( m_iId );
-		WRITE_BYTE( m_iClip );
-		MESSAGE_END();
+		g_HudStateMessages.SetCurWeapon( *pPlayer, static_cast<int>( state ), m_iId, m_iClip );
 
 		m_iClientClip = m_iClip;
 		m_iClientWeaponState = state;
@@ -25,11 +25,18 @@
 #include "gamerules/GameRules.h"
 #include "Skill.h"
 #include "Server.h"
+#include "CClientCommandTable.h"
 
 #include "entities/spawnpoints/CBaseSpawnPoint.h"
 
 extern DLL_GLOBAL bool	g_fGameOver;
 
+CGameRules::~CGameRules()
+{
+	//Remove commands registered by this game's rules.
+	g_ClientCommands.RemoveCommandsByOwner( this );
+}
+
 void CGameRules::OnCreate()
 {
 	RefreshSkillData();
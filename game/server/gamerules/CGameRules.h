@@ -225,7 +225,7 @@ public:
 	virtual bool AllowAutoTargetCrosshair() { return true; }
 
 	/**
-	*	Handles the user commands;  returns true if command handled properly
+	*	Handles user commands that aren't in the client command table;  returns true if command handled properly
 	*/
 	virtual bool ClientCommand( CBasePlayer *pPlayer, const char *pcmd ) { return false; }
 
@@ -402,8 +402,4 @@ public:
 	virtual void EndMultiplayerGame() {}
 };
 
-inline CGameRules::~CGameRules()
-{
-}
-
 #endif //GAME_SERVER_GAMERULES_CGAMERULES_H
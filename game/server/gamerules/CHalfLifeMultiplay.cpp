@@ -67,6 +67,7 @@ static CMultiplayGameMgrHelper g_GameMgrHelper;
 CHalfLifeMultiplay :: CHalfLifeMultiplay()
 {
 	g_VoiceGameMgr.Init(&g_GameMgrHelper, gpGlobals->maxClients);
+	g_VoiceGameMgr.RegisterCommands(this);
 
 	m_flIntermissionEndTime = 0;
 	g_flIntermissionStartTime = 0;
@@ -105,14 +106,6 @@ void CHalfLifeMultiplay::OnCreate()
 	}
 }
 
-bool CHalfLifeMultiplay::ClientCommand( CBasePlayer *pPlayer, const char *pcmd )
-{
-	if(g_VoiceGameMgr.ClientCommand(pPlayer, pcmd))
-		return true;
-
-	return CGameRules::ClientCommand(pPlayer, pcmd);
-}
-
 cvar_t* CHalfLifeMultiplay::GetSkillCvar( const skilldata_t& skillData, const char* pszSkillCvarName )
 {
 	//These cvars have overrides for multiplayer. - Solokiller
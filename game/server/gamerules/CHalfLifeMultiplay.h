@@ -58,7 +58,6 @@ public:
 	virtual CBaseEntity* GetPlayerSpawnSpot( CBasePlayer* pPlayer ) override;
 
 	virtual bool AllowAutoTargetCrosshair() override;
-	virtual bool ClientCommand( CBasePlayer *pPlayer, const char *pcmd ) override;
 
 // Client kills/scoring
 	virtual int IPointsForKill( CBasePlayer *pAttacker, CBasePlayer *pKilled ) override;
@@ -22,6 +22,7 @@
 #include	"Weapons.h"
 #include	"CHalfLifeTeamplay.h"
 #include	"Server.h"
+#include	"CClientCommandTable.h"
 
 static char team_names[MAX_TEAMS][MAX_TEAMNAME_LENGTH];
 static int team_scores[MAX_TEAMS];
@@ -29,8 +30,20 @@ static int num_teams = 0;
 
 extern DLL_GLOBAL bool		g_fGameOver;
 
+static void ClientCommand_MenuSelect( CBasePlayer& )
+{
+	if ( CMD_ARGC() < 2 )
+		return;
+
+	//int slot = atoi( CMD_ARGV(1) );
+
+	// select the item from the current menu
+}
+
 CHalfLifeTeamplay :: CHalfLifeTeamplay()
 {
+	g_ClientCommands.Add( "menuselect", &ClientCommand_MenuSelect, { 10, 20 }, this );
+
 	m_DisableDeathMessages = false;
 	m_DisableDeathPenalty = false;
 
@@ -137,31 +150,6 @@ void CHalfLifeTeamplay :: Think ( void )
 	last_time  = time_remaining;
 }
 
-//=========================================================
-// ClientCommand
-// the user has typed a command which is unrecognized by everything else;
-// this check to see if the gamerules knows anything about the command
-//=========================================================
-bool CHalfLifeTeamplay::ClientCommand( CBasePlayer *pPlayer, const char *pcmd )
-{
-	if(g_VoiceGameMgr.ClientCommand(pPlayer, pcmd))
-		return true;
-
-	if ( FStrEq( pcmd, "menuselect" ) )
-	{
-		if ( CMD_ARGC() < 2 )
-			return true;
-
-		//int slot = atoi( CMD_ARGV(1) );
-
-		// select the item from the current menu
-
-		return true;
-	}
-
-	return false;
-}
-
 void CHalfLifeTeamplay :: UpdateGameMode( CBasePlayer *pPlayer )
 {
 	MESSAGE_BEGIN( MSG_ONE, gmsgGameMode, NULL, pPlayer );
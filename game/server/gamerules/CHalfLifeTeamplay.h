@@ -30,7 +30,6 @@ class CHalfLifeTeamplay : public CHalfLifeMultiplay
 public:
 	CHalfLifeTeamplay();
 
-	virtual bool ClientCommand( CBasePlayer *pPlayer, const char *pcmd ) override;
 	virtual void ClientUserInfoChanged( CBasePlayer *pPlayer, char *infobuffer ) override;
 	virtual bool IsTeamplay() const override;
 	virtual bool FPlayerCanTakeDamage( CBasePlayer *pPlayer, const CTakeDamageInfo& info ) override;
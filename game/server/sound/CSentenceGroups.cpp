@@ -1,10 +1,40 @@
+#include <string>
+#include <vector>
+
 #include "extdll.h"
 #include "util.h"
+#include "LookupBenchmark.h"
 
 #include "CSentenceGroups.h"
 
 const int CSentenceGroups::INVALID_SENTENCE_INDEX = -1;
 
+namespace
+{
+/**
+*	Case insensitive FNV-1a.
+*/
+unsigned int HashSentenceName( const char* pszName )
+{
+	unsigned int uiHash = 2166136261U;
+
+	for( ; *pszName; ++pszName )
+	{
+		uiHash ^= static_cast<unsigned char>( tolower( *pszName ) );
+		uiHash *= 16777619U;
+	}
+
+	return uiHash;
+}
+
+void ServerCommand_Benchmark()
+{
+	const int iIterations = CMD_ARGC() >= 2 ? atoi( CMD_ARGV( 1 ) ) : 100;
+
+	g_Sentences.BenchmarkLookups( iIterations > 0 ? iIterations : 1 );
+}
+}
+
 bool CSentenceGroups::FormatSentenceName( char* pszBuffer, const size_t uiBufferSize, const char* const pszSentenceGroup, const int iPick )
 {
 	ASSERT( pszBuffer );
@@ -64,7 +94,7 @@ void CSentenceGroups::Initialize()
 		if( !buffer[ j ] )
 			continue;
 
-		if( m_uiSentenceCount > CVOXFILESENTENCEMAX )
+		if( m_uiSentenceCount >= CVOXFILESENTENCEMAX )
 		{
 			ALERT( at_error, "Too many sentences in sentences.txt!\n" );
 			break;
@@ -127,6 +157,8 @@ void CSentenceGroups::Initialize()
 
 	m_bInitialized = true;
 
+	BuildLookupTables();
+
 	// init lru lists
 
 	i = 0;
@@ -138,6 +170,59 @@ void CSentenceGroups::Initialize()
 	}
 }
 
+void CSentenceGroups::RegisterCommands()
+{
+	g_engfuncs.pfnAddServerCommand( "sv_sentence_lookup_benchmark", &::ServerCommand_Benchmark );
+}
+
+void CSentenceGroups::BenchmarkLookups( const int iIterations )
+{
+	if( !m_bInitialized )
+	{
+		Alert( at_console, "Sentences are loaded once a map has been loaded\n" );
+		return;
+	}
+
+	//Lookup expects the '!' prefix.
+	std::vector<std::string> samples;
+
+	samples.reserve( m_uiSentenceCount );
+
+	for( size_t uiSentence = 0; uiSentence < m_uiSentenceCount; ++uiSentence )
+	{
+		samples.emplace_back( std::string( "!" ) + m_szAllSentenceNames[ uiSentence ] );
+	}
+
+	const auto sentences = BenchmarkLookup( samples.size(), iIterations,
+		[ & ]( const size_t uiSentence ) { return LookupLinear( samples[ uiSentence ].c_str(), nullptr ); },
+		[ & ]( const size_t uiSentence ) { return Lookup( samples[ uiSentence ].c_str(), nullptr ); } );
+
+	for( const auto uiSentence : sentences.mismatches )
+	{
+		Alert( at_error, "Sentence \"%s\": hash table doesn't match linear search\n", m_szAllSentenceNames[ uiSentence ] );
+	}
+
+	Alert( at_console, "%u sentences: linear search %lld us, hash table %lld us\n",
+		static_cast<unsigned int>( samples.size() ), sentences.iReferenceMicroseconds, sentences.iMicroseconds );
+
+	size_t uiGroupCount = 0;
+
+	while( uiGroupCount < CSENTENCEG_MAX && m_SentenceGroups[ uiGroupCount ].count )
+		++uiGroupCount;
+
+	const auto groups = BenchmarkLookup( uiGroupCount, iIterations,
+		[ & ]( const size_t uiGroup ) { return GetIndexLinear( m_SentenceGroups[ uiGroup ].szgroupname ); },
+		[ & ]( const size_t uiGroup ) { return GetIndex( m_SentenceGroups[ uiGroup ].szgroupname ); } );
+
+	for( const auto uiGroup : groups.mismatches )
+	{
+		Alert( at_error, "Sentence group \"%s\": hash table doesn't match linear search\n", m_SentenceGroups[ uiGroup ].szgroupname );
+	}
+
+	Alert( at_console, "%u sentence groups: linear search %lld us, hash table %lld us\n",
+		static_cast<unsigned int>( uiGroupCount ), groups.iReferenceMicroseconds, groups.iMicroseconds );
+}
+
 void CSentenceGroups::Stop( CBaseEntity* pEntity, int isentenceg, int ipick )
 {
 	ASSERT( m_bInitialized );
@@ -227,12 +312,108 @@ int CSentenceGroups::GetIndex( const char* szgroupname )
 {
 	ASSERT( m_bInitialized );
 
+	if( !m_bInitialized || !szgroupname )
+		return INVALID_SENTENCE_INDEX;
+
+	// search m_SentenceGroups for match on szgroupname
+	//The table is case insensitive, but group names have always been matched case sensitively.
+	const size_t uiMask = GROUP_TABLE_SIZE - 1;
+
+	for( size_t uiSlot = HashSentenceName( szgroupname ) & uiMask; m_GroupTable[ uiSlot ] != -1; uiSlot = ( uiSlot + 1 ) & uiMask )
+	{
+		if( !strcmp( szgroupname, m_SentenceGroups[ m_GroupTable[ uiSlot ] ].szgroupname ) )
+			return m_GroupTable[ uiSlot ];
+	}
+
+	return INVALID_SENTENCE_INDEX;
+}
+
+int CSentenceGroups::Lookup( const char* sample, char* sentencenum )
+{
+	if( !m_bInitialized )
+		return INVALID_SENTENCE_INDEX;
+
+	// this is a sentence name; lookup sentence number
+	// and give to engine as string.
+	const char* pszName = sample + 1;
+
+	const size_t uiMask = SENTENCE_TABLE_SIZE - 1;
+
+	for( size_t uiSlot = HashSentenceName( pszName ) & uiMask; m_SentenceTable[ uiSlot ] != -1; uiSlot = ( uiSlot + 1 ) & uiMask )
+	{
+		const int iIndex = m_SentenceTable[ uiSlot ];
+
+		if( !stricmp( m_szAllSentenceNames[ iIndex ], pszName ) )
+		{
+			if( sentencenum )
+			{
+				strcpy( sentencenum, m_szSentenceNums[ iIndex ] );
+			}
+
+			return iIndex;
+		}
+	}
+
+	// sentence name not found!
+	return INVALID_SENTENCE_INDEX;
+}
+
+void CSentenceGroups::BuildLookupTables()
+{
+	static_assert( SENTENCE_TABLE_SIZE > CVOXFILESENTENCEMAX, "Sentence table must have an empty slot" );
+	static_assert( GROUP_TABLE_SIZE > CSENTENCEG_MAX, "Group table must have an empty slot" );
+
+	memset( m_SentenceTable, -1, sizeof( m_SentenceTable ) );
+	memset( m_GroupTable, -1, sizeof( m_GroupTable ) );
+
+	for( size_t i = 0; i < m_uiSentenceCount; ++i )
+	{
+		snprintf( m_szSentenceNums[ i ], sizeof( m_szSentenceNums[ i ] ), "!%u", static_cast<unsigned int>( i ) );
+
+		const char* pszName = m_szAllSentenceNames[ i ];
+
+		const size_t uiMask = SENTENCE_TABLE_SIZE - 1;
+
+		size_t uiSlot = HashSentenceName( pszName ) & uiMask;
+
+		for( ; m_SentenceTable[ uiSlot ] != -1; uiSlot = ( uiSlot + 1 ) & uiMask )
+		{
+			//Duplicates resolve to the first sentence with the name.
+			if( !stricmp( m_szAllSentenceNames[ m_SentenceTable[ uiSlot ] ], pszName ) )
+				break;
+		}
+
+		if( m_SentenceTable[ uiSlot ] == -1 )
+			m_SentenceTable[ uiSlot ] = static_cast<short>( i );
+	}
+
+	for( int i = 0; i < CSENTENCEG_MAX && m_SentenceGroups[ i ].count; ++i )
+	{
+		const char* pszName = m_SentenceGroups[ i ].szgroupname;
+
+		const size_t uiMask = GROUP_TABLE_SIZE - 1;
+
+		size_t uiSlot = HashSentenceName( pszName ) & uiMask;
+
+		for( ; m_GroupTable[ uiSlot ] != -1; uiSlot = ( uiSlot + 1 ) & uiMask )
+		{
+			if( !strcmp( m_SentenceGroups[ m_GroupTable[ uiSlot ] ].szgroupname, pszName ) )
+				break;
+		}
+
+		if( m_GroupTable[ uiSlot ] == -1 )
+			m_GroupTable[ uiSlot ] = static_cast<short>( i );
+	}
+}
+
+int CSentenceGroups::GetIndexLinear( const char* szgroupname ) const
+{
 	if( !m_bInitialized || !szgroupname )
 		return INVALID_SENTENCE_INDEX;
 
 	// search m_SentenceGroups for match on szgroupname
 
-	for( int i = 0; m_SentenceGroups[ i ].count; ++i )
+	for( int i = 0; i < CSENTENCEG_MAX && m_SentenceGroups[ i ].count; ++i )
 	{
 		if( !strcmp( szgroupname, m_SentenceGroups[ i ].szgroupname ) )
 			return i;
@@ -241,7 +422,7 @@ int CSentenceGroups::GetIndex( const char* szgroupname )
 	return INVALID_SENTENCE_INDEX;
 }
 
-int CSentenceGroups::Lookup( const char* sample, char* sentencenum )
+int CSentenceGroups::LookupLinear( const char* sample, char* sentencenum ) const
 {
 	// this is a sentence name; lookup sentence number
 	// and give to engine as string.
@@ -83,6 +83,18 @@ public:
 	*/
 	void Initialize();
 
+	/**
+	*	Registers the lookup benchmark command.
+	*/
+	void RegisterCommands();
+
+	/**
+	*	Looks up every sentence and sentence group name with both the linear searches and the hash tables,
+	*	and prints the time taken by each. Names that aren't found at the same index are reported as errors.
+	*	@param iIterations Number of times to look up each name.
+	*/
+	void BenchmarkLookups( const int iIterations );
+
 	/**
 	*	For this entity, for the given sentence within the sentence group, stop
 	*	the sentence.
@@ -146,12 +158,49 @@ private:
 
 	int PickSequential( int isentenceg, char* szfound, int ipick, const bool bReset );
 
+	/**
+	*	GetIndex without the hash table. Used to benchmark it.
+	*/
+	int GetIndexLinear( const char* szgroupname ) const;
+
+	/**
+	*	Lookup without the hash table. Used to benchmark it.
+	*/
+	int LookupLinear( const char* sample, char* sentencenum ) const;
+
+	/**
+	*	Builds the sentence and group name hash tables, and the sentence number strings.
+	*/
+	void BuildLookupTables();
+
 private:
+	/**
+	*	Size of the sentence name hash table. Must be a power of 2, and larger than CVOXFILESENTENCEMAX.
+	*/
+	static const size_t SENTENCE_TABLE_SIZE = 4096;
+
+	/**
+	*	Size of the sentence group name hash table. Must be a power of 2, and larger than CSENTENCEG_MAX.
+	*/
+	static const size_t GROUP_TABLE_SIZE = 512;
+
+	/**
+	*	Large enough for "!" followed by any sentence index.
+	*/
+	static const size_t MAX_CACHED_SENTENCENUM = 6;
+
 	char m_szAllSentenceNames[ CVOXFILESENTENCEMAX ][ CBSENTENCENAME_MAX ] = {};
 	size_t m_uiSentenceCount = 0;
 
 	CSentenceGroup m_SentenceGroups[ CSENTENCEG_MAX ] = {};
 
+	//Open addressing tables of indices, hashed case insensitively. -1 is empty.
+	short m_SentenceTable[ SENTENCE_TABLE_SIZE ];
+	short m_GroupTable[ GROUP_TABLE_SIZE ];
+
+	//"!<index>" for each sentence, as given to the engine.
+	char m_szSentenceNums[ CVOXFILESENTENCEMAX ][ MAX_CACHED_SENTENCENUM ] = {};
+
 	bool m_bInitialized = false;
 
 private:
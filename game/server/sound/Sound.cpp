@@ -124,50 +124,41 @@ void UTIL_EmitAmbientSound( CBaseEntity* pEntity, const Vector &vecOrigin, const
 float TEXTURETYPE_PlaySound(const TraceResult& tr, Vector vecSrc, Vector vecEnd, int iBulletType)
 {
 	// hit the world, try to play sound based on texture material type
-	
-	char szbuffer[64];
-	const texture_t* pTexture;
 
 	if ( !g_pGameRules->PlayTextureSounds() )
 		return 0.0;
 
 	CBaseEntity *pEntity = CBaseEntity::Instance(tr.pHit);
 
-	char chTextureType = CHAR_TEX_CONCRETE;
+	const char chTextureType = TEXTURETYPE_GetHitType( tr, vecSrc, vecEnd );
+
+	return TEXTURETYPE_PlayHitSound( tr, chTextureType, iBulletType, pEntity && pEntity->ClassnameIs( "func_breakable" ) );
+}
+
+char TEXTURETYPE_GetHitType( const TraceResult& tr, const Vector& vecSrc, const Vector& vecEnd )
+{
+	CBaseEntity *pEntity = CBaseEntity::Instance(tr.pHit);
 
 	if (pEntity && pEntity->Classify() != EntityClassifications().GetNoneId() && pEntity->Classify() != EntityClassifications().GetClassificationId( classify::MACHINE ))
 		// hit body
-		chTextureType = CHAR_TEX_FLESH;
-	else
-	{
-		// hit world
+		return CHAR_TEX_FLESH;
 
-		// find texture under strike, get material type
+	// hit world
 
-		// get texture from entity or world
-		pTexture = UTIL_TraceTexture( pEntity ? pEntity : CWorld::GetInstance(), vecSrc, vecEnd );
-			
-		if ( pTexture )
-		{
-			const char* pszTextureName = pTexture->name;
-
-			// strip leading '-0' or '+0~' or '{' or '!'
-			if (*pszTextureName == '-' || *pszTextureName == '+')
-				pszTextureName += 2;
-
-			if (*pszTextureName == '{' || *pszTextureName == '!' || *pszTextureName == '~' || *pszTextureName == ' ')
-				++pszTextureName;
-			// '}}'
-			strcpy( szbuffer, pszTextureName );
-			szbuffer[CBTEXTURENAMEMAX - 1] = 0;
-				
-			// ALERT ( at_console, "texture hit: %s\n", szbuffer);
-
-			// get texture type
-			chTextureType = g_MaterialsList.FindTextureType(szbuffer);	
-		}
-	}
+	// find texture under strike, get material type
+
+	// get texture from entity or world
+	const texture_t* pTexture = UTIL_TraceTexture( pEntity ? pEntity : CWorld::GetInstance(), vecSrc, vecEnd );
 
+	// get texture type
+	if ( pTexture )
+		return g_MaterialsList.GetTextureType( pTexture );
+
+	return CHAR_TEX_CONCRETE;
+}
+
+float TEXTURETYPE_PlayHitSound( const TraceResult& tr, const char chTextureType, const int iBulletType, const bool bBreakable )
+{
 	float fvol;
 	float fvolbar;
 	float fattn;
@@ -181,7 +172,7 @@ float TEXTURETYPE_PlaySound(const TraceResult& tr, Vector vecSrc, Vector vecEnd,
 
 	// did we hit a breakable?
 
-	if( pEntity && pEntity->ClassnameIs( "func_breakable" ) )
+	if( bBreakable )
 	{
 		// drop volumes, the object will already play a damaged sound
 		fvol /= 1.5;
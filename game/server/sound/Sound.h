@@ -45,6 +45,20 @@ extern CSentenceGroups g_Sentences;
 
 float TEXTURETYPE_PlaySound( const TraceResult& tr, Vector vecSrc, Vector vecEnd, int iBulletType );
 
+/**
+*	Finds the material type of the surface that the given trace hit. Anything with a classification other than machine is flesh.
+*	@param vecSrc Start of the attack's trace.
+*	@param vecEnd End of the attack's trace.
+*/
+char TEXTURETYPE_GetHitType( const TraceResult& tr, const Vector& vecSrc, const Vector& vecEnd );
+
+/**
+*	Plays the strike sound for a material type at the end of the given trace. Doesn't check whether texture sounds are enabled.
+*	@param bBreakable Whether a breakable was hit. Breakables play their own damage sound, so the strike sound is quieter.
+*	@return Volume of the strike instrument (crowbar) to play.
+*/
+float TEXTURETYPE_PlayHitSound( const TraceResult& tr, const char chTextureType, const int iBulletType, const bool bBreakable );
+
 // NOTE: use EMIT_SOUND_DYN to set the pitch of a sound. Pitch of 100
 // is no pitch shift.  Pitch > 100 up to 255 is a higher pitch, pitch < 100
 // down to 1 is a lower pitch.   150 to 70 is the realistic range.
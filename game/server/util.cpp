@@ -30,6 +30,8 @@
 #include "CBasePlayer.h"
 #include "Weapons.h"
 #include "gamerules/GameRules.h"
+#include "CClientPVS.h"
+#include "CTargetnameGraph.h"
 
 void UTIL_ParametricRocket( CBaseEntity* pEntity, Vector vecOrigin, Vector vecAngles, CBaseEntity* pOwner )
 {	
@@ -112,11 +114,22 @@ CBaseEntity* UTIL_FindClientInPVS( const CBaseEntity* const pPVSEntity )
 	if( !pPVSEntity )
 		return nullptr;
 
+	if( g_ClientPVS.IsLoaded() )
+		return g_ClientPVS.FindClientInPVS( pPVSEntity );
+
 	edict_t* pEnt = FIND_CLIENT_IN_PVS( pPVSEntity->edict() );
 
 	return pEnt ? CBaseEntity::Instance( pEnt ) : nullptr;
 }
 
+edict_t* UTIL_EntitiesInPVS( edict_t* pPVSEntity )
+{
+	if( g_ClientPVS.IsLoaded() )
+		return g_ClientPVS.EntitiesInPVS( pPVSEntity );
+
+	return g_engfuncs.pfnEntitiesInPVS( pPVSEntity );
+}
+
 bool UTIL_GetNextBestWeapon( CBasePlayer *pPlayer, CBasePlayerWeapon *pCurrentWeapon )
 {
 	return g_pGameRules->GetNextBestWeapon( pPlayer, pCurrentWeapon );
@@ -266,7 +279,7 @@ CBaseEntity *UTIL_FindEntityByClassname( CBaseEntity *pStartEntity, const char *
 
 CBaseEntity *UTIL_FindEntityByTargetname( CBaseEntity *pStartEntity, const char *szName )
 {
-	return UTIL_FindEntityByString( pStartEntity, "targetname", szName );
+	return g_TargetnameGraph.FindNext( pStartEntity, szName );
 }
 
 
@@ -1215,7 +1228,7 @@ CBaseEntity* UTIL_FindEntitiesInPVS( CBaseEntity* pEntity )
 	if( !pEntity )
 		return nullptr;
 
-	auto pResult = g_engfuncs.pfnEntitiesInPVS( pEntity->edict() );
+	auto pResult = UTIL_EntitiesInPVS( pEntity->edict() );
 
 	if( pResult )
 		return GET_PRIVATE( pResult );
@@ -13,6 +13,7 @@
 #include "util.h"
 #include "cbase.h"
 #include "CBasePlayer.h"
+#include "CClientCommandTable.h"
 
 
 
@@ -142,50 +143,63 @@ bool CVoiceGameMgr::PlayerHasBlockedPlayer(CBasePlayer *pReceiver, CBasePlayer *
 	return ( g_BanMasks[iReceiverIndex][iSenderIndex] ? true : false );
 }
 
-bool CVoiceGameMgr::ClientCommand(CBasePlayer *pPlayer, const char *cmd)
+void CVoiceGameMgr::RegisterCommands(const void *pOwner)
+{
+	g_ClientCommands.Add("vban", [this](CBasePlayer& player) { BanCommand(&player); }, {5, 10}, pOwner);
+	g_ClientCommands.Add("VModEnable", [this](CBasePlayer& player) { ModEnableCommand(&player); }, {5, 10}, pOwner);
+}
+
+
+int CVoiceGameMgr::GetClientIndex(CBasePlayer *pPlayer, const char *cmd)
 {
 	int playerClientIndex = pPlayer->entindex() - 1;
 	if(playerClientIndex < 0 || playerClientIndex >= m_nMaxPlayers)
 	{
 		VoiceServerDebug( "CVoiceGameMgr::ClientCommand: cmd %s from invalid client (%d)\n", cmd, playerClientIndex );
-		return true;
+		return -1;
 	}
 
-	bool bBan = stricmp(cmd, "vban") == 0;
-	if(bBan && CMD_ARGC() >= 2)
-	{
-		for(int i=1; i < CMD_ARGC(); i++)
-		{
-			uint32 mask = 0;
-			sscanf(CMD_ARGV(i), "%x", &mask);
+	return playerClientIndex;
+}
 
-			if(i <= VOICE_MAX_PLAYERS_DW)
-			{
-				VoiceServerDebug( "CVoiceGameMgr::ClientCommand: vban (0x%x) from %d\n", mask, playerClientIndex );
-				g_BanMasks[playerClientIndex].SetDWord(i-1, mask);
-			}
-			else
-			{
-				VoiceServerDebug( "CVoiceGameMgr::ClientCommand: invalid index (%d)\n", i );
-			}
-		}
 
-		// Force it to update the masks now.
-		//UpdateMasks();		
-		return true;
-	}
-	else if(stricmp(cmd, "VModEnable") == 0 && CMD_ARGC() >= 2)
-	{
-		VoiceServerDebug( "CVoiceGameMgr::ClientCommand: VModEnable (%d)\n", !!atoi(CMD_ARGV(1)) );
-		g_PlayerModEnable[playerClientIndex] = !!atoi(CMD_ARGV(1));
-		g_bWantModEnable[playerClientIndex] = false;
-		//UpdateMasks();		
-		return true;
-	}
-	else
+void CVoiceGameMgr::BanCommand(CBasePlayer *pPlayer)
+{
+	int playerClientIndex = GetClientIndex(pPlayer, "vban");
+	if(playerClientIndex == -1 || CMD_ARGC() < 2)
+		return;
+
+	for(int i=1; i < CMD_ARGC(); i++)
 	{
-		return false;
+		uint32 mask = 0;
+		sscanf(CMD_ARGV(i), "%x", &mask);
+
+		if(i <= VOICE_MAX_PLAYERS_DW)
+		{
+			VoiceServerDebug( "CVoiceGameMgr::ClientCommand: vban (0x%x) from %d\n", mask, playerClientIndex );
+			g_BanMasks[playerClientIndex].SetDWord(i-1, mask);
+		}
+		else
+		{
+			VoiceServerDebug( "CVoiceGameMgr::ClientCommand: invalid index (%d)\n", i );
+		}
 	}
+
+	// Force it to update the masks now.
+	//UpdateMasks();		
+}
+
+
+void CVoiceGameMgr::ModEnableCommand(CBasePlayer *pPlayer)
+{
+	int playerClientIndex = GetClientIndex(pPlayer, "VModEnable");
+	if(playerClientIndex == -1 || CMD_ARGC() < 2)
+		return;
+
+	VoiceServerDebug( "CVoiceGameMgr::ClientCommand: VModEnable (%d)\n", !!atoi(CMD_ARGV(1)) );
+	g_PlayerModEnable[playerClientIndex] = !!atoi(CMD_ARGV(1));
+	g_bWantModEnable[playerClientIndex] = false;
+	//UpdateMasks();		
 }
 
 
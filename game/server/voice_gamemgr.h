@@ -55,9 +55,9 @@ public:
 	// Called when a new client connects (unsquelches its entity for everyone).
 	void				ClientConnected(edict_t *pEdict);
 
-	// Called on ClientCommand. Checks for the squelch and unsquelch commands.
-	// Returns true if it handled the command.
-	bool				ClientCommand(CBasePlayer *pPlayer, const char *cmd);
+	// Adds the squelch and unsquelch commands to the client command table.
+	// The game rules pass themselves as the owner so the commands are removed along with them.
+	void				RegisterCommands(const void *pOwner);
 
 	// Called to determine if the Receiver has muted (blocked) the Sender
 	// Returns true if the receiver has blocked the sender
@@ -69,6 +69,12 @@ private:
 	// Force it to update the client masks.
 	void				UpdateMasks();
 
+	// Returns the client index of the player, or -1 if it's invalid.
+	int					GetClientIndex(CBasePlayer *pPlayer, const char *cmd);
+
+	void				BanCommand(CBasePlayer *pPlayer);
+	void				ModEnableCommand(CBasePlayer *pPlayer);
+
 
 private:
 	int					m_msgPlayerVoiceMask;
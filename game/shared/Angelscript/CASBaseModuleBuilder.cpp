@@ -1,9 +1,12 @@
 #include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <experimental/filesystem>
 #include <memory>
+#include <set>
 #include <string>
 
+#include <Angelscript/CASModule.h>
 #include <Angelscript/add_on/scriptbuilder.h>
 
 #include "extdll.h"
@@ -17,6 +20,18 @@
 
 namespace fs = std::experimental::filesystem;
 
+/**
+*	Provides access to the words defined in a script builder so they can be included in the cache hash.
+*/
+class CScriptBuilderDefinedWords final : public CScriptBuilder
+{
+public:
+	static const std::set<std::string>& Get( const CScriptBuilder& builder )
+	{
+		return builder.*( &CScriptBuilderDefinedWords::definedWords );
+	}
+};
+
 CASBaseModuleBuilder::CASBaseModuleBuilder( std::string&& szBasePath, std::string&& szModuleTypeName )
 	: m_szBasePath( std::move( szBasePath ) )
 	, m_szModuleTypeName( std::move( szModuleTypeName ) )
@@ -98,6 +113,25 @@ bool CASBaseModuleBuilder::DefineWords( CScriptBuilder& builder )
 
 bool CASBaseModuleBuilder::AddScripts( CScriptBuilder& builder )
 {
+	m_BuildTime.Reset();
+
+	m_bLoadedFromCache = false;
+	m_Cache.reset();
+	m_CacheSources.clear();
+
+	if( m_bUseCache && !m_Scripts.empty() )
+	{
+		m_Cache = std::make_unique<CASBytecodeCache>( GetCacheFileName() );
+		m_uiEnvironmentHash = ComputeEnvironmentHash( builder );
+
+		//Nothing is added so the build produces an empty module. The bytecode is loaded into it in PostBuild.
+		if( m_Cache->IsUpToDate( m_uiEnvironmentHash ) )
+		{
+			m_bLoadedFromCache = true;
+			return true;
+		}
+	}
+
 	for( auto& script : m_InternalScripts )
 	{
 		if( builder.AddSectionFromMemory( script.first.c_str(), script.second.c_str() ) < 0 )
@@ -128,6 +162,16 @@ bool CASBaseModuleBuilder::AddScripts( CScriptBuilder& builder )
 				Alert( at_console, "CASBaseModuleBuilder::AddScripts: Error adding script \"%s\"!\n", szRelativePath );
 				return false;
 			}
+
+			if( m_Cache )
+			{
+				uint64_t uiHash;
+
+				if( CASBytecodeCache::HashFile( szRelativePath, uiHash ) )
+					m_CacheSources.emplace_back( szRelativePath, uiHash );
+				else
+					m_Cache.reset();
+			}
 		}
 		else
 		{
@@ -229,8 +273,12 @@ bool CASBaseModuleBuilder::IncludeScript( CScriptBuilder& builder, const char* c
 			if( result >= 0 )
 			{
 				if( result == 1 )
+				{
 					Alert( at_console, "CASBaseModuleBuilder::IncludeScript: Included script \"%s\"\n", szRelativePath.c_str() );
 
+					AddCacheSource( szRelativePath.c_str(), data.get(), size );
+				}
+
 				bSuccess = true;
 			}
 			else
@@ -255,14 +303,90 @@ bool CASBaseModuleBuilder::PreBuild( CScriptBuilder& builder )
 {
 	const auto& scripts = GetScripts();
 
-	Alert( at_console, "%u script%s\nCompiling...\n", scripts.size(), scripts.size() == 1 ? "" : "s" );
+	Alert( at_console, "%u script%s\n%s\n", scripts.size(), scripts.size() == 1 ? "" : "s", m_bLoadedFromCache ? "Loading from cache..." : "Compiling..." );
 
 	return true;
 }
 
 bool CASBaseModuleBuilder::PostBuild( CScriptBuilder& builder, const bool bSuccess, CASModule* pModule )
 {
-	Alert( at_console, "Done\n%s script compilation %s\n", m_szModuleTypeName.c_str(), bSuccess ? "succeeded" : "failed" );
+	bool bKeep = true;
 
-	return true;
+	if( bSuccess && m_bLoadedFromCache )
+	{
+		if( !m_Cache->Load( *pModule->GetModule() ) )
+		{
+			Alert( at_console, "Couldn't load %s script from bytecode cache file \"%s\"\n", m_szModuleTypeName.c_str(), m_Cache->GetFileName().c_str() );
+			m_Cache->Remove();
+			bKeep = false;
+		}
+	}
+	else if( bSuccess && m_Cache )
+	{
+		if( !m_Cache->Save( *pModule->GetModule(), m_uiEnvironmentHash, m_CacheSources ) )
+			Alert( at_console, "Couldn't write bytecode cache file \"%s\"\n", m_Cache->GetFileName().c_str() );
+	}
+
+	m_Cache.reset();
+	m_CacheSources.clear();
+
+	Alert( at_console, "Done\n%s script %s %s (%.2f ms)\n",
+		   m_szModuleTypeName.c_str(), m_bLoadedFromCache ? "cache load" : "compilation", ( bSuccess && bKeep ) ? "succeeded" : "failed",
+		   m_BuildTime.GetElapsedMicroseconds() / 1000.0 );
+
+	return bKeep;
+}
+
+void CASBaseModuleBuilder::AddCacheSource( const char* const pszFileName, const void* pData, const size_t uiSize )
+{
+	if( m_Cache )
+		m_CacheSources.emplace_back( pszFileName, CASBytecodeCache::Hash( pData, uiSize ) );
+}
+
+uint64_t CASBaseModuleBuilder::ComputeEnvironmentHash( CScriptBuilder& builder ) const
+{
+	uint64_t uiHash = CASBytecodeCache::HashEngineAPI( *builder.GetModule()->GetEngine() );
+
+	uiHash = CASBytecodeCache::Hash( m_szModuleTypeName, uiHash );
+	uiHash = CASBytecodeCache::Hash( m_szBasePath, uiHash );
+
+	//Sets are sorted, so the order in which words were defined doesn't matter.
+	for( const auto& szWord : CScriptBuilderDefinedWords::Get( builder ) )
+	{
+		uiHash = CASBytecodeCache::Hash( szWord, uiHash );
+	}
+
+	for( const auto& script : m_InternalScripts )
+	{
+		uiHash = CASBytecodeCache::Hash( script.first, uiHash );
+		uiHash = CASBytecodeCache::Hash( script.second, uiHash );
+	}
+
+	for( const auto& script : m_Scripts )
+	{
+		uiHash = CASBytecodeCache::Hash( script, uiHash );
+	}
+
+	return uiHash;
+}
+
+std::string CASBaseModuleBuilder::GetCacheFileName() const
+{
+	std::string szFileName = m_szModuleTypeName;
+
+	for( const auto& script : m_Scripts )
+	{
+		szFileName += '_';
+		szFileName += script;
+	}
+
+	for( auto& character : szFileName )
+	{
+		if( !isalnum( static_cast<unsigned char>( character ) ) && character != '_' && character != '-' )
+			character = '_';
+	}
+
+	szFileName += ".ascache";
+
+	return szFileName;
 }
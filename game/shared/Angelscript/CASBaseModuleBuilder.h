@@ -1,11 +1,16 @@
 #ifndef GAME_SHARED_ANGELSCRIPT_CASEBASEMODULEBUILDER_H
 #define GAME_SHARED_ANGELSCRIPT_CASEBASEMODULEBUILDER_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <Angelscript/IASModuleBuilder.h>
 
+#include "CStopwatch.h"
+
+#include "CASBytecodeCache.h"
+
 /**
 *	Base class for builders that handle internal and regular scripts.
 *	Internal scripts are scripts that the application itself defines. These usually contain base classes for extension classes.
@@ -66,6 +71,21 @@ public:
 	*/
 	bool AddScript( std::string&& szName );
 
+	/**
+	*	Sets whether the module may be loaded from and saved to the bytecode cache.
+	*	Only modules that load at least one script from disk are cached.
+	*/
+	void SetUseCache( const bool bUseCache )
+	{
+		m_bUseCache = bUseCache;
+	}
+
+	/**
+	*	@return Whether the last build loaded the module from the bytecode cache.
+	*	If the build failed and this is true, the cache file has been removed and the module should be built again.
+	*/
+	bool IsLoadedFromCache() const { return m_bLoadedFromCache; }
+
 	bool DefineWords( CScriptBuilder& builder ) override;
 
 	bool AddScripts( CScriptBuilder& builder ) override;
@@ -76,11 +96,33 @@ public:
 
 	bool PostBuild( CScriptBuilder& builder, const bool bSuccess, CASModule* pModule ) override;
 
+private:
+	/**
+	*	Adds a script file's contents to the list of sources used for the cache.
+	*/
+	void AddCacheSource( const char* const pszFileName, const void* pData, const size_t uiSize );
+
+	/**
+	*	@return Hash of everything other than script files that affects the module's bytecode.
+	*/
+	uint64_t ComputeEnvironmentHash( CScriptBuilder& builder ) const;
+
+	std::string GetCacheFileName() const;
+
 private:
 	std::string m_szBasePath;
 	std::string m_szModuleTypeName;
 	InternalScripts_t m_InternalScripts;
 	std::vector<std::string> m_Scripts;
+
+	bool m_bUseCache = false;
+	bool m_bLoadedFromCache = false;
+
+	std::unique_ptr<CASBytecodeCache> m_Cache;
+	uint64_t m_uiEnvironmentHash = 0;
+	CASBytecodeCache::SourceHashes_t m_CacheSources;
+
+	CStopwatch m_BuildTime;
 };
 
 #endif //GAME_SHARED_ANGELSCRIPT_CASEBASEMODULEBUILDER_H
\ No newline at end of file
@@ -0,0 +1,418 @@
+#include <cstring>
+#include <memory>
+
+#include <angelscript.h>
+
+#include "extdll.h"
+#include "util.h"
+
+#include "CFile.h"
+
+#include "CASBytecodeCache.h"
+
+#define AS_BYTECODE_CACHE_DIR "scripts/cache"
+
+//Change the version number whenever the file format changes.
+#define AS_BYTECODE_CACHE_MAGIC "HLASBC01"
+#define AS_BYTECODE_CACHE_MAGIC_SIZE 8
+
+namespace
+{
+/**
+*	Reads bytecode from memory.
+*/
+class CASMemoryReadStream final : public asIBinaryStream
+{
+public:
+	CASMemoryReadStream( const std::vector<uint8_t>& data )
+		: m_Data( data )
+	{
+	}
+
+	void Read( void* ptr, asUINT size ) override
+	{
+		if( m_uiOffset + size > m_Data.size() )
+		{
+			//Let the engine fail on the zeroed data.
+			memset( ptr, 0, size );
+			m_uiOffset = m_Data.size();
+			return;
+		}
+
+		memcpy( ptr, m_Data.data() + m_uiOffset, size );
+		m_uiOffset += size;
+	}
+
+	void Write( const void*, asUINT ) override
+	{
+	}
+
+private:
+	const std::vector<uint8_t>& m_Data;
+	size_t m_uiOffset = 0;
+};
+
+/**
+*	Writes bytecode to memory.
+*/
+class CASMemoryWriteStream final : public asIBinaryStream
+{
+public:
+	CASMemoryWriteStream( std::vector<uint8_t>& data )
+		: m_Data( data )
+	{
+	}
+
+	void Read( void*, asUINT ) override
+	{
+	}
+
+	void Write( const void* ptr, asUINT size ) override
+	{
+		auto pData = reinterpret_cast<const uint8_t*>( ptr );
+
+		m_Data.insert( m_Data.end(), pData, pData + size );
+	}
+
+private:
+	std::vector<uint8_t>& m_Data;
+};
+
+/**
+*	Reads cache file fields.
+*/
+class CCacheFileReader final
+{
+public:
+	CCacheFileReader( const std::vector<uint8_t>& data )
+		: m_Data( data )
+	{
+	}
+
+	size_t GetOffset() const { return m_uiOffset; }
+
+	bool Read( void* pOutput, const size_t uiSize )
+	{
+		if( m_uiOffset + uiSize > m_Data.size() )
+			return false;
+
+		memcpy( pOutput, m_Data.data() + m_uiOffset, uiSize );
+		m_uiOffset += uiSize;
+
+		return true;
+	}
+
+	template<typename T>
+	bool Read( T& value )
+	{
+		return Read( &value, sizeof( value ) );
+	}
+
+	bool ReadString( std::string& szString )
+	{
+		uint32_t uiLength;
+
+		if( !Read( uiLength ) || m_uiOffset + uiLength > m_Data.size() )
+			return false;
+
+		szString.assign( reinterpret_cast<const char*>( m_Data.data() + m_uiOffset ), uiLength );
+		m_uiOffset += uiLength;
+
+		return true;
+	}
+
+private:
+	const std::vector<uint8_t>& m_Data;
+	size_t m_uiOffset = 0;
+};
+
+void WriteString( std::vector<uint8_t>& data, const std::string& szString )
+{
+	const uint32_t uiLength = static_cast<uint32_t>( szString.length() );
+
+	auto pLength = reinterpret_cast<const uint8_t*>( &uiLength );
+
+	data.insert( data.end(), pLength, pLength + sizeof( uiLength ) );
+	data.insert( data.end(), szString.begin(), szString.end() );
+}
+
+template<typename T>
+void WriteValue( std::vector<uint8_t>& data, const T& value )
+{
+	auto pValue = reinterpret_cast<const uint8_t*>( &value );
+
+	data.insert( data.end(), pValue, pValue + sizeof( value ) );
+}
+
+bool ReadFile( const char* const pszFileName, std::vector<uint8_t>& data )
+{
+	CFile file( pszFileName, "rb" );
+
+	if( !file.IsOpen() )
+		return false;
+
+	data.resize( file.Size() );
+
+	return data.empty() || file.Read( data.data(), data.size() ) == static_cast<int>( data.size() );
+}
+
+bool FormatCachePath( const std::string& szFileName, char* pszBuffer, const size_t uiBufferSize )
+{
+	const int iResult = snprintf( pszBuffer, uiBufferSize, "%s/%s", AS_BYTECODE_CACHE_DIR, szFileName.c_str() );
+
+	return iResult >= 0 && static_cast<size_t>( iResult ) < uiBufferSize;
+}
+
+uint64_t HashFunction( const asIScriptFunction* pFunction, const uint64_t uiHash )
+{
+	if( !pFunction )
+		return uiHash;
+
+	return CASBytecodeCache::Hash( pFunction->GetDeclaration( true, true, false ), uiHash );
+}
+
+uint64_t HashType( const asITypeInfo& type, uint64_t uiHash )
+{
+	uiHash = CASBytecodeCache::Hash( type.GetName(), uiHash );
+	uiHash = CASBytecodeCache::Hash( type.GetNamespace(), uiHash );
+
+	const asDWORD flags = type.GetFlags();
+
+	uiHash = CASBytecodeCache::Hash( &flags, sizeof( flags ), uiHash );
+
+	for( asUINT uiIndex = 0; uiIndex < type.GetFactoryCount(); ++uiIndex )
+	{
+		uiHash = HashFunction( type.GetFactoryByIndex( uiIndex ), uiHash );
+	}
+
+	for( asUINT uiIndex = 0; uiIndex < type.GetMethodCount(); ++uiIndex )
+	{
+		uiHash = HashFunction( type.GetMethodByIndex( uiIndex ), uiHash );
+	}
+
+	for( asUINT uiIndex = 0; uiIndex < type.GetPropertyCount(); ++uiIndex )
+	{
+		uiHash = CASBytecodeCache::Hash( type.GetPropertyDeclaration( uiIndex, true ), uiHash );
+	}
+
+	for( asUINT uiIndex = 0; uiIndex < type.GetBehaviourCount(); ++uiIndex )
+	{
+		asEBehaviours behaviour;
+
+		uiHash = HashFunction( type.GetBehaviourByIndex( uiIndex, &behaviour ), uiHash );
+		uiHash = CASBytecodeCache::Hash( &behaviour, sizeof( behaviour ), uiHash );
+	}
+
+	return uiHash;
+}
+}
+
+CASBytecodeCache::CASBytecodeCache( std::string&& szFileName )
+	: m_szFileName( std::move( szFileName ) )
+{
+}
+
+uint64_t CASBytecodeCache::Hash( const void* pData, const size_t uiSize, uint64_t uiHash )
+{
+	//64 bit FNV-1a.
+	auto pBytes = reinterpret_cast<const uint8_t*>( pData );
+
+	for( size_t uiIndex = 0; uiIndex < uiSize; ++uiIndex )
+	{
+		uiHash ^= pBytes[ uiIndex ];
+		uiHash *= 1099511628211ULL;
+	}
+
+	return uiHash;
+}
+
+uint64_t CASBytecodeCache::HashEngineAPI( asIScriptEngine& engine )
+{
+	static const asIScriptEngine* pHashedEngine = nullptr;
+	static uint64_t uiAPIHash = 0;
+
+	if( pHashedEngine == &engine )
+		return uiAPIHash;
+
+	uint64_t uiHash = Hash( ANGELSCRIPT_VERSION_STRING );
+
+	const uint32_t uiPointerSize = sizeof( void* );
+
+	uiHash = Hash( &uiPointerSize, sizeof( uiPointerSize ), uiHash );
+
+	for( asUINT uiIndex = 0; uiIndex < engine.GetGlobalFunctionCount(); ++uiIndex )
+	{
+		uiHash = HashFunction( engine.GetGlobalFunctionByIndex( uiIndex ), uiHash );
+	}
+
+	for( asUINT uiIndex = 0; uiIndex < engine.GetGlobalPropertyCount(); ++uiIndex )
+	{
+		const char* pszName;
+		const char* pszNamespace;
+		int iTypeId;
+		bool bIsConst;
+
+		if( engine.GetGlobalPropertyByIndex( uiIndex, &pszName, &pszNamespace, &iTypeId, &bIsConst ) < 0 )
+			continue;
+
+		uiHash = Hash( pszName, uiHash );
+		uiHash = Hash( pszNamespace, uiHash );
+		uiHash = Hash( engine.GetTypeDeclaration( iTypeId, true ), uiHash );
+		uiHash = Hash( &bIsConst, sizeof( bIsConst ), uiHash );
+	}
+
+	for( asUINT uiIndex = 0; uiIndex < engine.GetObjectTypeCount(); ++uiIndex )
+	{
+		uiHash = HashType( *engine.GetObjectTypeByIndex( uiIndex ), uiHash );
+	}
+
+	for( asUINT uiIndex = 0; uiIndex < engine.GetEnumCount(); ++uiIndex )
+	{
+		auto pEnum = engine.GetEnumByIndex( uiIndex );
+
+		uiHash = Hash( pEnum->GetName(), uiHash );
+		uiHash = Hash( pEnum->GetNamespace(), uiHash );
+
+		for( asUINT uiValue = 0; uiValue < pEnum->GetEnumValueCount(); ++uiValue )
+		{
+			int iValue;
+
+			uiHash = Hash( pEnum->GetEnumValueByIndex( uiValue, &iValue ), uiHash );
+			uiHash = Hash( &iValue, sizeof( iValue ), uiHash );
+		}
+	}
+
+	for( asUINT uiIndex = 0; uiIndex < engine.GetFuncdefCount(); ++uiIndex )
+	{
+		uiHash = HashFunction( engine.GetFuncdefByIndex( uiIndex )->GetFuncdefSignature(), uiHash );
+	}
+
+	for( asUINT uiIndex = 0; uiIndex < engine.GetTypedefCount(); ++uiIndex )
+	{
+		auto pTypedef = engine.GetTypedefByIndex( uiIndex );
+
+		uiHash = Hash( pTypedef->GetName(), uiHash );
+		uiHash = Hash( engine.GetTypeDeclaration( pTypedef->GetTypedefTypeId(), true ), uiHash );
+	}
+
+	pHashedEngine = &engine;
+	uiAPIHash = uiHash;
+
+	return uiAPIHash;
+}
+
+bool CASBytecodeCache::HashFile( const char* const pszFileName, uint64_t& uiOutHash )
+{
+	std::vector<uint8_t> data;
+
+	if( !ReadFile( pszFileName, data ) )
+		return false;
+
+	uiOutHash = Hash( data.data(), data.size() );
+
+	return true;
+}
+
+bool CASBytecodeCache::IsUpToDate( const uint64_t uiEnvironmentHash )
+{
+	m_Bytecode.clear();
+
+	char szPath[ MAX_PATH ];
+
+	if( !FormatCachePath( m_szFileName, szPath, sizeof( szPath ) ) )
+		return false;
+
+	std::vector<uint8_t> data;
+
+	if( !ReadFile( szPath, data ) )
+		return false;
+
+	CCacheFileReader reader( data );
+
+	char szMagic[ AS_BYTECODE_CACHE_MAGIC_SIZE ];
+	uint64_t uiFileEnvironmentHash;
+	uint32_t uiSourceCount;
+
+	if( !reader.Read( szMagic, sizeof( szMagic ) ) ||
+		memcmp( szMagic, AS_BYTECODE_CACHE_MAGIC, sizeof( szMagic ) ) != 0 ||
+		!reader.Read( uiFileEnvironmentHash ) ||
+		uiFileEnvironmentHash != uiEnvironmentHash ||
+		!reader.Read( uiSourceCount ) )
+	{
+		return false;
+	}
+
+	std::string szSourceName;
+
+	for( uint32_t uiIndex = 0; uiIndex < uiSourceCount; ++uiIndex )
+	{
+		uint64_t uiCachedHash;
+
+		if( !reader.ReadString( szSourceName ) || !reader.Read( uiCachedHash ) )
+			return false;
+
+		uint64_t uiHash;
+
+		if( !HashFile( szSourceName.c_str(), uiHash ) || uiHash != uiCachedHash )
+			return false;
+	}
+
+	m_Bytecode.assign( data.begin() + reader.GetOffset(), data.end() );
+
+	return !m_Bytecode.empty();
+}
+
+bool CASBytecodeCache::Load( asIScriptModule& module )
+{
+	CASMemoryReadStream stream( m_Bytecode );
+
+	const int iResult = module.LoadByteCode( &stream );
+
+	m_Bytecode.clear();
+	m_Bytecode.shrink_to_fit();
+
+	return iResult >= 0;
+}
+
+bool CASBytecodeCache::Save( asIScriptModule& module, const uint64_t uiEnvironmentHash, const SourceHashes_t& sources )
+{
+	std::vector<uint8_t> data;
+
+	data.insert( data.end(), AS_BYTECODE_CACHE_MAGIC, AS_BYTECODE_CACHE_MAGIC + AS_BYTECODE_CACHE_MAGIC_SIZE );
+
+	WriteValue( data, uiEnvironmentHash );
+	WriteValue( data, static_cast<uint32_t>( sources.size() ) );
+
+	for( const auto& source : sources )
+	{
+		WriteString( data, source.first );
+		WriteValue( data, source.second );
+	}
+
+	CASMemoryWriteStream stream( data );
+
+	if( module.SaveByteCode( &stream ) < 0 )
+		return false;
+
+	char szPath[ MAX_PATH ];
+
+	if( !FormatCachePath( m_szFileName, szPath, sizeof( szPath ) ) )
+		return false;
+
+	g_pFileSystem->CreateDirHierarchy( AS_BYTECODE_CACHE_DIR, nullptr );
+
+	CFile file( szPath, "wb" );
+
+	if( !file.IsOpen() )
+		return false;
+
+	return file.Write( data.data(), data.size() ) == static_cast<int>( data.size() );
+}
+
+void CASBytecodeCache::Remove()
+{
+	char szPath[ MAX_PATH ];
+
+	if( FormatCachePath( m_szFileName, szPath, sizeof( szPath ) ) )
+		g_pFileSystem->RemoveFile( szPath, nullptr );
+}
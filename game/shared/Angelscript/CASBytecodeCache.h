@@ -0,0 +1,97 @@
+#ifndef GAME_SHARED_ANGELSCRIPT_CASBYTECODECACHE_H
+#define GAME_SHARED_ANGELSCRIPT_CASBYTECODECACHE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+class asIScriptEngine;
+class asIScriptModule;
+
+/**
+*	On-disk cache of compiled module bytecode.
+*	A cache file stores a hash of the build environment (API, preprocessor words, internal scripts) and a hash of every script
+*	file that went into the module. The bytecode is only used if all of them still match.
+*/
+class CASBytecodeCache final
+{
+public:
+	/**
+	*	List of script files and the hash of their contents.
+	*/
+	using SourceHashes_t = std::vector<std::pair<std::string, uint64_t>>;
+
+	static const uint64_t HASH_OFFSET_BASIS = 14695981039346656037ULL;
+
+public:
+	/**
+	*	@param szFileName Name of the cache file, relative to the cache directory.
+	*/
+	CASBytecodeCache( std::string&& szFileName );
+	~CASBytecodeCache() = default;
+
+	const std::string& GetFileName() const { return m_szFileName; }
+
+	/**
+	*	Hashes data. Pass the previous result as uiHash to hash multiple pieces of data.
+	*/
+	static uint64_t Hash( const void* pData, const size_t uiSize, uint64_t uiHash = HASH_OFFSET_BASIS );
+
+	static uint64_t Hash( const char* const pszString, const uint64_t uiHash = HASH_OFFSET_BASIS )
+	{
+		//Include the terminator so consecutive strings can't run into each other.
+		return pszString ? Hash( pszString, strlen( pszString ) + 1, uiHash ) : Hash( "", 1, uiHash );
+	}
+
+	static uint64_t Hash( const std::string& szString, const uint64_t uiHash = HASH_OFFSET_BASIS )
+	{
+		return Hash( szString.c_str(), szString.length() + 1, uiHash );
+	}
+
+	/**
+	*	Hashes everything that has been registered with the engine. Computed once per engine.
+	*/
+	static uint64_t HashEngineAPI( asIScriptEngine& engine );
+
+	/**
+	*	Hashes a script file's contents.
+	*	@param pszFileName Filename relative to the game directory.
+	*	@param[ out ] uiOutHash Hash.
+	*	@return Whether the file could be read.
+	*/
+	static bool HashFile( const char* const pszFileName, uint64_t& uiOutHash );
+
+	/**
+	*	Reads the cache file and checks whether it matches the given environment and the current script files.
+	*	On success, the bytecode is kept in memory until Load is called.
+	*/
+	bool IsUpToDate( const uint64_t uiEnvironmentHash );
+
+	/**
+	*	Loads the bytecode read by IsUpToDate into the given module.
+	*/
+	bool Load( asIScriptModule& module );
+
+	/**
+	*	Writes the given module's bytecode to the cache file.
+	*/
+	bool Save( asIScriptModule& module, const uint64_t uiEnvironmentHash, const SourceHashes_t& sources );
+
+	/**
+	*	Removes the cache file.
+	*/
+	void Remove();
+
+private:
+	std::string m_szFileName;
+
+	std::vector<uint8_t> m_Bytecode;
+
+private:
+	CASBytecodeCache( const CASBytecodeCache& ) = delete;
+	CASBytecodeCache& operator=( const CASBytecodeCache& ) = delete;
+};
+
+#endif //GAME_SHARED_ANGELSCRIPT_CASBYTECODECACHE_H
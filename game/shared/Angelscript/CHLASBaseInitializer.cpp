@@ -9,7 +9,6 @@
 #include <Angelscript/add_on/scriptany.h>
 #include <Angelscript/add_on/scriptbuilder.h>
 
-#include <Angelscript/ScriptAPI/CASScheduler.h>
 #include <Angelscript/ScriptAPI/Reflection/ASReflection.h>
 #include <Angelscript/event/CASEventManager.h>
 
@@ -17,6 +16,7 @@
 #include "ScriptAPI/add_on/scriptmathcomplex.h"
 
 #include "ScriptAPI/ASScheduler.h"
+#include "ScriptAPI/CASTimerScheduler.h"
 
 #include "Angelscript/ScriptAPI/ASString.h"
 #include "Angelscript/ScriptAPI/ASMath.h"
@@ -56,7 +56,7 @@ bool CHLASBaseInitializer::RegisterCoreAPI( CASManager& manager )
 	RegisterScriptArray( &engine, true );
 	RegisterScriptDictionary( &engine );
 	RegisterScriptAny( &engine );
-	RegisterScriptScheduler( &engine );
+	RegisterScriptTimerScheduler( engine );
 	RegisterScriptReflection( engine );
 	RegisterScriptMath( &engine );
 	RegisterScriptMathComplex( &engine );
@@ -1,18 +1,19 @@
 #include <angelscript.h>
 
 #include "Angelscript/CASModule.h"
-#include "Angelscript/ScriptAPI/CASScheduler.h"
+
+#include "CASTimerScheduler.h"
 
 #include "ASScheduler.h"
 
-static CASScheduler* Script_get_Scheduler()
+static CASTimerScheduler* Script_get_Scheduler()
 {
 	auto pModule = GetModuleFromScriptContext( asGetActiveContext() );
 
 	if( !pModule )
 		return nullptr;
 
-	return pModule->GetScheduler();
+	return CASModule_GetScheduler( pModule );
 }
 
 void RegisterScriptSchedulerInterface( asIScriptEngine& engine )
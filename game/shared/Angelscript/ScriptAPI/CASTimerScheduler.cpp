@@ -0,0 +1,673 @@
+#include <algorithm>
+
+#include <angelscript.h>
+
+#include <Angelscript/CASModule.h>
+#include <Angelscript/util/ASUtil.h>
+#include <Angelscript/wrapper/ASCallable.h>
+#include <Angelscript/wrapper/CASArguments.h>
+
+#include "extdll.h"
+#include "util.h"
+
+#include "CStopwatch.h"
+
+#include "Angelscript/HLASConstants.h"
+
+#include "CASTimerScheduler.h"
+
+CASTimerScheduler::CScheduledFunction::CScheduledFunction( CASTimerScheduler& scheduler, asIScriptFunction* const pFunction,
+														   const float flNextCallTime, const float flRepeatTime, const int iRepeatCount,
+														   void* const pThis, const int iTypeId, CASArguments* pArguments )
+	: CASRefCountedBaseClass()
+	, m_pScheduler( &scheduler )
+	, m_pFunction( pFunction )
+	, m_flNextCallTime( flNextCallTime )
+	, m_flRepeatTime( flRepeatTime )
+	, m_iRepeatCount( iRepeatCount )
+	, m_pThis( pThis )
+	, m_iTypeId( iTypeId )
+	, m_pArguments( pArguments )
+{
+	pFunction->AddRef();
+}
+
+CASTimerScheduler::CScheduledFunction::~CScheduledFunction()
+{
+	ASSERT( m_bRemoved );
+}
+
+void CASTimerScheduler::CScheduledFunction::SetNextCallTime( const float flNextCallTime )
+{
+	m_flNextCallTime = flNextCallTime;
+
+	if( m_pScheduler )
+		m_pScheduler->Reschedule( this );
+}
+
+void CASTimerScheduler::CScheduledFunction::Remove( asIScriptEngine& engine )
+{
+	if( m_bRemoved )
+		return;
+
+	m_bRemoved = true;
+
+	m_pScheduler = nullptr;
+
+	if( m_pThis )
+	{
+		engine.ReleaseScriptObject( m_pThis, engine.GetTypeInfoById( m_iTypeId ) );
+		m_pThis = nullptr;
+	}
+
+	if( m_pArguments )
+	{
+		m_pArguments->Release();
+		m_pArguments = nullptr;
+	}
+
+	m_pFunction->Release();
+	m_pFunction = nullptr;
+}
+
+CASTimerScheduler::CASTimerScheduler( asIScriptModule& module )
+	: m_Module( module )
+{
+}
+
+CASTimerScheduler::~CASTimerScheduler()
+{
+	ClearTimerList();
+}
+
+void CASTimerScheduler::SetTimeoutHandler( asIScriptGeneric* pArguments )
+{
+	auto pThis = reinterpret_cast<CASTimerScheduler*>( pArguments->GetObject() );
+
+	const std::string& szFunctionName = *reinterpret_cast<const std::string*>( pArguments->GetArgAddress( 0 ) );
+
+	pArguments->SetReturnObject( pThis->SetInterval( szFunctionName, pArguments->GetArgFloat( 1 ), 1, 2, *pArguments ) );
+}
+
+void CASTimerScheduler::SetIntervalHandler( asIScriptGeneric* pArguments )
+{
+	auto pThis = reinterpret_cast<CASTimerScheduler*>( pArguments->GetObject() );
+
+	const std::string& szFunctionName = *reinterpret_cast<const std::string*>( pArguments->GetArgAddress( 0 ) );
+
+	pArguments->SetReturnObject( pThis->SetInterval( szFunctionName, pArguments->GetArgFloat( 1 ), pArguments->GetArgDWord( 2 ), 3, *pArguments ) );
+}
+
+void CASTimerScheduler::SetInterval_NoArgs( asIScriptGeneric* pArguments )
+{
+	auto pThis = reinterpret_cast<CASTimerScheduler*>( pArguments->GetObject() );
+
+	const std::string& szFunctionName = *reinterpret_cast<const std::string*>( pArguments->GetArgAddress( 0 ) );
+
+	pArguments->SetReturnObject( pThis->SetInterval( szFunctionName, pArguments->GetArgFloat( 1 ), REPEAT_INF_TIMES, 2, *pArguments ) );
+}
+
+/**
+*	Gets the object passed as the ?& in this object parameter. Handles are dereferenced.
+*/
+static void* GetThisObjectArgument( asIScriptGeneric& arguments, int& iOutTypeId )
+{
+	void* pThis = arguments.GetArgAddress( 0 );
+	iOutTypeId = arguments.GetArgTypeId( 0 );
+
+	if( iOutTypeId & asTYPEID_OBJHANDLE )
+	{
+		pThis = *reinterpret_cast<void**>( pThis );
+		iOutTypeId &= ~asTYPEID_OBJHANDLE;
+	}
+
+	return pThis;
+}
+
+void CASTimerScheduler::SetTimeoutObj( asIScriptGeneric* pArguments )
+{
+	auto pThis = reinterpret_cast<CASTimerScheduler*>( pArguments->GetObject() );
+
+	int iTypeId;
+	void* pObject = GetThisObjectArgument( *pArguments, iTypeId );
+
+	const std::string& szFunctionName = *reinterpret_cast<const std::string*>( pArguments->GetArgAddress( 1 ) );
+
+	pArguments->SetReturnObject( pThis->SetInterval( pObject, iTypeId, szFunctionName, pArguments->GetArgFloat( 2 ), 1, 3, *pArguments ) );
+}
+
+void CASTimerScheduler::SetIntervalObj( asIScriptGeneric* pArguments )
+{
+	auto pThis = reinterpret_cast<CASTimerScheduler*>( pArguments->GetObject() );
+
+	int iTypeId;
+	void* pObject = GetThisObjectArgument( *pArguments, iTypeId );
+
+	const std::string& szFunctionName = *reinterpret_cast<const std::string*>( pArguments->GetArgAddress( 1 ) );
+
+	pArguments->SetReturnObject( pThis->SetInterval( pObject, iTypeId, szFunctionName, pArguments->GetArgFloat( 2 ), pArguments->GetArgDWord( 3 ), 4, *pArguments ) );
+}
+
+void CASTimerScheduler::SetIntervalObj_NoArgs( asIScriptGeneric* pArguments )
+{
+	auto pThis = reinterpret_cast<CASTimerScheduler*>( pArguments->GetObject() );
+
+	int iTypeId;
+	void* pObject = GetThisObjectArgument( *pArguments, iTypeId );
+
+	const std::string& szFunctionName = *reinterpret_cast<const std::string*>( pArguments->GetArgAddress( 1 ) );
+
+	pArguments->SetReturnObject( pThis->SetInterval( pObject, iTypeId, szFunctionName, pArguments->GetArgFloat( 2 ), REPEAT_INF_TIMES, 3, *pArguments ) );
+}
+
+CASTimerScheduler::CScheduledFunction* CASTimerScheduler::SetInterval( const std::string& szFunctionName, float flRepeatTime, int iRepeatCount, asUINT uiStartIndex, asIScriptGeneric& arguments )
+{
+	return SetInterval( nullptr, 0, szFunctionName, flRepeatTime, iRepeatCount, uiStartIndex, arguments );
+}
+
+CASTimerScheduler::CScheduledFunction* CASTimerScheduler::SetInterval( void* pThis, int iTypeId, const std::string& szFunctionName, float flRepeatTime, int iRepeatCount, asUINT uiStartIndex, asIScriptGeneric& arguments )
+{
+	if( iRepeatCount == 0 || iRepeatCount < REPEAT_INF_TIMES )
+	{
+		Alert( at_console, "Error: CScheduler::SetInterval: can only add function '%s' if repeat count is positive and non-zero, or REPEAT_INFINITE_TIMES!\n", szFunctionName.c_str() );
+		return nullptr;
+	}
+
+	if( flRepeatTime < 0 )
+	{
+		Alert( at_console, "Error: CScheduler::SetInterval: negative repeat time or delay is not allowed!\n" );
+		return nullptr;
+	}
+
+	auto& engine = *arguments.GetEngine();
+
+	asITypeInfo* pType = nullptr;
+
+	if( pThis )
+	{
+		pType = engine.GetTypeInfoById( iTypeId );
+
+		if( !pType )
+		{
+			Alert( at_console, "Error: CScheduler::SetInterval: could not add function '%s', object type for this pointer not found!\n", szFunctionName.c_str() );
+			return nullptr;
+		}
+
+		if( !( pType->GetFlags() & asOBJ_REF ) )
+		{
+			Alert( at_console, "Error: CScheduler::SetInterval: could not add '%s::%s::%s', object type must be a reference!\n",
+				   pType->GetNamespace(), pType->GetName(), szFunctionName.c_str() );
+			return nullptr;
+		}
+	}
+
+	auto pArguments = new CASArguments();
+
+	if( !pArguments->SetArguments( arguments, uiStartIndex ) )
+	{
+		Alert( at_console, "Error: CScheduler::SetInterval: could not add function '%s', failed to parse arguments\n", szFunctionName.c_str() );
+		pArguments->Release();
+		return nullptr;
+	}
+
+	asIScriptFunction* pFunction;
+
+	if( pType )
+		pFunction = as::FindFunction( engine, as::CASMethodIterator( *pType ), szFunctionName, *pArguments );
+	else
+		pFunction = as::FindFunction( engine, as::CASFunctionIterator( m_Module ), szFunctionName, *pArguments );
+
+	if( !pFunction )
+	{
+		Alert( at_console, "Error: CScheduler::SetInterval: could not add function '%s', function not found\n", szFunctionName.c_str() );
+		pArguments->Release();
+		return nullptr;
+	}
+
+	if( pThis )
+		engine.AddRefScriptObject( pThis, pType );
+
+	auto pScheduledFunction = new CScheduledFunction( *this, pFunction, m_flLastTime + flRepeatTime, flRepeatTime, iRepeatCount, pThis, iTypeId, pArguments );
+
+	AddFunction( pScheduledFunction );
+
+	return pScheduledFunction;
+}
+
+void CASTimerScheduler::RemoveTimer( CScheduledFunction* pFunction )
+{
+	if( !pFunction || pFunction->m_pScheduler != this )
+		return;
+
+	//Remove it once the call has finished.
+	if( pFunction == m_pCurrentFunction )
+	{
+		m_bShouldRemove = true;
+		return;
+	}
+
+	if( pFunction->m_uiHeapIndex != INVALID_HEAP_INDEX )
+	{
+		HeapErase( pFunction->m_uiHeapIndex );
+	}
+	else
+	{
+		auto it = std::find( m_PendingList.begin(), m_PendingList.end(), pFunction );
+
+		if( it == m_PendingList.end() )
+			return;
+
+		m_PendingList.erase( it );
+	}
+
+	ReleaseFunction( pFunction );
+}
+
+void CASTimerScheduler::Think( const float flCurrentTime )
+{
+	m_flLastTime = flCurrentTime;
+
+	//Nothing is due; the common case costs a single comparison.
+	if( m_Heap.empty() || m_Heap.front()->m_flNextCallTime > flCurrentTime )
+		return;
+
+	CStopwatch stopwatch;
+
+	m_bThinking = true;
+
+	size_t uiCallCount = 0;
+
+	while( !m_Heap.empty() && m_Heap.front()->m_flNextCallTime <= flCurrentTime )
+	{
+		auto pFunction = HeapPopFront();
+
+		m_pCurrentFunction = pFunction;
+		m_bShouldRemove = false;
+
+		const float flCallTime = pFunction->m_flNextCallTime;
+
+		bool bSuccess;
+
+		if( pFunction->m_pThis )
+		{
+			bSuccess = as::CallArgs( pFunction->m_pThis, pFunction->m_pFunction, *pFunction->m_pArguments );
+		}
+		else
+		{
+			bSuccess = as::CallArgs( pFunction->m_pFunction, *pFunction->m_pArguments );
+		}
+
+		if( !bSuccess )
+		{
+			if( pFunction->m_pThis )
+			{
+				auto pType = pFunction->m_pFunction->GetObjectType();
+
+				Alert( at_console, "Error: CScheduler::Think: execution of method %s::%s::%s failed!\n",
+					   pType->GetNamespace(), pType->GetName(), pFunction->m_pFunction->GetName() );
+			}
+			else
+			{
+				Alert( at_console, "Error: CScheduler::Think: execution of function %s::%s failed!\n",
+					   pFunction->m_pFunction->GetNamespace(), pFunction->m_pFunction->GetName() );
+			}
+		}
+
+		++uiCallCount;
+
+		m_pCurrentFunction = nullptr;
+
+		pFunction->Called();
+
+		if( m_bShouldRemove || pFunction->ShouldRemove() )
+		{
+			ReleaseFunction( pFunction );
+		}
+		else
+		{
+			//Only advance the call time if the function didn't change it itself.
+			if( pFunction->m_flNextCallTime == flCallTime )
+				pFunction->m_flNextCallTime = flCurrentTime + pFunction->m_flRepeatTime;
+
+			//Deferred so functions with a repeat time of 0 are called once per think.
+			m_PendingList.push_back( pFunction );
+		}
+	}
+
+	m_bThinking = false;
+	m_bShouldRemove = false;
+
+	for( auto pFunction : m_PendingList )
+	{
+		HeapPush( pFunction );
+	}
+
+	m_PendingList.clear();
+
+	const auto iElapsed = stopwatch.GetElapsedMicroseconds();
+
+	m_uiLastThinkCallCount = uiCallCount;
+	m_uiTotalCallCount += uiCallCount;
+	m_iTotalThinkTime += iElapsed;
+	m_iWorstThinkTime = std::max( m_iWorstThinkTime, iElapsed );
+}
+
+void CASTimerScheduler::ClearTimerList()
+{
+	if( m_pCurrentFunction )
+		m_bShouldRemove = true;
+
+	//Release in a separate pass: releasing script objects can run script code that accesses the scheduler.
+	decltype( m_Heap ) functions;
+
+	functions.swap( m_Heap );
+	functions.insert( functions.end(), m_PendingList.begin(), m_PendingList.end() );
+	m_PendingList.clear();
+
+	for( auto pFunction : functions )
+	{
+		pFunction->m_uiHeapIndex = INVALID_HEAP_INDEX;
+		ReleaseFunction( pFunction );
+	}
+}
+
+void CASTimerScheduler::AdjustTime( float flTime )
+{
+	for( auto pFunction : m_Heap )
+	{
+		pFunction->m_flNextCallTime -= flTime;
+	}
+
+	for( auto pFunction : m_PendingList )
+	{
+		pFunction->m_flNextCallTime -= flTime;
+	}
+
+	m_flLastTime -= flTime;
+}
+
+void CASTimerScheduler::AddFunction( CScheduledFunction* pFunction )
+{
+	pFunction->m_uiSequence = m_uiNextSequence++;
+
+	if( m_bThinking )
+		m_PendingList.push_back( pFunction );
+	else
+		HeapPush( pFunction );
+
+	m_uiPeakFunctionCount = std::max( m_uiPeakFunctionCount, GetFunctionCount() );
+}
+
+void CASTimerScheduler::Reschedule( CScheduledFunction* pFunction )
+{
+	//Pending functions and the current function are placed when the think completes.
+	if( pFunction->m_uiHeapIndex == INVALID_HEAP_INDEX )
+		return;
+
+	HeapSiftUp( pFunction->m_uiHeapIndex );
+	HeapSiftDown( pFunction->m_uiHeapIndex );
+}
+
+void CASTimerScheduler::ReleaseFunction( CScheduledFunction* pFunction )
+{
+	pFunction->Remove( *m_Module.GetEngine() );
+	pFunction->Release();
+}
+
+bool CASTimerScheduler::IsEarlier( const CScheduledFunction* pLHS, const CScheduledFunction* pRHS )
+{
+	if( pLHS->m_flNextCallTime != pRHS->m_flNextCallTime )
+		return pLHS->m_flNextCallTime < pRHS->m_flNextCallTime;
+
+	//Compare the difference so wraparound of the sequence counter is handled.
+	return static_cast<int>( pLHS->m_uiSequence - pRHS->m_uiSequence ) < 0;
+}
+
+void CASTimerScheduler::HeapPush( CScheduledFunction* pFunction )
+{
+	m_Heap.push_back( pFunction );
+	pFunction->m_uiHeapIndex = m_Heap.size() - 1;
+
+	HeapSiftUp( pFunction->m_uiHeapIndex );
+}
+
+CASTimerScheduler::CScheduledFunction* CASTimerScheduler::HeapPopFront()
+{
+	auto pFunction = m_Heap.front();
+
+	HeapErase( 0 );
+
+	return pFunction;
+}
+
+void CASTimerScheduler::HeapErase( const size_t uiIndex )
+{
+	ASSERT( uiIndex < m_Heap.size() );
+
+	m_Heap[ uiIndex ]->m_uiHeapIndex = INVALID_HEAP_INDEX;
+
+	auto pLast = m_Heap.back();
+
+	m_Heap.pop_back();
+
+	if( uiIndex < m_Heap.size() )
+	{
+		HeapSet( uiIndex, pLast );
+		HeapSiftUp( uiIndex );
+		HeapSiftDown( pLast->m_uiHeapIndex );
+	}
+}
+
+void CASTimerScheduler::HeapSiftUp( size_t uiIndex )
+{
+	auto pFunction = m_Heap[ uiIndex ];
+
+	while( uiIndex > 0 )
+	{
+		const size_t uiParent = ( uiIndex - 1 ) / 2;
+
+		if( !IsEarlier( pFunction, m_Heap[ uiParent ] ) )
+			break;
+
+		HeapSet( uiIndex, m_Heap[ uiParent ] );
+		uiIndex = uiParent;
+	}
+
+	HeapSet( uiIndex, pFunction );
+}
+
+void CASTimerScheduler::HeapSiftDown( size_t uiIndex )
+{
+	auto pFunction = m_Heap[ uiIndex ];
+
+	const size_t uiCount = m_Heap.size();
+
+	while( true )
+	{
+		size_t uiChild = uiIndex * 2 + 1;
+
+		if( uiChild >= uiCount )
+			break;
+
+		if( uiChild + 1 < uiCount && IsEarlier( m_Heap[ uiChild + 1 ], m_Heap[ uiChild ] ) )
+			++uiChild;
+
+		if( !IsEarlier( m_Heap[ uiChild ], pFunction ) )
+			break;
+
+		HeapSet( uiIndex, m_Heap[ uiChild ] );
+		uiIndex = uiChild;
+	}
+
+	HeapSet( uiIndex, pFunction );
+}
+
+void CASTimerScheduler::HeapSet( const size_t uiIndex, CScheduledFunction* pFunction )
+{
+	m_Heap[ uiIndex ] = pFunction;
+	pFunction->m_uiHeapIndex = uiIndex;
+}
+
+CASTimerScheduler* CASModule_GetScheduler( CASModule* pModule )
+{
+	ASSERT( pModule );
+
+	auto pScriptModule = pModule->GetModule();
+
+	auto pScheduler = reinterpret_cast<CASTimerScheduler*>( pScriptModule->GetUserData( CASTIMERSCHEDULER_USER_DATA_ID ) );
+
+	if( !pScheduler )
+	{
+		pScheduler = new CASTimerScheduler( *pScriptModule );
+
+		pScriptModule->SetUserData( pScheduler, CASTIMERSCHEDULER_USER_DATA_ID );
+	}
+
+	return pScheduler;
+}
+
+CASTimerScheduler* CASModule_FindScheduler( CASModule* pModule )
+{
+	ASSERT( pModule );
+
+	return reinterpret_cast<CASTimerScheduler*>( pModule->GetModule()->GetUserData( CASTIMERSCHEDULER_USER_DATA_ID ) );
+}
+
+void CASModule_ClearScheduler( CASModule* pModule )
+{
+	if( auto pScheduler = CASModule_FindScheduler( pModule ) )
+	{
+		pScheduler->ClearTimerList();
+	}
+}
+
+/**
+*	Frees a module's scheduler when the script module is destroyed.
+*/
+static void CleanupModuleScheduler( asIScriptModule* pModule )
+{
+	delete reinterpret_cast<CASTimerScheduler*>( pModule->GetUserData( CASTIMERSCHEDULER_USER_DATA_ID ) );
+}
+
+static CASTimerScheduler::CScheduledFunction* CScheduler_GetCurrentFunction( const CASTimerScheduler* pThis )
+{
+	auto pFunction = pThis->GetCurrentFunction();
+
+	//The handle is returned to the script.
+	if( pFunction )
+		pFunction->AddRef();
+
+	return pFunction;
+}
+
+static void CScheduler_RemoveTimer( CASTimerScheduler* pThis, CASTimerScheduler::CScheduledFunction* pFunction )
+{
+	pThis->RemoveTimer( pFunction );
+
+	//The handle was passed to us.
+	if( pFunction )
+		pFunction->Release();
+}
+
+static int CScheduler_GetRepeatInfiniteTimes( const CASTimerScheduler* )
+{
+	return CASTimerScheduler::REPEAT_INF_TIMES;
+}
+
+static void RegisterScriptScheduledFunction( asIScriptEngine& engine )
+{
+	using Function_t = CASTimerScheduler::CScheduledFunction;
+
+	const char* const pszObjectName = "CScheduledFunction";
+
+	engine.RegisterObjectType( pszObjectName, 0, asOBJ_REF );
+
+	as::RegisterRefCountedBaseClass<Function_t>( &engine, pszObjectName );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "float GetNextCallTime() const",
+		asMETHOD( Function_t, GetNextCallTime ), asCALL_THISCALL );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "void SetNextCallTime(const float flNextCallTime)",
+		asMETHOD( Function_t, SetNextCallTime ), asCALL_THISCALL );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "float GetRepeatTime() const",
+		asMETHOD( Function_t, GetRepeatTime ), asCALL_THISCALL );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "void SetRepeatTime(const float flRepeatTime)",
+		asMETHOD( Function_t, SetRepeatTime ), asCALL_THISCALL );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "int GetRepeatCount() const",
+		asMETHOD( Function_t, GetRepeatCount ), asCALL_THISCALL );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "bool IsInfiniteRepeat() const",
+		asMETHOD( Function_t, IsInfiniteRepeat ), asCALL_THISCALL );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "void SetRepeatCount(const int iRepeatCount)",
+		asMETHOD( Function_t, SetRepeatCount ), asCALL_THISCALL );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "void MakeInfiniteRepeat()",
+		asMETHOD( Function_t, MakeInfiniteRepeat ), asCALL_THISCALL );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "bool HasBeenRemoved() const",
+		asMETHOD( Function_t, HasBeenRemoved ), asCALL_THISCALL );
+}
+
+void RegisterScriptTimerScheduler( asIScriptEngine& engine )
+{
+	engine.SetModuleUserDataCleanupCallback( &::CleanupModuleScheduler, CASTIMERSCHEDULER_USER_DATA_ID );
+
+	RegisterScriptScheduledFunction( engine );
+
+	const char* const pszObjectName = "CScheduler";
+
+	engine.RegisterObjectType( pszObjectName, 0, asOBJ_REF | asOBJ_NOCOUNT );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "int get_REPEAT_INFINITE_TIMES() const",
+		asFUNCTION( CScheduler_GetRepeatInfiniteTimes ), asCALL_CDECL_OBJFIRST );
+
+	as::RegisterVarArgsMethod(
+		engine, pszObjectName, "CScheduledFunction@", "SetTimeout", "const string& in szFunction, float flDelay",
+		0, AS_MAX_VARARGS, asFUNCTION( CASTimerScheduler::SetTimeoutHandler ) );
+
+	as::RegisterVarArgsMethod(
+		engine, pszObjectName, "CScheduledFunction@", "SetTimeout", "?& in thisObject, const string& in szFunction, float flDelay",
+		0, AS_MAX_VARARGS, asFUNCTION( CASTimerScheduler::SetTimeoutObj ) );
+
+	as::RegisterVarArgsMethod(
+		engine, pszObjectName, "CScheduledFunction@", "SetInterval", "const string& in szFunction, float flRepeatTime, int iRepeatCount",
+		0, AS_MAX_VARARGS, asFUNCTION( CASTimerScheduler::SetIntervalHandler ) );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "CScheduledFunction@ SetInterval(const string& in szFunction, float flRepeatTime)",
+		asFUNCTION( CASTimerScheduler::SetInterval_NoArgs ), asCALL_GENERIC );
+
+	as::RegisterVarArgsMethod(
+		engine, pszObjectName, "CScheduledFunction@", "SetInterval", "?& in thisObject, const string& in szFunction, float flRepeatTime, int iRepeatCount",
+		0, AS_MAX_VARARGS, asFUNCTION( CASTimerScheduler::SetIntervalObj ) );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "CScheduledFunction@ SetInterval(?& in thisObject, const string& in szFunction, float flRepeatTime)",
+		asFUNCTION( CASTimerScheduler::SetIntervalObj_NoArgs ), asCALL_GENERIC );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "void RemoveTimer(CScheduledFunction@ pFunction)",
+		asFUNCTION( CScheduler_RemoveTimer ), asCALL_CDECL_OBJFIRST );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "CScheduledFunction@ GetCurrentFunction() const",
+		asFUNCTION( CScheduler_GetCurrentFunction ), asCALL_CDECL_OBJFIRST );
+
+	engine.RegisterObjectMethod(
+		pszObjectName, "void ClearTimerList()",
+		asMETHOD( CASTimerScheduler, ClearTimerList ), asCALL_THISCALL );
+}
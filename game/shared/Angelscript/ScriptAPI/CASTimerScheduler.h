@@ -0,0 +1,421 @@
+#ifndef GAME_SHARED_ANGELSCRIPT_SCRIPTAPI_CASTIMERSCHEDULER_H
+#define GAME_SHARED_ANGELSCRIPT_SCRIPTAPI_CASTIMERSCHEDULER_H
+
+#include <cassert>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <angelscript.h>
+
+#include <Angelscript/util/CASBaseClass.h>
+
+class CASArguments;
+class CASModule;
+
+/**
+*	Script module user data id used to attach a scheduler to a module.
+*/
+#define CASTIMERSCHEDULER_USER_DATA_ID 10002
+
+/**
+*	Schedules functions for execution at a set time.
+*	Replaces the linked list based CASScheduler: pending functions are kept in a binary min-heap keyed on their next call time,
+*	so a think only touches functions that are due, and removal is O(log n).
+*/
+class CASTimerScheduler final
+{
+public:
+	static const int REPEAT_INF_TIMES = -1;
+
+	static const size_t INVALID_HEAP_INDEX = std::numeric_limits<size_t>::max();
+
+public:
+
+	/**
+	*	Represents a scheduled function. Scripts can access this and modify the settings.
+	*/
+	class CScheduledFunction final : public CASRefCountedBaseClass
+	{
+	public:
+		friend class CASTimerScheduler;
+
+		/**
+		*	Constructor.
+		*	@param scheduler Scheduler that owns this function.
+		*	@param pFunction Function.
+		*	@param flNextCallTime Time when the function should be called.
+		*	@param flRepeatTime Time between calls.
+		*	@param iRepeatCount Number of times to call the function, or infinite if REPEAT_INF_TIMES is given.
+		*	@param pThis This pointer. Can be null.
+		*	@param iTypeId This pointer type id.
+		*	@param pArguments Function arguments.
+		*/
+		CScheduledFunction( CASTimerScheduler& scheduler, asIScriptFunction* const pFunction,
+							const float flNextCallTime, const float flRepeatTime, const int iRepeatCount,
+							void* const pThis, const int iTypeId, CASArguments* pArguments );
+
+		void Release() const
+		{
+			if( InternalRelease() )
+				delete this;
+		}
+
+		/**
+		*	@return The function to call.
+		*/
+		asIScriptFunction* GetFunction() const { return m_pFunction; }
+
+		/**
+		*	@return Next call time.
+		*/
+		float GetNextCallTime() const { return m_flNextCallTime; }
+
+		/**
+		*	Sets the next call time. Moves the function to its new position in the owning scheduler.
+		*	@param flNextCallTime Next call time.
+		*/
+		void SetNextCallTime( const float flNextCallTime );
+
+		/**
+		*	@return The time between calls.
+		*/
+		float GetRepeatTime() const { return m_flRepeatTime; }
+
+		/**
+		*	Sets the time between calls.
+		*	@param flRepeatTime Time between calls.
+		*/
+		void SetRepeatTime( const float flRepeatTime )
+		{
+			if( flRepeatTime < 0 )
+				return;
+
+			m_flRepeatTime = flRepeatTime;
+		}
+
+		/**
+		*	@return The number of times to call the function.
+		*/
+		int GetRepeatCount() const { return m_iRepeatCount; }
+
+		/**
+		*	@return Whether this function should be called an infinite number of times.
+		*/
+		bool IsInfiniteRepeat() const { return m_iRepeatCount == REPEAT_INF_TIMES; }
+
+		/**
+		*	Sets the number of times to call the function, or an infinite number of times if REPEAT_INF_TIMES is given.
+		*	@param iRepeatCount Number of times to call the function.
+		*/
+		void SetRepeatCount( const int iRepeatCount )
+		{
+			//Allow 0, will cause immediate removal after call completes, or next call
+			if( iRepeatCount < REPEAT_INF_TIMES )
+				return;
+
+			m_iRepeatCount = iRepeatCount;
+		}
+
+		/**
+		*	Makes the function be called an infinite number of times.
+		*/
+		void MakeInfiniteRepeat()
+		{
+			m_iRepeatCount = REPEAT_INF_TIMES;
+		}
+
+		/**
+		*	Internal method used to notify this object that it's been called.
+		*/
+		void Called()
+		{
+			if( !IsInfiniteRepeat() )
+			{
+				assert( m_iRepeatCount > 0 );
+
+				--m_iRepeatCount;
+			}
+		}
+
+		/**
+		*	@return Whether this object should be removed.
+		*/
+		bool ShouldRemove() const
+		{
+			return !IsInfiniteRepeat() && ( GetRepeatCount() <= 0 );
+		}
+
+		/**
+		*	@return Whether this object has been removed.
+		*/
+		bool HasBeenRemoved() const { return m_bRemoved; }
+
+		/**
+		*	Removes all references to script data and code.
+		*	@param engine Script engine.
+		*/
+		void Remove( asIScriptEngine& engine );
+
+		/**
+		*	@return The this pointer.
+		*/
+		void* GetThis() const { return m_pThis; }
+
+		/**
+		*	@return The this pointer type id.
+		*/
+		int GetTypeId() const { return m_iTypeId; }
+
+		/**
+		*	@return The list of arguments.
+		*/
+		CASArguments* GetArguments() const { return m_pArguments; }
+
+	private:
+		/**
+		*	Destructor. Should never be called directly.
+		*/
+		~CScheduledFunction();
+
+	private:
+		CASTimerScheduler*	m_pScheduler;
+
+		asIScriptFunction*	m_pFunction;
+		float				m_flNextCallTime;
+		float				m_flRepeatTime;
+		int					m_iRepeatCount;
+
+		void*				m_pThis;
+		const int			m_iTypeId;
+
+		CASArguments*		m_pArguments;
+
+		/**
+		*	Position in the scheduler's heap, or INVALID_HEAP_INDEX if not in the heap.
+		*/
+		size_t				m_uiHeapIndex = INVALID_HEAP_INDEX;
+
+		/**
+		*	Insertion order, used to call functions with equal call times in the order they were scheduled.
+		*/
+		unsigned int		m_uiSequence = 0;
+
+		bool				m_bRemoved = false;
+
+	private:
+		CScheduledFunction( const CScheduledFunction& ) = delete;
+		CScheduledFunction& operator=( const CScheduledFunction& ) = delete;
+	};
+
+public:
+	/**
+	*	Constructor.
+	*	@param module The script module that owns this scheduler. Functions are looked up in this module.
+	*/
+	CASTimerScheduler( asIScriptModule& module );
+
+	/**
+	*	Destructor.
+	*/
+	~CASTimerScheduler();
+
+	/**
+	*	@return Whether the scheduler is currently thinking (calling functions).
+	*/
+	bool IsThinking() const { return m_bThinking; }
+
+	static void SetTimeoutHandler( asIScriptGeneric* pArguments );
+
+	static void SetIntervalHandler( asIScriptGeneric* pArguments );
+
+	static void SetInterval_NoArgs( asIScriptGeneric* pArguments );
+
+	static void SetTimeoutObj( asIScriptGeneric* pArguments );
+
+	static void SetIntervalObj( asIScriptGeneric* pArguments );
+
+	static void SetIntervalObj_NoArgs( asIScriptGeneric* pArguments );
+
+	/**
+	*	Sets an interval (call function every N seconds).
+	*	@param szFunctionName Name of the function to call.
+	*	@param flRepeatTime Time between calls.
+	*	@param iRepeatCount Number of times to call the function.
+	*	@param uiStartIndex First argument to get for the function call.
+	*	@param arguments Generic call instance to get function call arguments from.
+	*	@return The scheduled function, or null if the function could not be scheduled.
+	*/
+	CScheduledFunction* SetInterval( const std::string& szFunctionName, float flRepeatTime, int iRepeatCount, asUINT uiStartIndex, asIScriptGeneric& arguments );
+
+	/**
+	*	Sets an interval (call object method or function every N seconds).
+	*	@param pThis This pointer. Can be null, in which case it looks for global functions.
+	*	@param iTypeId This pointer type id.
+	*	@param szFunctionName Name of the function to call.
+	*	@param flRepeatTime Time between calls.
+	*	@param iRepeatCount Number of times to call the function.
+	*	@param uiStartIndex First argument to get for the function call.
+	*	@param arguments Generic call instance to get function call arguments from.
+	*	@return The scheduled function, or null if the function could not be scheduled.
+	*/
+	CScheduledFunction* SetInterval( void* pThis, int iTypeId, const std::string& szFunctionName, float flRepeatTime, int iRepeatCount, asUINT uiStartIndex, asIScriptGeneric& arguments );
+
+	/**
+	*	Removes a scheduled function.
+	*	@param pFunction Function to remove.
+	*/
+	void RemoveTimer( CScheduledFunction* pFunction );
+
+	/**
+	*	@return The function that is currently being executed, if any.
+	*/
+	CScheduledFunction* GetCurrentFunction() const { return m_pCurrentFunction; }
+
+	/**
+	*	Calls all functions whose next call time is smaller than or equal to flCurrentTime.
+	*	Each function is called at most once per think.
+	*	@param flCurrentTime Current time.
+	*/
+	void Think( const float flCurrentTime );
+
+	/**
+	*	Removes all scheduled functions.
+	*/
+	void ClearTimerList();
+
+	/**
+	*	Adjusts the next call time for all functions to be called at prevTime - flTime.
+	*	A uniform shift preserves the heap order, so this never reorders anything.
+	*	@param flTime Delta time between the previous current time and the next current time.
+	*/
+	void AdjustTime( float flTime );
+
+	/**
+	*	@return Number of functions waiting to be called.
+	*/
+	size_t GetFunctionCount() const { return m_Heap.size() + m_PendingList.size(); }
+
+	/**
+	*	@return Largest number of functions that were scheduled at the same time.
+	*/
+	size_t GetPeakFunctionCount() const { return m_uiPeakFunctionCount; }
+
+	/**
+	*	@return Number of function calls made during the last think that called anything.
+	*/
+	size_t GetLastThinkCallCount() const { return m_uiLastThinkCallCount; }
+
+	/**
+	*	@return Total number of function calls made by this scheduler.
+	*/
+	unsigned long long GetTotalCallCount() const { return m_uiTotalCallCount; }
+
+	/**
+	*	@return Total time spent calling functions, in microseconds.
+	*/
+	long long GetTotalThinkTime() const { return m_iTotalThinkTime; }
+
+	/**
+	*	@return Longest time spent calling functions in a single think, in microseconds.
+	*/
+	long long GetWorstThinkTime() const { return m_iWorstThinkTime; }
+
+private:
+	/**
+	*	Adds a function to the scheduler. If the scheduler is thinking, the function is added after the think completes.
+	*/
+	void AddFunction( CScheduledFunction* pFunction );
+
+	/**
+	*	Called when a function's next call time has been changed.
+	*/
+	void Reschedule( CScheduledFunction* pFunction );
+
+	/**
+	*	Releases a function that is no longer in the heap or pending list.
+	*/
+	void ReleaseFunction( CScheduledFunction* pFunction );
+
+	static bool IsEarlier( const CScheduledFunction* pLHS, const CScheduledFunction* pRHS );
+
+	void HeapPush( CScheduledFunction* pFunction );
+
+	CScheduledFunction* HeapPopFront();
+
+	void HeapErase( const size_t uiIndex );
+
+	void HeapSiftUp( size_t uiIndex );
+
+	void HeapSiftDown( size_t uiIndex );
+
+	void HeapSet( const size_t uiIndex, CScheduledFunction* pFunction );
+
+private:
+	asIScriptModule& m_Module;
+
+	float m_flLastTime = 0.0f;
+
+	/**
+	*	Binary min-heap of functions ordered by next call time, then by insertion order.
+	*/
+	std::vector<CScheduledFunction*> m_Heap;
+
+	/*
+	*	Used to store functions scheduled or rescheduled while the scheduler is thinking. Is merged with the heap at the end of Think.
+	*/
+	std::vector<CScheduledFunction*> m_PendingList;
+
+	/*
+	*	The current function being executed, if any.
+	*/
+	CScheduledFunction* m_pCurrentFunction = nullptr;
+
+	unsigned int m_uiNextSequence = 0;
+
+	bool m_bThinking = false;
+
+	/*
+	*	Used to determine if the current function should be removed.
+	*/
+	bool m_bShouldRemove = false;
+
+	size_t m_uiPeakFunctionCount = 0;
+	size_t m_uiLastThinkCallCount = 0;
+	unsigned long long m_uiTotalCallCount = 0;
+	long long m_iTotalThinkTime = 0;
+	long long m_iWorstThinkTime = 0;
+
+private:
+	CASTimerScheduler( const CASTimerScheduler& ) = delete;
+	CASTimerScheduler& operator=( const CASTimerScheduler& ) = delete;
+};
+
+/**
+*	Gets the scheduler for the given module, creating it if it does not exist yet.
+*	@param pModule Module whose scheduler should be returned.
+*	@return The scheduler.
+*/
+CASTimerScheduler* CASModule_GetScheduler( CASModule* pModule );
+
+/**
+*	Gets the scheduler for the given module if it has one.
+*	@param pModule Module whose scheduler should be returned.
+*	@return The scheduler, or null if none has been created.
+*/
+CASTimerScheduler* CASModule_FindScheduler( CASModule* pModule );
+
+/**
+*	Removes all scheduled functions from the given module's scheduler.
+*	Must be called before a module is removed, otherwise the references held by the scheduler keep the module alive.
+*	@param pModule Module whose scheduler should be cleared.
+*/
+void CASModule_ClearScheduler( CASModule* pModule );
+
+/**
+*	Registers the CScheduler and CScheduledFunction types.
+*	@param engine Script engine.
+*/
+void RegisterScriptTimerScheduler( asIScriptEngine& engine );
+
+#endif //GAME_SHARED_ANGELSCRIPT_SCRIPTAPI_CASTIMERSCHEDULER_H
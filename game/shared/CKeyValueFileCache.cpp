@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <utility>
+
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMNodeList.hpp>
+
+#include "extdll.h"
+#include "util.h"
+
+#include "CFile.h"
+
+#include "CKeyValueFileCache.h"
+
+#include "xml/CStrX.h"
+#include "xml/CXMLManager.h"
+#include "xml/XMLUtils.h"
+#include "xml/CXStr.h"
+
+//Change the version number whenever the file format changes.
+#define KV_FILE_CACHE_MAGIC "HLKVFC01"
+#define KV_FILE_CACHE_MAGIC_SIZE 8
+
+CKeyValueFileCache g_KeyValueFileCache;
+
+const char* const CKeyValueFileCache::CACHE_DIR = "cache";
+const char* const CKeyValueFileCache::CACHE_FILENAME = "cache/xml_keyvalues.bin";
+
+namespace
+{
+#pragma pack( push, 1 )
+struct CacheHeader final
+{
+	char szMagic[ KV_FILE_CACHE_MAGIC_SIZE ];
+
+	//Hash of everything that follows the header.
+	uint64_t uiContentHash;
+
+	uint32_t uiEntryCount;
+	uint32_t uiKeyValueCount;
+	uint32_t uiStringTableSize;
+};
+
+struct CacheEntry final
+{
+	uint32_t uiFileName;
+	uint32_t uiRootElement;
+	uint32_t uiFirstKeyValue;
+	uint32_t uiKeyValueCount;
+	int64_t iFileTime;
+	uint64_t uiSourceHash;
+};
+
+struct CacheKeyValue final
+{
+	uint32_t uiKey;
+	uint32_t uiValue;
+};
+#pragma pack( pop )
+
+/**
+*	Appends a string to a string table.
+*	@return Offset of the string.
+*/
+uint32_t AddString( std::vector<char>& table, const char* const pszString )
+{
+	const uint32_t uiOffset = static_cast<uint32_t>( table.size() );
+
+	table.insert( table.end(), pszString, pszString + strlen( pszString ) + 1 );
+
+	return uiOffset;
+}
+
+template<typename T>
+void WriteValues( std::vector<uint8_t>& data, const T* pValues, const size_t uiCount )
+{
+	auto pBytes = reinterpret_cast<const uint8_t*>( pValues );
+
+	data.insert( data.end(), pBytes, pBytes + sizeof( T ) * uiCount );
+}
+}
+
+uint64_t CKeyValueFileCache::Hash( const void* pData, const size_t uiSize, uint64_t uiHash )
+{
+	//64 bit FNV-1a.
+	auto pBytes = reinterpret_cast<const uint8_t*>( pData );
+
+	for( size_t uiIndex = 0; uiIndex < uiSize; ++uiIndex )
+	{
+		uiHash ^= pBytes[ uiIndex ];
+		uiHash *= 1099511628211ULL;
+	}
+
+	return uiHash;
+}
+
+const CKeyValueFileCache::KeyValues_t* CKeyValueFileCache::LoadFile( const char* const pszFileName, const char* const pszRootElement )
+{
+	ASSERT( pszFileName );
+	ASSERT( pszRootElement );
+
+	LoadCacheFile();
+
+	auto it = m_Entries.find( pszFileName );
+
+	if( it != m_Entries.end() && it->second.szRootElement == pszRootElement )
+	{
+		auto& entry = it->second;
+
+		const long iFileTime = g_pFileSystem->GetFileTime( pszFileName );
+
+		if( iFileTime == entry.iFileTime )
+		{
+			++m_uiHits;
+			return &entry.keyValues;
+		}
+
+		//The file was touched, but might not have changed.
+		CFile file( pszFileName, "rb" );
+
+		if( file.IsOpen() )
+		{
+			std::vector<uint8_t> data( file.Size() );
+
+			if( data.empty() || file.Read( data.data(), data.size() ) == static_cast<int>( data.size() ) )
+			{
+				if( Hash( data.data(), data.size() ) == entry.uiSourceHash )
+				{
+					entry.iFileTime = iFileTime;
+					m_bDirty = true;
+
+					++m_uiHits;
+					return &entry.keyValues;
+				}
+			}
+		}
+	}
+
+	++m_uiMisses;
+
+	return ParseFile( pszFileName, pszRootElement );
+}
+
+bool CKeyValueFileCache::Save()
+{
+	if( !m_bDirty )
+		return true;
+
+	m_bDirty = false;
+
+	//Sort by name so the same set of files always produces the same cache file.
+	std::vector<const Entries_t::value_type*> entries;
+
+	entries.reserve( m_Entries.size() );
+
+	for( const auto& entry : m_Entries )
+	{
+		entries.push_back( &entry );
+	}
+
+	std::sort( entries.begin(), entries.end(), []( const Entries_t::value_type* pLHS, const Entries_t::value_type* pRHS )
+		{
+			return stricmp( pLHS->first.c_str(), pRHS->first.c_str() ) < 0;
+		}
+	);
+
+	std::vector<CacheEntry> cacheEntries;
+	std::vector<CacheKeyValue> cacheKeyValues;
+	std::vector<char> strings;
+
+	cacheEntries.reserve( entries.size() );
+
+	for( auto pEntry : entries )
+	{
+		const auto& entry = pEntry->second;
+
+		CacheEntry cacheEntry;
+
+		cacheEntry.uiFileName = AddString( strings, pEntry->first.c_str() );
+		cacheEntry.uiRootElement = AddString( strings, entry.szRootElement.c_str() );
+		cacheEntry.uiFirstKeyValue = static_cast<uint32_t>( cacheKeyValues.size() );
+		cacheEntry.uiKeyValueCount = static_cast<uint32_t>( entry.keyValues.size() );
+		cacheEntry.iFileTime = entry.iFileTime;
+		cacheEntry.uiSourceHash = entry.uiSourceHash;
+
+		cacheEntries.push_back( cacheEntry );
+
+		for( const auto& keyValue : entry.keyValues )
+		{
+			CacheKeyValue cacheKeyValue;
+
+			cacheKeyValue.uiKey = AddString( strings, keyValue.pszKey );
+			cacheKeyValue.uiValue = AddString( strings, keyValue.pszValue );
+
+			cacheKeyValues.push_back( cacheKeyValue );
+		}
+	}
+
+	CacheHeader header;
+
+	memcpy( header.szMagic, KV_FILE_CACHE_MAGIC, sizeof( header.szMagic ) );
+	header.uiContentHash = 0;
+	header.uiEntryCount = static_cast<uint32_t>( cacheEntries.size() );
+	header.uiKeyValueCount = static_cast<uint32_t>( cacheKeyValues.size() );
+	header.uiStringTableSize = static_cast<uint32_t>( strings.size() );
+
+	std::vector<uint8_t> data;
+
+	data.reserve( sizeof( header ) + cacheEntries.size() * sizeof( CacheEntry ) + cacheKeyValues.size() * sizeof( CacheKeyValue ) + strings.size() );
+
+	WriteValues( data, &header, 1 );
+	WriteValues( data, cacheEntries.data(), cacheEntries.size() );
+	WriteValues( data, cacheKeyValues.data(), cacheKeyValues.size() );
+	WriteValues( data, strings.data(), strings.size() );
+
+	header.uiContentHash = Hash( data.data() + sizeof( header ), data.size() - sizeof( header ) );
+
+	memcpy( data.data(), &header, sizeof( header ) );
+
+	g_pFileSystem->CreateDirHierarchy( CACHE_DIR, nullptr );
+
+	CFile file( CACHE_FILENAME, "wb" );
+
+	if( !file.IsOpen() || file.Write( data.data(), data.size() ) != static_cast<int>( data.size() ) )
+	{
+		Alert( at_warning, "CKeyValueFileCache::Save: Couldn't write \"%s\"\n", CACHE_FILENAME );
+		return false;
+	}
+
+	Alert( at_aiconsole, "CKeyValueFileCache::Save: Wrote %u files (%u loaded from cache, %u parsed)\n",
+		   static_cast<unsigned int>( cacheEntries.size() ), m_uiHits, m_uiMisses );
+
+	return true;
+}
+
+void CKeyValueFileCache::Clear()
+{
+	m_Entries.clear();
+	m_CacheData.clear();
+	m_CacheData.shrink_to_fit();
+
+	m_bCacheFileLoaded = false;
+	m_bDirty = false;
+
+	m_uiHits = 0;
+	m_uiMisses = 0;
+}
+
+void CKeyValueFileCache::LoadCacheFile()
+{
+	if( m_bCacheFileLoaded )
+		return;
+
+	m_bCacheFileLoaded = true;
+
+	CFile file( CACHE_FILENAME, "rb" );
+
+	if( !file.IsOpen() )
+		return;
+
+	m_CacheData.resize( file.Size() );
+
+	if( m_CacheData.size() < sizeof( CacheHeader ) ||
+		file.Read( m_CacheData.data(), m_CacheData.size() ) != static_cast<int>( m_CacheData.size() ) )
+	{
+		m_CacheData.clear();
+		return;
+	}
+
+	CacheHeader header;
+
+	memcpy( &header, m_CacheData.data(), sizeof( header ) );
+
+	const uint64_t uiExpectedSize =
+		sizeof( CacheHeader ) +
+		static_cast<uint64_t>( header.uiEntryCount ) * sizeof( CacheEntry ) +
+		static_cast<uint64_t>( header.uiKeyValueCount ) * sizeof( CacheKeyValue ) +
+		header.uiStringTableSize;
+
+	//Another server instance could be writing the file, so validate everything.
+	if( memcmp( header.szMagic, KV_FILE_CACHE_MAGIC, sizeof( header.szMagic ) ) != 0 ||
+		uiExpectedSize != m_CacheData.size() ||
+		header.uiContentHash != Hash( m_CacheData.data() + sizeof( header ), m_CacheData.size() - sizeof( header ) ) ||
+		( header.uiStringTableSize > 0 && m_CacheData.back() != '\0' ) )
+	{
+		Alert( at_aiconsole, "CKeyValueFileCache::LoadCacheFile: \"%s\" is out of date or damaged, ignoring\n", CACHE_FILENAME );
+		m_CacheData.clear();
+		return;
+	}
+
+	auto pCacheEntries = reinterpret_cast<const CacheEntry*>( m_CacheData.data() + sizeof( CacheHeader ) );
+	auto pCacheKeyValues = reinterpret_cast<const CacheKeyValue*>( pCacheEntries + header.uiEntryCount );
+	auto pszStrings = reinterpret_cast<const char*>( pCacheKeyValues + header.uiKeyValueCount );
+
+	const uint32_t uiStringTableSize = header.uiStringTableSize;
+
+	for( uint32_t uiIndex = 0; uiIndex < header.uiEntryCount; ++uiIndex )
+	{
+		CacheEntry cacheEntry;
+
+		memcpy( &cacheEntry, pCacheEntries + uiIndex, sizeof( cacheEntry ) );
+
+		if( cacheEntry.uiFileName >= uiStringTableSize ||
+			cacheEntry.uiRootElement >= uiStringTableSize ||
+			cacheEntry.uiFirstKeyValue > header.uiKeyValueCount ||
+			cacheEntry.uiKeyValueCount > header.uiKeyValueCount - cacheEntry.uiFirstKeyValue )
+		{
+			continue;
+		}
+
+		Entry entry;
+
+		entry.szRootElement = pszStrings + cacheEntry.uiRootElement;
+		entry.iFileTime = static_cast<long>( cacheEntry.iFileTime );
+		entry.uiSourceHash = cacheEntry.uiSourceHash;
+
+		entry.keyValues.reserve( cacheEntry.uiKeyValueCount );
+
+		bool bValid = true;
+
+		for( uint32_t uiKeyValue = 0; uiKeyValue < cacheEntry.uiKeyValueCount; ++uiKeyValue )
+		{
+			CacheKeyValue cacheKeyValue;
+
+			memcpy( &cacheKeyValue, pCacheKeyValues + cacheEntry.uiFirstKeyValue + uiKeyValue, sizeof( cacheKeyValue ) );
+
+			if( cacheKeyValue.uiKey >= uiStringTableSize || cacheKeyValue.uiValue >= uiStringTableSize )
+			{
+				bValid = false;
+				break;
+			}
+
+			entry.keyValues.push_back( { pszStrings + cacheKeyValue.uiKey, pszStrings + cacheKeyValue.uiValue } );
+		}
+
+		if( bValid )
+			m_Entries[ pszStrings + cacheEntry.uiFileName ] = std::move( entry );
+	}
+}
+
+const CKeyValueFileCache::KeyValues_t* CKeyValueFileCache::ParseFile( const char* const pszFileName, const char* const pszRootElement )
+{
+	//Remove any out of date copy first so a missing or broken file isn't served from the cache.
+	if( m_Entries.erase( pszFileName ) )
+		m_bDirty = true;
+
+	CFile file( pszFileName, "rb" );
+
+	if( !file.IsOpen() )
+		return nullptr;
+
+	std::vector<uint8_t> data( file.Size() );
+
+	if( !data.empty() && file.Read( data.data(), data.size() ) != static_cast<int>( data.size() ) )
+		return nullptr;
+
+	auto document = xml::XMLManager().ParseFile( pszFileName, file.GetFileHandle() );
+
+	if( !document )
+		return nullptr;
+
+	auto pRoot = document->getDocumentElement();
+
+	if( !pRoot || xercesc::XMLString::compareString( pRoot->getNodeName(), xml::AsciiToXMLCh( pszRootElement ).data() ) != 0 )
+	{
+		Alert( at_console, "CKeyValueFileCache::ParseFile: File \"%s\": No %s data found, ignoring\n", pszFileName, pszRootElement );
+		return nullptr;
+	}
+
+	std::vector<std::pair<std::string, std::string>> keyValues;
+
+	size_t uiStringsSize = 0;
+
+	if( auto pKeyvalues = xml::GetElementsByTagName( *pRoot, "keyvalue" ) )
+	{
+		const auto count = pKeyvalues->getLength();
+
+		std::string szKey, szValue;
+
+		for( decltype( pKeyvalues->getLength() ) index = 0; index < count; ++index )
+		{
+			const auto pKeyvalue = pKeyvalues->item( index );
+
+			if( !pKeyvalue->hasAttributes() )
+			{
+				Alert( at_aiconsole, "CKeyValueFileCache::ParseFile: File \"%s\": Keyvalue with no attributes, ignoring\n", pszFileName );
+				continue;
+			}
+
+			if( !xml::GetKeyValue( *pKeyvalue->getAttributes(), szKey, szValue ) )
+			{
+				Alert( at_console, "CKeyValueFileCache::ParseFile: File \"%s\": encountered keyvalue with one or more missing parameters, ignoring\n", pszFileName );
+				continue;
+			}
+
+			uiStringsSize += szKey.length() + szValue.length() + 2;
+
+			keyValues.emplace_back( std::move( szKey ), std::move( szValue ) );
+		}
+	}
+
+	Entry entry;
+
+	entry.szRootElement = pszRootElement;
+	entry.iFileTime = g_pFileSystem->GetFileTime( pszFileName );
+	entry.uiSourceHash = Hash( data.data(), data.size() );
+
+	//Reserve up front so the pointers stay valid.
+	entry.strings.reserve( uiStringsSize );
+	entry.keyValues.reserve( keyValues.size() );
+
+	for( const auto& keyValue : keyValues )
+	{
+		const size_t uiKey = entry.strings.size();
+		entry.strings.insert( entry.strings.end(), keyValue.first.c_str(), keyValue.first.c_str() + keyValue.first.length() + 1 );
+
+		const size_t uiValue = entry.strings.size();
+		entry.strings.insert( entry.strings.end(), keyValue.second.c_str(), keyValue.second.c_str() + keyValue.second.length() + 1 );
+
+		entry.keyValues.push_back( { entry.strings.data() + uiKey, entry.strings.data() + uiValue } );
+	}
+
+	m_bDirty = true;
+
+	auto& result = m_Entries[ pszFileName ] = std::move( entry );
+
+	return &result.keyValues;
+}
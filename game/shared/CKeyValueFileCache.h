@@ -0,0 +1,120 @@
+#ifndef GAME_SHARED_CKEYVALUEFILECACHE_H
+#define GAME_SHARED_CKEYVALUEFILECACHE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "StringUtils.h"
+
+/**
+*	A key and its value. Both point into memory owned by the cache.
+*/
+struct FileKeyValue final
+{
+	const char* pszKey;
+	const char* pszValue;
+};
+
+/**
+*	Cache of XML files that consist of a root element containing a list of <keyvalue key="" value=""/> elements.
+*	Weapon info and replacement maps use this format.
+*
+*	Parsed files are stored in a binary cache file. On later runs, files whose modification time or contents haven't changed
+*	are served from the cache without being parsed by xerces.
+*	The cache file is a flat image: a header, a table of files, a table of keyvalues and a string table, all referenced by offset.
+*	It is read in a single operation and used in place.
+*/
+class CKeyValueFileCache final
+{
+public:
+	using KeyValues_t = std::vector<FileKeyValue>;
+
+	static const char* const CACHE_DIR;
+	static const char* const CACHE_FILENAME;
+
+	static const uint64_t HASH_OFFSET_BASIS = 14695981039346656037ULL;
+
+private:
+	struct Entry final
+	{
+		std::string szRootElement;
+
+		long iFileTime = 0;
+		uint64_t uiSourceHash = 0;
+
+		KeyValues_t keyValues;
+
+		//Strings for files that were parsed this session. Empty if the keyvalues point into the cache file.
+		std::vector<char> strings;
+	};
+
+	using Entries_t = std::unordered_map<std::string, Entry, CStdStringHashI, CStdStringEqualToI>;
+
+public:
+	CKeyValueFileCache() = default;
+	~CKeyValueFileCache() = default;
+
+	/**
+	*	Hashes data. Pass the previous result as uiHash to hash multiple pieces of data.
+	*/
+	static uint64_t Hash( const void* pData, const size_t uiSize, uint64_t uiHash = HASH_OFFSET_BASIS );
+
+	static uint64_t Hash( const char* const pszString, const uint64_t uiHash = HASH_OFFSET_BASIS )
+	{
+		//Include the terminator so consecutive strings can't run into each other.
+		return pszString ? Hash( pszString, strlen( pszString ) + 1, uiHash ) : Hash( "", 1, uiHash );
+	}
+
+	/**
+	*	Gets the keyvalues in the given file. Parses the file if the cache doesn't have an up to date copy.
+	*	The returned list is valid until the file is loaded again or the cache is cleared.
+	*	@param pszFileName Name of the file, relative to the game directory.
+	*	@param pszRootElement Expected name of the root element.
+	*	@return If the file could be loaded and has the expected root element, its keyvalues. Otherwise, null.
+	*/
+	const KeyValues_t* LoadFile( const char* const pszFileName, const char* const pszRootElement );
+
+	/**
+	*	Writes the cache file if any file was parsed since it was last read or written.
+	*/
+	bool Save();
+
+	/**
+	*	Frees all cached data. The cache file is read again on the next load.
+	*/
+	void Clear();
+
+private:
+	/**
+	*	Reads the cache file. Does nothing if it has already been read.
+	*/
+	void LoadCacheFile();
+
+	/**
+	*	Parses the given file and stores the result.
+	*/
+	const KeyValues_t* ParseFile( const char* const pszFileName, const char* const pszRootElement );
+
+private:
+	bool m_bCacheFileLoaded = false;
+	bool m_bDirty = false;
+
+	//Contents of the cache file. Entries loaded from the cache point into this.
+	std::vector<uint8_t> m_CacheData;
+
+	Entries_t m_Entries;
+
+	unsigned int m_uiHits = 0;
+	unsigned int m_uiMisses = 0;
+
+private:
+	CKeyValueFileCache( const CKeyValueFileCache& ) = delete;
+	CKeyValueFileCache& operator=( const CKeyValueFileCache& ) = delete;
+};
+
+extern CKeyValueFileCache g_KeyValueFileCache;
+
+#endif //GAME_SHARED_CKEYVALUEFILECACHE_H
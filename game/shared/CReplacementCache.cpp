@@ -1,21 +1,13 @@
 #include <cassert>
 
-#include <xercesc/dom/DOMDocument.hpp>
-#include <xercesc/dom/DOMElement.hpp>
-#include <xercesc/dom/DOMNodeList.hpp>
-#include <xercesc/util/XMLUniDefs.hpp>
-
 #include "extdll.h"
 #include "util.h"
 
 #include "CReplacementMap.h"
 
-#include "CReplacementCache.h"
+#include "CKeyValueFileCache.h"
 
-#include "xml/CStrX.h"
-#include "xml/CXMLManager.h"
-#include "xml/XMLUtils.h"
-#include "xml/CXStr.h"
+#include "CReplacementCache.h"
 
 CReplacementMap* CReplacementCache::GetMap( const char* const pszFileName ) const
 {
@@ -68,58 +60,28 @@ std::unique_ptr<CReplacementMap> CReplacementCache::LoadMap( const char* const p
 {
 	assert( pszAbsFileName );
 
-	auto document = xml::XMLManager().ParseFile( pszFileName );
+	auto pKeyValues = g_KeyValueFileCache.LoadFile( pszFileName, "replacement_map" );
 
-	if( !document )
+	if( !pKeyValues )
 	{
 		return nullptr;
 	}
 
-	auto pRootElement = document->getDocumentElement();
-
-	if( !pRootElement || xercesc::XMLString::compareString( pRootElement->getNodeName(), xml::AsciiToXMLCh( "replacement_map" ).data() ) != 0 )
-	{
-		Alert( at_console, "CReplacementCache::LoadMap: File \"%s\": no replacement keyvalues found, ignoring\n", pszFileName );
-		return nullptr;
-	}
-
-	auto pChildren = xml::GetElementsByTagName( *pRootElement, "keyvalue" );
-
-	const auto count = pChildren->getLength();
-
 	auto map = std::make_unique<CReplacementMap>( pszAbsFileName );
 
-	std::string szKey, szValue;
-
-	for( decltype( pChildren->getLength() ) index = 0; index < count; ++index )
+	for( const auto& keyValue : *pKeyValues )
 	{
-		auto pChild = pChildren->item( index );
-
-		if( !pChild->hasAttributes() )
-		{
-			Alert( at_console, "CReplacementCache::LoadMap: File \"%s\": encountered keyvalue with no attributes, ignoring\n", pszFileName );
-			continue;
-		}
-
-		auto& attrs = *pChild->getAttributes();
-
-		if( !xml::GetKeyValue( attrs, szKey, szValue ) )
-		{
-			Alert( at_console, "CReplacementCache::LoadMap: File \"%s\": encountered keyvalue with one or more missing parameters, ignoring\n", pszFileName );
-			continue;
-		}
-
-		if( szKey.empty() )
+		if( !( *keyValue.pszKey ) )
 		{
 			Alert( at_console, "CReplacementCache::LoadMap: File \"%s\": encountered keyvalue with empty key, ignoring\n", pszFileName );
 			continue;
 		}
 
-		if( !map->AddReplacement( szKey.c_str(), szValue.c_str() ) )
+		if( !map->AddReplacement( keyValue.pszKey, keyValue.pszValue ) )
 		{
-			Alert( at_warning, "CReplacementCache::LoadMap: File \"%s\": Duplicate original filename \"%s\", ignoring\n", pszFileName, szKey.c_str() );
+			Alert( at_warning, "CReplacementCache::LoadMap: File \"%s\": Duplicate original filename \"%s\", ignoring\n", pszFileName, keyValue.pszKey );
 		}
 	}
 
 	return map;
-}
\ No newline at end of file
+}
@@ -1,5 +1,5 @@
-#include <xercesc/dom/DOMDocument.hpp>
-#include <xercesc/dom/DOMNodeList.hpp>
+#include <algorithm>
+#include <utility>
 
 #include "extdll.h"
 #include "util.h"
@@ -13,12 +13,9 @@
 #include "CWeaponHUDInfo.h"
 #endif
 
-#include "CWeaponInfoCache.h"
+#include "CKeyValueFileCache.h"
 
-#include "xml/CStrX.h"
-#include "xml/CXMLManager.h"
-#include "xml/XMLUtils.h"
-#include "xml/CXStr.h"
+#include "CWeaponInfoCache.h"
 
 CWeaponInfoCache g_WeaponInfoCache;
 
@@ -61,11 +58,14 @@ const CWeaponInfo* CWeaponInfoCache::LoadWeaponInfo( const int iID, const char*
 
 	std::unique_ptr<CWeaponInfo> info = std::make_unique<CWeaponInfo>();
 
-	if( LoadWeaponInfoFromFile( pszWeaponName, pszSubDir, *info ) )
+	uint64_t uiContentHash;
+
+	if( LoadWeaponInfoFromFile( pszWeaponName, pszSubDir, *info, uiContentHash ) )
 	{
 		CWeaponInfo* pInfo = info.get();
 
 		m_InfoList.emplace_back( std::move( info ) );
+		m_ContentHashes.push_back( uiContentHash );
 
 		auto result = m_InfoMap.insert( std::make_pair( pInfo->GetWeaponName(), m_InfoList.size() - 1 ) );
 
@@ -91,6 +91,7 @@ const CWeaponInfo* CWeaponInfoCache::LoadWeaponInfo( const int iID, const char*
 		Alert( at_error, "CWeaponInfoCache::LoadWeaponInfo: Failed to insert weapon info \"%s\" into cache!\n", pszWeaponName );
 
 		m_InfoList.erase( m_InfoList.end() - 1 );
+		m_ContentHashes.pop_back();
 	}
 
 	return &m_DefaultInfo;
@@ -100,6 +101,7 @@ void CWeaponInfoCache::ClearInfos()
 {
 	m_InfoMap.clear();
 	m_InfoList.clear();
+	m_ContentHashes.clear();
 }
 
 void CWeaponInfoCache::EnumInfos( EnumInfoCallback pCallback, void* pUserData ) const
@@ -118,18 +120,34 @@ void CWeaponInfoCache::EnumInfos( EnumInfoCallback pCallback, void* pUserData )
 
 size_t CWeaponInfoCache::GenerateHash() const
 {
-	size_t uiHash = 0;
+	//Order by name so the client and server agree regardless of load order.
+	std::vector<std::pair<const char*, uint64_t>> hashes;
 
-	//TODO: not the best hash, but it'll do. - Solokiller
-	for( const auto& info : m_InfoList )
+	hashes.reserve( m_InfoList.size() );
+
+	for( size_t uiIndex = 0; uiIndex < m_InfoList.size(); ++uiIndex )
 	{
-		uiHash += StringHash( info->GetWeaponName() );
+		hashes.emplace_back( m_InfoList[ uiIndex ]->GetWeaponName(), m_ContentHashes[ uiIndex ] );
 	}
 
-	return uiHash;
+	std::sort( hashes.begin(), hashes.end(), []( const std::pair<const char*, uint64_t>& lhs, const std::pair<const char*, uint64_t>& rhs )
+		{
+			return stricmp( lhs.first, rhs.first ) < 0;
+		}
+	);
+
+	uint64_t uiHash = CKeyValueFileCache::HASH_OFFSET_BASIS;
+
+	for( const auto& hash : hashes )
+	{
+		uiHash = CKeyValueFileCache::Hash( &hash.second, sizeof( hash.second ), uiHash );
+	}
+
+	//Fold to fit in the handshake.
+	return static_cast<size_t>( uiHash ^ ( uiHash >> 32 ) );
 }
 
-bool CWeaponInfoCache::LoadWeaponInfoFromFile( const char* const pszWeaponName, const char* const pszSubDir, CWeaponInfo& info )
+bool CWeaponInfoCache::LoadWeaponInfoFromFile( const char* const pszWeaponName, const char* const pszSubDir, CWeaponInfo& info, uint64_t& uiOutContentHash )
 {
 	char szPath[ MAX_PATH ] = {};
 
@@ -151,55 +169,29 @@ bool CWeaponInfoCache::LoadWeaponInfoFromFile( const char* const pszWeaponName,
 		return false;
 	}
 
-	auto document = xml::XMLManager().ParseFile( szPath );
+	auto pKeyValues = g_KeyValueFileCache.LoadFile( szPath, "weapon" );
 
-	if( !document )
+	if( !pKeyValues )
 	{
 		return false;
 	}
 
 	info.SetWeaponName( pszWeaponName );
 
-	auto pRoot = document->getDocumentElement();
+	uint64_t uiHash = CKeyValueFileCache::Hash( info.GetWeaponName() );
 
-	if( !pRoot || xercesc::XMLString::compareString( pRoot->getNodeName(), xml::AsciiToXMLCh( "weapon" ).data() ) != 0 )
+	for( const auto& keyValue : *pKeyValues )
 	{
-		Alert( at_console, "CWeaponInfoCache::LoadWeaponInfoFromFile: File \"%s\": No weapon data found, ignoring\n", szPath );
-		return false;
-	}
-
-	auto pKeyvalues = xml::GetElementsByTagName( *pRoot, "keyvalue" );
+		uiHash = CKeyValueFileCache::Hash( keyValue.pszKey, uiHash );
+		uiHash = CKeyValueFileCache::Hash( keyValue.pszValue, uiHash );
 
-	if( pKeyvalues )
-	{
-		const auto count = pKeyvalues->getLength();
-
-		std::string szKey, szValue;
-
-		for( decltype( pKeyvalues->getLength() ) index = 0; index < count; ++index )
+		if( !info.KeyValue( keyValue.pszKey, keyValue.pszValue ) )
 		{
-			const auto pKeyvalue = pKeyvalues->item( index );
-
-			if( !pKeyvalue->hasAttributes() )
-			{
-				Alert( at_aiconsole, "CWeaponInfoCache::LoadWeaponInfoFromFile: Keyvalue with no attributes, ignoring\n" );
-				continue;
-			}
-
-			auto& attrs = *pKeyvalue->getAttributes();
-
-			if( !xml::GetKeyValue( attrs, szKey, szValue ) )
-			{
-				Alert( at_console, "CWeaponInfoCache::LoadWeaponInfoFromFile: File \"%s\": encountered keyvalue with one or more missing parameters, ignoring\n", szPath );
-				continue;
-			}
-
-			if( !info.KeyValue( szKey.c_str(), szValue.c_str() ) )
-			{
-				Alert( at_aiconsole, "CWeaponInfoCache::LoadWeaponInfoFromFile: Unhandled keyvalue \"%s\" \"%s\"\n", szKey.c_str(), szValue.c_str() );
-			}
+			Alert( at_aiconsole, "CWeaponInfoCache::LoadWeaponInfoFromFile: Unhandled keyvalue \"%s\" \"%s\"\n", keyValue.pszKey, keyValue.pszValue );
 		}
 	}
 
+	uiOutContentHash = uiHash;
+
 	return true;
 }
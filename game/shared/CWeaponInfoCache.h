@@ -1,6 +1,7 @@
 #ifndef GAME_SHARED_CWEAPONINFOCACHE_H
 #define GAME_SHARED_CWEAPONINFOCACHE_H
 
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -66,6 +67,9 @@ public:
 	*/
 	void EnumInfos( EnumInfoCallback pCallback, void* pUserData = nullptr ) const;
 
+	/**
+	*	@return Hash of the contents of all loaded weapon info files. Used to verify that the client and server have the same data.
+	*/
 	size_t GenerateHash() const;
 
 private:
@@ -74,14 +78,18 @@ private:
 	*	@param pszWeaponName Name of the weapon whose info should be loaded.
 	*	@param pszSubDir Optional. Subdirectory to check.
 	*	@param info Weapon info structure to initialize.
+	*	@param[ out ] uiOutContentHash Hash of the weapon name and keyvalues.
 	*	@return true on success, false otherwise.
 	*/
-	bool LoadWeaponInfoFromFile( const char* const pszWeaponName, const char* const pszSubDir, CWeaponInfo& info );
+	bool LoadWeaponInfoFromFile( const char* const pszWeaponName, const char* const pszSubDir, CWeaponInfo& info, uint64_t& uiOutContentHash );
 
 private:
 	InfoMap_t m_InfoMap;
 	InfoList_t m_InfoList;
 
+	//Content hash of each info in m_InfoList.
+	std::vector<uint64_t> m_ContentHashes;
+
 	//Used when a file failed to load.
 	CWeaponInfo m_DefaultInfo;
 
@@ -174,6 +174,9 @@ public:
 	void SetTargetname( const string_t iszTargetName )
 	{
 		pev->targetname = iszTargetName;
+#ifdef SERVER_DLL
+		TargetnameChanged();
+#endif
 	}
 
 	/**
@@ -193,6 +196,16 @@ public:
 		pev->targetname = iStringNull;
 	}
 
+#ifdef SERVER_DLL
+private:
+	/**
+	*	Lets the targetname graph know about the new name.
+	*/
+	void TargetnameChanged();
+
+public:
+#endif
+
 	/**
 	*	@return Whether this entity has a target.
 	*/
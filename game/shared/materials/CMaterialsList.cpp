@@ -2,6 +2,8 @@
 #include "util.h"
 #include "sound/Sound.h"
 
+#include "BSPIO.h"
+
 #include "CMaterialsList.h"
 
 bool CMaterialsList::LoadFromFile( const char* const pszFileName )
@@ -140,6 +142,88 @@ int CMaterialsList::FindTextureByType( int iPrevious, const char chType ) const
 	return INVALID_TEX_INDEX;
 }
 
+const char* CMaterialsList::StripTexturePrefix( const char* pszName )
+{
+	ASSERT( pszName );
+
+	// strip leading '-0' or '+0~' or '{' or '!'
+	if( ( *pszName == '-' || *pszName == '+' ) && pszName[ 1 ] )
+		pszName += 2;
+
+	if( *pszName == '{' || *pszName == '!' || *pszName == '~' || *pszName == ' ' )
+		++pszName;
+	// '}}'
+
+	return pszName;
+}
+
+bool CMaterialsList::LoadMapTextures( const char* const pszFileName )
+{
+	ASSERT( pszFileName );
+
+	ClearMapTextures();
+
+	std::vector<std::string> names;
+
+	if( !bsp::LoadTextureNames( pszFileName, names ) )
+	{
+		ALERT( at_console, "CMaterialsList::LoadMapTextures: Couldn't load textures for map \"%s\"\n", pszFileName );
+		return false;
+	}
+
+	m_MapTextureTypes.resize( names.size(), CHAR_TEX_CONCRETE );
+	m_MapTextureIndices.reserve( names.size() );
+
+	for( size_t uiIndex = 0; uiIndex < names.size(); ++uiIndex )
+	{
+		if( names[ uiIndex ].empty() )
+			continue;
+
+		m_MapTextureTypes[ uiIndex ] = FindTextureType( StripTexturePrefix( names[ uiIndex ].c_str() ) );
+
+		//Duplicate names use the first texture; the engine does the same.
+		m_MapTextureIndices.emplace( std::move( names[ uiIndex ] ), static_cast<int>( uiIndex ) );
+	}
+
+	ALERT( at_aiconsole, "CMaterialsList::LoadMapTextures: Resolved %u textures\n", static_cast<unsigned int>( m_MapTextureTypes.size() ) );
+
+	return true;
+}
+
+void CMaterialsList::ClearMapTextures()
+{
+	m_MapTextureTypes.clear();
+	m_MapTextureIndices.clear();
+	m_TextureTypeCache.clear();
+}
+
+char CMaterialsList::GetTextureType( const char* const pszEngineName )
+{
+	ASSERT( pszEngineName );
+
+	auto it = m_TextureTypeCache.find( pszEngineName );
+
+	if( it != m_TextureTypeCache.end() )
+		return it->second;
+
+	char chType;
+
+	auto index = m_MapTextureIndices.find( pszEngineName );
+
+	if( index != m_MapTextureIndices.end() )
+	{
+		chType = m_MapTextureTypes[ index->second ];
+	}
+	else
+	{
+		chType = FindTextureType( StripTexturePrefix( pszEngineName ) );
+	}
+
+	m_TextureTypeCache.emplace( pszEngineName, chType );
+
+	return chType;
+}
+
 void CMaterialsList::SwapTextures( int i, int j )
 {
 	ASSERT( i < m_iTextures );
@@ -1,8 +1,16 @@
 #ifndef GAME_SHARED_MATERIALS_CMATERIALSLIST_H
 #define GAME_SHARED_MATERIALS_CMATERIALSLIST_H
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "StringUtils.h"
+
 #include "MaterialsConst.h"
 
+struct texture_t;
+
 /**
 *	List of materials.
 */
@@ -41,6 +49,59 @@ public:
 	*/
 	int FindTextureByType( int iPrevious, const char chType ) const;
 
+	/**
+	*	Strips the prefixes that mark animated, tiling, transparent and water textures from a texture name.
+	*	@param pszName Texture name.
+	*	@return Name without prefixes. Points into pszName.
+	*/
+	static const char* StripTexturePrefix( const char* pszName );
+
+	/**
+	*	Resolves the material type of every texture in the given map, and clears the texture lookup cache.
+	*	Must be called on every map change, before any texture lookups for that map are made.
+	*	@param pszFileName Name of the BSP file.
+	*	@return Whether the map's textures could be loaded. If not, lookups fall back to searching by name.
+	*/
+	bool LoadMapTextures( const char* const pszFileName );
+
+	/**
+	*	Clears the current map's textures and the texture lookup cache.
+	*/
+	void ClearMapTextures();
+
+	/**
+	*	@return Number of textures in the current map.
+	*/
+	int GetMapTextureCount() const { return static_cast<int>( m_MapTextureTypes.size() ); }
+
+	/**
+	*	Gets the material type of a texture in the current map.
+	*	@param iMiptex Index of the texture in the map's texture lump.
+	*	@return Texture type. If the index is invalid, type 'concrete'.
+	*/
+	char GetMapTextureType( const int iMiptex ) const
+	{
+		return iMiptex >= 0 && static_cast<size_t>( iMiptex ) < m_MapTextureTypes.size() ? m_MapTextureTypes[ iMiptex ] : CHAR_TEX_CONCRETE;
+	}
+
+	/**
+	*	Gets the material type of a texture returned by the engine's texture traces.
+	*	The result is cached by address, so only pass names owned by the engine (texture_t::name, PM_TraceTexture, EV_TraceTexture).
+	*	Textures that aren't in the current map are looked up by name.
+	*	@param pszEngineName Texture name, including prefixes.
+	*	@return Texture type.
+	*/
+	char GetTextureType( const char* const pszEngineName );
+
+	/**
+	*	@copydoc GetTextureType( const char* const pszEngineName )
+	*/
+	char GetTextureType( const texture_t* pTexture )
+	{
+		//texture_t::name is the first member; its layout differs between renderers so don't access it directly. See pfnTraceTexture.
+		return GetTextureType( reinterpret_cast<const char*>( pTexture ) );
+	}
+
 private:
 	void SwapTextures( int i, int j );
 
@@ -59,6 +120,15 @@ private:
 	char m_szTextureName[ CTEXTURESMAX ][ CBTEXTURENAMEMAX ];
 	char m_chTextureType[ CTEXTURESMAX ];
 
+	//Material type of each texture in the current map, indexed by miptex.
+	std::vector<char> m_MapTextureTypes;
+
+	//Miptex index of each texture in the current map, by name.
+	std::unordered_map<std::string, int, CStdStringHashI, CStdStringEqualToI> m_MapTextureIndices;
+
+	//Material type by engine texture name address. Addresses are only valid for the current map.
+	std::unordered_map<const char*, char> m_TextureTypeCache;
+
 private:
 	CMaterialsList( const CMaterialsList& ) = delete;
 	CMaterialsList& operator=( const CMaterialsList& ) = delete;
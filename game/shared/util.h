@@ -106,6 +106,11 @@ bool FNullEnt( const CBaseEntity* pEntity );
 // Misc useful
 CBaseEntity* UTIL_FindClientInPVS( const CBaseEntity* const pPVSEntity );
 
+/**
+*	@copydoc enginefuncs_t::pfnEntitiesInPVS
+*/
+edict_t* UTIL_EntitiesInPVS( edict_t* pPVSEntity );
+
 struct TYPEDESCRIPTION;
 
 class CBaseEntity;
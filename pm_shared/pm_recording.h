@@ -0,0 +1,234 @@
+#ifndef PM_SHARED_PM_RECORDING_H
+#define PM_SHARED_PM_RECORDING_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "pm_defs.h"
+#include "pm_movevars.h"
+
+/**
+*	File format of player movement recordings, written by the server's pm_record command and replayed by the pmreplay tool.
+*	A recording is a RecordingHeader followed by one frame per move.
+*	Each frame holds a FrameHeader, the player state, the user command, the movevars and the physinfo string going into the move.
+*	The FrameHeader holds the origin and velocity that came out of it.
+*/
+namespace pmrec
+{
+//Change the version number whenever the file format changes.
+#define PM_RECORDING_MAGIC "HLPMRC01"
+#define PM_RECORDING_MAGIC_SIZE 8
+
+/**
+*	Extension of recording files.
+*/
+const char* const RECORDING_EXT = "pmr";
+
+#pragma pack( push, 1 )
+struct RecordingHeader final
+{
+	char szMagic[ PM_RECORDING_MAGIC_SIZE ];
+
+	//Sizes of the structures stored in each frame, so recordings made with a different build are rejected.
+	uint32_t uiStateSize;
+	uint32_t uiCmdSize;
+	uint32_t uiMoveVarsSize;
+
+	char szMapName[ 64 ];
+};
+
+struct FrameHeader final
+{
+	int32_t iNumPhysEnts;
+	int32_t iNumMoveEnts;
+
+	//Results of the move.
+	float vecOrigin[ 3 ];
+	float vecVelocity[ 3 ];
+};
+
+/**
+*	The user command as it's stored in a frame. usercmd_t contains Vectors, so it can't be copied as raw bytes.
+*/
+struct FrameCmd final
+{
+	int16_t iLerpMSec;
+	uint8_t uiMSec;
+	float vecViewAngles[ 3 ];
+
+	float flForwardMove;
+	float flSideMove;
+	float flUpMove;
+	uint8_t uiLightLevel;
+	uint16_t uiButtons;
+	uint8_t uiImpulse;
+	uint8_t uiWeaponSelect;
+
+	int32_t iImpactIndex;
+	float vecImpactPosition[ 3 ];
+};
+#pragma pack( pop )
+
+inline void WriteCmd( const usercmd_t& cmd, uint8_t* pData )
+{
+	FrameCmd frameCmd;
+
+	frameCmd.iLerpMSec = cmd.lerp_msec;
+	frameCmd.uiMSec = cmd.msec;
+	cmd.viewangles.CopyToArray( frameCmd.vecViewAngles );
+
+	frameCmd.flForwardMove = cmd.forwardmove;
+	frameCmd.flSideMove = cmd.sidemove;
+	frameCmd.flUpMove = cmd.upmove;
+	frameCmd.uiLightLevel = cmd.lightlevel;
+	frameCmd.uiButtons = cmd.buttons;
+	frameCmd.uiImpulse = cmd.impulse;
+	frameCmd.uiWeaponSelect = cmd.weaponselect;
+
+	frameCmd.iImpactIndex = cmd.impact_index;
+	cmd.impact_position.CopyToArray( frameCmd.vecImpactPosition );
+
+	memcpy( pData, &frameCmd, sizeof( frameCmd ) );
+}
+
+inline void ReadCmd( const uint8_t* pData, usercmd_t& cmd )
+{
+	FrameCmd frameCmd;
+
+	memcpy( &frameCmd, pData, sizeof( frameCmd ) );
+
+	cmd.lerp_msec = frameCmd.iLerpMSec;
+	cmd.msec = frameCmd.uiMSec;
+	cmd.viewangles = Vector( frameCmd.vecViewAngles[ 0 ], frameCmd.vecViewAngles[ 1 ], frameCmd.vecViewAngles[ 2 ] );
+
+	cmd.forwardmove = frameCmd.flForwardMove;
+	cmd.sidemove = frameCmd.flSideMove;
+	cmd.upmove = frameCmd.flUpMove;
+	cmd.lightlevel = frameCmd.uiLightLevel;
+	cmd.buttons = frameCmd.uiButtons;
+	cmd.impulse = frameCmd.uiImpulse;
+	cmd.weaponselect = frameCmd.uiWeaponSelect;
+
+	cmd.impact_index = frameCmd.iImpactIndex;
+	cmd.impact_position = Vector( frameCmd.vecImpactPosition[ 0 ], frameCmd.vecImpactPosition[ 1 ], frameCmd.vecImpactPosition[ 2 ] );
+}
+
+/**
+*	@return Start of the player state in playermove_t. Everything up to the physents list is copied as-is.
+*/
+inline uint8_t* GetState( playermove_t& move )
+{
+	return reinterpret_cast<uint8_t*>( &move.player_index );
+}
+
+inline const uint8_t* GetState( const playermove_t& move )
+{
+	return reinterpret_cast<const uint8_t*>( &move.player_index );
+}
+
+inline size_t GetStateSize( const playermove_t& move )
+{
+	return reinterpret_cast<const uint8_t*>( &move.numphysent ) - GetState( move );
+}
+
+inline size_t GetFrameSize( const size_t uiStateSize )
+{
+	return sizeof( FrameHeader ) + uiStateSize + sizeof( FrameCmd ) + sizeof( movevars_t ) + MAX_PHYSINFO_STRING;
+}
+
+/**
+*	Fills in a recording header for moves made with the given playermove_t.
+*/
+inline void InitHeader( RecordingHeader& header, const playermove_t& move, const char* const pszMapName )
+{
+	memset( &header, 0, sizeof( header ) );
+
+	memcpy( header.szMagic, PM_RECORDING_MAGIC, sizeof( header.szMagic ) );
+	header.uiStateSize = static_cast<uint32_t>( GetStateSize( move ) );
+	header.uiCmdSize = sizeof( FrameCmd );
+	header.uiMoveVarsSize = sizeof( movevars_t );
+	strncpy( header.szMapName, pszMapName, sizeof( header.szMapName ) - 1 );
+}
+
+/**
+*	@return Whether the header belongs to a recording that can be replayed with the given playermove_t.
+*/
+inline bool IsCompatible( const RecordingHeader& header, const playermove_t& move )
+{
+	return memcmp( header.szMagic, PM_RECORDING_MAGIC, sizeof( header.szMagic ) ) == 0 &&
+		header.uiStateSize == GetStateSize( move ) &&
+		header.uiCmdSize == sizeof( FrameCmd ) &&
+		header.uiMoveVarsSize == sizeof( movevars_t );
+}
+
+/**
+*	Stores the input of a move in a frame. Must be called before the move runs.
+*	@param pFrame Frame of GetFrameSize( GetStateSize( move ) ) bytes.
+*/
+inline void WriteFrameInput( const playermove_t& move, uint8_t* pFrame )
+{
+	const size_t uiStateSize = GetStateSize( move );
+
+	auto pData = pFrame + sizeof( FrameHeader );
+
+	memcpy( pData, GetState( move ), uiStateSize );
+	pData += uiStateSize;
+
+	WriteCmd( move.cmd, pData );
+	pData += sizeof( FrameCmd );
+
+	memcpy( pData, move.movevars, sizeof( movevars_t ) );
+	pData += sizeof( movevars_t );
+
+	memcpy( pData, move.physinfo, MAX_PHYSINFO_STRING );
+}
+
+/**
+*	Stores the result of a move in a frame. Must be called after the move runs.
+*	@param iNumPhysEnts Number of physents the move had. The move may have changed it.
+*	@param iNumMoveEnts Number of moveents the move had.
+*/
+inline void WriteFrameResult( const playermove_t& move, const int iNumPhysEnts, const int iNumMoveEnts, uint8_t* pFrame )
+{
+	FrameHeader header;
+
+	header.iNumPhysEnts = iNumPhysEnts;
+	header.iNumMoveEnts = iNumMoveEnts;
+
+	move.origin.CopyToArray( header.vecOrigin );
+	move.velocity.CopyToArray( header.vecVelocity );
+
+	memcpy( pFrame, &header, sizeof( header ) );
+}
+
+/**
+*	Restores the input of a move from a frame. The movevars are copied into the movevars_t that move.movevars points to.
+*	@return The frame's header.
+*/
+inline FrameHeader ReadFrame( const uint8_t* pFrame, playermove_t& move )
+{
+	FrameHeader header;
+
+	memcpy( &header, pFrame, sizeof( header ) );
+
+	const size_t uiStateSize = GetStateSize( move );
+
+	auto pData = pFrame + sizeof( FrameHeader );
+
+	memcpy( GetState( move ), pData, uiStateSize );
+	pData += uiStateSize;
+
+	ReadCmd( pData, move.cmd );
+	pData += sizeof( FrameCmd );
+
+	memcpy( move.movevars, pData, sizeof( movevars_t ) );
+	pData += sizeof( movevars_t );
+
+	memcpy( move.physinfo, pData, MAX_PHYSINFO_STRING );
+	move.physinfo[ MAX_PHYSINFO_STRING - 1 ] = '\0';
+
+	return header;
+}
+}
+
+#endif //PM_SHARED_PM_RECORDING_H
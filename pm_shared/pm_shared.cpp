@@ -30,6 +30,8 @@
 
 #include "com_model.h"
 
+#include "CStopwatch.h"
+
 #ifdef CLIENT_DLL
 #include "hud.h"
 #include "cl_util.h"
@@ -53,6 +55,64 @@ static bool pm_shared_initialized = false;
 
 playermove_t* pmove = nullptr;
 
+PMProfile g_PMProfile = {};
+
+namespace
+{
+/**
+*	Adds the time spent in a scope to the movement profile.
+*/
+class CPMProfileScope final
+{
+public:
+	CPMProfileScope( const PMProfileFunc func )
+		: m_Func( func )
+		, m_bEnabled( g_PMProfile.bEnabled )
+	{
+		if( m_bEnabled )
+			m_Start = CStopwatch::Clock_t::now();
+	}
+
+	~CPMProfileScope()
+	{
+		if( m_bEnabled )
+		{
+			g_PMProfile.flTime[ m_Func ] += std::chrono::duration<double>( CStopwatch::Clock_t::now() - m_Start ).count();
+			++g_PMProfile.uiCalls[ m_Func ];
+		}
+	}
+
+private:
+	const PMProfileFunc m_Func;
+	const bool m_bEnabled;
+	CStopwatch::Clock_t::time_point m_Start;
+
+private:
+	CPMProfileScope( const CPMProfileScope& ) = delete;
+	CPMProfileScope& operator=( const CPMProfileScope& ) = delete;
+};
+}
+
+void PM_ResetProfile()
+{
+	const bool bEnabled = g_PMProfile.bEnabled;
+
+	g_PMProfile = {};
+
+	g_PMProfile.bEnabled = bEnabled;
+}
+
+const char* PM_ProfileFuncName( const PMProfileFunc func )
+{
+	switch( func )
+	{
+	case PMPROF_FLYMOVE:			return "PM_FlyMove";
+	case PMPROF_CHECKSTUCK:			return "PM_CheckStuck";
+	case PMPROF_CATEGORIZEPOSITION:	return "PM_CategorizePosition";
+	default:						return "unknown";
+	}
+}
+
 // Ducking time
 #define TIME_TO_DUCK		0.4
 #define STUCK_MOVEUP		1
@@ -267,19 +327,11 @@ void PM_CategorizeTextureType()
 	if ( !pTextureName )
 		return;
 
-	// strip leading '-0' or '+0~' or '{' or '!'
-	if (*pTextureName == '-' || *pTextureName == '+')
-		pTextureName += 2;
-
-	if (*pTextureName == '{' || *pTextureName == '!' || *pTextureName == '~' || *pTextureName == ' ')
-		pTextureName++;
-	// '}}'
-	
-	strcpy( pmove->sztexturename, pTextureName);
+	strcpy( pmove->sztexturename, CMaterialsList::StripTexturePrefix( pTextureName ) );
 	pmove->sztexturename[ CBTEXTURENAMEMAX - 1 ] = 0;
 		
-	// get texture type
-	pmove->chtexturetype = g_MaterialsList.FindTextureType( pmove->sztexturename );	
+	// get texture type, using the engine's name so the result can be cached
+	pmove->chtexturetype = g_MaterialsList.GetTextureType( pTextureName );	
 }
 
 void PM_UpdateStepSound()
@@ -587,6 +639,8 @@ The basic solid body movement clip that slides along multiple planes
 */
 int PM_FlyMove()
 {
+	CPMProfileScope profileScope( PMPROF_FLYMOVE );
+
 	int			bumpcount, numbumps;
 	Vector		dir;
 	float		d;
@@ -1300,6 +1354,8 @@ PM_CatagorizePosition
 */
 void PM_CategorizePosition()
 {
+	CPMProfileScope profileScope( PMPROF_CATEGORIZEPOSITION );
+
 	// if the player hull point one unit down is solid, the player
 	// is on ground
 	
@@ -1402,6 +1458,8 @@ allow for the cut precision of the net coordinates
 
 bool PM_CheckStuck()
 {
+	CPMProfileScope profileScope( PMPROF_CHECKSTUCK );
+
 	Vector  offset;
 	Vector  test;
 	int		idx;
@@ -3029,7 +3087,7 @@ int PM_GetPhysEntInfo( int ent )
 	return -1;
 }
 
-void PM_Init( playermove_t *ppmove )
+void PM_InitMovement( playermove_t *ppmove )
 {
 	assert( !pm_shared_initialized );
 
@@ -3037,7 +3095,12 @@ void PM_Init( playermove_t *ppmove )
 
 	PM_CreateStuckTable();
 
-	g_MaterialsList.LoadFromFile( "sound/materials.txt" );
-
 	pm_shared_initialized = true;
 }
+
+void PM_Init( playermove_t *ppmove )
+{
+	PM_InitMovement( ppmove );
+
+	g_MaterialsList.LoadFromFile( "sound/materials.txt" );
+}
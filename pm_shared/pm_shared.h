@@ -21,8 +21,52 @@
 #pragma once
 
 void PM_Init( playermove_t *ppmove );
+
+/**
+*	Initializes player movement without loading the materials list.
+*	For tools that run player movement without the engine's filesystem. Texture types then default to concrete.
+*/
+void PM_InitMovement( playermove_t *ppmove );
+
 void PM_Move ( playermove_t *ppmove, int server );
 
+/**
+*	Functions whose cost is measured by the movement profiler.
+*/
+enum PMProfileFunc
+{
+	PMPROF_FLYMOVE = 0,
+	PMPROF_CHECKSTUCK,
+	PMPROF_CATEGORIZEPOSITION,
+
+	PMPROF_COUNT
+};
+
+/**
+*	Time spent in the profiled movement functions.
+*	Only collected while bEnabled is set, so regular movement doesn't pay for the timing.
+*/
+struct PMProfile
+{
+	bool bEnabled;
+
+	//In seconds.
+	double flTime[ PMPROF_COUNT ];
+	unsigned int uiCalls[ PMPROF_COUNT ];
+};
+
+extern PMProfile g_PMProfile;
+
+/**
+*	Clears the profile counters. Does not change whether profiling is enabled.
+*/
+void PM_ResetProfile();
+
+/**
+*	@return Name of the given profiled function.
+*/
+const char* PM_ProfileFuncName( const PMProfileFunc func );
+
 /**
 *	Spectator Movement modes (stored in pev->iuser1, so the physics code can get at them)
 */
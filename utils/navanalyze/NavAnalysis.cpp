@@ -0,0 +1,907 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+#include "CClipHulls.h"
+
+#include "NavAnalysis.h"
+
+namespace nav
+{
+namespace
+{
+const size_t INVALID_AREA = static_cast<size_t>( -1 );
+
+/**
+*	Calls func for every index in [ 0, uiCount ) on uiThreadCount threads.
+*	Each thread gets its own copy of func, so mutable lambdas can keep per thread state.
+*/
+template<typename FUNC>
+void ParallelFor( const size_t uiCount, const unsigned int uiThreadCount, const FUNC& func )
+{
+	std::atomic<size_t> next( 0 );
+
+	auto worker = [ & ]()
+	{
+		FUNC localFunc = func;
+
+		for( size_t uiIndex = next++; uiIndex < uiCount; uiIndex = next++ )
+		{
+			localFunc( uiIndex );
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	threads.reserve( uiThreadCount - 1 );
+
+	for( unsigned int uiThread = 1; uiThread < uiThreadCount; ++uiThread )
+	{
+		threads.emplace_back( worker );
+	}
+
+	worker();
+
+	for( auto& thread : threads )
+	{
+		thread.join();
+	}
+}
+}
+
+/**
+*	A* search over the areas, as done by NavAreaBuildPath in game_shared/bot/nav_area.h with the approach area cost.
+*	The open list is kept in the same order as the game's, so ties are broken the same way.
+*	Only floor connections are followed.
+*/
+class CPathSearch final
+{
+public:
+	explicit CPathSearch( const std::vector<Area>& areas )
+		: m_Areas( areas )
+		, m_Nodes( areas.size() )
+	{
+	}
+
+	/**
+	*	Finds a path between two areas that doesn't go through any of the blocked areas.
+	*	The path is followed by going from the goal to its parent, until there is no parent.
+	*	@return Whether a path exists.
+	*/
+	bool BuildPath( const size_t uiStart, const size_t uiGoal, const std::vector<size_t>& blocked );
+
+	size_t GetParent( const size_t uiArea ) const { return m_Nodes[ uiArea ].uiParent; }
+
+	/**
+	*	@return How the area was entered from its parent, or NUM_TRAVERSE_TYPES if it has no parent.
+	*/
+	unsigned char GetParentHow( const size_t uiArea ) const { return m_Nodes[ uiArea ].parentHow; }
+
+private:
+	struct Node final
+	{
+		size_t uiParent = INVALID_AREA;
+		unsigned char parentHow = NUM_TRAVERSE_TYPES;
+
+		float flCostSoFar = 0;
+		float flTotalCost = 0;
+
+		size_t uiPrevOpen = INVALID_AREA;
+		size_t uiNextOpen = INVALID_AREA;
+
+		unsigned int uiOpenMarker = 0;
+		unsigned int uiClosedMarker = 0;
+	};
+
+	bool IsOpen( const size_t uiArea ) const { return m_Nodes[ uiArea ].uiOpenMarker == m_uiMarker; }
+	bool IsClosed( const size_t uiArea ) const { return m_Nodes[ uiArea ].uiClosedMarker == m_uiMarker; }
+
+	/**
+	*	@return Cost of the path to uiArea through uiFrom, or -1 if uiArea is blocked.
+	*/
+	float GetCost( const size_t uiArea, const size_t uiFrom, const std::vector<size_t>& blocked ) const;
+
+	/**
+	*	Inserts the area after all areas that don't cost more.
+	*/
+	void AddToOpenList( const size_t uiArea );
+
+	/**
+	*	Moves the area towards the front of the list after its cost went down.
+	*/
+	void UpdateOnOpenList( const size_t uiArea );
+
+	size_t PopOpenList();
+
+private:
+	const std::vector<Area>& m_Areas;
+	std::vector<Node> m_Nodes;
+
+	size_t m_uiOpenList = INVALID_AREA;
+
+	unsigned int m_uiMarker = 0;
+};
+
+bool CPathSearch::BuildPath( const size_t uiStart, const size_t uiGoal, const std::vector<size_t>& blocked )
+{
+	auto& start = m_Nodes[ uiStart ];
+
+	start.uiParent = INVALID_AREA;
+	start.parentHow = NUM_TRAVERSE_TYPES;
+
+	if( uiStart == uiGoal )
+		return true;
+
+	const Vector vecGoal = m_Areas[ uiGoal ].GetCenter();
+
+	//Start a new search. Zero is never a valid marker.
+	if( ++m_uiMarker == 0 )
+		m_uiMarker = 1;
+
+	m_uiOpenList = INVALID_AREA;
+
+	start.flTotalCost = ( m_Areas[ uiStart ].GetCenter() - vecGoal ).Length();
+
+	const float flInitCost = GetCost( uiStart, INVALID_AREA, blocked );
+
+	if( flInitCost < 0.0f )
+		return false;
+
+	start.flCostSoFar = flInitCost;
+
+	AddToOpenList( uiStart );
+
+	while( m_uiOpenList != INVALID_AREA )
+	{
+		const size_t uiArea = PopOpenList();
+
+		if( uiArea == uiGoal )
+			return true;
+
+		for( int iDir = 0; iDir < NUM_DIRECTIONS; ++iDir )
+		{
+			for( const auto uiNewArea : m_Areas[ uiArea ].connections[ iDir ] )
+			{
+				//Don't backtrack.
+				if( uiNewArea == uiArea )
+					continue;
+
+				const float flNewCostSoFar = GetCost( uiNewArea, uiArea, blocked );
+
+				//Dead end.
+				if( flNewCostSoFar < 0.0f )
+					continue;
+
+				auto& node = m_Nodes[ uiNewArea ];
+
+				//This is a worse path.
+				if( ( IsOpen( uiNewArea ) || IsClosed( uiNewArea ) ) && node.flCostSoFar <= flNewCostSoFar )
+					continue;
+
+				const float flNewCostRemaining = ( m_Areas[ uiNewArea ].GetCenter() - vecGoal ).Length();
+
+				node.uiParent = uiArea;
+				node.parentHow = static_cast<unsigned char>( iDir );
+				node.flCostSoFar = flNewCostSoFar;
+				node.flTotalCost = flNewCostSoFar + flNewCostRemaining;
+
+				if( IsClosed( uiNewArea ) )
+					node.uiClosedMarker = 0;
+
+				if( IsOpen( uiNewArea ) )
+					UpdateOnOpenList( uiNewArea );
+				else
+					AddToOpenList( uiNewArea );
+			}
+		}
+
+		m_Nodes[ uiArea ].uiClosedMarker = m_uiMarker;
+	}
+
+	return false;
+}
+
+float CPathSearch::GetCost( const size_t uiArea, const size_t uiFrom, const std::vector<size_t>& blocked ) const
+{
+	if( std::find( blocked.begin(), blocked.end(), uiArea ) != blocked.end() )
+		return -1.0f;
+
+	//First area in the path, no cost.
+	if( uiFrom == INVALID_AREA )
+		return 0.0f;
+
+	return ( m_Areas[ uiArea ].GetCenter() - m_Areas[ uiFrom ].GetCenter() ).Length() + m_Nodes[ uiFrom ].flCostSoFar;
+}
+
+void CPathSearch::AddToOpenList( const size_t uiArea )
+{
+	auto& node = m_Nodes[ uiArea ];
+
+	node.uiOpenMarker = m_uiMarker;
+
+	size_t uiOther = m_uiOpenList;
+	size_t uiLast = INVALID_AREA;
+
+	for( ; uiOther != INVALID_AREA; uiOther = m_Nodes[ uiOther ].uiNextOpen )
+	{
+		if( node.flTotalCost < m_Nodes[ uiOther ].flTotalCost )
+			break;
+
+		uiLast = uiOther;
+	}
+
+	node.uiPrevOpen = uiLast;
+	node.uiNextOpen = uiOther;
+
+	if( uiLast != INVALID_AREA )
+		m_Nodes[ uiLast ].uiNextOpen = uiArea;
+	else
+		m_uiOpenList = uiArea;
+
+	if( uiOther != INVALID_AREA )
+		m_Nodes[ uiOther ].uiPrevOpen = uiArea;
+}
+
+void CPathSearch::UpdateOnOpenList( const size_t uiArea )
+{
+	auto& node = m_Nodes[ uiArea ];
+
+	//The cost can only go down, so move towards the front.
+	while( node.uiPrevOpen != INVALID_AREA && node.flTotalCost < m_Nodes[ node.uiPrevOpen ].flTotalCost )
+	{
+		const size_t uiOther = node.uiPrevOpen;
+		auto& other = m_Nodes[ uiOther ];
+
+		const size_t uiBefore = other.uiPrevOpen;
+		const size_t uiAfter = node.uiNextOpen;
+
+		node.uiNextOpen = uiOther;
+		node.uiPrevOpen = uiBefore;
+
+		other.uiPrevOpen = uiArea;
+		other.uiNextOpen = uiAfter;
+
+		if( uiBefore != INVALID_AREA )
+			m_Nodes[ uiBefore ].uiNextOpen = uiArea;
+		else
+			m_uiOpenList = uiArea;
+
+		if( uiAfter != INVALID_AREA )
+			m_Nodes[ uiAfter ].uiPrevOpen = uiOther;
+	}
+}
+
+size_t CPathSearch::PopOpenList()
+{
+	const size_t uiArea = m_uiOpenList;
+
+	auto& node = m_Nodes[ uiArea ];
+
+	m_uiOpenList = node.uiNextOpen;
+
+	if( m_uiOpenList != INVALID_AREA )
+		m_Nodes[ m_uiOpenList ].uiPrevOpen = INVALID_AREA;
+
+	node.uiOpenMarker = 0;
+
+	return uiArea;
+}
+
+CNavAnalyzer::CNavAnalyzer( CNavMesh& mesh, const bsp::CClipHulls& hulls, const unsigned int uiThreadCount )
+	: m_Mesh( mesh )
+	, m_Hulls( hulls )
+	, m_uiThreadCount( uiThreadCount > 0 ? uiThreadCount : 1 )
+{
+}
+
+size_t CNavAnalyzer::ComputeHidingSpots()
+{
+	auto& areas = m_Mesh.GetAreas();
+
+	std::vector<std::vector<HidingSpot>> spots( areas.size() );
+
+	ParallelFor( areas.size(), m_uiThreadCount, [ & ]( const size_t uiArea )
+	{
+		ComputeHidingSpots( uiArea, spots[ uiArea ] );
+	} );
+
+	//Assign IDs in area order, like the game does when it analyzes areas one at a time.
+	unsigned int uiNextID = 1;
+
+	m_HidingSpots.clear();
+
+	for( size_t uiArea = 0; uiArea < areas.size(); ++uiArea )
+	{
+		areas[ uiArea ].hidingSpots = std::move( spots[ uiArea ] );
+
+		for( auto& spot : areas[ uiArea ].hidingSpots )
+		{
+			spot.uiID = uiNextID++;
+			m_HidingSpots.push_back( &spot );
+		}
+	}
+
+	return m_HidingSpots.size();
+}
+
+size_t CNavAnalyzer::ComputeSniperSpots()
+{
+	ParallelFor( m_HidingSpots.size(), m_uiThreadCount, [ & ]( const size_t uiSpot )
+	{
+		ClassifySniperSpot( *m_HidingSpots[ uiSpot ] );
+	} );
+
+	size_t uiCount = 0;
+
+	for( const auto pSpot : m_HidingSpots )
+	{
+		if( pSpot->flags & ( HidingSpot::GOOD_SNIPER_SPOT | HidingSpot::IDEAL_SNIPER_SPOT ) )
+			++uiCount;
+	}
+
+	return uiCount;
+}
+
+size_t CNavAnalyzer::ComputeSpotEncounters()
+{
+	auto& areas = m_Mesh.GetAreas();
+
+	ParallelFor( areas.size(), m_uiThreadCount,
+		[ this, &areas, markers = std::vector<unsigned int>( m_HidingSpots.size(), 0 ), uiMarker = 0u ]( const size_t uiArea ) mutable
+	{
+		auto& area = areas[ uiArea ];
+
+		area.encounters.clear();
+
+		//For every path through this area.
+		for( int iFromDir = 0; iFromDir < NUM_DIRECTIONS; ++iFromDir )
+		{
+			const auto& fromConnections = area.connections[ iFromDir ];
+
+			for( size_t uiFrom = 0; uiFrom < fromConnections.size(); ++uiFrom )
+			{
+				for( int iToDir = 0; iToDir < NUM_DIRECTIONS; ++iToDir )
+				{
+					const auto& toConnections = area.connections[ iToDir ];
+
+					for( size_t uiTo = 0; uiTo < toConnections.size(); ++uiTo )
+					{
+						if( iFromDir == iToDir && uiFrom == uiTo )
+							continue;
+
+						AddSpotEncounters( uiArea,
+							fromConnections[ uiFrom ], static_cast<DirType>( iFromDir ),
+							toConnections[ uiTo ], static_cast<DirType>( iToDir ),
+							markers, ++uiMarker );
+					}
+				}
+			}
+		}
+	} );
+
+	size_t uiCount = 0;
+
+	for( const auto& area : areas )
+	{
+		uiCount += area.encounters.size();
+	}
+
+	return uiCount;
+}
+
+size_t CNavAnalyzer::ComputeApproachAreas()
+{
+	auto& areas = m_Mesh.GetAreas();
+
+	//Paths are found to every area that's at least this large in both directions.
+	const float flMinSize = 200.0f;
+
+	std::vector<size_t> farAreas;
+
+	for( size_t uiArea = 0; uiArea < areas.size(); ++uiArea )
+	{
+		const auto& area = areas[ uiArea ];
+
+		if( area.vecHi.x - area.vecLo.x >= flMinSize && area.vecHi.y - area.vecLo.y >= flMinSize )
+			farAreas.push_back( uiArea );
+	}
+
+	std::vector<std::vector<ApproachInfo>> approaches( areas.size() );
+
+	//Not vector<bool>, threads write to it concurrently.
+	std::vector<unsigned char> complete( areas.size() );
+
+	ParallelFor( areas.size(), m_uiThreadCount,
+		[ this, &farAreas, &approaches, &complete, search = CPathSearch( areas ) ]( const size_t uiArea ) mutable
+	{
+		complete[ uiArea ] = ComputeApproachAreas( uiArea, farAreas, search, approaches[ uiArea ] );
+	} );
+
+	//Stored in area order, so warnings come out in the same order as the game's.
+	size_t uiCount = 0;
+
+	for( size_t uiArea = 0; uiArea < areas.size(); ++uiArea )
+	{
+		if( !complete[ uiArea ] )
+			printf( "Overflow computing approach areas for area #%u.\n", areas[ uiArea ].uiID );
+
+		areas[ uiArea ].approaches = std::move( approaches[ uiArea ] );
+
+		uiCount += areas[ uiArea ].approaches.size();
+	}
+
+	return uiCount;
+}
+
+bool CNavAnalyzer::GetGroundHeight( const Vector& vecPos, float& flHeight ) const
+{
+	const Vector vecTo( vecPos.x, vecPos.y, vecPos.z - 9999.9f );
+
+	const float flMaxOffset = 100.0f;
+	const float flInc = 10.0f;
+
+	const int MAX_GROUND_LAYERS = 16;
+
+	float flLayers[ MAX_GROUND_LAYERS ];
+	int iLayerCount = 0;
+
+	for( float flOffset = 1.0f; flOffset < flMaxOffset; flOffset += flInc )
+	{
+		bsp::HullTrace tr;
+
+		m_Hulls.Trace( vecPos + Vector( 0, 0, flOffset ), vecTo, tr );
+
+		//If we didn't start inside a solid area, the trace hit a ground layer.
+		if( tr.bStartSolid )
+			continue;
+
+		if( iLayerCount == 0 || tr.vecEndPos.z > flLayers[ iLayerCount - 1 ] )
+		{
+			flLayers[ iLayerCount++ ] = tr.vecEndPos.z;
+
+			if( iLayerCount == MAX_GROUND_LAYERS )
+				break;
+		}
+	}
+
+	if( iLayerCount == 0 )
+		return false;
+
+	//Find the lowest layer that allows a player to stand or crouch upon it.
+	int iLayer = 0;
+
+	for( ; iLayer < iLayerCount - 1; ++iLayer )
+	{
+		if( flLayers[ iLayer + 1 ] - flLayers[ iLayer ] >= HalfHumanHeight )
+			break;
+	}
+
+	flHeight = flLayers[ iLayer ];
+
+	return true;
+}
+
+bool CNavAnalyzer::IsAreaVisible( const Vector& vecEye, const Area& area ) const
+{
+	for( int iCorner = 0; iCorner < NUM_CORNERS; ++iCorner )
+	{
+		const Vector vecCorner = area.GetCorner( static_cast<CornerType>( iCorner ) ) + Vector( 0, 0, 0.75f * HumanHeight );
+
+		if( IsLineClear( vecEye, vecCorner ) )
+			return true;
+	}
+
+	return false;
+}
+
+bool CNavAnalyzer::IsLineClear( const Vector& vecStart, const Vector& vecEnd ) const
+{
+	bsp::HullTrace tr;
+
+	m_Hulls.Trace( vecStart, vecEnd, tr );
+
+	return tr.flFraction == 1.0f;
+}
+
+bool CNavAnalyzer::IsHidingSpotInCover( const Vector& vecSpot ) const
+{
+	const Vector vecFrom = vecSpot + Vector( 0, 0, HalfHumanHeight );
+
+	//If we are crouched underneath something, that counts as good cover.
+	if( !IsLineClear( vecFrom, vecFrom + Vector( 0, 0, 20.0f ) ) )
+		return true;
+
+	const float flCoverRange = 100.0f;
+	const float flInc = M_PI / 8.0f;
+
+	int iCoverCount = 0;
+
+	for( float flAngle = 0.0f; flAngle < 2.0f * M_PI; flAngle += flInc )
+	{
+		const Vector vecTo = vecFrom + Vector( flCoverRange * cos( flAngle ), flCoverRange * sin( flAngle ), HalfHumanHeight );
+
+		if( !IsLineClear( vecFrom, vecTo ) )
+			++iCoverCount;
+	}
+
+	//If more than half of the circle has no cover, the spot is not in cover.
+	return iCoverCount >= 8;
+}
+
+void CNavAnalyzer::ComputeHidingSpots( const size_t uiArea, std::vector<HidingSpot>& spots ) const
+{
+	const auto& areas = m_Mesh.GetAreas();
+	const auto& area = areas[ uiArea ];
+
+	//Jump areas cannot have hiding spots.
+	if( area.attributeFlags & NAV_JUMP )
+		return;
+
+	int cornerCount[ NUM_CORNERS ] = {};
+
+	const float flCornerSize = 20.0f;
+
+	//For each direction, find the extents of adjacent areas along the wall.
+	for( int iDir = 0; iDir < NUM_DIRECTIONS; ++iDir )
+	{
+		float flLo = 999999.9f;
+		float flHi = -999999.9f;
+
+		const bool bIsHoriz = iDir == NORTH || iDir == SOUTH;
+
+		for( const auto uiOther : area.connections[ iDir ] )
+		{
+			const auto& other = areas[ uiOther ];
+
+			//One way connections are drops that may mean cover, ignore them.
+			if( !other.IsConnected( uiArea, OppositeDirection( static_cast<DirType>( iDir ) ) ) )
+				continue;
+
+			if( other.attributeFlags & NAV_JUMP )
+				continue;
+
+			flLo = std::min( flLo, bIsHoriz ? other.vecLo.x : other.vecLo.y );
+			flHi = std::max( flHi, bIsHoriz ? other.vecHi.x : other.vecHi.y );
+		}
+
+		switch( iDir )
+		{
+		case NORTH:
+			if( flLo - area.vecLo.x >= flCornerSize )
+				++cornerCount[ NORTH_WEST ];
+
+			if( area.vecHi.x - flHi >= flCornerSize )
+				++cornerCount[ NORTH_EAST ];
+			break;
+
+		case SOUTH:
+			if( flLo - area.vecLo.x >= flCornerSize )
+				++cornerCount[ SOUTH_WEST ];
+
+			if( area.vecHi.x - flHi >= flCornerSize )
+				++cornerCount[ SOUTH_EAST ];
+			break;
+
+		case EAST:
+			if( flLo - area.vecLo.y >= flCornerSize )
+				++cornerCount[ NORTH_EAST ];
+
+			if( area.vecHi.y - flHi >= flCornerSize )
+				++cornerCount[ SOUTH_EAST ];
+			break;
+
+		case WEST:
+			if( flLo - area.vecLo.y >= flCornerSize )
+				++cornerCount[ NORTH_WEST ];
+
+			if( area.vecHi.y - flHi >= flCornerSize )
+				++cornerCount[ SOUTH_WEST ];
+			break;
+		}
+	}
+
+	//If a corner count is 2, then it really is a corner (walls on both sides).
+	const float flOffset = 12.5f;
+
+	const Vector offsets[ NUM_CORNERS ] =
+	{
+		Vector( flOffset, flOffset, 0.0f ),
+		Vector( -flOffset, flOffset, 0.0f ),
+		Vector( -flOffset, -flOffset, 0.0f ),
+		Vector( flOffset, -flOffset, 0.0f )
+	};
+
+	//Same order as the game.
+	const CornerType corners[ NUM_CORNERS ] = { NORTH_WEST, NORTH_EAST, SOUTH_WEST, SOUTH_EAST };
+
+	const float flCollisionRange = 30.0f;
+
+	for( const auto corner : corners )
+	{
+		if( cornerCount[ corner ] != 2 )
+			continue;
+
+		const Vector vecPos = area.GetCorner( corner ) + offsets[ corner ];
+
+		bool bCollides = false;
+
+		for( const auto& spot : spots )
+		{
+			if( ( spot.vecPos - vecPos ).Length() < flCollisionRange )
+			{
+				bCollides = true;
+				break;
+			}
+		}
+
+		if( !bCollides )
+			spots.push_back( { 0, vecPos, static_cast<unsigned char>( IsHidingSpotInCover( vecPos ) ? HidingSpot::IN_COVER : 0 ) } );
+	}
+}
+
+void CNavAnalyzer::ClassifySniperSpot( HidingSpot& spot ) const
+{
+	//Assume we are crouching.
+	const Vector vecEye = spot.vecPos + Vector( 0, 0, HalfHumanHeight );
+
+	const float flStepSize = 25.0f;
+	const float flMinSniperRangeSq = 1000.0f * 1000.0f;
+
+	Vector vecSniperLo, vecSniperHi;
+	float flFarthestRangeSq = 0.0f;
+	bool bFound = false;
+
+	for( const auto& area : m_Mesh.GetAreas() )
+	{
+		Vector vecWalkable;
+
+		for( vecWalkable.y = area.vecLo.y + flStepSize / 2.0f; vecWalkable.y < area.vecHi.y; vecWalkable.y += flStepSize )
+		{
+			for( vecWalkable.x = area.vecLo.x + flStepSize / 2.0f; vecWalkable.x < area.vecHi.x; vecWalkable.x += flStepSize )
+			{
+				vecWalkable.z = area.GetZ( vecWalkable.x, vecWalkable.y ) + HalfHumanHeight;
+
+				const float flRangeSq = DotProduct( vecEye - vecWalkable, vecEye - vecWalkable );
+
+				//Only spots that are farther away than any we can already see matter.
+				if( flRangeSq <= flFarthestRangeSq )
+					continue;
+
+				bsp::HullTrace tr;
+
+				m_Hulls.Trace( vecEye, vecWalkable, tr );
+
+				if( tr.flFraction != 1.0f || tr.bStartSolid )
+					continue;
+
+				flFarthestRangeSq = flRangeSq;
+
+				if( flRangeSq < flMinSniperRangeSq )
+					continue;
+
+				//This is a sniper spot. Determine how good it is by keeping track of the snipable area.
+				if( bFound )
+				{
+					vecSniperLo.x = std::min( vecSniperLo.x, vecWalkable.x );
+					vecSniperHi.x = std::max( vecSniperHi.x, vecWalkable.x );
+					vecSniperLo.y = std::min( vecSniperLo.y, vecWalkable.y );
+					vecSniperHi.y = std::max( vecSniperHi.y, vecWalkable.y );
+				}
+				else
+				{
+					vecSniperLo = vecWalkable;
+					vecSniperHi = vecWalkable;
+					bFound = true;
+				}
+			}
+		}
+	}
+
+	if( !bFound )
+		return;
+
+	//If we can see a large snipable area, it is an ideal spot.
+	const float flSnipableArea = ( vecSniperHi.x - vecSniperLo.x ) * ( vecSniperHi.y - vecSniperLo.y );
+
+	const float flMinIdealSniperArea = 200.0f * 200.0f;
+	const float flLongSniperRangeSq = 1500.0f * 1500.0f;
+
+	if( flSnipableArea >= flMinIdealSniperArea || flFarthestRangeSq >= flLongSniperRangeSq )
+		spot.flags |= HidingSpot::IDEAL_SNIPER_SPOT;
+	else
+		spot.flags |= HidingSpot::GOOD_SNIPER_SPOT;
+}
+
+void CNavAnalyzer::AddSpotEncounters( const size_t uiArea, const size_t uiFrom, const DirType fromDir, const size_t uiTo, const DirType toDir,
+									  std::vector<unsigned int>& markers, const unsigned int uiMarker )
+{
+	auto& areas = m_Mesh.GetAreas();
+	auto& area = areas[ uiArea ];
+	const auto& from = areas[ uiFrom ];
+	const auto& to = areas[ uiTo ];
+
+	SpotEncounter encounter;
+
+	encounter.uiFromID = from.uiID;
+	encounter.fromDir = static_cast<unsigned char>( fromDir );
+	encounter.uiToID = to.uiID;
+	encounter.toDir = static_cast<unsigned char>( toDir );
+
+	const float flEyeHeight = HalfHumanHeight;
+
+	Vector vecPathFrom, vecPathTo;
+
+	area.ComputePortal( to, toDir, vecPathTo );
+	area.ComputePortal( from, fromDir, vecPathFrom );
+
+	vecPathFrom.z = from.GetZ( vecPathFrom.x, vecPathFrom.y ) + flEyeHeight;
+	vecPathTo.z = to.GetZ( vecPathTo.x, vecPathTo.y ) + flEyeHeight;
+
+	//Step along the path and track which spots can be seen.
+	Vector vecDir = vecPathTo - vecPathFrom;
+	const float flLength = vecDir.NormalizeInPlace();
+
+	const float flStepSize = 25.0f;
+	const float flSeeSpotRange = 2000.0f;
+
+	bool bDone = false;
+
+	for( float flAlong = 0.0f; !bDone; flAlong += flStepSize )
+	{
+		//Make sure we check the endpoint of the path segment.
+		if( flAlong >= flLength )
+		{
+			flAlong = flLength;
+			bDone = true;
+		}
+
+		const Vector vecEye = vecPathFrom + flAlong * vecDir;
+
+		for( size_t uiSpot = 0; uiSpot < m_HidingSpots.size(); ++uiSpot )
+		{
+			const auto& spot = *m_HidingSpots[ uiSpot ];
+
+			//Only look at spots with cover, the others are out in the open and easily seen.
+			if( !( spot.flags & HidingSpot::IN_COVER ) )
+				continue;
+
+			if( markers[ uiSpot ] == uiMarker )
+				continue;
+
+			const Vector vecSpotEye = spot.vecPos + Vector( 0, 0, flEyeHeight );
+
+			Vector vecDelta = vecSpotEye - vecEye;
+
+			if( vecDelta.Length() > flSeeSpotRange )
+				continue;
+
+			if( !IsLineClear( vecEye, vecSpotEye ) )
+				continue;
+
+			//Only keep spots that become visible as we walk past them, so skip all spots that are visible at the start of the path.
+			vecDelta.NormalizeInPlace();
+			const float flDot = DotProduct( vecDir, vecDelta );
+
+			if( flDot < 0.7071f && flDot > -0.7071f && flAlong > 0.0f )
+				encounter.spots.push_back( { spot.uiID, flAlong / flLength } );
+
+			markers[ uiSpot ] = uiMarker;
+		}
+	}
+
+	area.encounters.push_back( std::move( encounter ) );
+}
+bool CNavAnalyzer::ComputeApproachAreas( const size_t uiArea, const std::vector<size_t>& farAreas, CPathSearch& search, std::vector<ApproachInfo>& approaches ) const
+{
+	const auto& areas = m_Mesh.GetAreas();
+	const auto& area = areas[ uiArea ];
+
+	//Use the center of the area as the view point.
+	Vector vecEye = area.GetCenter();
+
+	if( !GetGroundHeight( vecEye, vecEye.z ) )
+		return true;
+
+	vecEye.z += ( area.attributeFlags & NAV_CROUCH ) ? 0.9f * HalfHumanHeight : 0.9f * HumanHeight;
+
+	const size_t MAX_PATH_LENGTH = 256;
+	const size_t MAX_BLOCKED_AREAS = 256;
+
+	size_t path[ MAX_PATH_LENGTH ];
+
+	std::vector<size_t> blocked;
+
+	//Find paths to every far away area and keep the union of the approach areas found on them.
+	for( const auto uiFar : farAreas )
+	{
+		blocked.clear();
+
+		//If we can see the far area, try again. The whole point is to go around the bend.
+		if( IsAreaVisible( vecEye, areas[ uiFar ] ) )
+			continue;
+
+		if( !search.BuildPath( uiArea, uiFar, blocked ) )
+			continue;
+
+		//Keep building paths to the far area and blocking them off until we can't path there any more.
+		//As areas are blocked off, all exits will be enumerated.
+		while( approaches.size() < MAX_APPROACH_AREAS )
+		{
+			size_t uiCount = 0;
+
+			for( size_t uiPathArea = uiFar; uiPathArea != INVALID_AREA; uiPathArea = search.GetParent( uiPathArea ) )
+			{
+				++uiCount;
+			}
+
+			if( uiCount > MAX_PATH_LENGTH )
+				uiCount = MAX_PATH_LENGTH;
+
+			//Build the path in order, from the eye outwards.
+			size_t i = uiCount;
+
+			for( size_t uiPathArea = uiFar; i && uiPathArea != INVALID_AREA; uiPathArea = search.GetParent( uiPathArea ) )
+			{
+				path[ --i ] = uiPathArea;
+			}
+
+			bool bBlocked = false;
+
+			//Find the first area on the path that we can't see, skipping the first area.
+			for( i = 1; i < uiCount; ++i )
+			{
+				if( IsAreaVisible( vecEye, areas[ path[ i ] ] ) )
+					continue;
+
+				//Mark this area as blocked and unusable by later paths.
+				if( blocked.size() == MAX_BLOCKED_AREAS )
+					return false;
+
+				//If the area to block is the far area, block the one before it. Blocking the far area makes all later paths fail.
+				const size_t uiBlock = path[ i ] == uiFar ? i - 1 : i;
+
+				blocked.push_back( path[ uiBlock ] );
+				bBlocked = true;
+
+				if( uiBlock == 0 )
+					break;
+
+				const size_t uiHere = path[ uiBlock - 1 ];
+
+				const auto it = std::find_if( approaches.begin(), approaches.end(), [ & ]( const ApproachInfo& approach )
+				{
+					return approach.uiHereID == areas[ uiHere ].uiID;
+				} );
+
+				if( it == approaches.end() )
+				{
+					ApproachInfo approach;
+
+					approach.uiPrevID = uiBlock >= 2 ? areas[ path[ uiBlock - 2 ] ].uiID : 0;
+
+					approach.uiHereID = areas[ uiHere ].uiID;
+					approach.prevToHereHow = search.GetParentHow( uiHere );
+
+					approach.uiNextID = areas[ path[ uiBlock ] ].uiID;
+					approach.hereToNextHow = search.GetParentHow( path[ uiBlock ] );
+
+					approaches.push_back( approach );
+				}
+
+				break;
+			}
+
+			//The game would find the same path again forever if every area on it can be seen.
+			if( !bBlocked )
+				break;
+
+			//Can't find a path to the far area, all exits have been found and blocked.
+			if( !search.BuildPath( uiArea, uiFar, blocked ) )
+				break;
+		}
+	}
+
+	return true;
+}
+}
@@ -0,0 +1,109 @@
+#ifndef UTILS_NAVANALYZE_NAVANALYSIS_H
+#define UTILS_NAVANALYZE_NAVANALYSIS_H
+
+#include "NavMesh.h"
+
+namespace bsp
+{
+class CClipHulls;
+}
+
+namespace nav
+{
+class CPathSearch;
+
+/**
+*	Runs the per area analysis passes from game_shared/bot/nav_area.cpp on a thread pool.
+*	Each pass only writes to the area or spot it's working on, and hiding spot IDs are assigned in area order once all spots are found,
+*	so the results don't depend on the number of threads.
+*/
+class CNavAnalyzer final
+{
+public:
+	/**
+	*	@param uiThreadCount Number of worker threads to use. Must be at least 1.
+	*/
+	CNavAnalyzer( CNavMesh& mesh, const bsp::CClipHulls& hulls, const unsigned int uiThreadCount );
+	~CNavAnalyzer() = default;
+
+	/**
+	*	Replaces the hiding spots of every area. Spots are placed in corners with walls on both sides.
+	*	@return Number of hiding spots.
+	*/
+	size_t ComputeHidingSpots();
+
+	/**
+	*	Flags hiding spots that can see far, or see a large walkable area.
+	*	@return Number of sniper spots.
+	*/
+	size_t ComputeSniperSpots();
+
+	/**
+	*	Replaces the encounter spots of every area. These are the spots to look at on each path through an area,
+	*	in the order in which they become visible.
+	*	@return Number of encounter paths.
+	*/
+	size_t ComputeSpotEncounters();
+
+	/**
+	*	Replaces the approach areas of every area. These are the areas through which players move into or out of the areas around an area.
+	*	Ladders aren't stored in .nav files, so the paths used to find them only follow floor connections.
+	*	@return Number of approach areas.
+	*/
+	size_t ComputeApproachAreas();
+
+private:
+	/**
+	*	@return Whether a line from vecStart to vecEnd doesn't hit the world.
+	*/
+	bool IsLineClear( const Vector& vecStart, const Vector& vecEnd ) const;
+
+	/**
+	*	Finds the height of the lowest ground below the given point that a player can stand or crouch on.
+	*	@return Whether there is any ground.
+	*/
+	bool GetGroundHeight( const Vector& vecPos, float& flHeight ) const;
+
+	/**
+	*	@return Whether any corner of the area can be seen from the given point.
+	*/
+	bool IsAreaVisible( const Vector& vecEye, const Area& area ) const;
+
+	bool IsHidingSpotInCover( const Vector& vecSpot ) const;
+
+	void ComputeHidingSpots( const size_t uiArea, std::vector<HidingSpot>& spots ) const;
+
+	void ClassifySniperSpot( HidingSpot& spot ) const;
+
+	/**
+	*	Adds the encounter spots for the path between two areas adjacent to the given area.
+	*	@param markers Per spot markers used to add each spot only once.
+	*	@param uiMarker Marker value for this path.
+	*/
+	void AddSpotEncounters( const size_t uiArea, const size_t uiFrom, const DirType fromDir, const size_t uiTo, const DirType toDir,
+							std::vector<unsigned int>& markers, const unsigned int uiMarker );
+
+	/**
+	*	Computes the approach areas of a single area.
+	*	@param farAreas Areas to find paths to.
+	*	@return Whether all paths could be blocked. If not, approaches holds the areas found so far.
+	*/
+	bool ComputeApproachAreas( const size_t uiArea, const std::vector<size_t>& farAreas, CPathSearch& search, std::vector<ApproachInfo>& approaches ) const;
+
+private:
+	CNavMesh& m_Mesh;
+	const bsp::CClipHulls& m_Hulls;
+	const unsigned int m_uiThreadCount;
+
+	/**
+	*	All hiding spots, in ID order.
+	*/
+	std::vector<HidingSpot*> m_HidingSpots;
+
+private:
+	CNavAnalyzer( const CNavAnalyzer& ) = delete;
+	CNavAnalyzer& operator=( const CNavAnalyzer& ) = delete;
+};
+}
+
+#endif //UTILS_NAVANALYZE_NAVANALYSIS_H
@@ -0,0 +1,460 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+#include "NavMesh.h"
+
+namespace nav
+{
+namespace
+{
+/**
+*	Reads values from a file that has been loaded into memory.
+*/
+class CReader final
+{
+public:
+	CReader( const std::vector<uint8_t>& data )
+		: m_Data( data )
+	{
+	}
+
+	bool IsValid() const { return m_bValid; }
+
+	bool Read( void* pDest, const size_t uiSize )
+	{
+		if( !m_bValid || m_Data.size() - m_uiOffset < uiSize )
+		{
+			m_bValid = false;
+			return false;
+		}
+
+		memcpy( pDest, m_Data.data() + m_uiOffset, uiSize );
+		m_uiOffset += uiSize;
+
+		return true;
+	}
+
+	template<typename T>
+	T Read()
+	{
+		T value{};
+		Read( &value, sizeof( value ) );
+		return value;
+	}
+
+	Vector ReadVector()
+	{
+		float flValues[ 3 ] = {};
+		Read( flValues, sizeof( flValues ) );
+		return Vector( flValues[ 0 ], flValues[ 1 ], flValues[ 2 ] );
+	}
+
+private:
+	const std::vector<uint8_t>& m_Data;
+	size_t m_uiOffset = 0;
+	bool m_bValid = true;
+};
+
+/**
+*	Buffers a file's contents before writing them out in one go.
+*/
+class CWriter final
+{
+public:
+	void Write( const void* pSource, const size_t uiSize )
+	{
+		const auto pBytes = reinterpret_cast<const uint8_t*>( pSource );
+		m_Data.insert( m_Data.end(), pBytes, pBytes + uiSize );
+	}
+
+	template<typename T>
+	void Write( const T value )
+	{
+		Write( &value, sizeof( value ) );
+	}
+
+	void WriteVector( const Vector& vec )
+	{
+		const float flValues[ 3 ] = { vec.x, vec.y, vec.z };
+		Write( flValues, sizeof( flValues ) );
+	}
+
+	const std::vector<uint8_t>& GetData() const { return m_Data; }
+
+private:
+	std::vector<uint8_t> m_Data;
+};
+
+bool LoadFile( const char* const pszFileName, std::vector<uint8_t>& data )
+{
+	FILE* pFile = fopen( pszFileName, "rb" );
+
+	if( !pFile )
+		return false;
+
+	fseek( pFile, 0, SEEK_END );
+	const long iSize = ftell( pFile );
+	fseek( pFile, 0, SEEK_SET );
+
+	bool bSuccess = iSize >= 0;
+
+	if( bSuccess )
+	{
+		data.resize( iSize );
+		bSuccess = fread( data.data(), 1, data.size(), pFile ) == data.size();
+	}
+
+	fclose( pFile );
+
+	return bSuccess;
+}
+}
+
+float Area::GetZ( const float x, const float y ) const
+{
+	const float dx = vecHi.x - vecLo.x;
+	const float dy = vecHi.y - vecLo.y;
+
+	//Guard against division by zero due to degenerate areas.
+	if( dx == 0 || dy == 0 )
+		return flNEZ;
+
+	const float u = std::min( 1.0f, std::max( 0.0f, ( x - vecLo.x ) / dx ) );
+	const float v = std::min( 1.0f, std::max( 0.0f, ( y - vecLo.y ) / dy ) );
+
+	const float flNorthZ = vecLo.z + u * ( flNEZ - vecLo.z );
+	const float flSouthZ = flSWZ + u * ( vecHi.z - flSWZ );
+
+	return flNorthZ + v * ( flSouthZ - flNorthZ );
+}
+
+Vector Area::GetCorner( const CornerType corner ) const
+{
+	switch( corner )
+	{
+	default:
+	case NORTH_WEST:	return vecLo;
+	case NORTH_EAST:	return Vector( vecHi.x, vecLo.y, flNEZ );
+	case SOUTH_WEST:	return Vector( vecLo.x, vecHi.y, flSWZ );
+	case SOUTH_EAST:	return vecHi;
+	}
+}
+
+void Area::ComputePortal( const Area& to, const DirType dir, Vector& vecCenter ) const
+{
+	//Clamped to our extent in case the areas are disjoint.
+	if( dir == NORTH || dir == SOUTH )
+	{
+		vecCenter.y = dir == NORTH ? vecLo.y : vecHi.y;
+
+		const float flLeft = std::min( vecHi.x, std::max( vecLo.x, std::max( vecLo.x, to.vecLo.x ) ) );
+		const float flRight = std::min( vecHi.x, std::max( vecLo.x, std::min( vecHi.x, to.vecHi.x ) ) );
+
+		vecCenter.x = ( flLeft + flRight ) / 2.0f;
+	}
+	else
+	{
+		vecCenter.x = dir == WEST ? vecLo.x : vecHi.x;
+
+		const float flTop = std::min( vecHi.y, std::max( vecLo.y, std::max( vecLo.y, to.vecLo.y ) ) );
+		const float flBottom = std::min( vecHi.y, std::max( vecLo.y, std::min( vecHi.y, to.vecHi.y ) ) );
+
+		vecCenter.y = ( flTop + flBottom ) / 2.0f;
+	}
+}
+
+bool Area::IsConnected( const size_t uiArea, const DirType dir ) const
+{
+	const auto& connected = connections[ dir ];
+
+	return std::find( connected.begin(), connected.end(), uiArea ) != connected.end();
+}
+
+bool CNavMesh::Load( const char* const pszFileName )
+{
+	m_Places.clear();
+	m_Areas.clear();
+
+	std::vector<uint8_t> data;
+
+	if( !LoadFile( pszFileName, data ) )
+	{
+		printf( "Couldn't read nav file \"%s\"\n", pszFileName );
+		return false;
+	}
+
+	CReader reader( data );
+
+	if( reader.Read<unsigned int>() != MAGIC_NUMBER )
+	{
+		printf( "\"%s\" is not a nav file\n", pszFileName );
+		return false;
+	}
+
+	const auto uiVersion = reader.Read<unsigned int>();
+
+	if( uiVersion < MIN_FILE_VERSION || uiVersion > FILE_VERSION )
+	{
+		printf( "Nav file \"%s\" has unsupported version %u (must be %u to %u)\n", pszFileName, uiVersion, MIN_FILE_VERSION, FILE_VERSION );
+		return false;
+	}
+
+	//Size of the BSP when the file was saved. Replaced when saving.
+	reader.Read<unsigned int>();
+
+	if( uiVersion >= 5 )
+	{
+		const auto uiPlaceCount = reader.Read<unsigned short>();
+
+		m_Places.reserve( uiPlaceCount );
+
+		char szName[ 256 ];
+
+		for( unsigned int uiPlace = 0; uiPlace < uiPlaceCount && reader.IsValid(); ++uiPlace )
+		{
+			const auto uiLength = reader.Read<unsigned short>();
+
+			if( uiLength == 0 || uiLength > sizeof( szName ) || !reader.Read( szName, uiLength ) )
+			{
+				printf( "Nav file \"%s\" has an invalid place directory\n", pszFileName );
+				return false;
+			}
+
+			szName[ uiLength - 1 ] = '\0';
+
+			m_Places.emplace_back( szName );
+		}
+	}
+
+	const auto uiAreaCount = reader.Read<unsigned int>();
+
+	for( unsigned int uiArea = 0; uiArea < uiAreaCount && reader.IsValid(); ++uiArea )
+	{
+		m_Areas.emplace_back();
+
+		auto& area = m_Areas.back();
+
+		area.uiID = reader.Read<unsigned int>();
+		area.attributeFlags = reader.Read<unsigned char>();
+		area.vecLo = reader.ReadVector();
+		area.vecHi = reader.ReadVector();
+		area.flNEZ = reader.Read<float>();
+		area.flSWZ = reader.Read<float>();
+
+		for( auto& connectIDs : area.connectIDs )
+		{
+			const auto uiCount = reader.Read<unsigned int>();
+
+			for( unsigned int uiConnection = 0; uiConnection < uiCount && reader.IsValid(); ++uiConnection )
+			{
+				connectIDs.push_back( reader.Read<unsigned int>() );
+			}
+		}
+
+		const auto uiSpotCount = reader.Read<unsigned char>();
+
+		for( unsigned int uiSpot = 0; uiSpot < uiSpotCount; ++uiSpot )
+		{
+			HidingSpot spot;
+
+			spot.uiID = reader.Read<unsigned int>();
+			spot.vecPos = reader.ReadVector();
+			spot.flags = reader.Read<unsigned char>();
+
+			area.hidingSpots.push_back( spot );
+		}
+
+		const auto uiApproachCount = reader.Read<unsigned char>();
+
+		for( unsigned int uiApproach = 0; uiApproach < uiApproachCount; ++uiApproach )
+		{
+			ApproachInfo approach;
+
+			approach.uiHereID = reader.Read<unsigned int>();
+			approach.uiPrevID = reader.Read<unsigned int>();
+			approach.prevToHereHow = reader.Read<unsigned char>();
+			approach.uiNextID = reader.Read<unsigned int>();
+			approach.hereToNextHow = reader.Read<unsigned char>();
+
+			area.approaches.push_back( approach );
+		}
+
+		const auto uiEncounterCount = reader.Read<unsigned int>();
+
+		for( unsigned int uiEncounter = 0; uiEncounter < uiEncounterCount && reader.IsValid(); ++uiEncounter )
+		{
+			SpotEncounter encounter;
+
+			encounter.uiFromID = reader.Read<unsigned int>();
+			encounter.fromDir = reader.Read<unsigned char>();
+			encounter.uiToID = reader.Read<unsigned int>();
+			encounter.toDir = reader.Read<unsigned char>();
+
+			const auto uiOrderCount = reader.Read<unsigned char>();
+
+			for( unsigned int uiOrder = 0; uiOrder < uiOrderCount; ++uiOrder )
+			{
+				SpotOrder order;
+
+				order.uiSpotID = reader.Read<unsigned int>();
+				order.t = reader.Read<unsigned char>() / 255.0f;
+
+				encounter.spots.push_back( order );
+			}
+
+			area.encounters.push_back( std::move( encounter ) );
+		}
+
+		area.place = uiVersion >= 5 ? reader.Read<unsigned short>() : 0;
+	}
+
+	if( !reader.IsValid() )
+	{
+		printf( "Nav file \"%s\" is truncated\n", pszFileName );
+		m_Places.clear();
+		m_Areas.clear();
+		return false;
+	}
+
+	//Resolve connections.
+	std::unordered_map<unsigned int, size_t> areaIndices;
+
+	for( size_t uiIndex = 0; uiIndex < m_Areas.size(); ++uiIndex )
+	{
+		areaIndices.emplace( m_Areas[ uiIndex ].uiID, uiIndex );
+	}
+
+	for( auto& area : m_Areas )
+	{
+		for( int iDir = 0; iDir < NUM_DIRECTIONS; ++iDir )
+		{
+			for( const auto uiID : area.connectIDs[ iDir ] )
+			{
+				const auto it = areaIndices.find( uiID );
+
+				if( it != areaIndices.end() )
+					area.connections[ iDir ].push_back( it->second );
+				else
+					printf( "Nav area #%u is connected to missing area #%u\n", area.uiID, uiID );
+			}
+		}
+	}
+
+	return true;
+}
+
+bool CNavMesh::Save( const char* const pszFileName, const unsigned int uiBSPSize ) const
+{
+	CWriter writer;
+
+	writer.Write( MAGIC_NUMBER );
+	writer.Write( FILE_VERSION );
+	writer.Write( uiBSPSize );
+
+	writer.Write( static_cast<unsigned short>( m_Places.size() ) );
+
+	for( const auto& place : m_Places )
+	{
+		const unsigned short uiLength = static_cast<unsigned short>( place.length() + 1 );
+		writer.Write( uiLength );
+		writer.Write( place.c_str(), uiLength );
+	}
+
+	writer.Write( static_cast<unsigned int>( m_Areas.size() ) );
+
+	for( const auto& area : m_Areas )
+	{
+		writer.Write( area.uiID );
+		writer.Write( area.attributeFlags );
+		writer.WriteVector( area.vecLo );
+		writer.WriteVector( area.vecHi );
+		writer.Write( area.flNEZ );
+		writer.Write( area.flSWZ );
+
+		for( const auto& connectIDs : area.connectIDs )
+		{
+			writer.Write( static_cast<unsigned int>( connectIDs.size() ) );
+
+			for( const auto uiID : connectIDs )
+			{
+				writer.Write( uiID );
+			}
+		}
+
+		const size_t uiSpotCount = std::min<size_t>( area.hidingSpots.size(), 255 );
+
+		if( uiSpotCount < area.hidingSpots.size() )
+			printf( "Warning: Nav area #%u: Truncated hiding spot list to 255\n", area.uiID );
+
+		writer.Write( static_cast<unsigned char>( uiSpotCount ) );
+
+		for( size_t uiSpot = 0; uiSpot < uiSpotCount; ++uiSpot )
+		{
+			const auto& spot = area.hidingSpots[ uiSpot ];
+
+			writer.Write( spot.uiID );
+			writer.WriteVector( spot.vecPos );
+			writer.Write( spot.flags );
+		}
+
+		writer.Write( static_cast<unsigned char>( area.approaches.size() ) );
+
+		for( const auto& approach : area.approaches )
+		{
+			writer.Write( approach.uiHereID );
+			writer.Write( approach.uiPrevID );
+			writer.Write( approach.prevToHereHow );
+			writer.Write( approach.uiNextID );
+			writer.Write( approach.hereToNextHow );
+		}
+
+		writer.Write( static_cast<unsigned int>( area.encounters.size() ) );
+
+		for( const auto& encounter : area.encounters )
+		{
+			writer.Write( encounter.uiFromID );
+			writer.Write( encounter.fromDir );
+			writer.Write( encounter.uiToID );
+			writer.Write( encounter.toDir );
+
+			const size_t uiOrderCount = std::min<size_t>( encounter.spots.size(), 255 );
+
+			if( uiOrderCount < encounter.spots.size() )
+				printf( "Warning: Nav area #%u: Truncated encounter spot list to 255\n", area.uiID );
+
+			writer.Write( static_cast<unsigned char>( uiOrderCount ) );
+
+			for( size_t uiOrder = 0; uiOrder < uiOrderCount; ++uiOrder )
+			{
+				const auto& order = encounter.spots[ uiOrder ];
+
+				writer.Write( order.uiSpotID );
+				writer.Write( static_cast<unsigned char>( 255 * order.t ) );
+			}
+		}
+
+		writer.Write( area.place );
+	}
+
+	FILE* pFile = fopen( pszFileName, "wb" );
+
+	if( !pFile )
+	{
+		printf( "Couldn't open \"%s\" for writing\n", pszFileName );
+		return false;
+	}
+
+	const auto& data = writer.GetData();
+
+	const bool bSuccess = fwrite( data.data(), 1, data.size(), pFile ) == data.size();
+
+	fclose( pFile );
+
+	if( !bSuccess )
+		printf( "Couldn't write \"%s\"\n", pszFileName );
+
+	return bSuccess;
+}
+}
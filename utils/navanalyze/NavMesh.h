@@ -0,0 +1,210 @@
+#ifndef UTILS_NAVANALYZE_NAVMESH_H
+#define UTILS_NAVANALYZE_NAVMESH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mathlib.h"
+
+/**
+*	The parts of the bot navigation mesh that the analysis passes need.
+*	The file format and constants match game_shared/bot/nav.h and nav_file.cpp, which can't be used without the engine.
+*/
+namespace nav
+{
+const unsigned int MAGIC_NUMBER = 0xFEEDFACE;
+
+/**
+*	Version written by this tool. Version 4 files can be read, they have no place directory.
+*/
+const unsigned int FILE_VERSION = 5;
+
+const unsigned int MIN_FILE_VERSION = 4;
+
+const float HalfHumanHeight = 36.0f;
+const float HumanHeight = 72.0f;
+
+enum AttributeType
+{
+	NAV_CROUCH = 0x01,
+	NAV_JUMP = 0x02,
+};
+
+enum DirType
+{
+	NORTH = 0,
+	EAST = 1,
+	SOUTH = 2,
+	WEST = 3,
+
+	NUM_DIRECTIONS
+};
+
+enum CornerType
+{
+	NORTH_WEST = 0,
+	NORTH_EAST = 1,
+	SOUTH_EAST = 2,
+	SOUTH_WEST = 3,
+
+	NUM_CORNERS
+};
+
+/**
+*	How an area is entered from another area. The first 4 match DirType.
+*/
+enum TraverseType
+{
+	GO_NORTH = 0,
+	GO_EAST,
+	GO_SOUTH,
+	GO_WEST,
+	GO_LADDER_UP,
+	GO_LADDER_DOWN,
+	GO_JUMP,
+
+	NUM_TRAVERSE_TYPES
+};
+
+const size_t MAX_APPROACH_AREAS = 16;
+
+inline DirType OppositeDirection( const DirType dir )
+{
+	return static_cast<DirType>( ( dir + 2 ) % NUM_DIRECTIONS );
+}
+
+struct HidingSpot final
+{
+	enum
+	{
+		IN_COVER			= 0x01,
+		GOOD_SNIPER_SPOT	= 0x02,
+		IDEAL_SNIPER_SPOT	= 0x04
+	};
+
+	unsigned int uiID;
+	Vector vecPos;
+	unsigned char flags;
+};
+
+struct SpotOrder final
+{
+	unsigned int uiSpotID;
+
+	/**
+	*	Parametric distance along the path where the spot first becomes visible.
+	*/
+	float t;
+};
+
+struct SpotEncounter final
+{
+	unsigned int uiFromID;
+	unsigned char fromDir;
+	unsigned int uiToID;
+	unsigned char toDir;
+
+	std::vector<SpotOrder> spots;
+};
+
+/**
+*	An area through which players move into or out of the areas around an area.
+*	Areas are referred to by ID, 0 if there is none.
+*/
+struct ApproachInfo final
+{
+	unsigned int uiHereID;
+
+	unsigned int uiPrevID;
+	unsigned char prevToHereHow;
+
+	unsigned int uiNextID;
+	unsigned char hereToNextHow;
+};
+
+struct Area final
+{
+	unsigned int uiID;
+	unsigned char attributeFlags;
+
+	Vector vecLo, vecHi;
+	float flNEZ, flSWZ;
+
+	/**
+	*	IDs of connected areas in each direction, as stored in the file.
+	*/
+	std::vector<unsigned int> connectIDs[ NUM_DIRECTIONS ];
+
+	/**
+	*	Indices of connected areas in each direction. Connections to missing areas are left out.
+	*/
+	std::vector<size_t> connections[ NUM_DIRECTIONS ];
+
+	std::vector<HidingSpot> hidingSpots;
+
+	std::vector<ApproachInfo> approaches;
+
+	std::vector<SpotEncounter> encounters;
+
+	unsigned short place;
+
+	/**
+	*	@return Z of the area at the given x and y, interpolated between its corners.
+	*/
+	float GetZ( const float x, const float y ) const;
+
+	Vector GetCenter() const { return ( vecLo + vecHi ) / 2.0f; }
+
+	/**
+	*	@return Position of the given corner.
+	*/
+	Vector GetCorner( const CornerType corner ) const;
+
+	/**
+	*	Computes the center of the opening to an adjacent area. The center's Z is left unset.
+	*/
+	void ComputePortal( const Area& to, const DirType dir, Vector& vecCenter ) const;
+
+	/**
+	*	@return Whether the given area is connected to this one in the given direction.
+	*/
+	bool IsConnected( const size_t uiArea, const DirType dir ) const;
+};
+
+/**
+*	A loaded .nav file.
+*/
+class CNavMesh final
+{
+public:
+	CNavMesh() = default;
+	~CNavMesh() = default;
+
+	/**
+	*	Loads a .nav file. Any previously loaded mesh is discarded.
+	*	@return Whether the file could be loaded.
+	*/
+	bool Load( const char* const pszFileName );
+
+	/**
+	*	Saves the mesh as a version FILE_VERSION .nav file.
+	*	@param uiBSPSize Size of the BSP file the mesh was analyzed against. Used by the game to detect out of date meshes.
+	*/
+	bool Save( const char* const pszFileName, const unsigned int uiBSPSize ) const;
+
+	std::vector<Area>& GetAreas() { return m_Areas; }
+	const std::vector<Area>& GetAreas() const { return m_Areas; }
+
+private:
+	std::vector<std::string> m_Places;
+
+	std::vector<Area> m_Areas;
+
+private:
+	CNavMesh( const CNavMesh& ) = delete;
+	CNavMesh& operator=( const CNavMesh& ) = delete;
+};
+}
+
+#endif //UTILS_NAVANALYZE_NAVMESH_H
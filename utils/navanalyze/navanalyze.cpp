@@ -0,0 +1,106 @@
+/**
+*	Runs the bot navigation analysis passes on an existing .nav file, without the game.
+*	Usage: navanalyze [-threads <count>] [-out <nav file>] <bsp file> <nav file>
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "CClipHulls.h"
+#include "CStopwatch.h"
+
+#include "NavAnalysis.h"
+#include "NavMesh.h"
+
+namespace
+{
+void PrintUsage()
+{
+	printf( "Usage: navanalyze [-threads <count>] [-out <nav file>] <bsp file> <nav file>\n"
+			"Recomputes the hiding spots, sniper spots, encounter spots and approach areas of a nav file.\n"
+			"The nav file is overwritten unless -out is given.\n" );
+}
+}
+
+int main( int argc, char* argv[] )
+{
+	unsigned int uiThreadCount = std::thread::hardware_concurrency();
+	const char* pszOutFileName = nullptr;
+
+	int iArg = 1;
+
+	for( ; iArg < argc && argv[ iArg ][ 0 ] == '-'; ++iArg )
+	{
+		if( !strcmp( argv[ iArg ], "-threads" ) && iArg + 1 < argc )
+		{
+			uiThreadCount = static_cast<unsigned int>( atoi( argv[ ++iArg ] ) );
+		}
+		else if( !strcmp( argv[ iArg ], "-out" ) && iArg + 1 < argc )
+		{
+			pszOutFileName = argv[ ++iArg ];
+		}
+		else
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if( argc - iArg != 2 )
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	const char* const pszBSPFileName = argv[ iArg ];
+	const char* const pszNavFileName = argv[ iArg + 1 ];
+
+	if( !pszOutFileName )
+		pszOutFileName = pszNavFileName;
+
+	if( uiThreadCount < 1 )
+		uiThreadCount = 1;
+
+	CStopwatch totalTime;
+	CStopwatch phaseTime;
+
+	bsp::CClipHulls hulls;
+	unsigned int uiBSPSize = 0;
+
+	if( !hulls.LoadFromFile( pszBSPFileName, &uiBSPSize ) )
+		return EXIT_FAILURE;
+
+	nav::CNavMesh mesh;
+
+	if( !mesh.Load( pszNavFileName ) )
+		return EXIT_FAILURE;
+
+	printf( "Loaded %u areas in %.3f seconds\n", static_cast<unsigned int>( mesh.GetAreas().size() ), phaseTime.GetElapsedSeconds() );
+	printf( "Using %u threads\n", uiThreadCount );
+
+	nav::CNavAnalyzer analyzer( mesh, hulls, uiThreadCount );
+
+	phaseTime.Reset();
+	const size_t uiHidingSpots = analyzer.ComputeHidingSpots();
+	printf( "Found %u hiding spots in %.3f seconds\n", static_cast<unsigned int>( uiHidingSpots ), phaseTime.GetElapsedSeconds() );
+
+	phaseTime.Reset();
+	const size_t uiSniperSpots = analyzer.ComputeSniperSpots();
+	printf( "Found %u sniper spots in %.3f seconds\n", static_cast<unsigned int>( uiSniperSpots ), phaseTime.GetElapsedSeconds() );
+
+	phaseTime.Reset();
+	const size_t uiEncounters = analyzer.ComputeSpotEncounters();
+	printf( "Computed %u encounter paths in %.3f seconds\n", static_cast<unsigned int>( uiEncounters ), phaseTime.GetElapsedSeconds() );
+
+	phaseTime.Reset();
+	const size_t uiApproachAreas = analyzer.ComputeApproachAreas();
+	printf( "Found %u approach areas in %.3f seconds\n", static_cast<unsigned int>( uiApproachAreas ), phaseTime.GetElapsedSeconds() );
+
+	if( !mesh.Save( pszOutFileName, uiBSPSize ) )
+		return EXIT_FAILURE;
+
+	printf( "Wrote \"%s\", total time %.3f seconds\n", pszOutFileName, totalTime.GetElapsedSeconds() );
+
+	return EXIT_SUCCESS;
+}
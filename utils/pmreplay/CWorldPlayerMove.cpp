@@ -0,0 +1,302 @@
+#include <cstring>
+
+#include "extdll.h"
+#include "util.h"
+
+#include "pm_defs.h"
+#include "pm_movevars.h"
+#include "pm_shared.h"
+
+#include "CClipHulls.h"
+
+#include "CWorldPlayerMove.h"
+
+namespace
+{
+const bsp::CClipHulls* g_pHulls = nullptr;
+
+playermove_t* g_pPlayerMove = nullptr;
+
+/**
+*	Clip hull that the engine uses for each value of playermove_t::usehull.
+*/
+const int HULL_FOR_USEHULL[ 4 ] = { 1, 3, 0, 2 };
+
+int GetHull( const int iUseHull )
+{
+	return HULL_FOR_USEHULL[ iUseHull >= 0 && iUseHull < 4 ? iUseHull : 0 ];
+}
+
+/**
+*	@return A trace that didn't hit anything.
+*/
+pmtrace_t EmptyTrace( const Vector& vecEnd )
+{
+	pmtrace_t tr = pmtrace_t();
+
+	tr.fraction = 1;
+	tr.endpos = vecEnd;
+	tr.ent = -1;
+
+	return tr;
+}
+
+/**
+*	Traces the world like the engine's player traces do: the result is only used if the world was hit, otherwise nothing was hit.
+*/
+pmtrace_t TraceWorld( const Vector& vecStart, const Vector& vecEnd, const int iHull )
+{
+	pmtrace_t tr = EmptyTrace( vecEnd );
+
+	bsp::HullTrace hullTrace;
+
+	g_pHulls->Trace( vecStart, vecEnd, hullTrace, iHull );
+
+	const float flFraction = hullTrace.bStartSolid ? 0 : hullTrace.flFraction;
+
+	if( flFraction < 1 )
+	{
+		tr.allsolid = hullTrace.bAllSolid;
+		tr.startsolid = hullTrace.bStartSolid;
+		tr.fraction = flFraction;
+		tr.endpos = hullTrace.vecEndPos;
+		tr.plane.normal = hullTrace.vecPlaneNormal;
+		tr.plane.dist = hullTrace.flPlaneDist;
+		tr.ent = 0;
+	}
+
+	return tr;
+}
+
+const char* PM_Info_ValueForKey( const char* s, const char* key )
+{
+	static char szValue[ MAX_PHYSINFO_STRING ];
+
+	const size_t uiKeyLength = strlen( key );
+
+	if( *s == '\\' )
+		++s;
+
+	while( *s )
+	{
+		const char* pszKeyEnd = strchr( s, '\\' );
+
+		if( !pszKeyEnd )
+			break;
+
+		const char* pszValue = pszKeyEnd + 1;
+		const char* pszValueEnd = strchr( pszValue, '\\' );
+
+		if( !pszValueEnd )
+			pszValueEnd = pszValue + strlen( pszValue );
+
+		if( static_cast<size_t>( pszKeyEnd - s ) == uiKeyLength && !strncmp( s, key, uiKeyLength ) )
+		{
+			const size_t uiLength = min( static_cast<size_t>( pszValueEnd - pszValue ), sizeof( szValue ) - 1 );
+
+			memcpy( szValue, pszValue, uiLength );
+			szValue[ uiLength ] = '\0';
+
+			return szValue;
+		}
+
+		s = *pszValueEnd ? pszValueEnd + 1 : pszValueEnd;
+	}
+
+	return "";
+}
+
+void PM_Particle( const Vector&, int, float, int, int )
+{
+}
+
+int PM_TestPlayerPosition( const Vector& pos, pmtrace_t* ptrace )
+{
+	const int iHull = GetHull( g_pPlayerMove->usehull );
+
+	if( g_pHulls->PointContents( pos, iHull ) != CONTENTS_SOLID )
+		return -1;
+
+	if( ptrace )
+		*ptrace = TraceWorld( pos, pos, iHull );
+
+	return 0;
+}
+
+void Con_NPrintf( int, const char* const, ... )
+{
+}
+
+/**
+*	The stuck checks use this to rate limit themselves, so use the move's time to keep replays deterministic.
+*/
+double Sys_FloatTime()
+{
+	return g_pPlayerMove->time / 1000.0;
+}
+
+void PM_StuckTouch( int, pmtrace_t* )
+{
+}
+
+int PM_PointContents( const Vector& p, int* truecontents )
+{
+	int iContents = g_pHulls->PointContents( p );
+
+	if( truecontents )
+		*truecontents = iContents;
+
+	//Currents are water to the movement code.
+	if( iContents <= CONTENTS_CURRENT_0 && iContents >= CONTENTS_CURRENT_DOWN )
+		iContents = CONTENTS_WATER;
+
+	return iContents;
+}
+
+int PM_TruePointContents( const Vector& p )
+{
+	return g_pHulls->PointContents( p );
+}
+
+pmtrace_t PM_PlayerTrace( const Vector& start, const Vector& end, int, int ignore_pe )
+{
+	if( ignore_pe == 0 )
+		return EmptyTrace( end );
+
+	return TraceWorld( start, end, GetHull( g_pPlayerMove->usehull ) );
+}
+
+pmtrace_t* PM_TraceLine( const Vector& start, const Vector& end, int, int usehull, int ignore_pe )
+{
+	static pmtrace_t tr;
+
+	tr = ignore_pe == 0 ? EmptyTrace( end ) : TraceWorld( start, end, GetHull( usehull ) );
+
+	return &tr;
+}
+
+int32 RandomLong( int32 lLow, int32 )
+{
+	return lLow;
+}
+
+float RandomFloat( float flLow, float )
+{
+	return flLow;
+}
+
+void PM_PlaySound( int, const char*, float, float, int, int )
+{
+}
+
+/**
+*	The hulls have no textures, so texture types stay at their default.
+*/
+const char* PM_TraceTexture( int, const Vector&, const Vector& )
+{
+	return nullptr;
+}
+
+void PM_PlaybackEventFull( int, int, unsigned short, float, const Vector&, const Vector&, float, float, int, int, int, int )
+{
+}
+
+pmtrace_t PM_PlayerTraceEx( const Vector& start, const Vector& end, int traceFlags, int ( *pfnIgnore )( physent_t* pe ) )
+{
+	return PM_PlayerTrace( start, end, traceFlags, pfnIgnore( &g_pPlayerMove->physents[ 0 ] ) ? 0 : -1 );
+}
+
+int PM_TestPlayerPositionEx( const Vector& pos, pmtrace_t* ptrace, int ( *pfnIgnore )( physent_t* pe ) )
+{
+	if( pfnIgnore( &g_pPlayerMove->physents[ 0 ] ) )
+		return -1;
+
+	return PM_TestPlayerPosition( pos, ptrace );
+}
+
+pmtrace_t* PM_TraceLineEx( const Vector& start, const Vector& end, int flags, int usehull, int ( *pfnIgnore )( physent_t* pe ) )
+{
+	return PM_TraceLine( start, end, flags, usehull, pfnIgnore( &g_pPlayerMove->physents[ 0 ] ) ? 0 : -1 );
+}
+}
+
+CWorldPlayerMove::CWorldPlayerMove( const bsp::CClipHulls& hulls )
+	: m_Move( new playermove_t() )
+	, m_MoveVars()
+{
+	g_pHulls = &hulls;
+	g_pPlayerMove = m_Move.get();
+
+	auto& move = *m_Move;
+
+	move.movevars = &m_MoveVars;
+
+	//Same as the game's GetHullBounds. The engine's default is used for the large hull.
+	move.player_mins[ 0 ] = VEC_HULL_MIN;
+	move.player_maxs[ 0 ] = VEC_HULL_MAX;
+	move.player_mins[ 1 ] = VEC_DUCK_HULL_MIN;
+	move.player_maxs[ 1 ] = VEC_DUCK_HULL_MAX;
+	move.player_mins[ 2 ] = Vector( 0, 0, 0 );
+	move.player_maxs[ 2 ] = Vector( 0, 0, 0 );
+	move.player_mins[ 3 ] = Vector( -32, -32, -32 );
+	move.player_maxs[ 3 ] = Vector( 32, 32, 32 );
+
+	//Functions that need engine models are left unset. The world physent has no model and there are no moveents.
+	move.PM_Info_ValueForKey = &::PM_Info_ValueForKey;
+	move.PM_Particle = &::PM_Particle;
+	move.PM_TestPlayerPosition = &::PM_TestPlayerPosition;
+	move.Con_NPrintf = &::Con_NPrintf;
+	move.Con_DPrintf = &Con_DPrintf;
+	move.Con_Printf = &Con_Printf;
+	move.Sys_FloatTime = &::Sys_FloatTime;
+	move.PM_StuckTouch = &::PM_StuckTouch;
+	move.PM_PointContents = &::PM_PointContents;
+	move.PM_TruePointContents = &::PM_TruePointContents;
+	move.PM_PlayerTrace = &::PM_PlayerTrace;
+	move.PM_TraceLine = &::PM_TraceLine;
+	move.RandomLong = &::RandomLong;
+	move.RandomFloat = &::RandomFloat;
+	move.PM_PlaySound = &::PM_PlaySound;
+	move.PM_TraceTexture = &::PM_TraceTexture;
+	move.PM_PlaybackEventFull = &::PM_PlaybackEventFull;
+	move.PM_PlayerTraceEx = &::PM_PlayerTraceEx;
+	move.PM_TestPlayerPositionEx = &::PM_TestPlayerPositionEx;
+	move.PM_TraceLineEx = &::PM_TraceLineEx;
+
+	PM_InitMovement( &move );
+}
+
+CWorldPlayerMove::~CWorldPlayerMove()
+{
+	g_pHulls = nullptr;
+	g_pPlayerMove = nullptr;
+}
+
+void CWorldPlayerMove::PrepareMove()
+{
+	auto& move = *m_Move;
+
+	move.movevars = &m_MoveVars;
+
+	auto& world = move.physents[ 0 ];
+
+	world = physent_t();
+
+	strcpy( world.name, "world" );
+	world.solid = SOLID_BSP;
+	world.info = 0;
+
+	move.numphysent = 1;
+	move.nummoveent = 0;
+	move.numvisent = 1;
+	move.visents[ 0 ] = world;
+	move.numtouch = 0;
+
+	//Don't play sounds or events.
+	move.runfuncs = false;
+}
+
+void CWorldPlayerMove::Move()
+{
+	PM_Move( m_Move.get(), true );
+}
@@ -0,0 +1,55 @@
+#ifndef UTILS_PMREPLAY_CWORLDPLAYERMOVE_H
+#define UTILS_PMREPLAY_CWORLDPLAYERMOVE_H
+
+#include <memory>
+
+#include "extdll.h"
+
+#include "pm_defs.h"
+#include "pm_movevars.h"
+
+namespace bsp
+{
+class CClipHulls;
+}
+
+/**
+*	Runs player movement against the world's clip hulls, standing in for the engine.
+*	Traces and contents checks go through bsp::CClipHulls. Sounds, events and entity lookups do nothing, and the world is the only entity.
+*	PM_Move uses global state, so only one instance may exist at a time.
+*/
+class CWorldPlayerMove final
+{
+public:
+	/**
+	*	@param hulls Hulls to collide with. Must outlive this object.
+	*/
+	explicit CWorldPlayerMove( const bsp::CClipHulls& hulls );
+	~CWorldPlayerMove();
+
+	playermove_t& GetMove() { return *m_Move; }
+
+	movevars_t& GetMoveVars() { return m_MoveVars; }
+
+	/**
+	*	Resets the entity lists to just the world and disables sounds and events.
+	*	Must be called after the player state is set, and before each move.
+	*/
+	void PrepareMove();
+
+	/**
+	*	Runs a move with the current state and user command.
+	*/
+	void Move();
+
+private:
+	std::unique_ptr<playermove_t> m_Move;
+
+	movevars_t m_MoveVars;
+
+private:
+	CWorldPlayerMove( const CWorldPlayerMove& ) = delete;
+	CWorldPlayerMove& operator=( const CWorldPlayerMove& ) = delete;
+};
+
+#endif //UTILS_PMREPLAY_CWORLDPLAYERMOVE_H
@@ -0,0 +1,71 @@
+/**
+*	Definitions that the shared movement and materials code normally gets from the engine and the game libraries.
+*	Only the world entity exists, and there is no filesystem; the materials list is never loaded.
+*/
+#include <cstdarg>
+#include <cstdio>
+
+#include "extdll.h"
+#include "util.h"
+
+namespace
+{
+edict_t g_WorldEdict;
+
+edict_t* PEntityOfEntIndex( int )
+{
+	return &g_WorldEdict;
+}
+
+void AlertMessage( ALERT_TYPE aType, const char* pszFormat, ... )
+{
+	if( aType == at_aiconsole )
+		return;
+
+	va_list list;
+
+	va_start( list, pszFormat );
+	vprintf( pszFormat, list );
+	va_end( list );
+}
+
+enginefuncs_t CreateEngineFuncs()
+{
+	enginefuncs_t funcs = enginefuncs_t();
+
+	funcs.pfnPEntityOfEntIndex = &::PEntityOfEntIndex;
+	funcs.pfnAlertMessage = &::AlertMessage;
+
+	return funcs;
+}
+}
+
+enginefuncs_t g_engfuncs = CreateEngineFuncs();
+
+IFileSystem* g_pFileSystem = nullptr;
+
+void Con_Printf( const char* const pszFormat, ... )
+{
+	va_list list;
+
+	va_start( list, pszFormat );
+	vprintf( pszFormat, list );
+	va_end( list );
+}
+
+void Con_DPrintf( const char* const, ... )
+{
+}
+
+#ifdef DEBUG
+void DBG_AssertFunction( const bool fExpr, const char* szExpr, const char* szFile, int szLine, const char* szMessage )
+{
+	if( fExpr )
+		return;
+
+	if( szMessage )
+		printf( "ASSERT FAILED:\n %s \n(%s@%d)\n%s\n", szExpr, szFile, szLine, szMessage );
+	else
+		printf( "ASSERT FAILED:\n %s \n(%s@%d)\n", szExpr, szFile, szLine );
+}
+#endif
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+"""
+Writes pmtest.bsp, the map that pmtest.pmr is recorded on.
+
+The map only has what pmreplay needs: planes, nodes, leafs, clip nodes and the world model.
+It's a closed room with a step, a ledge that can be jumped onto, a tall block, a ramp and a pool of water.
+Every solid is convex, so each hull is built as a chain of plane tests per solid,
+and the clip hulls are made by moving each plane out by the hull's size.
+"""
+import math
+import struct
+
+BSPVERSION = 30
+
+LUMP_ENTITIES = 0
+LUMP_PLANES = 1
+LUMP_NODES = 5
+LUMP_CLIPNODES = 9
+LUMP_LEAFS = 10
+LUMP_MODELS = 14
+HEADER_LUMPS = 15
+
+CONTENTS_EMPTY = -1
+CONTENTS_SOLID = -2
+CONTENTS_WATER = -3
+
+#Half sizes of hulls 1 to 3. Hull 0 is the point hull.
+HULL_SIZES = [(0, 0, 0), (16, 16, 36), (32, 32, 32), (16, 16, 18)]
+
+ROOM_MINS = (-512, -512, 0)
+ROOM_MAXS = (512, 512, 256)
+
+
+def box(mins, maxs):
+	"""Planes of a box, as (normal, dist) pairs. A point is inside if it's behind every plane."""
+	planes = []
+	for axis in range(3):
+		normal = [0, 0, 0]
+		normal[axis] = 1
+		planes.append((tuple(normal), maxs[axis]))
+		normal[axis] = -1
+		planes.append((tuple(normal), -mins[axis]))
+	return planes
+
+
+def ramp(x0, x1, halfwidth, height):
+	"""A wedge that rises along +x, with the axial bevel planes that the clip hulls need."""
+	length = x1 - x0
+	scale = math.hypot(length, height)
+	normal = (-height / scale, 0, length / scale)
+	return [
+		(normal, normal[0] * x0),
+		((0, 0, -1), 0),
+		((1, 0, 0), x1),
+		((0, 1, 0), halfwidth),
+		((0, -1, 0), halfwidth),
+		((-1, 0, 0), -x0),
+		((0, 0, 1), height),
+	]
+
+
+SOLIDS = [
+	#Step that can be walked up.
+	box((64, -128, 0), (192, 128, 16)),
+	#Ledge that can be jumped onto.
+	box((-256, -256, 0), (-128, -128, 40)),
+	#Block that's too tall to get onto.
+	box((-256, 128, 0), (-128, 256, 128)),
+	ramp(256, 448, 64, 96),
+]
+
+WATER = box((-448, 192, 0), (-320, 448, 96))
+
+
+def expand(planes, size, sign):
+	return [(normal, dist + sign * sum(abs(n) * s for n, s in zip(normal, size))) for normal, dist in planes]
+
+
+class Writer:
+	def __init__(self):
+		self.planes = []
+		self.plane_index = {}
+
+	def add_plane(self, normal, dist):
+		"""Stores the plane facing along a positive axis if it's axial, like qbsp does.
+		Returns the plane index and whether the plane was flipped."""
+		flipped = False
+		axial = [i for i in range(3) if normal[i] != 0]
+		if len(axial) == 1 and normal[axial[0]] < 0:
+			normal = tuple(-n for n in normal)
+			dist = -dist
+			flipped = True
+		if len(axial) == 1:
+			plane_type = axial[0]
+		else:
+			plane_type = 3 + max(range(3), key=lambda i: abs(normal[i]))
+		key = (tuple(float(n) for n in normal), float(dist))
+		if key not in self.plane_index:
+			self.plane_index[key] = len(self.planes)
+			self.planes.append(struct.pack('<4fi', *key[0], key[1], plane_type))
+		return self.plane_index[key], flipped
+
+	def build_hull(self, size, leaf_for):
+		"""Builds the plane tests for one hull. Returns the nodes as (plane, front, back), in order, with the head node first.
+		Children below 0 are contents, turned into a leaf reference by leaf_for."""
+		nodes = []
+
+		def add_node(plane, inside, outside):
+			index, flipped = self.add_plane(*plane)
+			nodes.append([index] + ([inside, outside] if flipped else [outside, inside]))
+			return len(nodes) - 1
+
+		#Built back to front so every child already has its index.
+		chains = [(expand(solid, size, 1), CONTENTS_SOLID) for solid in SOLIDS]
+		if leaf_for is not None:
+			chains.append((WATER, CONTENTS_WATER))
+
+		pending = []
+		outside = leaf_for(CONTENTS_EMPTY) if leaf_for else CONTENTS_EMPTY
+		for planes, contents in reversed(chains):
+			inside = leaf_for(contents) if leaf_for else contents
+			for plane in reversed(planes):
+				pending.append((plane, inside, outside))
+				inside = ('node', len(pending) - 1)
+			outside = inside
+
+		room = expand(box(ROOM_MINS, ROOM_MAXS), size, -1)
+		inside = outside
+		solid = leaf_for(CONTENTS_SOLID) if leaf_for else CONTENTS_SOLID
+		for plane in reversed(room):
+			pending.append((plane, inside, solid))
+			inside = ('node', len(pending) - 1)
+
+		#Reverse so the head node comes first.
+		count = len(pending)
+		resolve = lambda child: count - 1 - child[1] if isinstance(child, tuple) else child
+		for plane, inside, outside in reversed(pending):
+			add_node(plane, resolve(inside), resolve(outside))
+		return nodes
+
+
+def main():
+	writer = Writer()
+
+	#Leaf 0 must be the solid leaf.
+	leaf_contents = [CONTENTS_SOLID, CONTENTS_EMPTY, CONTENTS_WATER]
+	leaf_for = lambda contents: -(leaf_contents.index(contents) + 1)
+
+	mins = ROOM_MINS
+	maxs = ROOM_MAXS
+
+	nodes = writer.build_hull(HULL_SIZES[0], leaf_for)
+	node_data = b''.join(struct.pack('<i2h3h3h2H', plane, front, back, *mins, *maxs, 0, 0) for plane, front, back in nodes)
+
+	clipnodes = []
+	headnodes = [0]
+	for size in HULL_SIZES[1:]:
+		headnodes.append(len(clipnodes))
+		base = len(clipnodes)
+		for plane, front, back in writer.build_hull(size, None):
+			clipnodes.append((plane, front + base if front >= 0 else front, back + base if back >= 0 else back))
+	clipnode_data = b''.join(struct.pack('<i2h', *node) for node in clipnodes)
+
+	leaf_data = b''.join(struct.pack('<2i3h3h2H4B', contents, -1, *mins, *maxs, 0, 0, 0, 0, 0, 0) for contents in leaf_contents)
+	model_data = struct.pack('<9f4i3i', *mins, *maxs, 0, 0, 0, *headnodes, 0, 0, 0)
+
+	entities = b'{\n"classname" "worldspawn"\n}\n{\n"classname" "info_player_start"\n"origin" "-64 0 36"\n}\n\0'
+
+	lumps = {
+		LUMP_ENTITIES: entities,
+		LUMP_PLANES: b''.join(writer.planes),
+		LUMP_NODES: node_data,
+		LUMP_CLIPNODES: clipnode_data,
+		LUMP_LEAFS: leaf_data,
+		LUMP_MODELS: model_data,
+	}
+
+	offset = 4 + HEADER_LUMPS * 8
+	header = struct.pack('<i', BSPVERSION)
+	data = b''
+	for lump in range(HEADER_LUMPS):
+		lump_data = lumps.get(lump, b'')
+		header += struct.pack('<2i', offset, len(lump_data))
+		data += lump_data
+		offset += len(lump_data)
+
+	with open('pmtest.bsp', 'wb') as file:
+		file.write(header + data)
+
+
+if __name__ == '__main__':
+	main()
@@ -0,0 +1,518 @@
+/**
+*	Replays player movement recordings against a map's clip hulls, without the game.
+*	Usage: pmreplay [-iterations <count>] [-tolerance <units>] <bsp file> <recording>
+*	       pmreplay -record <script> <bsp file> <recording>
+*
+*	Recordings are made with the server's pm_record command, or from a movement script with -record.
+*	A replay runs every recorded move again, checks the resulting origin and velocity against the recording and reports how long the moves took.
+*	Results must match exactly unless a tolerance is given. Recordings made by a build with different floating point code generation need one.
+*
+*	data/pmtest.pmr is recorded from data/pmtest.txt on data/pmtest.bsp. Check movement code changes against it with:
+*	pmreplay -tolerance 0.01 data/pmtest.bsp data/pmtest.pmr
+*/
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "extdll.h"
+#include "util.h"
+
+#include "pm_defs.h"
+#include "pm_movevars.h"
+#include "pm_recording.h"
+#include "pm_shared.h"
+
+#include "CClipHulls.h"
+#include "CStopwatch.h"
+
+#include "CWorldPlayerMove.h"
+
+namespace
+{
+/**
+*	A scripted stretch of movement. Angles turn from the previous move's angles to these over the duration.
+*/
+struct ScriptMove final
+{
+	int iDuration;
+
+	Vector vecAngles;
+
+	float flForwardMove;
+	float flSideMove;
+	float flUpMove;
+
+	unsigned short uiButtons;
+};
+
+struct MovementScript final
+{
+	Vector vecOrigin = Vector( 0, 0, 0 );
+
+	int iMSec = 10;
+
+	std::vector<ScriptMove> moves;
+};
+
+void PrintUsage()
+{
+	printf( "Usage: pmreplay [-iterations <count>] [-tolerance <units>] <bsp file> <recording>\n"
+			"       pmreplay -record <script> <bsp file> <recording>\n"
+			"Replays a player movement recording against the map's clip hulls and checks the results.\n"
+			"With -record, runs a movement script and writes the moves to a new recording.\n" );
+}
+
+/**
+*	Same as the server's defaults.
+*/
+void SetDefaultMoveVars( movevars_t& movevars )
+{
+	movevars.gravity = 800;
+	movevars.stopspeed = 100;
+	movevars.maxspeed = 320;
+	movevars.spectatormaxspeed = 500;
+	movevars.accelerate = 10;
+	movevars.airaccelerate = 10;
+	movevars.wateraccelerate = 10;
+	movevars.friction = 4;
+	movevars.edgefriction = 2;
+	movevars.waterfriction = 1;
+	movevars.entgravity = 1;
+	movevars.bounce = 1;
+	movevars.stepsize = 18;
+	movevars.maxvelocity = 2000;
+	movevars.zmax = 4096;
+	movevars.footsteps = true;
+}
+
+/**
+*	Loads a movement script. Each line is one of:
+*	origin <x> <y> <z>		Starting origin
+*	msec <milliseconds>		Length of each move
+*	move <milliseconds> <pitch> <yaw> <forward> <side> <up> [jump] [duck]
+*	Lines starting with // are comments.
+*/
+bool LoadScript( const char* const pszFileName, MovementScript& script )
+{
+	FILE* pFile = fopen( pszFileName, "r" );
+
+	if( !pFile )
+	{
+		printf( "Couldn't open script \"%s\"\n", pszFileName );
+		return false;
+	}
+
+	char szLine[ 512 ];
+	int iLine = 0;
+
+	bool bSuccess = true;
+
+	while( bSuccess && fgets( szLine, sizeof( szLine ), pFile ) )
+	{
+		++iLine;
+
+		char szCommand[ 16 ];
+		int iOffset = 0;
+
+		if( sscanf( szLine, " %15s%n", szCommand, &iOffset ) != 1 || !strncmp( szCommand, "//", 2 ) )
+			continue;
+
+		const char* pszArgs = szLine + iOffset;
+
+		if( !strcmp( szCommand, "origin" ) )
+		{
+			bSuccess = sscanf( pszArgs, "%f %f %f", &script.vecOrigin.x, &script.vecOrigin.y, &script.vecOrigin.z ) == 3;
+		}
+		else if( !strcmp( szCommand, "msec" ) )
+		{
+			bSuccess = sscanf( pszArgs, "%d", &script.iMSec ) == 1 && script.iMSec > 0 && script.iMSec < 256;
+		}
+		else if( !strcmp( szCommand, "move" ) )
+		{
+			ScriptMove move;
+
+			bSuccess = sscanf( pszArgs, "%d %f %f %f %f %f%n", &move.iDuration, &move.vecAngles.x, &move.vecAngles.y,
+							   &move.flForwardMove, &move.flSideMove, &move.flUpMove, &iOffset ) == 6 && move.iDuration > 0;
+
+			move.vecAngles.z = 0;
+			move.uiButtons = 0;
+
+			char szButton[ 16 ];
+
+			for( pszArgs += iOffset; bSuccess && sscanf( pszArgs, " %15s%n", szButton, &iOffset ) == 1; pszArgs += iOffset )
+			{
+				if( !strcmp( szButton, "jump" ) )
+					move.uiButtons |= IN_JUMP;
+				else if( !strcmp( szButton, "duck" ) )
+					move.uiButtons |= IN_DUCK;
+				else
+					bSuccess = false;
+			}
+
+			if( bSuccess )
+				script.moves.push_back( move );
+		}
+		else
+		{
+			bSuccess = false;
+		}
+
+		if( !bSuccess )
+			printf( "Script \"%s\" line %d: invalid command\n", pszFileName, iLine );
+	}
+
+	fclose( pFile );
+
+	return bSuccess;
+}
+
+/**
+*	@return Name of the map, without path or extension.
+*/
+std::string GetMapName( const char* const pszFileName )
+{
+	std::string szName = pszFileName;
+
+	const size_t uiSlash = szName.find_last_of( "/\\" );
+
+	if( uiSlash != std::string::npos )
+		szName.erase( 0, uiSlash + 1 );
+
+	const size_t uiDot = szName.find_last_of( '.' );
+
+	if( uiDot != std::string::npos )
+		szName.erase( uiDot );
+
+	return szName;
+}
+
+/**
+*	Runs a script the way the engine runs a player's user commands, and records each move.
+*/
+bool Record( const char* const pszScriptFileName, const bsp::CClipHulls& hulls, const char* const pszMapFileName, const char* const pszFileName )
+{
+	MovementScript script;
+
+	if( !LoadScript( pszScriptFileName, script ) )
+		return false;
+
+	CWorldPlayerMove world( hulls );
+
+	auto& move = world.GetMove();
+
+	SetDefaultMoveVars( world.GetMoveVars() );
+
+	move.server = true;
+	move.multiplayer = false;
+	move.time = 1000;
+	move.origin = script.vecOrigin;
+	move.view_ofs = VEC_VIEW;
+	move.flags = FL_CLIENT;
+	move.gravity = 1;
+	move.friction = 1;
+	move.movetype = MOVETYPE_WALK;
+	move.onground = -1;
+	move.watertype = CONTENTS_EMPTY;
+	move.maxspeed = world.GetMoveVars().maxspeed;
+	move.clientmaxspeed = world.GetMoveVars().maxspeed;
+
+	FILE* pFile = fopen( pszFileName, "wb" );
+
+	if( !pFile )
+	{
+		printf( "Couldn't open \"%s\" for writing\n", pszFileName );
+		return false;
+	}
+
+	pmrec::RecordingHeader header;
+
+	pmrec::InitHeader( header, move, GetMapName( pszMapFileName ).c_str() );
+
+	bool bSuccess = fwrite( &header, sizeof( header ), 1, pFile ) == 1;
+
+	std::vector<uint8_t> frame( pmrec::GetFrameSize( pmrec::GetStateSize( move ) ) );
+
+	unsigned int uiFrames = 0;
+
+	Vector vecAngles( 0, 0, 0 );
+
+	for( auto it = script.moves.begin(); bSuccess && it != script.moves.end(); ++it )
+	{
+		const auto& scriptMove = *it;
+
+		const Vector vecStartAngles = vecAngles;
+
+		const int iMoves = max( 1, scriptMove.iDuration / script.iMSec );
+
+		for( int iMove = 1; bSuccess && iMove <= iMoves; ++iMove )
+		{
+			vecAngles = vecStartAngles + ( scriptMove.vecAngles - vecStartAngles ) * ( static_cast<float>( iMove ) / iMoves );
+
+			auto& cmd = move.cmd;
+
+			cmd = usercmd_t();
+
+			cmd.msec = static_cast<byte>( script.iMSec );
+			cmd.viewangles = vecAngles;
+			cmd.forwardmove = scriptMove.flForwardMove;
+			cmd.sidemove = scriptMove.flSideMove;
+			cmd.upmove = scriptMove.flUpMove;
+			cmd.buttons = scriptMove.uiButtons;
+
+			//Set up the parts of the state that the engine takes from the player entity.
+			move.frametime = script.iMSec * 0.001f;
+			move.angles = vecAngles;
+			move.oldangles = vecAngles;
+			move.usehull = ( move.flags & FL_DUCKING ) ? 1 : 0;
+
+			world.PrepareMove();
+
+			pmrec::WriteFrameInput( move, frame.data() );
+
+			world.Move();
+
+			pmrec::WriteFrameResult( move, move.numphysent, move.nummoveent, frame.data() );
+
+			bSuccess = fwrite( frame.data(), frame.size(), 1, pFile ) == 1;
+
+			move.oldbuttons = cmd.buttons;
+			move.time += script.iMSec;
+
+			++uiFrames;
+		}
+	}
+
+	fclose( pFile );
+
+	if( !bSuccess )
+	{
+		printf( "Couldn't write to \"%s\"\n", pszFileName );
+		return false;
+	}
+
+	printf( "Recorded %u moves to \"%s\", ending at %.3f %.3f %.3f\n", uiFrames, pszFileName, move.origin.x, move.origin.y, move.origin.z );
+
+	return true;
+}
+
+bool Matches( const Vector& vecValue, const float* pflRecorded, const float flTolerance )
+{
+	if( flTolerance <= 0 )
+		return memcmp( &vecValue, pflRecorded, sizeof( Vector ) ) == 0;
+
+	for( int i = 0; i < 3; ++i )
+	{
+		if( fabs( vecValue[ i ] - pflRecorded[ i ] ) > flTolerance )
+			return false;
+	}
+
+	return true;
+}
+
+/**
+*	Replays a recording.
+*	@return Whether all world-only moves matched the recording.
+*/
+bool Replay( const char* const pszFileName, const bsp::CClipHulls& hulls, const int iIterations, const float flTolerance )
+{
+	std::vector<uint8_t> data;
+
+	{
+		FILE* pFile = fopen( pszFileName, "rb" );
+
+		if( !pFile )
+		{
+			printf( "Couldn't open \"%s\"\n", pszFileName );
+			return false;
+		}
+
+		fseek( pFile, 0, SEEK_END );
+		data.resize( ftell( pFile ) );
+		fseek( pFile, 0, SEEK_SET );
+
+		const bool bRead = data.size() >= sizeof( pmrec::RecordingHeader ) && fread( data.data(), data.size(), 1, pFile ) == 1;
+
+		fclose( pFile );
+
+		if( !bRead )
+		{
+			printf( "Couldn't read \"%s\"\n", pszFileName );
+			return false;
+		}
+	}
+
+	CWorldPlayerMove world( hulls );
+
+	auto& move = world.GetMove();
+
+	pmrec::RecordingHeader header;
+
+	memcpy( &header, data.data(), sizeof( header ) );
+
+	header.szMapName[ sizeof( header.szMapName ) - 1 ] = '\0';
+
+	if( !pmrec::IsCompatible( header, move ) )
+	{
+		printf( "\"%s\" is not a recording or was made with a different build\n", pszFileName );
+		return false;
+	}
+
+	const size_t uiFrameSize = pmrec::GetFrameSize( header.uiStateSize );
+	const size_t uiFrameCount = ( data.size() - sizeof( pmrec::RecordingHeader ) ) / uiFrameSize;
+
+	if( uiFrameCount == 0 )
+	{
+		printf( "\"%s\" has no moves\n", pszFileName );
+		return false;
+	}
+
+	size_t uiMismatches = 0;
+	size_t uiEntityFrames = 0;
+	size_t uiEntityMismatches = 0;
+	float flMaxError = 0;
+	size_t uiFirstMismatch = uiFrameCount;
+
+	double flMoveTime = 0;
+
+	PM_ResetProfile();
+	g_PMProfile.bEnabled = true;
+
+	for( int iIteration = 0; iIteration < iIterations; ++iIteration )
+	{
+		const uint8_t* pFrame = data.data() + sizeof( pmrec::RecordingHeader );
+
+		for( size_t uiFrame = 0; uiFrame < uiFrameCount; ++uiFrame, pFrame += uiFrameSize )
+		{
+			const auto frameHeader = pmrec::ReadFrame( pFrame, move );
+
+			world.PrepareMove();
+
+			CStopwatch stopwatch;
+
+			world.Move();
+
+			flMoveTime += stopwatch.GetElapsedSeconds();
+
+			//Only check the first iteration; the rest are for timing.
+			if( iIteration > 0 )
+				continue;
+
+			const bool bHadEntities = frameHeader.iNumPhysEnts > 1 || frameHeader.iNumMoveEnts > 0;
+
+			if( bHadEntities )
+				++uiEntityFrames;
+
+			if( !Matches( move.origin, frameHeader.vecOrigin, flTolerance ) ||
+				!Matches( move.velocity, frameHeader.vecVelocity, flTolerance ) )
+			{
+				if( bHadEntities )
+				{
+					++uiEntityMismatches;
+				}
+				else
+				{
+					++uiMismatches;
+
+					const Vector vecOrigin( frameHeader.vecOrigin[ 0 ], frameHeader.vecOrigin[ 1 ], frameHeader.vecOrigin[ 2 ] );
+
+					flMaxError = max( flMaxError, ( move.origin - vecOrigin ).Length() );
+
+					if( uiFirstMismatch == uiFrameCount )
+						uiFirstMismatch = uiFrame;
+				}
+			}
+		}
+	}
+
+	g_PMProfile.bEnabled = false;
+
+	const size_t uiTotalMoves = uiFrameCount * iIterations;
+
+	printf( "\"%s\" (map %s): %u moves x %d iterations\n", pszFileName, header.szMapName, static_cast<unsigned int>( uiFrameCount ), iIterations );
+	printf( "%.3f ms total, %.0f moves/s, %.3f us/move\n",
+			flMoveTime * 1000, flMoveTime > 0 ? uiTotalMoves / flMoveTime : 0.0, ( flMoveTime * 1000000 ) / uiTotalMoves );
+
+	printf( "%-24s %10s %12s %10s %7s\n", "function", "calls", "total ms", "avg us", "share" );
+
+	for( int iFunc = 0; iFunc < PMPROF_COUNT; ++iFunc )
+	{
+		const auto uiCalls = g_PMProfile.uiCalls[ iFunc ];
+		const double flTime = g_PMProfile.flTime[ iFunc ];
+
+		printf( "%-24s %10u %12.3f %10.3f %6.1f%%\n",
+				PM_ProfileFuncName( static_cast<PMProfileFunc>( iFunc ) ), uiCalls, flTime * 1000,
+				uiCalls ? ( flTime * 1000000 ) / uiCalls : 0.0, flMoveTime > 0 ? ( flTime * 100 ) / flMoveTime : 0.0 );
+	}
+
+	if( uiMismatches == 0 )
+	{
+		printf( "All %u world-only moves match the recording\n", static_cast<unsigned int>( uiFrameCount - uiEntityFrames ) );
+	}
+	else
+	{
+		printf( "%u of %u world-only moves differ from the recording (first at move %u, max origin error %f)\n",
+				static_cast<unsigned int>( uiMismatches ), static_cast<unsigned int>( uiFrameCount - uiEntityFrames ),
+				static_cast<unsigned int>( uiFirstMismatch ), flMaxError );
+	}
+
+	if( uiEntityFrames > 0 )
+	{
+		printf( "%u moves were recorded near other entities; %u of them differ because replays only collide with the world\n",
+				static_cast<unsigned int>( uiEntityFrames ), static_cast<unsigned int>( uiEntityMismatches ) );
+	}
+
+	return uiMismatches == 0;
+}
+}
+
+int main( int argc, char* argv[] )
+{
+	int iIterations = 1;
+	float flTolerance = 0;
+	const char* pszScriptFileName = nullptr;
+
+	int iArg = 1;
+
+	for( ; iArg < argc && argv[ iArg ][ 0 ] == '-'; ++iArg )
+	{
+		if( !strcmp( argv[ iArg ], "-iterations" ) && iArg + 1 < argc )
+		{
+			iIterations = max( 1, atoi( argv[ ++iArg ] ) );
+		}
+		else if( !strcmp( argv[ iArg ], "-tolerance" ) && iArg + 1 < argc )
+		{
+			flTolerance = static_cast<float>( atof( argv[ ++iArg ] ) );
+		}
+		else if( !strcmp( argv[ iArg ], "-record" ) && iArg + 1 < argc )
+		{
+			pszScriptFileName = argv[ ++iArg ];
+		}
+		else
+		{
+			PrintUsage();
+			return EXIT_FAILURE;
+		}
+	}
+
+	if( argc - iArg != 2 )
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	const char* const pszBSPFileName = argv[ iArg ];
+	const char* const pszRecordingFileName = argv[ iArg + 1 ];
+
+	bsp::CClipHulls hulls;
+
+	if( !hulls.LoadFromFile( pszBSPFileName ) )
+		return EXIT_FAILURE;
+
+	if( pszScriptFileName )
+		return Record( pszScriptFileName, hulls, pszBSPFileName, pszRecordingFileName ) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	return Replay( pszRecordingFileName, hulls, iIterations, flTolerance ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}